@@ -35,6 +35,7 @@ public:
     AclManager():db(0),lastOID(0)
     {
        pthread_mutex_init(&mutex, 0);
+       pthread_rwlock_init(&index_lock, 0);
     };
 
     virtual ~AclManager();
@@ -127,30 +128,56 @@ protected:
      */
     map<int, AclRule *> acl_rules_oids;
 
+    /**
+     *  Compiles the rule set into the decision index. Must be called, with
+     *  the manager locked, each time acl_rules is modified
+     */
+    void rebuild_index();
+
 private:
 
+    // ----------------------------------------
+    // ACL decision index
+    // ----------------------------------------
+
     /**
-     *  Gets all rules that apply to the user_req and, if any of them grants
-     *  permission, returns true.
+     *  Rights granted to a user (individual, group or all) over the objects
+     *  of a given type
+     */
+    struct AclRights
+    {
+        AclRights():all(0){};
+
+        long long           all;  /**< Rights over all the objects       */
+        map<int, long long> gids; /**< Rights over the objects of a group */
+        map<int, long long> oids; /**< Rights over individual objects    */
+    };
+
+    /**
+     *  Precompiled rule set. The rights are indexed by the rule user
+     *  attribute and each one of the object types of the rule resource.
+     *  The rights of all the rules for the same user and resource are OR'ed
+     */
+    map<long long, map<long long, AclRights> > acl_index;
+
+    /**
+     *  Checks the index for the rights granted to the user_req. The index
+     *  is only read, so concurrent requests do not block each other.
      *
      *    @param user_req user/group id and flags
-     *    @param resource_oid_req 64 bit request, ob. type and individual oid
-     *    @param resource_gid_req 64 bit request, ob. type and group id
-     *    @param resource_all_req 64 bit request, ob. type and all flag
+     *    @param obj_type The object over which the operation will be performed
+     *    @param obj_id The object ID, -1 if not set
+     *    @param obj_gid The object's group ID, -1 if not set
      *    @param rights_req Requested rights
-     *    @param individual_obj_type Mask with ob. type and individual flags
-     *    @param group_obj_type Mask with ob. type and gropu flags
      *
      *    @return true if any rule grants permission
      */
     bool match_rules(
             long long user_req,
-            long long resource_oid_req,
-            long long resource_gid_req,
-            long long resource_all_req,
-            long long rights_req,
-            long long individual_obj_type,
-            long long group_obj_type);
+            long long obj_type,
+            int       obj_id,
+            int       obj_gid,
+            long long rights_req);
 
     // ----------------------------------------
     // Mutex synchronization
@@ -174,6 +201,12 @@ private:
         pthread_mutex_unlock(&mutex);
     };
 
+    /**
+     *  Readers-writer lock for the decision index, authorize() takes it as
+     *  a reader, rebuild_index() as a writer
+     */
+    pthread_rwlock_t index_lock;
+
     // ----------------------------------------
     // DataBase implementation variables
     // ----------------------------------------
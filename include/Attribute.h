@@ -22,6 +22,8 @@
 #include <sstream>
 #include <algorithm>
 
+#include "XMLWriter.h"
+
 using namespace std;
 
 /**
@@ -83,6 +85,12 @@ public:
      */
     virtual string * to_xml() const = 0;
 
+    /**
+     *  Write the attribute using a simple XML format into an XML document
+     *    @param xml the writer holding the document
+     */
+    virtual void to_xml(XMLWriter& xml) const = 0;
+
     /**
      *  Builds a new attribute from a string.
      */
@@ -161,12 +169,20 @@ public:
      */
     string * to_xml() const
     {
-    	string * xml = new string;
+        XMLWriter xml(2 * name().size() + attribute_value.size() + 24);
 
-    	*xml = "<" + name() + "><![CDATA[" + attribute_value
-    		 + "]]></"+ name() + ">";
+        to_xml(xml);
 
-    	return xml;
+        string * str = new string;
+
+        xml.swap(*str);
+
+        return str;
+    }
+
+    void to_xml(XMLWriter& xml) const
+    {
+        xml.cdata(name(), attribute_value);
     }
 
     /**
@@ -265,6 +281,8 @@ public:
      */
     string * to_xml() const;
 
+    void to_xml(XMLWriter& xml) const;
+
     /**
      *  Builds a new attribute from a string of the form:
      *  "VAL_NAME_1=VAL_VALUE_1,...,VAL_NAME_N=VAL_VALUE_N".
@@ -280,6 +298,12 @@ public:
      *  Replace the value of the given vector attribute
      */
     void replace(const string& name, const string& value);
+
+    /**
+     *  Removes a value of the vector attribute
+     *    @param name of the value
+     */
+    void remove(const string& name);
     
     /**
      *  Returns the attribute type
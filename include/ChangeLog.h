@@ -0,0 +1,162 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef CHANGE_LOG_H_
+#define CHANGE_LOG_H_
+
+#include <deque>
+#include <string>
+#include <sstream>
+#include <pthread.h>
+
+using namespace std;
+
+/**
+ *  The ChangeLog keeps the last changes (allocate, update, drop) made to the
+ *  objects of the pools, so clients can get them incrementally instead of
+ *  polling the whole pools. Every change is identified by a sequence number,
+ *  only the last max_size changes are kept.
+ */
+class ChangeLog
+{
+public:
+    /**
+     *  Type of the change
+     */
+    enum EventType
+    {
+        ALLOCATE = 0,
+        UPDATE   = 1,
+        DROP     = 2
+    };
+
+    /**
+     *  @param _max_size number of changes kept in the log
+     *  @param _max_waiters number of calls that can wait for new changes at
+     *  the same time, each one holds a server thread
+     */
+    ChangeLog(unsigned int _max_size, unsigned int _max_waiters);
+
+    ~ChangeLog();
+
+    /**
+     *  Adds a change to the log, and wakes up the clients waiting for it
+     *    @param table of the pool of the object, "vm_pool" is stored as "vm"
+     *    @param oid of the object
+     *    @param event type of change
+     *    @param state of the object, -1 if not defined
+     *    @param sub_state of the object (e.g. LCM state), -1 if not defined
+     */
+    void add(const string&  table,
+             int            oid,
+             EventType      event,
+             int            state,
+             int            sub_state);
+
+    /**
+     *  Prints the changes with sequence number greater than seq in XML
+     *  format. If there is no such change the call waits up to timeout
+     *  seconds for a new one, unless max_waiters calls are already waiting;
+     *  then it returns at once.
+     *    @param seq last sequence number seen by the client
+     *    @param timeout in seconds, 0 to return at once
+     *    @param xml the resulting XML string
+     *    @return a reference to the generated string
+     */
+    string& to_xml(unsigned long long seq, int timeout, string& xml);
+
+    /**
+     *  Gets the sequence number of the last change
+     */
+    unsigned long long get_last_seq()
+    {
+        unsigned long long seq;
+
+        pthread_mutex_lock(&mutex);
+
+        seq = last_seq;
+
+        pthread_mutex_unlock(&mutex);
+
+        return seq;
+    };
+
+    /**
+     *  Gets a string representation of the event type
+     */
+    static const char * event_to_str(EventType event)
+    {
+        switch (event)
+        {
+            case ALLOCATE: return "ALLOCATE";
+            case UPDATE:   return "UPDATE";
+            case DROP:     return "DROP";
+            default:       return "-";
+        }
+    };
+
+private:
+
+    /**
+     *  A change in the log
+     */
+    struct Change
+    {
+        unsigned long long seq;
+        string             type;
+        int                oid;
+        EventType          event;
+        int                state;
+        int                sub_state;
+    };
+
+    /**
+     *  Number of changes kept in the log
+     */
+    unsigned int max_size;
+
+    /**
+     *  Max. number of calls waiting for new changes
+     */
+    unsigned int max_waiters;
+
+    /**
+     *  Number of calls waiting for new changes
+     */
+    unsigned int waiters;
+
+    /**
+     *  Sequence number of the last change added
+     */
+    unsigned long long last_seq;
+
+    /**
+     *  The changes, oldest first
+     */
+    deque<Change> changes;
+
+    /**
+     *  Mutex to access the log
+     */
+    pthread_mutex_t mutex;
+
+    /**
+     *  Signaled when a change is added
+     */
+    pthread_cond_t cond;
+};
+
+#endif /*CHANGE_LOG_H_*/
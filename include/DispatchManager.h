@@ -259,6 +259,12 @@ private:
     void  failed_action(int vid);
 
     void  resubmit_action(int vid);
+
+    /**
+     *  Removes the monitoring samples kept in memory for a VM, when it is DONE
+     *    @param vid VM unique id
+     */
+    void  remove_monitoring(int vid);
 };
 
 #endif /*DISPATCH_MANAGER_H*/
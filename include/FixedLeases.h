@@ -59,14 +59,25 @@ public:
      */
     int get(int vid, string&  ip, string&  mac);
 
+    /**
+     * Returns unused leases, which become used. All the leases are updated
+     * in the DB with a multi-row statement
+     *   @param vids identifiers of the VMs getting the leases, -1 to hold
+     *   @param ips of the returned leases
+     *   @param macs of the returned leases
+     *   @return 0 if success
+     */
+    int get(const vector<int>& vids, vector<string>& ips, vector<string>& macs);
+
     /**
      * Ask for a specific lease in the network
      *  @param vid identifier of the VM getting this lease
      *  @param ip ip of lease requested
      *  @param mac mac of the lease
+     *  @param use_held if a held lease can be set
      *  @return 0 if success
      */
-    int set(int vid, const string&  ip, string&  mac);
+    int set(int vid, const string& ip, string& mac, bool use_held);
 
     /**
      * Release an used lease, which becomes unused
@@ -120,7 +131,7 @@ private:
     /**
      *  Current lease pointer
      */
-    map<unsigned int, Lease *>::iterator  current;
+    map<unsigned int, Lease>::iterator  current;
 
     /**
      * Add a lease, from the Lease interface
@@ -152,7 +163,7 @@ private:
      int unset(const string& ip);
 
     /**
-     * Updates the DB entry for this lease
+     * Updates the DB entry for this lease and the used leases counter
      * @param lease Lease to be updated
      * @return 0 if success
      */
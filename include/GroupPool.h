@@ -102,7 +102,7 @@ public:
      */
     int update(Group * group)
     {
-        return group->update(db);
+        return PoolSQL::update(group);
     };
 
     /**
@@ -18,6 +18,8 @@
 #define HISTORY_H_
 
 #include "ObjectSQL.h"
+#include "XMLWriter.h"
+#include "XMLReader.h"
 
 using namespace std;
 
@@ -63,6 +65,12 @@ public:
      */
     string& to_xml(string& xml) const;
 
+    /**
+     * Function to print the History object into an XML document
+     *  @param xml the writer holding the document
+     */
+    void to_xml(XMLWriter& xml) const;
+
 private:
     friend class VirtualMachine;
     friend class VirtualMachinePool;
@@ -171,17 +179,13 @@ private:
     int select_cb(void *nil, int num, char **values, char **names);
 
     /**
-     *  Rebuilds the object from an xml node
-     *    @param node The xml node pointer
+     *  Rebuilds the object from a parsed xml document
+     *    @param reader holding the xml document
+     *    @param root path of the HISTORY element in the document
      *
      *    @return 0 on success, -1 otherwise
      */
-    int from_xml_node(const xmlNodePtr node)
-    {
-        ObjectXML::update_from_node(node);
-
-        return rebuild_attributes();
-    }
+    int from_xml(const XMLReader& reader, const string& root);
 
     /**
      *  Rebuilds the object from an xml formatted string
@@ -191,15 +195,15 @@ private:
      */
     int from_xml(const string &xml_str)
     {
-        ObjectXML::update_from_str(xml_str);
+        XMLReader reader;
 
-        return rebuild_attributes();
-    }
+        if ( reader.parse(xml_str) != 0 )
+        {
+            return -1;
+        }
 
-    /**
-     *  Rebuilds the internal attributes using xpath
-     */
-    int rebuild_attributes();
+        return from_xml(reader, "/HISTORY");
+    }
 };
 
 #endif /*HISTORY_H_*/
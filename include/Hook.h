@@ -25,6 +25,52 @@ using namespace std;
 //Forward definition of Hookable
 class Hookable;
 
+/**
+ *  Compact description of a change in a hookable object. Events are generated
+ *  in the pool update path (while the object is locked) and the hooks are
+ *  evaluated later with the state of the object at that time.
+ */
+struct HookEvent
+{
+    /**
+     *  Type of the change (Hook::ALLOCATE, Hook::UPDATE...)
+     */
+    int hook_type;
+
+    /**
+     *  Object id
+     */
+    int oid;
+
+    /**
+     *  State of the object
+     */
+    int state;
+
+    /**
+     *  Sub-state of the object (e.g. the LCM state of a VM), -1 if not used
+     */
+    int sub_state;
+};
+
+/**
+ *  Interface to queue hook events, so the hooks are evaluated and executed
+ *  out of the pool update path.
+ */
+class HookQueue
+{
+public:
+    virtual ~HookQueue(){};
+
+    /**
+     *  Queues an event to evaluate the hooks of a hookable object.
+     *    @param hookable that generated the event
+     *    @param event to be evaluated
+     *    @return 0 on success, -1 if the event can not be queued
+     */
+    virtual int queue(Hookable * hookable, const HookEvent& event) = 0;
+};
+
 /**
  *  This class is an abstract representation of a hook, provides a method to
  *  check if the hook has to be executed, and a method to invoke the hook. The
@@ -70,9 +116,22 @@ public:
 
     /**
      *  Executes the hook it self (usually with the aid of the ExecutionManager)
-     *    @param arg additional arguments for the hook
+     *    @param event that triggered the hook
+     *    @param arg the object associated to the event (locked), it may be 0
+     *    if the object does not exist anymore
      */
-    virtual void do_hook(void *arg) = 0;
+    virtual void do_hook(const HookEvent& event, void *arg) = 0;
+
+    /**
+     *  Checks if the hook will use the object of the event, so the object is
+     *  only locked when needed
+     *    @param event that triggered the hook
+     *    @return true if do_hook needs the object
+     */
+    virtual bool needs_object(const HookEvent& event)
+    {
+        return true;
+    };
 
 protected:
     /**
@@ -112,7 +171,7 @@ public:
     //--------------------------------------------------------------------------
     // Constructor and Destructor Methods
     //--------------------------------------------------------------------------
-    Hookable(){};
+    Hookable():hook_queue(0){};
 
     virtual ~Hookable()
     {
@@ -151,20 +210,110 @@ public:
         hooks.clear();
     };
 
+    /**
+     *  Sets the queue used to evaluate the hooks asynchronously. If no queue
+     *  is set the hooks are executed by do_hooks.
+     *    @param hq the hook queue
+     */
+    void set_hook_queue(HookQueue * hq)
+    {
+        hook_queue = hq;
+    };
+
+    /**
+     *  Generates the event for a change in the object and queues it to
+     *  evaluate the hooks. The hooks are executed right away if there is no
+     *  hook queue.
+     *    @param arg the object that has changed
+     *    @param hook_mask type of the change
+     */
+    void do_hooks(void *arg = 0, int hook_mask = 0xFF)
+    {
+        HookEvent event;
+
+        if ( hooks.empty() )
+        {
+            return;
+        }
+
+        event.hook_type = hook_mask;
+        event.oid       = -1;
+        event.state     = -1;
+        event.sub_state = -1;
+
+        hook_event(arg, event);
+
+        if ( hook_queue != 0 )
+        {
+            hook_queue->queue(this, event);
+        }
+        else
+        {
+            execute_hooks(event, arg);
+        }
+    };
+
+    /**
+     *  Evaluates the hooks for the events of an object queued by do_hooks,
+     *  in the order they were generated. This function is called by the
+     *  HookQueue.
+     *    @param events of the same object
+     */
+    virtual void run_hooks(const vector<HookEvent>& events)
+    {
+        vector<HookEvent>::const_iterator it;
+
+        for (it = events.begin(); it != events.end(); it++)
+        {
+            execute_hooks(*it, 0);
+        }
+    };
+
+protected:
+    /**
+     *  Fills the event for a change in an object, hookables should set the
+     *  object id and state of the event.
+     *    @param arg the object that has changed
+     *    @param event to be filled
+     */
+    virtual void hook_event(void *arg, HookEvent& event){};
+
+    /**
+     *  Checks if any of the hooks for an event will use the object
+     *    @param event the hook event
+     *    @return true if the object is needed
+     */
+    bool needs_object(const HookEvent& event)
+    {
+        int sz = static_cast<int>(hooks.size());
+
+        for (int i=0; i<sz ; i++)
+        {
+            if ((hooks[i]->type() & event.hook_type) &&
+                 hooks[i]->needs_object(event))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
     /**
      *  Iterates through the hooks, checking if they have to be executed and
      *  invokes them.
-     *    @param arg additional arguments for the hook
+     *    @param event the hook event
+     *    @param arg the object associated to the event
      */
-    void do_hooks(void *arg = 0, int hook_mask = 0xFF)
+    void execute_hooks(const HookEvent& event, void *arg)
     {
         int sz = static_cast<int>(hooks.size());
 
         for (int i=0; i<sz ; i++)
         {
-            if ( hooks[i]->type() & hook_mask )
+            if ( hooks[i]->type() & event.hook_type )
             {
-                hooks[i]->do_hook(arg);
+                hooks[i]->do_hook(event, arg);
             }
         }
     };
@@ -174,6 +323,11 @@ private:
      *  Those that hooked in the object
      */
     vector<Hook *> hooks;
+
+    /**
+     *  Queue to evaluate the hooks out of the pool update path
+     */
+    HookQueue *    hook_queue;
 };
 
 #endif
@@ -21,22 +21,28 @@
 #include "ActionManager.h"
 #include "HookManagerDriver.h"
 #include "VirtualMachinePool.h"
+#include "Hook.h"
 
 using namespace std;
 
 extern "C" void * hm_action_loop(void *arg);
 
-class HookManager : public MadManager, public ActionListener
+class HookManager : public MadManager, public ActionListener, public HookQueue
 {
 public:
 
     HookManager(vector<const Attribute*>& _mads, VirtualMachinePool * _vmpool)
-        :MadManager(_mads),vmpool(_vmpool)
+        :MadManager(_mads),vmpool(_vmpool),dropped_events(0),finalized(false)
     {
+        pthread_mutex_init(&queue_mutex,0);
+
         am.addListener(this);
     };
 
-    ~HookManager(){};
+    ~HookManager()
+    {
+        pthread_mutex_destroy(&queue_mutex);
+    };
 
     /**
      *  This functions starts the associated listener thread, and creates a
@@ -68,6 +74,17 @@ public:
         am.trigger(ACTION_FINALIZE,0);
     };
 
+    /**
+     *  Queues a hook event, the hooks will be evaluated and executed by the
+     *  Hook Manager thread. Events are discarded if there are more than
+     *  MAX_HOOK_EVENTS waiting to be processed, or if the Hook Manager has
+     *  been finalized.
+     *    @param hookable that generated the event
+     *    @param event to be evaluated
+     *    @return 0 on success, -1 if the event has been discarded
+     */
+    int queue(Hookable * hookable, const HookEvent& event);
+
     /**
      *  Returns a pointer to a Information Manager MAD. The driver is
      *  searched by its name and owned by oneadmin with uid=0.
@@ -89,6 +106,11 @@ private:
      */
      static const char *  hook_driver_name;
 
+    /**
+     *  Max. number of hook events waiting to be processed
+     */
+     static const unsigned int MAX_HOOK_EVENTS;
+
     /**
      *  Pointer to the VirtualMachine Pool
      */
@@ -104,12 +126,51 @@ private:
      */
     ActionManager         am;
 
+    /**
+     *  A queued hook event and the object pool that generated it
+     */
+    struct HookAction
+    {
+        HookAction(Hookable * _hookable, const HookEvent& _event):
+            hookable(_hookable), event(_event){};
+
+        Hookable * hookable;
+        HookEvent  event;
+    };
+
+    /**
+     *  Mutex to control the hook event queue
+     */
+    pthread_mutex_t       queue_mutex;
+
+    /**
+     *  Hook events waiting to be processed, a HOOK_EVENT action is triggered
+     *  when the first one is queued
+     */
+    vector<HookAction>    pending_events;
+
+    /**
+     *  Number of hook events discarded since the queue was last full
+     */
+    unsigned int          dropped_events;
+
+    /**
+     *  True when the Hook Manager has been stopped, no more events are queued
+     */
+    bool                  finalized;
+
     /**
      *  Function to execute the Manager action loop method within a new pthread
      *  (requires C linkage)
      */
     friend void * hm_action_loop(void *arg);
 
+    /**
+     *  Evaluates the hooks for the pending events. The events of each object
+     *  are processed together, so the object is locked once.
+     */
+    void run_pending_events();
+
     /**
      *  The action function executed when an action is triggered.
      *    @param action the name of the action
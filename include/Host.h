@@ -20,6 +20,7 @@
 #include "PoolSQL.h"
 #include "HostTemplate.h"
 #include "HostShare.h"
+#include "HostImageCache.h"
 
 using namespace std;
 
@@ -86,6 +87,8 @@ public:
                 state = ERROR;
             }
         }
+
+        set_dirty();
     };
 
     /**
@@ -95,6 +98,8 @@ public:
     void disable()
     {
         state = DISABLED;
+
+        set_dirty();
     };
 
     /**
@@ -104,6 +109,8 @@ public:
     void enable()
     {
         state = INIT;
+
+        set_dirty();
     };
 
     /** Update host counters and update the whole host on the DB
@@ -121,6 +128,17 @@ public:
         return state;
     };
 
+    /**
+     *  Gets the host state for the pools change log
+     *    @param _state of the host
+     *    @param _sub_state not defined for hosts, -1
+     */
+    void get_states(int& _state, int& _sub_state) const
+    {
+        _state     = state;
+        _sub_state = -1;
+    };
+
     /**
      * Retrives VMM mad name
      *    @return string vmm mad name
@@ -155,6 +173,8 @@ public:
     void set_state(HostState state)
     {
         this->state = state;
+
+        set_dirty();
     };
 
     /**
@@ -277,6 +297,16 @@ public:
         return host_share.test(cpu,mem,disk);
     }
 
+    /**
+     *  Gets the image cache of the host, the host must be updated in the DB
+     *  after modifying the cache
+     *    @return a reference to the cache
+     */
+    HostImageCache& get_image_cache()
+    {
+        return image_cache;
+    };
+
     /**
      *  Factory method for host templates
      */
@@ -330,6 +360,11 @@ private:
      */
     HostShare       host_share;
 
+    /**
+     *  Images copied to the cache directory of the host
+     */
+    HostImageCache  image_cache;
+
     // *************************************************************************
     // Constructor
     // *************************************************************************
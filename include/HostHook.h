@@ -47,7 +47,7 @@ public:
     // Hook methods
     // -------------------------------------------------------------------------
 
-    void do_hook(void *arg);
+    void do_hook(const HookEvent& event, void *arg);
 };
 
 /**
@@ -58,7 +58,7 @@ public:
 class HostStateMapHook: public Hook
 {
 public:
-    virtual void do_hook(void *arg) = 0;
+    virtual void do_hook(const HookEvent& event, void *arg) = 0;
 
 protected:
     // -------------------------------------------------------------------------
@@ -135,7 +135,12 @@ public:
     // -------------------------------------------------------------------------
     // Hook methods
     // -------------------------------------------------------------------------
-    void do_hook(void *arg);
+    void do_hook(const HookEvent& event, void *arg);
+
+    /**
+     *  The object is only used when the state changes to the target one
+     */
+    bool needs_object(const HookEvent& event);
 
 private:
     /**
@@ -161,7 +166,15 @@ public:
     // -------------------------------------------------------------------------
     // Hook methods
     // -------------------------------------------------------------------------
-    void do_hook(void *arg);
+    void do_hook(const HookEvent& event, void *arg);
+
+    /**
+     *  The state map is updated with the states recorded in the event
+     */
+    bool needs_object(const HookEvent& event)
+    {
+        return false;
+    };
 };
 
 #endif
@@ -0,0 +1,158 @@
+/* ------------------------------------------------------------------------ */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)           */
+/*                                                                          */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may  */
+/* not use this file except in compliance with the License. You may obtain  */
+/* a copy of the License at                                                 */
+/*                                                                          */
+/* http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                          */
+/* Unless required by applicable law or agreed to in writing, software      */
+/* distributed under the License is distributed on an "AS IS" BASIS,        */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and      */
+/* limitations under the License.                                           */
+/* ------------------------------------------------------------------------ */
+
+#ifndef HOST_IMAGE_CACHE_H_
+#define HOST_IMAGE_CACHE_H_
+
+#include <map>
+#include <vector>
+#include <string>
+#include <time.h>
+
+#include <libxml/tree.h>
+
+#include "XMLWriter.h"
+
+using namespace std;
+
+/* ------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------ */
+
+/**
+ *  The HostImageCache class. It keeps track of the images copied to the
+ *  image cache directory of a host, so a non-persistent image is only
+ *  transferred from the repository the first time it is deployed in the
+ *  host. The cached copy is valid as long as the image SOURCE does not
+ *  change. Images are evicted in LRU order to keep the cache within its
+ *  size quota.
+ */
+class HostImageCache
+{
+public:
+
+    HostImageCache():cache_size(0){};
+
+    ~HostImageCache(){};
+
+    /**
+     *  State of an image in the cache
+     */
+    enum EntryState
+    {
+        MISS    = 0, /**< Not in the cache, or the cached copy is stale  */
+        FILLING = 1, /**< Being copied to the cache by other VM prolog    */
+        READY   = 2  /**< Available in the cache                          */
+    };
+
+    /**
+     *  Entries used in the last EVICT_GRACE seconds are never evicted, a
+     *  prolog could be still copying from them
+     */
+    static const int EVICT_GRACE = 600;
+
+    /**
+     *  Looks for an image in the cache. The last used time of READY images
+     *  is updated.
+     *    @param iid of the image
+     *    @param source of the image, a cached copy with a different source is
+     *    stale
+     *    @param now current time
+     *    @return the state of the image in the cache
+     */
+    EntryState lookup(int iid, const string& source, time_t now);
+
+    /**
+     *  Adds an image to the cache, the image will be copied to the host by
+     *  the VM prolog. Least recently used images are evicted if needed to
+     *  keep the cache size below the quota.
+     *    @param iid of the image
+     *    @param source of the image
+     *    @param size of the image in MB
+     *    @param vid of the VM copying the image to the cache
+     *    @param quota of the cache in MB
+     *    @param now current time
+     *    @param evicted ids of the images evicted, to be removed from the
+     *    host
+     *    @return 0 on success, -1 if the image does not fit in the cache
+     */
+    int add(int            iid,
+            const string&  source,
+            int            size,
+            int            vid,
+            int            quota,
+            time_t         now,
+            vector<int>&   evicted);
+
+    /**
+     *  Sets the images copied by a VM prolog as READY
+     *    @param vid of the VM
+     *    @return number of images updated
+     */
+    int ready(int vid);
+
+    /**
+     *  Removes the images copied by a VM prolog, used when the prolog fails
+     *    @param vid of the VM
+     *    @return number of images removed
+     */
+    int drop(int vid);
+
+    /**
+     *  Size of the images in the cache (in MB)
+     */
+    int get_size() const
+    {
+        return cache_size;
+    };
+
+    /**
+     * Function to print the HostImageCache object into an XML document
+     *  @param xml the writer holding the document
+     */
+    void to_xml(XMLWriter& xml) const;
+
+    /**
+     *  Rebuilds the cache from the IMAGE_CACHE element
+     *    @param node the IMAGE_CACHE element, if 0 the cache is emptied
+     *    @return 0 on success, -1 otherwise
+     */
+    int from_xml_node(const xmlNodePtr node);
+
+private:
+
+    /**
+     *  An image in the cache
+     */
+    struct Entry
+    {
+        string source;    /**< Source of the cached copy                */
+        int    size;      /**< Size of the image (in MB)                */
+        time_t last_used; /**< Last time the cached copy was used       */
+        int    vid;       /**< VM filling the cache, -1 once READY      */
+    };
+
+    /**
+     *  Cached images, by image id
+     */
+    map<int, Entry> images;
+
+    /**
+     *  Size of the cached images (in MB)
+     */
+    int cache_size;
+};
+
+#endif /*HOST_IMAGE_CACHE_H_*/
@@ -18,6 +18,8 @@
 #define HOST_SHARE_H_
 
 #include "ObjectXML.h"
+#include "XMLWriter.h"
+#include "XMLReader.h"
 #include <time.h>
 
 using namespace std;
@@ -98,6 +100,12 @@ public:
      */
     string& to_xml(string& xml) const;
 
+    /**
+     * Function to print the HostShare object into an XML document
+     *  @param xml the writer holding the document
+     */
+    void to_xml(XMLWriter& xml) const;
+
 private:
 
     int disk_usage; /**< Disk allocated to VMs (in Mb).        */
@@ -126,12 +134,13 @@ private:
     friend class HostPool;
 
     /**
-     *  Rebuilds the object from an xml node
-     *    @param node The xml node pointer
+     *  Rebuilds the object from a parsed xml document
+     *    @param reader holding the xml document
+     *    @param root path of the HOST_SHARE element in the document
      *
      *    @return 0 on success, -1 otherwise
      */
-    int from_xml_node(const xmlNodePtr node);
+    int from_xml(const XMLReader& reader, const string& root);
 };
 
 #endif /*HOST_SHARE_H_*/
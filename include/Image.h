@@ -149,6 +149,17 @@ public:
         return state;
     }
 
+    /**
+     *  Gets the image state for the pools change log
+     *    @param _state of the image
+     *    @param _sub_state not defined for images, -1
+     */
+    void get_states(int& _state, int& _sub_state) const
+    {
+        _state     = state;
+        _sub_state = -1;
+    }
+
     /**
      *  Sets the image state
      *     @param state of image
@@ -99,7 +99,7 @@ public:
      */
     int update(Image * image)
     {
-        return image->update(db);
+        return PoolSQL::update(image);
     };
 
     /**
@@ -0,0 +1,118 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef LEASE_BITMAP_H_
+#define LEASE_BITMAP_H_
+
+#include <vector>
+
+using namespace std;
+
+/**
+ *  The LeaseBitmap class keeps the used addresses of a range. The addresses
+ *  are stored in a bitmap, and each level above it has a bit for every word
+ *  of the previous one, set when the word is full. Looking for a free
+ *  address skips 32 used addresses per bit of the first summary level, so
+ *  it takes a few word operations even in a nearly full /16 network.
+ */
+class LeaseBitmap
+{
+public:
+
+    LeaseBitmap():num_bits(0){};
+
+    ~LeaseBitmap(){};
+
+    /**
+     *  Sets the size of the range, all the addresses are marked as free
+     *    @param size number of addresses in the range
+     */
+    void init(unsigned int size);
+
+    /**
+     *  Marks an address as used or free
+     *    @param index of the address in the range
+     *    @param used true if the address is in use
+     */
+    void set(unsigned int index, bool used);
+
+    /**
+     *  Checks if an address is used
+     *    @param index of the address in the range
+     *    @return true if the address is used or out of the range
+     */
+    bool test(unsigned int index) const
+    {
+        if ( index >= num_bits )
+        {
+            return true;
+        }
+
+        return (levels[0][index / WORD_BITS] & (1U << (index % WORD_BITS)))
+                != 0;
+    };
+
+    /**
+     *  Looks for a free address, starting from a given one and wrapping
+     *  around at the end of the range
+     *    @param start index of the first address to check
+     *    @return the index of the free address, -1 if the range is full
+     */
+    long next_free(unsigned int start) const;
+
+private:
+
+    static const unsigned int WORD_BITS = 32;
+
+    static const unsigned int FULL = 0xFFFFFFFF;
+
+    /**
+     *  Number of addresses in the range
+     */
+    unsigned int num_bits;
+
+    /**
+     *  The bitmap (level 0) and the summary levels, the bits past the end of
+     *  each level are set so incomplete words can be full
+     */
+    vector< vector<unsigned int> > levels;
+
+    /**
+     *  Looks for a zero bit in a level from a given position
+     *    @param level to look in
+     *    @param pos of the first bit to check
+     *    @return the position of the bit, -1 if all the bits are set
+     */
+    long next_zero(unsigned int level, unsigned int pos) const;
+
+    /**
+     *  Index of the lowest zero bit of a word that is not full
+     */
+    static unsigned int first_zero(unsigned int word)
+    {
+        unsigned int bit = 0;
+
+        while ( word & 1 )
+        {
+            word >>= 1;
+            bit++;
+        }
+
+        return bit;
+    };
+};
+
+#endif /*LEASE_BITMAP_H_*/
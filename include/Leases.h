@@ -18,7 +18,7 @@
 #define LEASES_H_
 
 #include "ObjectSQL.h"
-#include "ObjectXML.h"
+#include "XMLWriter.h"
 #include "Attribute.h"
 
 #include <map>
@@ -44,15 +44,7 @@ public:
         ObjectSQL(),
         oid(_oid), size(_size), n_used(0), db(_db){};
 
-    virtual ~Leases()
-    {
-        map<unsigned int, Lease *>::iterator  it;
-
-        for(it=leases.begin();it!=leases.end();it++)
-        {
-            delete it->second;
-        }
-    };
+    virtual ~Leases(){};
 
     friend ostream& operator<<(ostream& os, Leases& _leases);
 
@@ -65,14 +57,30 @@ public:
      */
      virtual int get(int vid, string& ip,string& mac) = 0;
 
+    /**
+     * Returns unused leases, which become used. The leases are taken in a
+     * single operation, if there are not enough free leases none is taken.
+     *  @param vids identifiers of the VMs getting the leases, one lease is
+     *  returned for each of them. A -1 holds the lease until it is set for
+     *  a VM or released
+     *  @param ips of the returned leases
+     *  @param macs of the returned leases
+     *  @return 0 if success
+     */
+     virtual int get(const vector<int>& vids,
+                     vector<string>&    ips,
+                     vector<string>&    macs) = 0;
+
      /**
       * Ask for a specific lease in the network
       *  @param vid identifier of the VM getting this lease
       *  @param ip ip of lease requested
       *  @param mac mac of the lease
+      *  @param use_held if a held lease can be set, only for those
+      *  authorized to manage the network
       *  @return 0 if success
       */
-     virtual int set(int vid, const string&  ip, string&  mac) = 0;
+     virtual int set(int vid, const string& ip, string& mac, bool use_held)=0;
 
      /**
       * Release an used lease, which becomes unused
@@ -80,6 +88,32 @@ public:
       */
      virtual void release(const string& ip) = 0;
 
+     /**
+      * Releases a held lease, i.e. a lease got for VM -1 and not set for
+      * any VM since then
+      *   @param ip of the held lease
+      *   @return 0 on success, -1 if the lease is not held
+      */
+     int release_held(const string& ip);
+
+     /**
+      * Checks if a lease is held, i.e. got for VM -1 and not set for any VM
+      *   @param ip of the lease
+      *   @return true if the lease is held
+      */
+     bool is_held(const string& ip);
+
+     /**
+      * Sets held leases for a set of VMs. They are written to the DB with
+      * one statement per BATCH_SIZE leases, if a statement fails the leases
+      * set by the previous ones are kept and the rest are still held.
+      * Leases no longer held are skipped
+      *   @param ips of the held leases
+      *   @param vids of the VMs, one for each lease
+      *   @return 0 on success
+      */
+     int bind_held(const vector<string>& ips, const vector<int>& vids);
+
     /**
      * Adds New leases. (Only implemented for FIXED networks)
      *  @param vector_leases vector of VectorAttribute objects. For the
@@ -108,9 +142,10 @@ public:
 protected:
     /**
      *  The Lease class, it represents a pair of IP and MAC assigned to
-     *  a Virtual Machine
+     *  a Virtual Machine. Leases are stored as plain columns, the XML
+     *  representation is only generated for the network info
      */
-    class Lease : public ObjectXML
+    class Lease
     {
     public:
         /**
@@ -131,7 +166,7 @@ protected:
         * @param _used, the lease is in use
         */
         Lease(unsigned int _ip, unsigned int _mac[], int _vid, bool _used=true)
-            :ObjectXML(),ip(_ip), vid(_vid), used(_used)
+            :ip(_ip), vid(_vid), used(_used)
         {
                 // TODO check size
                 mac[PREFIX]=_mac[PREFIX];
@@ -139,10 +174,13 @@ protected:
         };
 
         /**
-         *  Creates a new empty lease. Method from_xml should be called right
-         *  after this constructor.
+         *  Creates a new empty lease
          */
-        Lease():ObjectXML(){};
+        Lease():ip(0), vid(-1), used(false)
+        {
+            mac[PREFIX] = 0;
+            mac[SUFFIX] = 0;
+        };
 
         ~Lease(){};
 
@@ -189,21 +227,10 @@ protected:
         string& to_xml(string& xml) const;
 
         /**
-         * Function to print the Lease object into a string in
-         * XML format. The output contains all the internal attributes,
-         * to be saved in the DB as a blob
-         *  @param xml the resulting XML string
-         *  @return a reference to the generated string
-         */
-        string& to_xml_db(string& xml) const;
-
-        /**
-         *  Rebuilds the object from an xml formatted string
-         *    @param xml_str The xml-formatted string
-         *
-         *    @return 0 on success, -1 otherwise
+         * Function to print the Lease object into an XML document
+         *  @param xml the writer holding the document
          */
-        int from_xml(const string &xml_str);
+        void to_xml(XMLWriter& xml) const;
 
         /**
          * Constants to access the array storing the MAC address
@@ -242,7 +269,7 @@ protected:
     /**
      * Hash of leases, indexed by lease.ip
      */
-    map<unsigned int, Lease *> leases;
+    map<unsigned int, Lease> leases;
 
     /**
      * Number of used leases
@@ -263,6 +290,11 @@ protected:
 
     static const char * db_bootstrap;
 
+    /**
+     *  Max number of leases written by a single statement
+     */
+    static const unsigned int BATCH_SIZE;
+
     // -------------------------------------------------------------------------
     // Leases methods
     // -------------------------------------------------------------------------
@@ -283,6 +315,44 @@ protected:
      */
     virtual int select(SqlDB * db);
 
+    /**
+     *  Writes a new lease in the DB
+     *    @param lease to be written
+     *    @return 0 on success
+     */
+    int insert_lease(const Lease& lease);
+
+    /**
+     *  Updates the VM and use of a lease in the DB
+     *    @param lease to be updated
+     *    @return 0 on success
+     */
+    int update_lease(const Lease& lease);
+
+    /**
+     *  Deletes a lease from the DB
+     *    @param ip of the lease
+     *    @return 0 on success
+     */
+    int delete_lease(unsigned int ip);
+
+    /**
+     *  Writes new leases in the DB with multi-row statements, each one
+     *  with BATCH_SIZE leases at most. If a statement fails the leases
+     *  already written are deleted.
+     *    @param new_leases to be written
+     *    @return 0 on success
+     */
+    int insert_leases(const vector<Lease>& new_leases);
+
+    /**
+     *  Updates the VM and use of a set of leases in the DB, with
+     *  BATCH_SIZE leases per statement at most
+     *    @param new_leases to be updated
+     *    @return 0 on success
+     */
+    int update_leases(const vector<Lease>& new_leases);
+
     friend ostream& operator<<(ostream& os, Lease& _lease);
 
     /**
@@ -293,9 +363,15 @@ protected:
     */
     string& to_xml(string& xml) const;
 
+    /**
+     * Function to print the Leases object into an XML document
+     *  @param xml the writer holding the document
+     */
+    void to_xml(XMLWriter& xml) const;
+
 private:
     /**
-     *  Callback function to unmarshall a Lease object (Lease::select)
+     *  Callback function to read a Lease from its columns (Lease::select)
      *    @param num the number of columns read from the DB
      *    @para names the column names
      *    @para vaues the column values
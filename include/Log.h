@@ -53,6 +53,14 @@ public:
         const MessageType       type,
         const char *            message) = 0;
 
+    /**
+     *  Minimum log level for the messages
+     */
+    MessageType get_log_level() const
+    {
+        return log_level;
+    };
+
 protected:
     /**
      *  Minimum log level for the messages
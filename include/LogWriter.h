@@ -0,0 +1,281 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef LOG_WRITER_H_
+#define LOG_WRITER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <pthread.h>
+
+#include "Log.h"
+
+using namespace std;
+
+/**
+ *  Background writer for the asynchronous logs. Each thread queues its
+ *  messages in its own buffer (a single producer, single consumer ring, so no
+ *  locks are taken when logging). A writer thread drains the buffers
+ *  periodically, keeping the log files open and writing the messages in
+ *  batches. When the buffer of a thread is full the messages are dropped and
+ *  counted, logging never blocks the caller.
+ */
+class LogWriter
+{
+public:
+
+    /**
+     *  Starts the writer thread
+     *    @param main_file log file to report the dropped messages
+     *    @param buffer_size number of messages of each thread buffer
+     *    @return 0 on success
+     */
+    static int start(const string& main_file, unsigned int buffer_size);
+
+    /**
+     *  Stops the writer thread, once every message queued before the call is
+     *  written. Messages logged after this call are written synchronously.
+     *  The thread buffers are kept, so it is safe to log while stopping.
+     */
+    static void stop();
+
+    /**
+     *  Closes the open log files, so they are opened again with the next
+     *  message. Used to rotate the log files (SIGHUP).
+     */
+    static void reopen();
+
+    /**
+     *  Queues a message to be written by the writer thread
+     *    @param file the log file
+     *    @param module that generated the message
+     *    @param type of the message
+     *    @param message to be logged
+     *    @return false if the writer is not running, the message is not
+     *    queued. Messages dropped because the buffer is full return true.
+     */
+    static bool write(const string&          file,
+                      const char *           module,
+                      const Log::MessageType type,
+                      const char *           message);
+
+    /**
+     *  Total number of messages dropped because the buffers were full
+     */
+    static unsigned long get_dropped()
+    {
+        return dropped;
+    };
+
+    /**
+     *  Default number of messages of each thread buffer
+     */
+    static const unsigned int DEFAULT_BUFFER_SIZE;
+
+private:
+
+    LogWriter(){};
+
+    ~LogWriter(){};
+
+    /**
+     *  A message queued by a thread
+     */
+    struct Record
+    {
+        string              file;
+        time_t              time;
+        Log::MessageType    type;
+        char                module[16];
+        string              message;
+    };
+
+    /**
+     *  Ring of messages of a thread. head is only updated by the logging
+     *  thread and tail by the writer thread.
+     */
+    struct Buffer
+    {
+        Buffer(unsigned int _size):size(_size), head(0), tail(0),
+            dropped(0), reported(0), orphan(false)
+        {
+            records = new Record[size];
+        };
+
+        ~Buffer()
+        {
+            delete [] records;
+        };
+
+        Record *                records;
+        unsigned int            size;
+
+        volatile unsigned int   head;
+        volatile unsigned int   tail;
+
+        volatile unsigned long  dropped;
+        unsigned long           reported;
+
+        /**
+         *  The thread has exited, the writer frees the buffer once empty
+         */
+        volatile bool           orphan;
+    };
+
+    /**
+     *  An open log file
+     */
+    struct File
+    {
+        FILE *  fd;
+        time_t  last_write;
+    };
+
+    /**
+     *  Seconds an unused file is kept open
+     */
+    static const time_t IDLE_TIME;
+
+    /**
+     *  Interval to drain the buffers (ms)
+     */
+    static const long   DRAIN_INTERVAL;
+
+    static volatile bool running;
+
+    /**
+     *  Number of threads queueing a message
+     */
+    static volatile int  writers;
+
+    static volatile bool stopping;
+
+    static volatile bool reopen_files;
+
+    static unsigned int  buffer_size;
+
+    static string        main_file;
+
+    static unsigned long dropped;
+
+    static pthread_t     writer_thread;
+
+    static pthread_key_t buffer_key;
+
+    static pthread_once_t buffer_key_once;
+
+    /**
+     *  Wakes up the writer thread
+     */
+    static pthread_mutex_t writer_mutex;
+
+    static pthread_cond_t  writer_cond;
+
+    /**
+     *  Protects the list of buffers, the writer thread only holds it to copy
+     *  the list and to remove the orphan buffers
+     */
+    static pthread_mutex_t buffers_mutex;
+
+    static vector<Buffer *> buffers;
+
+    /**
+     *  Open files, only used by the writer thread
+     */
+    static map<string, File> files;
+
+    /**
+     *  Creates the key of the thread buffers
+     */
+    static void create_buffer_key();
+
+    /**
+     *  Gets the buffer of the calling thread, creating it if needed
+     */
+    static Buffer * get_buffer();
+
+    /**
+     *  Marks the buffer of an exiting thread to be freed
+     */
+    static void orphan_buffer(void * buffer);
+
+    /**
+     *  Writer thread loop
+     */
+    static void * writer_loop(void * arg);
+
+    /**
+     *  Writes the messages queued in the buffers, frees orphan buffers
+     *    @param now current time
+     */
+    static void drain(time_t now);
+
+    /**
+     *  Writes a message to a file, opening it if needed
+     */
+    static void write_line(const string& file,
+                           time_t        the_time,
+                           const char *  module,
+                           char          type,
+                           const string& message,
+                           time_t        now);
+
+    /**
+     *  Closes the files, all of them or just the idle ones
+     */
+    static void close_files(bool all, time_t now);
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Log messages to a log file through the LogWriter. If the writer is not
+ *  running messages are written synchronously.
+ */
+class AsyncFileLog : public FileLogTS
+{
+public:
+    AsyncFileLog(const string&       file_name,
+                 const MessageType   level    = WARNING,
+                 ios_base::openmode  mode     = ios_base::app)
+                    :FileLogTS(file_name,level,mode), file(file_name){};
+
+    ~AsyncFileLog(){};
+
+    void log(
+        const char *            module,
+        const MessageType       type,
+        const char *            message)
+    {
+        if ( type > log_level )
+        {
+            return;
+        }
+
+        if ( LogWriter::write(file, module, type, message) == false )
+        {
+            FileLogTS::log(module,type,message);
+        }
+    };
+
+private:
+    string file;
+};
+
+#endif /*LOG_WRITER_H_*/
@@ -0,0 +1,435 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef MONITOR_STORE_H_
+#define MONITOR_STORE_H_
+
+#include <deque>
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <pthread.h>
+#include <time.h>
+
+#include "SqlDB.h"
+#include "ActionManager.h"
+
+using namespace std;
+
+extern "C" void * ms_action_loop(void *arg);
+
+/**
+ *  The MonitorStore keeps the monitoring time-series of the VMs and Hosts.
+ *  Each object has a fixed number of raw samples in memory, stored as deltas
+ *  of the previous one. Samples evicted from the raw ring are averaged over
+ *  a period and kept in a second ring, so older data is kept at a lower
+ *  resolution. Every sample is also written to the monitoring table, where
+ *  it is kept until it expires. The pending samples are written in batches
+ *  by the MonitorStore thread, so the drivers adding them never wait for
+ *  the DB.
+ */
+class MonitorStore : public Callbackable, public ActionListener
+{
+public:
+    /**
+     *  Type of the monitored object
+     */
+    enum ObjectType
+    {
+        VM   = 0,
+        HOST = 1
+    };
+
+    /**
+     *  Number of values of each sample:
+     *    VM:   USEDMEMORY, USEDCPU, NETTX, NETRX
+     *    HOST: USEDMEMORY, USEDCPU, FREEMEMORY, FREECPU
+     */
+    static const int NUM_VALUES = 4;
+
+    /**
+     *  @param _db pointer to the DataBase, 0 to keep the samples only in
+     *  memory
+     *  @param _max_samples number of raw samples, and averages, kept in
+     *  memory for each object
+     *  @param _period in seconds of the averages, 0 to keep only raw samples
+     *  @param _expiration in seconds of the samples stored in the DB, 0 to
+     *  keep them forever
+     */
+    MonitorStore(SqlDB *      _db,
+                 unsigned int _max_samples,
+                 time_t       _period,
+                 time_t       _expiration);
+
+    /**
+     *  Writes the pending samples to the DB
+     */
+    ~MonitorStore();
+
+    /**
+     *  Creates the thread that writes the pending samples to the DB every
+     *  FLUSH_INTERVAL seconds. It runs till it receives ACTION_FINALIZE.
+     *    @return 0 on success.
+     */
+    int start();
+
+    /**
+     *  Gets the thread identification.
+     *    @return pthread_t for the store thread (that in the action loop).
+     */
+    pthread_t get_thread_id() const
+    {
+        return ms_thread;
+    };
+
+    /**
+     *  Stops the store thread, the pending samples are written to the DB
+     */
+    void finalize()
+    {
+        am.trigger(ACTION_FINALIZE,0);
+    };
+
+    /**
+     *  Adds a new sample for an object. Negative values are not known and
+     *  take the value of the previous sample
+     *    @param type of the object
+     *    @param oid of the object
+     *    @param timestamp of the sample
+     *    @param values of the sample, NUM_VALUES of them
+     */
+    void add(ObjectType type, int oid, time_t timestamp, const int values[]);
+
+    /**
+     *  Removes from memory the samples of an object, when it is deleted. The
+     *  samples in the DB are kept until they expire.
+     *    @param type of the object
+     *    @param oid of the object
+     */
+    void remove(ObjectType type, int oid);
+
+    /**
+     *  Prints the samples of an object taken in a time range in XML format.
+     *  Samples older than those kept in memory are read from the DB.
+     *    @param type of the object
+     *    @param oid of the object
+     *    @param start of the range
+     *    @param end of the range, -1 for no end
+     *    @param xml the resulting XML string
+     *    @return a reference to the generated string
+     */
+    string& to_xml(ObjectType   type,
+                   int          oid,
+                   time_t       start,
+                   time_t       end,
+                   string&      xml);
+
+    /**
+     *  Writes the pending samples to the DB, and removes the expired ones.
+     *    @return 0 on success
+     */
+    int flush();
+
+    /**
+     *  Bootstraps the database table for the samples
+     *    @return 0 on success
+     */
+    static int bootstrap(SqlDB * db)
+    {
+        ostringstream oss(MonitorStore::db_bootstrap);
+
+        return db->exec(oss);
+    };
+
+    /**
+     *  Gets a string representation of the object type
+     */
+    static const char * type_to_str(ObjectType type)
+    {
+        switch (type)
+        {
+            case VM:   return "VM";
+            case HOST: return "HOST";
+            default:   return "-";
+        }
+    };
+
+    /**
+     *  Gets the name of the i-th value of a sample
+     */
+    static const char * value_name(ObjectType type, int i);
+
+private:
+
+    friend void * ms_action_loop(void *arg);
+
+    /**
+     *  A sample with absolute values
+     */
+    struct Sample
+    {
+        time_t time;
+        int    values[NUM_VALUES];
+    };
+
+    /**
+     *  A sample of an object waiting to be written to the DB
+     */
+    struct Row
+    {
+        ObjectType type;
+        int        oid;
+        Sample     sample;
+    };
+
+    /**
+     *  Fixed size ring of samples. Only the oldest and newest samples are
+     *  stored with absolute values, the rest as the difference with the
+     *  previous one. Differences are small for consecutive samples, so they
+     *  are stored as variable length integers, most of them in one byte.
+     */
+    class SampleRing
+    {
+    public:
+        SampleRing():first_time(0),last_time(0),size(0){};
+
+        /**
+         *  Adds a sample, the oldest one is evicted if the ring is full
+         *    @param sample to add, must be newer than the last one
+         *    @param max_size of the ring
+         *    @param evicted the oldest sample if it was removed
+         *    @return true if a sample was evicted
+         */
+        bool push(const Sample& sample, unsigned int max_size,Sample& evicted);
+
+        /**
+         *  Gets the samples in a time range, oldest first
+         */
+        void get(time_t start, time_t end, vector<Sample>& samples) const;
+
+        /**
+         *  Gets the newest sample, the ring must not be empty
+         */
+        void last(Sample& sample) const
+        {
+            sample.time = last_time;
+
+            for (int i = 0; i < NUM_VALUES; i++)
+            {
+                sample.values[i] = last_values[i];
+            }
+        };
+
+        bool empty() const
+        {
+            return size == 0;
+        };
+
+        time_t get_first_time() const
+        {
+            return first_time;
+        };
+
+        time_t get_last_time() const
+        {
+            return last_time;
+        };
+
+    private:
+        time_t first_time;
+        int    first_values[NUM_VALUES];
+
+        time_t last_time;
+        int    last_values[NUM_VALUES];
+
+        /**
+         *  Differences of the time and values of each sample, but the oldest
+         *  one, with the previous sample. Each one is zigzag encoded (so
+         *  small negative values are also small) in 7 bit groups, the high
+         *  bit of a byte is set if more bytes follow.
+         */
+        deque<unsigned char> deltas;
+
+        /**
+         *  Number of samples in the ring
+         */
+        unsigned int size;
+
+        /**
+         *  Appends a difference to the deltas
+         */
+        void encode(long long value);
+
+        /**
+         *  Reads a difference from the deltas
+         *    @param pos of its first byte, set to the next one
+         *    @return the difference
+         */
+        long long decode(unsigned int& pos) const;
+    };
+
+    /**
+     *  The samples of an object
+     */
+    struct Series
+    {
+        /**
+         *  Last samples as received
+         */
+        SampleRing raw;
+
+        /**
+         *  Averages of the samples evicted from the raw ring
+         */
+        SampleRing averages;
+
+        /**
+         *  Start time, and accumulated values, of the average being computed
+         */
+        time_t     period_start;
+        long long  period_sum[NUM_VALUES];
+        int        period_samples;
+    };
+
+    /**
+     *  Max. number of samples written to the DB in a single statement
+     */
+    static const unsigned int BATCH_SIZE;
+
+    /**
+     *  Max. seconds a sample waits to be written to the DB
+     */
+    static const time_t FLUSH_INTERVAL;
+
+    /**
+     *  Seconds between two purges of the expired samples
+     */
+    static const time_t PURGE_INTERVAL;
+
+    // -------------------------------------------------------------------------
+    // Configuration
+    // -------------------------------------------------------------------------
+
+    SqlDB *      db;
+
+    unsigned int max_samples;
+
+    time_t       period;
+
+    time_t       expiration;
+
+    // -------------------------------------------------------------------------
+    // In memory samples
+    // -------------------------------------------------------------------------
+
+    /**
+     *  Series of the objects, indexed by (type, oid)
+     */
+    map<pair<int,int>, Series *> series;
+
+    /**
+     *  Samples not yet written to the DB
+     */
+    vector<Row> pending;
+
+    /**
+     *  Time of the last purge of expired samples
+     */
+    time_t last_purge;
+
+    /**
+     *  Mutex to access the series and the pending samples
+     */
+    pthread_mutex_t mutex;
+
+    /**
+     *  Serializes the flushes, so after a flush the DB holds every sample
+     *  added before it
+     */
+    pthread_mutex_t flush_mutex;
+
+    /**
+     *  Thread id of the MonitorStore
+     */
+    pthread_t       ms_thread;
+
+    /**
+     *  Action engine for the store, its timer flushes the pending samples
+     */
+    ActionManager   am;
+
+    /**
+     *  The action function executed when an action is triggered.
+     *    @param action the name of the action
+     *    @param arg arguments for the action function
+     */
+    void do_action(const string& action, void * arg);
+
+    /**
+     *  Adds an evicted raw sample to the average of its period
+     */
+    void add_to_average(Series * s, const Sample& sample);
+
+    /**
+     *  Writes a set of samples to the DB in a single statement
+     *    @param rows the samples
+     *    @param first index of the first sample to write
+     *    @param last index after the last sample to write
+     *    @return 0 on success
+     */
+    int insert(const vector<Row>& rows, unsigned int first, unsigned int last);
+
+    /**
+     *  Removes from memory the series not updated for a long time, the
+     *  mutex must be locked
+     */
+    void purge_series(time_t now);
+
+    // -------------------------------------------------------------------------
+    // DataBase implementation
+    // -------------------------------------------------------------------------
+
+    static const char * db_names;
+
+    static const char * db_bootstrap;
+
+    static const char * table;
+
+    /**
+     *  Callback function to read samples from the DB (MonitorStore::select)
+     */
+    int select_cb(void * _samples, int num, char **values, char **names);
+
+    /**
+     *  Reads the samples of an object in a time range from the DB
+     */
+    int select(ObjectType       type,
+               int              oid,
+               time_t           start,
+               time_t           end,
+               vector<Sample>&  samples);
+
+    /**
+     *  Prints a set of samples in XML format
+     */
+    static void samples_to_xml(ObjectType               type,
+                               time_t                   sample_period,
+                               const vector<Sample>&    samples,
+                               ostringstream&           oss);
+};
+
+#endif /*MONITOR_STORE_H_*/
@@ -38,6 +38,7 @@
 #include "AuthManager.h"
 #include "AclManager.h"
 #include "ImageManager.h"
+#include "MonitorStore.h"
 
 #include "Callbackable.h"
 
@@ -140,6 +141,16 @@ public:
         return aclm;
     };
 
+    ChangeLog * get_change_log()
+    {
+        return change_log;
+    };
+
+    MonitorStore * get_monitor_store()
+    {
+        return monitor_store;
+    };
+
     // --------------------------------------------------------------
     // Environment & Configuration
     // --------------------------------------------------------------
@@ -233,7 +244,7 @@ public:
 
     static string db_version()
     {
-        return "3.1.0";
+        return "3.1.80";
     }
 
     void start();
@@ -255,7 +266,8 @@ private:
 
     Nebula():nebula_configuration(0),db(0),vmpool(0),hpool(0),vnpool(0),
         upool(0),ipool(0),gpool(0),tpool(0),lcm(0),vmm(0),im(0),tm(0),
-        dm(0),rm(0),hm(0),authm(0),aclm(0),imagem(0)
+        dm(0),rm(0),hm(0),authm(0),aclm(0),imagem(0),change_log(0),
+        monitor_store(0)
     {
         const char * nl = getenv("ONE_LOCATION");
 
@@ -373,6 +385,18 @@ private:
             delete imagem;
         }
 
+        if ( change_log != 0)
+        {
+            PoolSQL::set_change_log(0);
+
+            delete change_log;
+        }
+
+        if ( monitor_store != 0)
+        {
+            delete monitor_store;
+        }
+
         if ( nebula_configuration != 0)
         {
             delete nebula_configuration;
@@ -437,6 +461,18 @@ private:
     AclManager *            aclm;
     ImageManager *          imagem;
 
+    // ---------------------------------------------------------------
+    // Change log of the pool objects
+    // ---------------------------------------------------------------
+
+    ChangeLog *             change_log;
+
+    // ---------------------------------------------------------------
+    // Monitoring samples of the VMs and hosts
+    // ---------------------------------------------------------------
+
+    MonitorStore *          monitor_store;
+
     // ---------------------------------------------------------------
     // Implementation functions
     // ---------------------------------------------------------------
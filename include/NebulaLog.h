@@ -18,6 +18,7 @@
 #define _NEBULA_LOG_H_
 
 #include "Log.h"
+#include "LogWriter.h"
 #include <sstream>
 
 using namespace std;
@@ -31,7 +32,8 @@ public:
     enum LogType {
         FILE       = 0,
         FILE_TS    = 1,
-        CERR       = 2
+        CERR       = 2,
+        FILE_ASYNC = 3
     };
 
     // ---------------------------------------------------------------
@@ -42,8 +44,11 @@ public:
         LogType             ltype,
         Log::MessageType    clevel,
         const char *        filename = 0,
-        ios_base::openmode  mode     = ios_base::trunc)
+        ios_base::openmode  mode     = ios_base::trunc,
+        unsigned int        buffer_size = LogWriter::DEFAULT_BUFFER_SIZE)
     {
+        log_type = ltype;
+
         switch(ltype)
         {
             case FILE:
@@ -52,6 +57,14 @@ public:
             case FILE_TS:
               NebulaLog::logger = new FileLogTS(filename,clevel,mode);
               break;
+            case FILE_ASYNC:
+              NebulaLog::logger = new AsyncFileLog(filename,clevel,mode);
+
+              if ( LogWriter::start(filename, buffer_size) != 0 )
+              {
+                  log_type = FILE_TS;
+              }
+              break;
             default:
               NebulaLog::logger = new CerrLog(clevel);
               break;
@@ -60,9 +73,28 @@ public:
 
     static void finalize_log_system()
     {
+        LogWriter::stop();
+
         delete logger;
     }
 
+    /**
+     *  Creates a log for a file (e.g. the log of a VM) using the same
+     *  backend as the log system.
+     *    @param filename of the log
+     *    @param level of the log
+     *    @return the new log, it MUST be freed by the caller
+     */
+    static Log * new_file_log(const string& filename, Log::MessageType level)
+    {
+        if ( log_type == FILE_ASYNC )
+        {
+            return new AsyncFileLog(filename, level);
+        }
+
+        return new FileLog(filename, level);
+    };
+
     static void log(
         const char *           module,
         const Log::MessageType type,
@@ -87,14 +119,58 @@ public:
         logger->log(module,type,message.c_str());
     };
 
+    /**
+     *  Minimum log level of the messages written by the log system
+     */
+    static Log::MessageType log_level()
+    {
+        return logger->get_log_level();
+    };
+
+    /**
+     *  Checks if messages of a given type are written by the log system. Use
+     *  it to skip building messages that will be discarded.
+     *    @param type of the message
+     *    @return true if the message would be logged
+     */
+    static bool enabled(const Log::MessageType type)
+    {
+        return type <= logger->get_log_level();
+    };
+
 private:
     NebulaLog(){};
     ~NebulaLog(){};
 
     static Log * logger;
+
+    static LogType log_type;
 };
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+/**
+ *  Logs a message built with the << operator. The message is only built if
+ *  its type is enabled in the log system, e.g:
+ *
+ *    NEBULA_LOG("ReM", Log::DEBUG, "Host " << hid << " filtered out.");
+ */
+#define NEBULA_LOG(module, type, message)                                     \
+    do                                                                        \
+    {                                                                         \
+        if ( NebulaLog::enabled(type) )                                       \
+        {                                                                     \
+            ostringstream _nebula_log_oss;                                    \
+                                                                              \
+            _nebula_log_oss << message;                                       \
+                                                                              \
+            NebulaLog::log(module, type, _nebula_log_oss);                    \
+        }                                                                     \
+    }                                                                         \
+    while (0)
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 #endif /* _NEBULA_LOG_H_ */
@@ -19,6 +19,7 @@
 
 #include "ObjectSQL.h"
 #include "ObjectXML.h"
+#include "XMLReader.h"
 #include "Template.h"
 #include <pthread.h>
 #include <string.h>
@@ -54,6 +55,7 @@ public:
              valid(true),
              public_obj(0),
              obj_template(0),
+             xml_dirty(true),
              table(_table)
     {
         pthread_mutex_init(&mutex,0);
@@ -106,6 +108,8 @@ public:
     {
         uid   = _uid;
         uname = _uname;
+
+        set_dirty();
     }
 
     /**
@@ -117,6 +121,8 @@ public:
     {
         gid   = _gid;
         gname = _gname;
+
+        set_dirty();
     };
 
     /* --------------------------------------------------------------------- */
@@ -163,6 +169,34 @@ public:
      */
     virtual string& to_xml64(string &xml64);
 
+    /**
+     *  Gets the XML representation of the object returned by the info calls.
+     *  The string is cached, and only rebuilt after the object is modified
+     *  or locked with PoolSQL::get(). The object SHOULD be locked.
+     *    @return a reference to the cached XML string
+     */
+    const string& info_xml()
+    {
+        if ( xml_dirty )
+        {
+            to_info_xml(xml_cache);
+
+            xml_dirty = false;
+        }
+
+        return xml_cache;
+    };
+
+    /**
+     *  Marks the cached XML of the object as outdated. PoolSQL::get() calls
+     *  it for every locked object; setters call it too, in case the object
+     *  is modified after info_xml() under the same lock.
+     */
+    void set_dirty()
+    {
+        xml_dirty = true;
+    };
+
     /**
      * Function to print the object into a string in XML format
      *  @param xml the resulting XML string
@@ -252,6 +286,8 @@ public:
 
         obj_template->set(sattr);
 
+        set_dirty();
+
         return 0;
     }
 
@@ -270,6 +306,8 @@ public:
      */
     int remove_template_attribute(const string& name)
     {
+        set_dirty();
+
         return obj_template->erase(name);
     }
 
@@ -290,6 +328,18 @@ public:
         return 0;
     }
 
+    /**
+     *  Gets the state of the object, as reported in the pools change log.
+     *  Objects with a state should implement this function.
+     *    @param state of the object, -1 if not defined
+     *    @param sub_state of the object, -1 if not defined
+     */
+    virtual void get_states(int& state, int& sub_state) const
+    {
+        state     = -1;
+        sub_state = -1;
+    };
+
     /**
      *  Replace template for this object. Object should be updated
      *  after calling this method
@@ -401,6 +451,36 @@ protected:
      */
     Template * obj_template;
 
+    /**
+     *  Prints the object as returned by the info calls. By default it is
+     *  the same representation stored in the DB.
+     *    @param xml the resulting XML string
+     *    @return a reference to the generated string
+     */
+    virtual string& to_info_xml(string& xml) const
+    {
+        return to_xml(xml);
+    };
+
+    /**
+     *  Updates the cached XML after writing the object to the DB. Objects
+     *  that store the info representation should pass it here, others just
+     *  invalidate the cache.
+     *    @param xml stored in the DB, 0 if it is not the info representation
+     */
+    void update_xml_cache(const string * xml)
+    {
+        if ( xml != 0 )
+        {
+            xml_cache = *xml;
+            xml_dirty = false;
+        }
+        else
+        {
+            xml_dirty = true;
+        }
+    };
+
 private:
 
     /**
@@ -414,6 +494,16 @@ private:
      */
     pthread_mutex_t mutex;
 
+    /**
+     *  Cached XML representation of the object (info_xml)
+     */
+    string xml_cache;
+
+    /**
+     *  True if xml_cache is outdated
+     */
+    bool xml_dirty;
+
     /**
      *  Pointer to the SQL table for the PoolObjectSQL
      */
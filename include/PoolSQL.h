@@ -25,6 +25,7 @@
 #include "PoolObjectSQL.h"
 #include "Log.h"
 #include "Hook.h"
+#include "ChangeLog.h"
 
 using namespace std;
 
@@ -63,7 +64,8 @@ public:
 
     /**
      *  Gets an object from the pool (if needed the object is loaded from the
-     *  database).
+     *  database). A locked object may be modified by the caller, so its
+     *  cached info XML is invalidated.
      *   @param oid the object unique identifier
      *   @param lock locks the object if true
      *
@@ -73,7 +75,8 @@ public:
 
     /**
      *  Gets an object from the pool (if needed the object is loaded from the
-     *  database).
+     *  database). A locked object may be modified by the caller, so its
+     *  cached info XML is invalidated.
      *   @param name of the object
      *   @param uid id of owner
      *   @param lock locks the object if true
@@ -82,6 +85,15 @@ public:
      */
     PoolObjectSQL * get(const string& name, int uid, bool lock);
 
+    /**
+     *  Gets a locked object to read it, its cached info XML is kept. The
+     *  caller MUST NOT modify the object.
+     *   @param oid the object unique identifier
+     *
+     *   @return a pointer to the object, 0 in case of failure
+     */
+    PoolObjectSQL * get_ro(int oid);
+
     /**
      *  Finds a set objects that satisfies a given condition
      *   @param oids a vector with the oids of the objects.
@@ -112,6 +124,8 @@ public:
         if ( rc == 0 )
         {
             do_hooks(objsql, Hook::UPDATE);
+
+            log_change(objsql, ChangeLog::UPDATE);
         }
 
         return rc;
@@ -134,6 +148,8 @@ public:
             return -1;
         }
 
+        log_change(objsql, ChangeLog::DROP);
+
         return 0;
     };
 
@@ -152,6 +168,22 @@ public:
      */
     virtual int dump(ostringstream& oss, const string& where) = 0;
 
+    /**
+     *  Sets the change log fed by all the pools, 0 disables it
+     *    @param _change_log the log
+     */
+    static void set_change_log(ChangeLog * _change_log)
+    {
+        change_log = _change_log;
+    };
+
+    /**
+     *  Evaluates the hooks for the queued events of an object. The object is
+     *  locked once, and only if a hook uses it.
+     *    @param events of the same object
+     */
+    void run_hooks(const vector<HookEvent>& events);
+
 protected:
 
     /**
@@ -196,6 +228,46 @@ protected:
         update_lastOID();
     };
 
+    /**
+     *  Records a change of an object in the change log, if any. Pools that
+     *  write their objects without PoolSQL::update MUST call this function.
+     *    @param objsql the object, it SHOULD be locked
+     *    @param event type of change
+     */
+    void log_change(PoolObjectSQL * objsql, ChangeLog::EventType event)
+    {
+        int state;
+        int sub_state;
+
+        if ( change_log == 0 )
+        {
+            return;
+        }
+
+        objsql->get_states(state, sub_state);
+
+        change_log->add(table, objsql->oid, event, state, sub_state);
+    };
+
+    /**
+     *  Fills the hook event with the id and states of the object
+     *    @param arg the object, it SHOULD be locked
+     *    @param event to be filled
+     */
+    void hook_event(void *arg, HookEvent& event)
+    {
+        PoolObjectSQL * objsql = static_cast<PoolObjectSQL *>(arg);
+
+        if ( objsql == 0 )
+        {
+            return;
+        }
+
+        event.oid = objsql->oid;
+
+        objsql->get_states(event.state, event.sub_state);
+    };
+
 private:
 
     pthread_mutex_t mutex;
@@ -207,6 +279,11 @@ private:
      */
     static const unsigned int MAX_POOL_SIZE;
 
+    /**
+     *  Change log shared by all the pools
+     */
+    static ChangeLog * change_log;
+
     /**
      *  Last object ID assigned to an object. It must be initialized by the
      *  target pool.
@@ -230,6 +307,27 @@ private:
      */
     map<string,PoolObjectSQL *> name_pool;
 
+    /**
+     *  Gets an object from the pool (if needed the object is loaded from the
+     *  database), without invalidating its cached info XML.
+     *   @param oid the object unique identifier
+     *   @param lock locks the object if true
+     *
+     *   @return a pointer to the object, 0 in case of failure
+     */
+    PoolObjectSQL * get_object(int oid, bool lock);
+
+    /**
+     *  Gets an object from the pool by name (if needed the object is loaded
+     *  from the database), without invalidating its cached info XML.
+     *   @param name of the object
+     *   @param uid id of owner
+     *   @param lock locks the object if true
+     *
+     *   @return a pointer to the object, 0 in case of failure
+     */
+    PoolObjectSQL * get_object(const string& name, int uid, bool lock);
+
     /**
      *  Factory method, must return an ObjectSQL pointer to an allocated pool
      *  specific object.
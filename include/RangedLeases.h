@@ -18,6 +18,7 @@
 #define RANGED_LEASES_H_
 
 #include "Leases.h"
+#include "LeaseBitmap.h"
 
 using namespace std;
 
@@ -36,6 +37,11 @@ public:
 
     ~RangedLeases(){};
 
+    /**
+     *  Max. number of hosts of a ranged network, those of a class A
+     */
+    static const unsigned long MAX_SIZE;
+
     /**
      * Returns an unused lease, which becomes used
      *   @param vid identifier of the VM getting this lease
@@ -45,14 +51,25 @@ public:
      */
     int get(int vid, string&  ip, string&  mac);
 
+    /**
+     * Returns unused leases, which become used. All the leases are written
+     * to the DB with a multi-row statement
+     *   @param vids identifiers of the VMs getting the leases, -1 to hold
+     *   @param ips of the returned leases
+     *   @param macs of the returned leases
+     *   @return 0 if success
+     */
+    int get(const vector<int>& vids, vector<string>& ips, vector<string>& macs);
+
     /**
      * Ask for a specific lease in the network
      *  @param vid identifier of the VM getting this lease
      *  @param ip ip of lease requested
      *  @param mac mac of the lease
+     *  @param use_held if a held lease can be set
      *  @return 0 if success
      */
-    int set(int vid, const string&  ip, string&  mac);
+    int set(int vid, const string& ip, string& mac, bool use_held);
 
     /**
      * Release an used lease, which becomes unused
@@ -96,13 +113,7 @@ public:
     /**
      *  Loads the leases from the DB.
      */
-    int select(SqlDB * db)
-    {
-        //Read the leases from the DB
-        int rc = Leases::select(db);
-
-        return rc;
-    }
+    int select(SqlDB * db);
 
 private:
     /**
@@ -117,6 +128,11 @@ private:
 
     unsigned int current;
 
+    /**
+     *  Used addresses of the range, indexed by ip - network_address - 1
+     */
+    LeaseBitmap  used_ips;
+
     /**
      * Add a lease, from the Lease interface
      * @param ip ip of the lease
@@ -23,6 +23,9 @@
 #include "RequestManager.h"
 #include "AuthManager.h"
 
+#include <sys/time.h>
+#include <string.h>
+
 using namespace std;
 
 /**
@@ -55,6 +58,60 @@ public:
         INTERNAL       = 0x2000,
     };
 
+    /**
+     *  Sets the maximum number of simultaneous executions of this method.
+     *  Calls beyond this limit are rejected with an INTERNAL error, so a
+     *  burst of expensive calls can not take every server thread.
+     *    @param max number of concurrent calls, 0 means no limit
+     */
+    void set_max_concurrent(int max)
+    {
+        max_concurrent = max;
+    };
+
+    /**
+     *  Number of buckets in the latency histogram of the method
+     */
+    static const int NUM_BUCKETS = 12;
+
+    /**
+     *  Upper bound (in microseconds) of each bucket in the latency histogram,
+     *  the last bucket gets any call over BUCKET_LIMITS[NUM_BUCKETS-2]
+     */
+    static const unsigned long BUCKET_LIMITS[NUM_BUCKETS-1];
+
+    /**
+     *  Prints the execution statistics of this method in XML format
+     *    @param name of the XML-RPC method
+     *    @param xml the resulting XML string
+     *    @return a reference to the generated string
+     */
+    string& stats_to_xml(const string& name, string& xml);
+
+    /**
+     *  Prints a one-line summary of the execution statistics of this method
+     *    @param name of the XML-RPC method
+     *    @param str the resulting string
+     *    @return a reference to the generated string
+     */
+    string& stats_to_str(const string& name, string& str);
+
+    /**
+     *  Gets the number of calls served by this method
+     */
+    unsigned long get_calls()
+    {
+        unsigned long calls;
+
+        pthread_mutex_lock(&stats_mutex);
+
+        calls = stats.calls;
+
+        pthread_mutex_unlock(&stats_mutex);
+
+        return calls;
+    };
+
 protected:
 
     /* ---------------------------------------------------------------------*/
@@ -74,6 +131,11 @@ protected:
         string session;           /**< Session from ONE XML-RPC API */
 
         xmlrpc_c::value * retval; /**< Return value from libxmlrpc-c */
+
+        bool failed;              /**< A failure response was built */
+
+        unsigned long authz_time; /**< usecs spent in basic_authorization */
+        unsigned long resp_time;  /**< usecs spent building the response */
     };
 
     /* -------- Static (shared among request of the same method) -------- */
@@ -81,6 +143,33 @@ protected:
     PoolSQL *           pool;           /**< Pool of objects */
     string              method_name;    /**< The name of the XML-RPC method */
 
+    int                 max_concurrent; /**< Max. executions, 0 unlimited */
+    int                 running;        /**< Executions in progress */
+    pthread_mutex_t     running_mutex;  /**< Protects the running counter */
+
+    /**
+     *  Execution statistics for the method, times are in microseconds
+     */
+    struct MethodStats
+    {
+        unsigned long      calls;      /**< Calls served */
+        unsigned long      errors;     /**< Failed calls, but not rejected */
+        unsigned long      rejected;   /**< Calls over max_concurrent */
+
+        unsigned long long total_time; /**< Whole execute() */
+        unsigned long long authn_time; /**< UserPool::authenticate */
+        unsigned long long authz_time; /**< basic_authorization */
+        unsigned long long exec_time;  /**< request_execute, no authz/resp */
+        unsigned long long resp_time;  /**< Building the response */
+
+        unsigned long      max_time;   /**< Slowest call */
+
+        unsigned long      histogram[NUM_BUCKETS]; /**< Latency histogram */
+    };
+
+    MethodStats         stats;          /**< Statistics of the method */
+    pthread_mutex_t     stats_mutex;    /**< Protects the statistics */
+
     AuthRequest::Object    auth_object; /**< Auth object for the request */
     AuthRequest::Operation auth_op;     /**< Auth operation for the request */
 
@@ -88,13 +177,23 @@ protected:
 
     Request(const string& mn, 
             const string& signature, 
-            const string& help): pool(0),method_name(mn)
+            const string& help): pool(0),method_name(mn),
+                                 max_concurrent(0),running(0)
     {
         _signature = signature;
         _help      = help;
+
+        memset(&stats, 0, sizeof(MethodStats));
+
+        pthread_mutex_init(&running_mutex,0);
+        pthread_mutex_init(&stats_mutex,0);
     };
 
-    virtual ~Request(){};
+    virtual ~Request()
+    {
+        pthread_mutex_destroy(&running_mutex);
+        pthread_mutex_destroy(&stats_mutex);
+    };
 
     /* -------------------------------------------------------------------- */
     /* -------------------------------------------------------------------- */
@@ -129,6 +228,13 @@ protected:
      */
     bool basic_authorization(int oid, AuthRequest::Operation op,
                              RequestAttributes& att);
+
+    /**
+     *  Implements basic_authorization, so its cost can be accounted in the
+     *  statistics of the method
+     */
+    bool authorize(int oid, AuthRequest::Operation op,
+                   RequestAttributes& att);
             
     /**
      *  Actual Execution method for the request. Must be implemented by the
@@ -155,6 +261,15 @@ protected:
      */
     void success_response(const string& val, RequestAttributes& att);
 
+    /**
+     *  Builds an XML-RPC response updating retval. After calling this function
+     *  the xml-rpc excute method should return
+     *    @param val value to be returned to the client, e.g. an array with
+     *    the results of a batch operation
+     *    @param att the specific request attributes
+     */
+    void success_response(const xmlrpc_c::value& val, RequestAttributes& att);
+
     /**
      *  Builds an XML-RPC response updating retval. After calling this function
      *  the xml-rpc excute method should return
@@ -188,6 +303,48 @@ protected:
      */
     string authenticate_error ();
 
+    /**
+     *  Microseconds elapsed since the given time
+     *    @param start time
+     *    @return the elapsed time in usecs
+     */
+    static unsigned long elapsed(const struct timeval& start)
+    {
+        struct timeval now;
+
+        gettimeofday(&now, 0);
+
+        return (now.tv_sec - start.tv_sec) * 1000000 +
+               (now.tv_usec - start.tv_usec);
+    };
+
+    /**
+     *  Adds a call to the statistics of the method
+     *    @param att the specific request attributes
+     *    @param authn_time usecs spent authenticating the user
+     *    @param total_time usecs spent in the whole call
+     *    @param rejected true if the call was over max_concurrent
+     */
+    void update_stats(RequestAttributes& att,
+                      unsigned long      authn_time,
+                      unsigned long      total_time,
+                      bool               rejected);
+
+    /**
+     *  Estimates a latency percentile from the histogram of the method
+     *    @param st statistics of the method
+     *    @param pct the percentile, e.g. 99
+     *    @return upper bound (usecs) of the bucket holding the percentile, or
+     *    the slowest call if it falls in the last bucket
+     */
+    static unsigned long percentile(const MethodStats& st, unsigned int pct);
+
+    /**
+     *  Logs calls rejected by the concurrency limit of the method
+     *    @return string for logging
+     */
+    string concurrency_error ();
+
     /**
      *  Logs get object errors
      *    @param object over which the get failed
@@ -34,6 +34,8 @@
 
 using namespace std;
 
+class Request;
+
 extern "C" void * rm_action_loop(void *arg);
 
 extern "C" void * rm_xml_server_loop(void *arg);
@@ -42,8 +44,40 @@ class RequestManager : public ActionListener
 {
 public:
 
-    RequestManager(int _port, const string _xml_log_file)
-            :port(_port), socket_fd(-1), xml_log_file(_xml_log_file)
+    /**
+     *  Creates the Request Manager.
+     *    @param _port where the XML-RPC server listens
+     *    @param _max_conn simultaneous connections, one thread per connection
+     *    @param _max_conn_backlog connections queued waiting for a thread
+     *    @param _keepalive_timeout seconds an idle persistent connection is
+     *    kept open
+     *    @param _keepalive_max_conn max. requests served on a persistent
+     *    connection
+     *    @param _timeout seconds to wait for the client to send a request
+     *    @param _stats_interval seconds between method statistics summaries
+     *    in the log, 0 to disable them
+     *    @param _xml_log_file log file for the XML-RPC calls
+     *    @param _method_limits max. concurrent calls for each method name
+     */
+    RequestManager(
+            int                      _port,
+            int                      _max_conn,
+            int                      _max_conn_backlog,
+            int                      _keepalive_timeout,
+            int                      _keepalive_max_conn,
+            int                      _timeout,
+            time_t                   _stats_interval,
+            const string             _xml_log_file,
+            const map<string,int>&   _method_limits)
+            :port(_port), socket_fd(-1),
+             max_conn(_max_conn),
+             max_conn_backlog(_max_conn_backlog),
+             keepalive_timeout(_keepalive_timeout),
+             keepalive_max_conn(_keepalive_max_conn),
+             timeout(_timeout),
+             stats_interval(_stats_interval),
+             xml_log_file(_xml_log_file),
+             method_limits(_method_limits)
     {
         am.addListener(this);
     };
@@ -75,6 +109,13 @@ public:
         am.trigger(ACTION_FINALIZE,0);
     };
 
+    /**
+     *  Prints the execution statistics of the XML-RPC methods
+     *    @param xml the resulting XML string
+     *    @return a reference to the generated string
+     */
+    string& stats_to_xml(string& xml);
+
 
 private:
 
@@ -106,11 +147,51 @@ private:
      */
     int socket_fd;
 
+    /**
+     *  Max connections processed at the same time by the XML server
+     */
+    int max_conn;
+
+    /**
+     *  Max connections queued in the listen socket
+     */
+    int max_conn_backlog;
+
+    /**
+     *  Seconds an idle persistent connection is kept open
+     */
+    int keepalive_timeout;
+
+    /**
+     *  Max requests served in a persistent connection
+     */
+    int keepalive_max_conn;
+
+    /**
+     *  Seconds to wait for the client to send a request
+     */
+    int timeout;
+
+    /**
+     *  Seconds between method statistics summaries in the log
+     */
+    time_t stats_interval;
+
     /**
      *  Filename for the log of the xmlrpc server that listens
      */
     string xml_log_file;
 
+    /**
+     *  Max. concurrent executions for each XML-RPC method
+     */
+    map<string,int> method_limits;
+
+    /**
+     *  Registered methods, indexed by their XML-RPC name
+     */
+    map<string,Request *> methods;
+
     /**
      *  Action engine for the Manager
      */
@@ -138,6 +219,19 @@ private:
      */
     void register_xml_methods();
 
+    /**
+     *  Adds a method to the registry, applying its concurrency limit if one
+     *  has been configured
+     *    @param name of the XML-RPC method
+     *    @param method implementing the call
+     */
+    void add_method(const string& name, xmlrpc_c::methodPtr& method);
+
+    /**
+     *  Logs a summary of the statistics of the methods called so far
+     */
+    void log_stats();
+
     int setup_socket();
 };
 
@@ -131,6 +131,10 @@ public:
     };
 
     ~HostDelete(){};
+
+    /* -------------------------------------------------------------------- */
+
+    int drop(int oid, PoolObjectSQL * object, string& error_msg);
 };
 
 /* ------------------------------------------------------------------------- */
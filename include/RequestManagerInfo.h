@@ -47,7 +47,7 @@ protected:
 
     virtual void to_xml(PoolObjectSQL * object, string& str)
     {
-        object->to_xml(str);
+        str = object->info_xml();
     };
 };
 
@@ -72,8 +72,9 @@ public:
 
     void to_xml(PoolObjectSQL * object, string& str)
     {
-        VirtualMachine * vm = static_cast<VirtualMachine *>(object);
-        vm->to_xml_extended(str);
+        VirtualMachinePool * vmpool = static_cast<VirtualMachinePool *>(pool);
+
+        vmpool->info_xml(static_cast<VirtualMachine *>(object), str);
     };
 };
 
@@ -112,14 +113,6 @@ public:
     };
 
     ~VirtualNetworkInfo(){};
-
-    /* -------------------------------------------------------------------- */
-
-    void to_xml(PoolObjectSQL * object, string& str)
-    {
-        VirtualNetwork * vn = static_cast<VirtualNetwork*>(object);
-        vn->to_xml_extended(str);
-    };
 };
 
 /* ------------------------------------------------------------------------- */
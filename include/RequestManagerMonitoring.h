@@ -0,0 +1,98 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef REQUEST_MANAGER_MONITORING_H_
+#define REQUEST_MANAGER_MONITORING_H_
+
+#include "Request.h"
+#include "Nebula.h"
+
+using namespace std;
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class RequestManagerMonitoring: public Request
+{
+protected:
+    RequestManagerMonitoring(const string& method_name,
+                             const string& help)
+        :Request(method_name,"A:siii",help)
+    {
+        Nebula& nd    = Nebula::instance();
+        monitor_store = nd.get_monitor_store();
+
+        auth_op = AuthRequest::INFO;
+    };
+
+    ~RequestManagerMonitoring(){};
+
+    /* -------------------------------------------------------------------- */
+
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+                         RequestAttributes& att);
+
+    /* -------------------------------------------------------------------- */
+
+    MonitorStore *           monitor_store;
+
+    MonitorStore::ObjectType monitor_type;
+};
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class VirtualMachineMonitoring : public RequestManagerMonitoring
+{
+public:
+    VirtualMachineMonitoring():
+        RequestManagerMonitoring("VirtualMachineMonitoring",
+                    "Returns the monitoring records of a virtual machine")
+    {
+        Nebula& nd   = Nebula::instance();
+        pool         = nd.get_vmpool();
+        auth_object  = AuthRequest::VM;
+        monitor_type = MonitorStore::VM;
+    };
+
+    ~VirtualMachineMonitoring(){};
+};
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class HostMonitoring : public RequestManagerMonitoring
+{
+public:
+    HostMonitoring():
+        RequestManagerMonitoring("HostMonitoring",
+                                 "Returns the monitoring records of a host")
+    {
+        Nebula& nd   = Nebula::instance();
+        pool         = nd.get_hpool();
+        auth_object  = AuthRequest::HOST;
+        monitor_type = MonitorStore::HOST;
+    };
+
+    ~HostMonitoring(){};
+};
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+#endif
@@ -0,0 +1,87 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef REQUEST_MANAGER_SYSTEM_H
+#define REQUEST_MANAGER_SYSTEM_H
+
+#include "Request.h"
+#include "Nebula.h"
+
+using namespace std;
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class SystemStats : public Request
+{
+public:
+    SystemStats(RequestManager * _rm):
+        Request("SystemStats",
+                "A:s",
+                "Returns the execution statistics of the XML-RPC methods"),
+        rm(_rm)
+    {
+        auth_object = AuthRequest::ACL;
+        auth_op     = AuthRequest::MANAGE;
+    };
+
+    ~SystemStats(){};
+
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+                         RequestAttributes& att);
+
+private:
+    RequestManager * rm;
+};
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class SystemChanges : public Request
+{
+public:
+    SystemChanges():
+        Request("SystemChanges",
+                "A:sIi",
+                "Returns the changes in the pools after a sequence number")
+    {
+        Nebula& nd  = Nebula::instance();
+        change_log  = nd.get_change_log();
+
+        auth_object = AuthRequest::ACL;
+        auth_op     = AuthRequest::MANAGE;
+    };
+
+    ~SystemChanges(){};
+
+    /**
+     *  Max. seconds a call waits for new changes
+     */
+    static const int MAX_WAIT;
+
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+                         RequestAttributes& att);
+
+private:
+    ChangeLog * change_log;
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+#endif
@@ -46,6 +46,19 @@ protected:
 
     virtual void request_execute(xmlrpc_c::paramList const& _paramList,
                                  RequestAttributes& att) = 0;
+
+    /**
+     *  Gets a copy of a template to be instantiated, and authorizes the
+     *  operation. A failure response is built if the template can not be
+     *  instantiated.
+     *    @param id of the template
+     *    @param name of the new VMs
+     *    @param att the specific request attributes
+     *    @return the new template, 0 in case of failure
+     */
+    VirtualMachineTemplate * instance_template(int                id,
+                                               const string&      name,
+                                               RequestAttributes& att);
 };
 
 /* ------------------------------------------------------------------------- */
@@ -68,6 +81,31 @@ public:
                          RequestAttributes& att);
 };
 
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class VMTemplateInstantiateBatch : public RequestManagerVMTemplate
+{
+public:
+    VMTemplateInstantiateBatch():
+        RequestManagerVMTemplate("TemplateInstantiateBatch",
+                                 "Instantiates a number of virtual machines using a template",
+                                 "A:sisi")
+    {
+        auth_op = AuthRequest::INSTANTIATE;
+    };
+
+    ~VMTemplateInstantiateBatch(){};
+
+    /**
+     *  Max. number of VMs instantiated by a single call
+     */
+    static const int MAX_VMS = 100;
+
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+                         RequestAttributes& att);
+};
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
@@ -51,6 +51,35 @@ protected:
     bool vm_authorization(int id, int hid, ImageTemplate *tmpl,
             RequestAttributes& att);
 
+    /**
+     *  Authorizes the operation over a set of VMs with a single AuthRequest.
+     *  No response is built, if the whole set is not authorized the caller
+     *  should fall back to vm_authorization to get the result of each VM.
+     *    @param ids of the VMs
+     *    @param hids of the hosts used by the operation
+     *    @param att the specific request attributes
+     *    @return true if the operation is authorized for every VM
+     */
+    bool bulk_authorization(const vector<int>& ids,
+                            const set<int>&    hids,
+                            RequestAttributes& att);
+
+    /**
+     *  Performs an action over a VM through the DispatchManager
+     *    @param action name ("shutdown", "hold", ...)
+     *    @param id of the VM
+     *    @param att the specific request attributes
+     */
+    void vm_action(const string& action, int id, RequestAttributes& att);
+
+    /**
+     *  Deploys a pending VM on a host
+     *    @param id of the VM
+     *    @param hid of the host
+     *    @param att the specific request attributes
+     */
+    void vm_deploy(int id, int hid, RequestAttributes& att);
+
     int get_host_information(int hid, string& name, string& vmm, string& tm,
             RequestAttributes& att);
 
@@ -123,6 +152,42 @@ public:
 /* ------------------------------------------------------------------------- */
 /* ------------------------------------------------------------------------- */
 
+class VirtualMachineActionBatch : public RequestManagerVirtualMachine
+{
+public:
+    VirtualMachineActionBatch():
+        RequestManagerVirtualMachine("VirtualMachineActionBatch",
+                                     "Performs an action on a list of VMs",
+                                     "A:ssA"){};
+    ~VirtualMachineActionBatch(){};
+
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+            RequestAttributes& att);
+};
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class VirtualMachineDeployBatch : public RequestManagerVirtualMachine
+{
+public:
+    VirtualMachineDeployBatch():
+        RequestManagerVirtualMachine("VirtualMachineDeployBatch",
+                                     "Deploys a list of [vm id, host id]",
+                                     "A:sA")
+    {
+         auth_op = AuthRequest::DEPLOY;
+    };
+
+    ~VirtualMachineDeployBatch(){};
+
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+            RequestAttributes& att);
+};
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
 class VirtualMachineSaveDisk : public RequestManagerVirtualMachine
 {
 public:
@@ -93,6 +93,55 @@ public:
     }
 };
 
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class VirtualNetworkReleaseLeases : public RequestManagerVirtualNetwork
+{
+public:
+    VirtualNetworkReleaseLeases():
+        RequestManagerVirtualNetwork("VirtualNetworkReleaseLeases",
+                                     "Releases held leases of a virtual network"){};
+
+    ~VirtualNetworkReleaseLeases(){};
+
+    int leases_action(VirtualNetwork * vn,
+                      VirtualNetworkTemplate * tmpl,
+                      string& error_str)
+    {
+        return vn->release_leases(tmpl, error_str);
+    }
+};
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+class VirtualNetworkHoldLeases : public Request
+{
+public:
+    VirtualNetworkHoldLeases():
+        Request("VirtualNetworkHoldLeases",
+                "A:sii",
+                "Holds a block of leases of a virtual network")
+    {
+        Nebula& nd  = Nebula::instance();
+        pool        = nd.get_vnpool();
+
+        auth_object = AuthRequest::NET;
+        auth_op     = AuthRequest::MANAGE;
+    };
+
+    ~VirtualNetworkHoldLeases(){};
+
+    /**
+     *  Max. number of leases held by a single call
+     */
+    static const int MAX_LEASES = 256;
+
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+            RequestAttributes& att);
+};
+
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
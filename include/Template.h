@@ -109,6 +109,12 @@ public:
 	 */
     string& to_xml(string& xml) const;
 
+    /**
+     *  Writes the template in an XML document, as to_xml(string&)
+     *    @param xml the writer holding the document
+     */
+    void to_xml(XMLWriter& xml) const;
+
     /**
      *  Writes the template in a plain text string
      *    @param str string that hold the template representation
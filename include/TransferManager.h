@@ -160,6 +160,25 @@ private:
         const string &  action,
         void *          arg);
 
+    /**
+     *  Gets the cached copy of a non-persistent disk image in the VM host.
+     *  The image is added to the host cache if it is not there, and the
+     *  commands to copy it and to remove the evicted images are generated.
+     *    @param vm the virtual machine, must be locked
+     *    @param tm_md the transfer driver of the VM host
+     *    @param disk the DISK attribute of the image
+     *    @param evict_xfr commands to remove the images evicted from the cache
+     *    @param fill_xfr commands to copy the images to the cache
+     *    @return host:path of the cached copy, or empty if the disk has to
+     *    be copied from the repository
+     */
+    string cache_image(
+        VirtualMachine *              vm,
+        const TransferManagerDriver * tm_md,
+        const VectorAttribute *       disk,
+        ostringstream&                evict_xfr,
+        ostringstream&                fill_xfr);
+
     /**
      *  This function starts the prolog sequence 
      */
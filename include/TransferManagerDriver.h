@@ -39,8 +39,7 @@ public:
         int                         userid,
         const map<string,string>&   attrs,
         bool                        sudo,
-        VirtualMachinePool *        pool):
-            Mad(userid,attrs,sudo), vmpool(pool){};
+        VirtualMachinePool *        pool);
 
     virtual ~TransferManagerDriver(){};
 
@@ -65,11 +64,49 @@ private:
     VirtualMachinePool * vmpool;
 
     /**
-     *  Sends a transfer request to the MAD: "TRANSFER    ID    XFR_FILE"
+     *  The transfer script is sent in the driver message (INLINE attribute)
+     */
+    bool inline_xfr;
+
+    /**
+     *  The transfer script is written to a file even if it is sent inline,
+     *  for debugging (XFR_FILES attribute)
+     */
+    bool xfr_files;
+
+    /**
+     *  Directory of the image cache in the hosts, empty if the driver does
+     *  not cache images (IMAGE_CACHE attribute)
+     */
+    string image_cache;
+
+    /**
+     *  Default size quota of the image cache in MB, can be set for each host
+     *  with the IMAGE_CACHE_SIZE host attribute (IMAGE_CACHE_SIZE attribute)
+     */
+    int image_cache_size;
+
+    /**
+     *  Sends a transfer request to the MAD: "TRANSFER ID XFR_FILE [XFR64]".
+     *  The script is written to XFR_FILE unless it is sent inline, base64
+     *  encoded, as XFR64.
      *    @param oid the virtual machine id.
      *    @param xfr_file is the path to the transfer script
+     *    @param xfr the transfer script
+     *    @return 0 on success, -1 if the script could not be written
+     */
+    int transfer (const int      oid,
+                  const string&  xfr_file,
+                  const string&  xfr) const;
+
+    /**
+     *  Updates the image cache of the VM host when the prolog ends, the
+     *  images copied by the prolog are marked as ready or removed. The VM
+     *  must be locked.
+     *    @param vm the virtual machine
+     *    @param success of the prolog
      */
-    void transfer (const int oid, const string& xfr_file) const;
+    void update_image_cache(VirtualMachine * vm, bool success) const;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -42,7 +42,10 @@ public:
     UserPool(SqlDB * db,
              time_t  __session_expiration_time);
 
-    ~UserPool(){};
+    ~UserPool()
+    {
+        pthread_mutex_destroy(&session_mutex);
+    };
 
     /**
      *  Function to allocate a new User object
@@ -89,7 +92,35 @@ public:
      */
     int update(User * user)
     {
-        return user->update(db);
+        invalidate_sessions(user->get_oid());
+
+        return PoolSQL::update(user);
+    };
+
+    /**
+     *  Updates the user in the DB, cached sessions of the user are removed as
+     *  its password, auth driver, group or state may have changed
+     *    @param objsql pointer to the User
+     *    @return 0 on success
+     */
+    int update(PoolObjectSQL * objsql)
+    {
+        invalidate_sessions(objsql->get_oid());
+
+        return PoolSQL::update(objsql);
+    };
+
+    /**
+     *  Drops the user from the DB and its cached sessions
+     *    @param objsql pointer to the User
+     *    @param error_msg Error reason, if any
+     *    @return 0 on success, -1 DB error
+     */
+    int drop(PoolObjectSQL * objsql, string& error_msg)
+    {
+        invalidate_sessions(objsql->get_oid());
+
+        return PoolSQL::drop(objsql, error_msg);
     };
 
     /**
@@ -172,6 +203,77 @@ private:
      **/
     static time_t _session_expiration_time;
 
+    // -------------------------------------------------------------------------
+    // Authentication session cache
+    // -------------------------------------------------------------------------
+
+    /**
+     *  A session authenticated by oned, valid until the user session expires
+     */
+    struct Session
+    {
+        int    uid;
+        int    gid;
+        string uname;
+        string gname;
+        time_t valid_until;
+    };
+
+    /**
+     *  Authenticated sessions indexed by the sha1 hash of the session string,
+     *  so the user passwords are not kept in memory. Requests with a cached
+     *  session are served without getting the User from the pool.
+     */
+    map<string, Session> session_cache;
+
+    /**
+     *  Incremented each time the sessions of a user are invalidated, so a
+     *  concurrent authentication does not cache a stale session
+     */
+    unsigned long session_generation;
+
+    /**
+     *  Maximum number of cached sessions, expired sessions are purged when
+     *  it is reached
+     */
+    static const unsigned int MAX_SESSIONS;
+
+    /**
+     *  Mutex for the session cache, it is never held while getting a User
+     */
+    pthread_mutex_t session_mutex;
+
+    /**
+     *  Looks for a valid session in the cache
+     *    @param session_key sha1 hash of the session string
+     *    @return true if the session is cached and has not expired
+     */
+    bool get_session(const string& session_key,
+                     int&          uid,
+                     int&          gid,
+                     string&       uname,
+                     string&       gname);
+
+    /**
+     *  Adds an authenticated session to the cache
+     *    @param session_key sha1 hash of the session string
+     *    @param generation of the cache when the authentication started
+     *    @param valid_until expiration time of the session, 0 to not cache it
+     */
+    void set_session(const string& session_key,
+                     unsigned long generation,
+                     int           uid,
+                     int           gid,
+                     const string& uname,
+                     const string& gname,
+                     time_t        valid_until);
+
+    /**
+     *  Removes the cached sessions of a user
+     *    @param uid of the user
+     */
+    void invalidate_sessions(int uid);
+
     /**
      *  Function to authenticate internal (known) users
      */
@@ -180,7 +282,8 @@ private:
                                int&          user_id,
                                int&          group_id,
                                string&       uname,
-                               string&       gname);
+                               string&       gname,
+                               time_t&       valid_until);
 
     /**
      *  Function to authenticate internal users using a server driver
@@ -190,7 +293,8 @@ private:
                              int&          user_id,
                              int&          group_id,
                              string&       uname,
-                             string&       gname);
+                             string&       gname,
+                             time_t&       valid_until);
 
     
     /**
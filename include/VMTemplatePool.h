@@ -86,7 +86,7 @@ public:
      */
     int update(VMTemplate * vm_template)
     {
-        return vm_template->update(db);
+        return PoolSQL::update(vm_template);
     };
 
     /**
@@ -126,7 +126,8 @@ public:
 
     /**
      * Function to print the VirtualMachine object into a string in
-     * XML format, with extended information (full history records)
+     * XML format, with extended information (current and previous history
+     * records)
      *  @param xml the resulting XML string
      *  @return a reference to the generated string
      */
@@ -155,37 +156,31 @@ public:
     };
 
     /**
-     *  Updates VM dynamic information (usage counters).
+     *  Updates VM dynamic information (usage counters). A value is only
+     *  updated if it differs more than delta percent from the current one.
      *   @param _memory used by the VM (total)
      *   @param _cpu used by the VM (rate)
      *   @param _net_tx transmitted bytes (total)
      *   @param _net_tx received bytes (total)
+     *   @param delta min. change (percent) to update a value, 0 to update
+     *   any change
+     *   @return true if any value has been updated
      */
-    void update_info(
+    bool update_info(
         const int _memory,
         const int _cpu,
         const int _net_tx,
-        const int _net_rx)
+        const int _net_rx,
+        const int delta = 0)
     {
-        if (_memory != -1)
-        {
-            memory = _memory;
-        }
-
-        if (_cpu != -1)
-        {
-            cpu    = _cpu;
-        }
+        bool updated = false;
 
-        if (_net_tx != -1)
-        {
-            net_tx = _net_tx;
-        }
+        updated = update_usage(memory, _memory, delta) || updated;
+        updated = update_usage(cpu,    _cpu,    delta) || updated;
+        updated = update_usage(net_tx, _net_tx, delta) || updated;
+        updated = update_usage(net_rx, _net_rx, delta) || updated;
 
-        if (_net_rx != -1)
-        {
-            net_rx = _net_rx;
-        }
+        return updated;
     };
 
     /**
@@ -575,6 +570,17 @@ public:
         return lcm_state;
     };
 
+    /**
+     *  Gets the VM state and its LCM state for the pools change log
+     *    @param _state of the VM (Dispatch Manager)
+     *    @param _sub_state of the VM (life-cycle Manager)
+     */
+    void get_states(int& _state, int& _sub_state) const
+    {
+        _state     = state;
+        _sub_state = lcm_state;
+    };
+
     /**
      *  Sets VM state
      *    @param s state
@@ -582,6 +588,8 @@ public:
     void set_state(VmState s)
     {
         state = s;
+
+        set_dirty();
     };
 
     /**
@@ -591,6 +599,8 @@ public:
     void set_state(LcmState s)
     {
         lcm_state = s;
+
+        set_dirty();
     };
 
     // ------------------------------------------------------------------------
@@ -612,6 +622,8 @@ public:
     void set_last_poll(time_t poll)
     {
         last_poll = poll;
+
+        set_dirty();
     };
 
     /**
@@ -760,11 +772,8 @@ private:
      */
     History *   previous_history;
 
-
-    /**
-     *  Complete set of history records for the VM
-     */
-    vector<History *> history_records;
+    // Older history records are not kept in memory, they are only read from
+    // the DB for the info calls (VirtualMachinePool::info_xml)
 
     // -------------------------------------------------------------------------
     // Logging
@@ -776,7 +785,63 @@ private:
      *  or, in case that OpenNebula is installed in root
      *          /var/log/one/$VM_ID.log
      */
-    FileLog *       _log;
+    Log *           _log;
+
+    // -------------------------------------------------------------------------
+    // Network Leases
+    // -------------------------------------------------------------------------
+
+    /**
+     *  The NICs of the template already have their leases, held by the
+     *  caller that allocates the VM. They are not taken when it is inserted,
+     *  nor released if the insert fails
+     */
+    bool            leases_held;
+
+    // -------------------------------------------------------------------------
+    // Dynamic Info
+    // -------------------------------------------------------------------------
+
+    /**
+     *  Updates a usage counter if the new value differs more than delta
+     *  percent from the current one
+     *    @param value current value of the counter
+     *    @param new_value for the counter, -1 if not available
+     *    @param delta min. change (percent) to update the value
+     *    @return true if the value has been updated
+     */
+    static bool update_usage(int& value, const int new_value, const int delta)
+    {
+        long long diff;
+        long long base;
+
+        if ( new_value == -1 || new_value == value )
+        {
+            return false;
+        }
+
+        diff = static_cast<long long>(new_value) - value;
+        base = value;
+
+        if ( diff < 0 )
+        {
+            diff = -diff;
+        }
+
+        if ( base < 0 )
+        {
+            base = -base;
+        }
+
+        if ( diff * 100 <= delta * base )
+        {
+            return false;
+        }
+
+        value = new_value;
+
+        return true;
+    };
 
     // *************************************************************************
     // DataBase implementation (Private)
@@ -826,6 +891,8 @@ private:
     {
         if ( history != 0 )
         {
+            set_dirty();
+
             return history->update(db);
         }
         else
@@ -841,6 +908,8 @@ private:
     {
         if ( previous_history != 0 )
         {
+            set_dirty();
+
             return previous_history->update(db);
         }
         else
@@ -880,7 +949,7 @@ private:
 
     /**
      *  Function that renders the VM in XML format optinally including
-     *  extended information (all history records)
+     *  extended information (current and previous history records)
      *  @param xml the resulting XML string
      *  @param extended include additional info if true
      *  @return a reference to the generated string
@@ -889,6 +958,15 @@ private:
 
 protected:
 
+    /**
+     *  The info calls return the extended XML, the history records older
+     *  than the previous one are added by VirtualMachinePool::info_xml
+     */
+    string& to_info_xml(string& xml) const
+    {
+        return to_xml_extended(xml, true);
+    };
+
     //**************************************************************************
     // Constructor
     //**************************************************************************
@@ -235,7 +235,18 @@ private:
         int vid);
     
     /**
-     *  This function is executed periodically to poll the running VMs
+     *  VMs of a host to be polled with a single request
+     */
+    struct HostPoll
+    {
+        const VirtualMachineManagerDriver * vmd;
+        string                              name;
+        vector<pair<int,string> >           vms;
+    };
+
+    /**
+     *  This function is executed periodically to poll the running VMs. The
+     *  VMs are grouped by host and polled with one request per host.
      */
     void timer_action();
 
@@ -58,6 +58,17 @@ public:
      */
     void recover();
 
+    /**
+     *  Gets the driver action id of a host, or the host id of an action id.
+     *  Host actions use negative ids, so they never clash with the VM ones
+     *    @param id of the host or of the action
+     *    @return the action or host id
+     */
+    static int host_action_id(int id)
+    {
+        return -id - 1;
+    };
+
     /**
      *  Generates a driver-specific deployment file:
      *    @param vm pointer to a virtual machine
@@ -212,6 +223,47 @@ private:
         const int     oid,
         const string& host,
         const string& name) const;    
+
+    /**
+     *  Sends a poll request for all the VMs of a host to the MAD:
+     *  "POLL_HOST    ID    HOST    VID:NAME,VID:NAME...    -". The driver
+     *  answers with the monitor information of each VM preceded by VM=VID.
+     *  The action id is the host_action_id() of the host
+     *    @param hid the host id
+     *    @param host the hostname
+     *    @param vms id and name (deployment id) of the VMs in the host
+     */
+    void poll_host (
+        const int                        hid,
+        const string&                    host,
+        const vector<pair<int,string> >& vms) const;
+
+    /**
+     *  Updates a VM with the monitor information returned by the driver
+     *    @param vm the virtual machine, it MUST be locked
+     *    @param is VAR=VALUE pairs with the monitor information
+     */
+    void process_poll(
+        VirtualMachine * vm,
+        istringstream&   is);
+
+    /**
+     *  Updates a VM with the monitor information of a host poll
+     *    @param vid the virtual machine id, -1 is ignored
+     *    @param monitor VAR=VALUE pairs with the monitor information
+     */
+    void process_poll(int vid, const string& monitor);
+
+    /**
+     *  Processes the answer to a host poll
+     *    @param result of the poll request
+     *    @param hid the host id
+     *    @param is monitor information of the VMs
+     */
+    void process_poll_host(
+        const string&  result,
+        int            hid,
+        istringstream& is);
 };
 
 /* -------------------------------------------------------------------------- */
@@ -34,7 +34,8 @@ public:
 
     VirtualMachinePool(SqlDB * db,
                        vector<const Attribute *> hook_mads,
-                       const string& hook_location);
+                       const string& hook_location,
+                       int           _polling_delta = 0);
 
     ~VirtualMachinePool(){};
 
@@ -46,6 +47,8 @@ public:
      *    @param oid the id assigned to the VM (output)
      *    @param error_str Returns the error reason, if any
      *    @param on_hold flag to submit on hold
+     *    @param leases_held the NICs of the template have the attributes of
+     *    leases already held by the caller, that binds them to the VM
      *    @return oid on success, -1 error inserting in DB or -2 error parsing
      *  the template
      */
@@ -57,7 +60,8 @@ public:
         VirtualMachineTemplate * vm_template,
         int *                    oid,
         string&                  error_str,
-        bool                     on_hold = false);
+        bool                     on_hold = false,
+        bool                     leases_held = false);
 
     /**
      *  Function to get a VM from the pool, if the object is not in memory
@@ -86,6 +90,17 @@ public:
         int             vm_limit,
         time_t          last_poll);
 
+    /**
+     *  Sets the last_poll column of a set of VMs in one DB operation. The
+     *  VM objects SHOULD be also updated with set_last_poll()
+     *   @param oids of the VMs
+     *   @param last_poll time of the last poll
+     *   @return 0 on success
+     */
+    int update_last_poll(
+        const vector<int>& oids,
+        time_t             last_poll);
+
     /**
      *  Function to get the IDs of pending VMs
      *   @param oids a vector that contains the IDs
@@ -120,6 +135,17 @@ public:
         return vm->update_previous_history(db);
     }
 
+    /**
+     *  Gets the XML returned by the info calls for a VM, with all its history
+     *  records. Only the current and previous records are in memory, older
+     *  ones are read from the DB with a single query. The vm's mutex SHOULD
+     *  be locked
+     *    @param vm pointer to the virtual machine object
+     *    @param xml the resulting XML string
+     *    @return 0 on success
+     */
+    int info_xml(VirtualMachine * vm, string& xml);
+
     /**
      *  Bootstraps the database table(s) associated to the VirtualMachine pool
      *    @return 0 on success
@@ -143,7 +169,27 @@ public:
         return PoolSQL::dump(oss, "VM_POOL", VirtualMachine::table, where);
     }
 
+    /**
+     *  Min. change (percent) of a monitored value to update the VM in the DB
+     *    @return the polling delta
+     */
+    int get_polling_delta() const
+    {
+        return polling_delta;
+    };
+
 private:
+    /**
+     *  Min. change (percent) of a monitored value to update the VM
+     */
+    int polling_delta;
+
+    /**
+     *  Callback function to get the XML bodies of the history records
+     *  (VirtualMachinePool::info_xml)
+     */
+    int history_cb(void * _records, int num, char **values, char **names);
+
     /**
      *  Factory method to produce VM objects
      *    @return a pointer to the new VM
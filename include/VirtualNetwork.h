@@ -104,6 +104,16 @@ public:
      */
     int remove_leases(VirtualNetworkTemplate* leases, string& error_msg);
 
+    /**
+     * Releases held leases, the leases must not be in use by any VM
+     *  @param leases_template template in the form LEASES = [IP=XX]. It can
+     *         contain any number of LEASE definitions.
+     *  @param error_msg If the action fails, this message contains
+     *         the reason.
+     *  @return 0 on success
+     */
+    int release_leases(VirtualNetworkTemplate* leases, string& error_msg);
+
     /**
      *    Gets a new lease for a specific VM
      *    @param vid VM identifier
@@ -115,21 +125,61 @@ public:
     int get_lease(int vid, string& _ip, string& _mac, string& _bridge)
     {
         _bridge = bridge;
+
+        set_dirty();
+
         return leases->get(vid,_ip,_mac);
     };
 
+    /**
+     *    Gets a set of new leases in a single operation, if the network has
+     *    not enough free leases none is taken
+     *    @param vids VM identifiers, one lease for each one. The leases
+     *    for VM -1 are held until they are set for a VM or released
+     *    @param ips of the leases
+     *    @param macs of the leases
+     *    @return 0 if success
+     */
+    int get_leases(const vector<int>& vids,
+                   vector<string>&    ips,
+                   vector<string>&    macs)
+    {
+        set_dirty();
+
+        return leases->get(vids,ips,macs);
+    };
+
     /**
      *    Asks for an specific lease of the given virtual network
      *    @param vid VM identifier
      *    @param _ip the ip of the requested lease
      *    @param _mac pointer to string for MAC to be stored into
      *    @param _bridge name of the physical bridge this VN binds to
+     *    @param use_held if the lease can be a held one
      *    @return 0 if success
      */
-    int set_lease(int vid, const string& _ip, string& _mac, string& _bridge)
+    int set_lease(int           vid,
+                  const string& _ip,
+                  string&       _mac,
+                  string&       _bridge,
+                  bool          use_held = false)
     {
         _bridge = bridge;
-        return leases->set(vid,_ip,_mac);
+
+        set_dirty();
+
+        return leases->set(vid,_ip,_mac,use_held);
+    };
+
+    /**
+     *    Checks if a lease is held, held leases can only be set for a VM by
+     *    those that can manage the network
+     *    @param _ip the ip of the lease
+     *    @return true if the lease is held
+     */
+    bool is_held(const string& _ip)
+    {
+        return leases->is_held(_ip);
     };
 
     /**
@@ -139,6 +189,8 @@ public:
      */
     void release_lease(const string& ip)
     {
+        set_dirty();
+
         return leases->release(ip);
     };
 
@@ -174,9 +226,20 @@ public:
      *  * BRIDGE: for this virtual network
      *  @param nic attribute for the VM template
      *  @param vid of the VM getting the lease
+     *  @param use_held if the IP of the NIC can be a held lease
      *  @return 0 on success
      */
-    int nic_attribute(VectorAttribute * nic, int vid);
+    int nic_attribute(VectorAttribute * nic, int vid, bool use_held);
+
+protected:
+
+    /**
+     *  The info calls return the extended XML, with the LEASES
+     */
+    string& to_info_xml(string& xml) const
+    {
+        return to_xml_extended(xml);
+    };
 
 private:
 
@@ -185,6 +248,13 @@ private:
     // -------------------------------------------------------------------------
     friend class VirtualNetworkPool;
 
+    /**
+     * Sets the attributes of this network in a NIC: NETWORK, NETWORK_ID,
+     * BRIDGE, PHYDEV and VLAN_ID. IP and MAC are not modified
+     *  @param nic attribute for the VM template
+     */
+    void network_attributes(VectorAttribute * nic);
+
     // *************************************************************************
     // Virtual Network Private Attributes
     // *************************************************************************
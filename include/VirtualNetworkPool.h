@@ -89,8 +89,10 @@ public:
 
     /**
      *  Generates a NIC attribute for VM templates using the VirtualNetwork
-     *  metadata
+     *  metadata. A held lease is only set if the NIC was authorized to use
+     *  it (see authorize_nic) or for oneadmin
      *    @param nic the nic attribute to be generated
+     *    @param uid of the VM owner
      *    @param vid of the VM requesting the lease
      *    @return 0 on success, 
      *            -1 error, 
@@ -100,12 +102,68 @@ public:
     int nic_attribute(VectorAttribute * nic, int uid, int vid);
 
     /**
-     *  Generates an Authorization token for a NIC attribute
+     *  Generates an Authorization token for a NIC attribute. Using a held
+     *  lease requires MANAGE, in that case the NIC is marked so the lease
+     *  can be set by nic_attribute
      *    @param nic the nic to be authorized
      *    @param ar the AuthRequest
      */
     void authorize_nic(VectorAttribute * nic, int uid, AuthRequest * ar);
 
+    /**
+     *  Holds a block of leases of a network. The leases are taken in a single
+     *  locked operation and can be later used by NICs with a fixed IP
+     *    @param nid of the network
+     *    @param num number of leases
+     *    @param ips of the leases (output)
+     *    @param macs of the leases (output)
+     *    @return 0 on success,
+     *            -1 the network does not exist,
+     *            -2 not enough free leases
+     */
+    int hold_leases(int             nid,
+                    unsigned int    num,
+                    vector<string>& ips,
+                    vector<string>& macs);
+
+    /**
+     *  Holds a block of leases for a NIC of a set of VMs, in a single locked
+     *  operation. The attributes of the network are set in the NIC, but for
+     *  the IP and MAC of each lease
+     *    @param nic the NIC, the network is referenced with NETWORK_ID
+     *    @param num number of leases
+     *    @param ips of the leases (output)
+     *    @param macs of the leases (output)
+     *    @return 0 on success,
+     *            -1 the network does not exist,
+     *            -2 not enough free leases,
+     *            -3 the network is referenced with NETWORK
+     */
+    int hold_nic_leases(VectorAttribute * nic,
+                        unsigned int      num,
+                        vector<string>&   ips,
+                        vector<string>&   macs);
+
+    /**
+     *  Sets held leases of a network for a set of VMs, all of them are
+     *  written with a single batched update
+     *    @param nid of the network
+     *    @param ips of the held leases
+     *    @param vids of the VMs, one for each lease
+     *    @return 0 on success
+     */
+    int bind_held_leases(int                   nid,
+                         const vector<string>& ips,
+                         const vector<int>&    vids);
+
+    /**
+     *  Releases the leases of a network that are still held, leases set
+     *  for a VM are not modified
+     *    @param nid of the network
+     *    @param ips of the leases
+     */
+    void release_held_leases(int nid, const vector<string>& ips);
+
     /**
      *  Bootstraps the database table(s) associated to the VirtualNetwork pool
      *    @return 0 on success
@@ -157,6 +215,11 @@ private:
      */
     static unsigned int     _default_size;
 
+    /**
+     *  NIC value set by authorize_nic when MANAGE was requested for its IP
+     */
+    static const char *     held_lease_name;
+
     /**
      *  Factory method to produce VN objects
      *    @return a pointer to the new VN
@@ -0,0 +1,113 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef XML_READER_H_
+#define XML_READER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+
+#include <libxml/tree.h>
+#include <libxml/xmlreader.h>
+
+using namespace std;
+
+/**
+ *  Single pass reader for the XML body of the pool objects. The document is
+ *  streamed with the libxml2 pull parser, the text of the leaf elements is
+ *  stored by its absolute path (e.g. /VM/ID) so the object attributes can be
+ *  set without building the DOM and evaluating a XPath expression for each
+ *  one. Elements with a complex content, like templates, are kept as DOM
+ *  nodes if requested.
+ */
+class XMLReader
+{
+public:
+
+    XMLReader(){};
+
+    ~XMLReader();
+
+    /**
+     *  Reads a XML document, previous contents are freed
+     *    @param xml_doc the XML document
+     *    @param node_paths 0-terminated list of the absolute paths of the
+     *    elements to be kept as DOM nodes, e.g. {"/VM/TEMPLATE", 0}
+     *    @return 0 on success, -1 if the document is not well formed
+     */
+    int parse(const string& xml_doc, const char * node_paths[] = 0);
+
+    /**
+     *  Gets the value of an element, if the element is not found a default
+     *  is used. When an element appears more than once, the first one is used.
+     *    @param value to set
+     *    @param path absolute path of the element
+     *    @param def default value if the element is not found
+     *
+     *    @return -1 if default was set
+     */
+    int get(string& value, const string& path, const char * def) const;
+
+    int get(int& value, const string& path, int def) const;
+
+    int get(unsigned int& value, const string& path, unsigned int def) const;
+
+    int get(time_t& value, const string& path, time_t def) const;
+
+    /**
+     *  Gets an element kept as DOM node
+     *    @param path absolute path of the element, as passed to parse
+     *    @return the node or 0 if not found. The node is freed by the reader
+     */
+    xmlNodePtr get_node(const string& path) const;
+
+private:
+
+    /**
+     *  Text of the leaf elements by path
+     */
+    map<string, string>     values;
+
+    /**
+     *  Elements kept as DOM nodes by path
+     */
+    map<string, xmlNodePtr> nodes;
+
+    /**
+     *  Frees the contents of the reader
+     */
+    void clear();
+
+    /**
+     *  Gets the text of an element
+     *    @return 0 if the element is not found
+     */
+    const string * text(const string& path) const
+    {
+        map<string, string>::const_iterator it = values.find(path);
+
+        if ( it == values.end() )
+        {
+            return 0;
+        }
+
+        return &(it->second);
+    };
+};
+
+#endif /*XML_READER_H_*/
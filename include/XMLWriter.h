@@ -0,0 +1,269 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef XML_WRITER_H_
+#define XML_WRITER_H_
+
+#include <string>
+#include <cstdio>
+#include <ctime>
+
+using namespace std;
+
+/**
+ *  Append-only XML writer. Elements are appended to a single buffer,
+ *  preallocated to the expected document size, so nested objects (e.g.
+ *  HostShare or the Template of a Host) write directly into the document
+ *  instead of building and copying their own strings. Text elements are
+ *  escaped, and CDATA sections are split if the value contains "]]>".
+ */
+class XMLWriter
+{
+public:
+    /**
+     *  @param size initial capacity of the buffer
+     */
+    XMLWriter(string::size_type size = 2048)
+    {
+        buffer.reserve(size);
+    };
+
+    ~XMLWriter(){};
+
+    /**
+     *  Opens an element, <name>
+     */
+    XMLWriter& open(const char * name)
+    {
+        buffer += '<';
+        buffer += name;
+        buffer += '>';
+
+        return *this;
+    };
+
+    XMLWriter& open(const string& name)
+    {
+        return open(name.c_str());
+    };
+
+    /**
+     *  Closes an element, </name>
+     */
+    XMLWriter& close(const char * name)
+    {
+        buffer += "</";
+        buffer += name;
+        buffer += '>';
+
+        return *this;
+    };
+
+    XMLWriter& close(const string& name)
+    {
+        return close(name.c_str());
+    };
+
+    /**
+     *  Adds an empty element, <name/>
+     */
+    XMLWriter& empty(const string& name)
+    {
+        buffer += '<';
+        buffer += name;
+        buffer += "/>";
+
+        return *this;
+    };
+
+    /**
+     *  Adds an element with a text value, <name>value</name>. The value is
+     *  escaped.
+     */
+    XMLWriter& add(const char * name, const string& value)
+    {
+        open(name);
+        text(value);
+
+        return close(name);
+    };
+
+    XMLWriter& add(const char * name, const char * value)
+    {
+        open(name);
+        text(value);
+
+        return close(name);
+    };
+
+    /**
+     *  Adds an element with a numeric value, <name>value</name>. Numbers
+     *  are formatted as an ostringstream with the default flags would do.
+     */
+    XMLWriter& add(const char * name, int value)
+    {
+        return number(name, "%d", value);
+    };
+
+    XMLWriter& add(const char * name, unsigned int value)
+    {
+        return number(name, "%u", value);
+    };
+
+    XMLWriter& add(const char * name, long value)
+    {
+        return number(name, "%ld", value);
+    };
+
+    XMLWriter& add(const char * name, unsigned long value)
+    {
+        return number(name, "%lu", value);
+    };
+
+    XMLWriter& add(const char * name, long long value)
+    {
+        return number(name, "%lld", value);
+    };
+
+    XMLWriter& add(const char * name, float value)
+    {
+        return number(name, "%g", static_cast<double>(value));
+    };
+
+    XMLWriter& add(const char * name, double value)
+    {
+        return number(name, "%g", value);
+    };
+
+    /**
+     *  Adds an element with a CDATA section, <name><![CDATA[value]]></name>
+     */
+    XMLWriter& cdata(const string& name, const string& value)
+    {
+        string::size_type start = 0;
+        string::size_type end;
+
+        open(name);
+
+        buffer += "<![CDATA[";
+
+        // "]]>" can not be inside a CDATA section, end it after "]]"
+        while ((end = value.find("]]>", start)) != string::npos)
+        {
+            buffer.append(value, start, end + 2 - start);
+            buffer += "]]><![CDATA[";
+
+            start = end + 2;
+        }
+
+        buffer.append(value, start, string::npos);
+
+        buffer += "]]>";
+
+        return close(name);
+    };
+
+    /**
+     *  Appends escaped text
+     */
+    XMLWriter& text(const string& value)
+    {
+        return text(value.c_str());
+    };
+
+    XMLWriter& text(const char * value)
+    {
+        const char * start = value;
+
+        for (const char * c = value; *c != '\0'; c++)
+        {
+            const char * entity;
+
+            switch (*c)
+            {
+                case '&': entity = "&amp;";  break;
+                case '<': entity = "&lt;";   break;
+                case '>': entity = "&gt;";   break;
+                default : continue;
+            }
+
+            buffer.append(start, c - start);
+            buffer += entity;
+
+            start = c + 1;
+        }
+
+        buffer += start;
+
+        return *this;
+    };
+
+    /**
+     *  Appends a well-formed XML string as is
+     */
+    XMLWriter& raw(const string& xml)
+    {
+        buffer += xml;
+
+        return *this;
+    };
+
+    /**
+     *  Gets the XML document
+     */
+    const string& str() const
+    {
+        return buffer;
+    };
+
+    /**
+     *  Moves the XML document to a string, the writer is left empty
+     *    @param xml the resulting XML string
+     *    @return a reference to the resulting string
+     */
+    string& swap(string& xml)
+    {
+        xml.clear();
+        xml.swap(buffer);
+
+        return xml;
+    };
+
+private:
+
+    /**
+     *  The XML document
+     */
+    string buffer;
+
+    /**
+     *  Adds an element with a number formatted with printf
+     */
+    template<typename T>
+    XMLWriter& number(const char * name, const char * format, T value)
+    {
+        char num[32];
+        int  len = snprintf(num, sizeof(num), format, value);
+
+        open(name);
+
+        buffer.append(num, len);
+
+        return close(name);
+    };
+};
+
+#endif /*XML_WRITER_H_*/
@@ -664,6 +664,7 @@ ONEDB_MIGRATOR_FILES="src/onedb/2.0_to_2.9.80.rb \
                       src/onedb/2.9.85_to_2.9.90.rb \
                       src/onedb/2.9.90_to_3.0.0.rb \
                       src/onedb/3.0.0_to_3.1.0.rb \
+                      src/onedb/3.1.0_to_3.1.80.rb \
                       src/onedb/onedb.rb \
                       src/onedb/onedb_backend.rb"
 
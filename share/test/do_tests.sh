@@ -13,10 +13,14 @@ TESTS="$TWD_DIR/vnm/test \
        $TWD_DIR/template/test \
        $TWD_DIR/image/test \
        $TWD_DIR/authm/test \
+       $TWD_DIR/acl/test \
        $TWD_DIR/vm/test \
+       $TWD_DIR/vmm/test \
        $TWD_DIR/um/test \
        $TWD_DIR/lcm/test \
+       $TWD_DIR/log/test \
        $TWD_DIR/pool/test \
+       $TWD_DIR/rm/test \
        $TWD_DIR/vm_template/test \
        $TWD_DIR/group/test"
 
@@ -52,6 +52,7 @@ AclManager::AclManager(SqlDB * _db) : db(_db), lastOID(-1)
     ostringstream oss;
 
     pthread_mutex_init(&mutex, 0);
+    pthread_rwlock_init(&index_lock, 0);
 
     set_callback(static_cast<Callbackable::Callback> (&AclManager::init_cb));
 
@@ -86,7 +87,17 @@ AclManager::AclManager(SqlDB * _db) : db(_db), lastOID(-1)
 
 int AclManager::start()
 {
-    return select();
+    int rc;
+
+    lock();
+
+    rc = select();
+
+    rebuild_index();
+
+    unlock();
+
+    return rc;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -106,6 +117,7 @@ AclManager::~AclManager()
     unlock();
 
     pthread_mutex_destroy(&mutex);
+    pthread_rwlock_destroy(&index_lock);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -119,125 +131,138 @@ const bool AclManager::authorize(
         int                    obj_gid,
         AuthRequest::Operation op)
 {
-    ostringstream oss;
+    bool auth;
 
-    multimap<long long, AclRule *>::iterator        it;
-    pair<multimap<long long, AclRule *>::iterator,
-         multimap<long long, AclRule *>::iterator>  index;
+    long long rights_req = op;
 
-    bool auth = false;
+    if ( NebulaLog::enabled(Log::DEBUG) )
+    {
+        ostringstream oss;
 
-    // Build masks for request
-    long long user_req;
-    long long resource_oid_req;
+        // Create a temporal rule, to log the request
+        long long log_resource;
 
-    if ( obj_id >= 0 )
-    {
-        resource_oid_req  = obj_type | AclRule::INDIVIDUAL_ID | obj_id;
-    }
-    else
-    {
-        resource_oid_req = AclRule::NONE_ID;
-    }
+        if ( obj_id >= 0 )
+        {
+            log_resource = obj_type | AclRule::INDIVIDUAL_ID | obj_id;
+        }
+        else if ( obj_gid >= 0 )
+        {
+            log_resource = obj_type | AclRule::GROUP_ID | obj_gid;
+        }
+        else
+        {
+            log_resource = obj_type | AclRule::ALL_ID;
+        }
 
-    long long resource_gid_req;
+        AclRule log_rule(-1,
+                         AclRule::INDIVIDUAL_ID | uid,
+                         log_resource,
+                         rights_req);
 
-    if ( obj_gid >= 0 )
-    {
-        resource_gid_req  = obj_type | AclRule::GROUP_ID | obj_gid;
+        oss << "Request " << log_rule.to_str();
+        NebulaLog::log("ACL",Log::DEBUG,oss);
     }
-    else
+
+    pthread_rwlock_rdlock(&index_lock);
+
+    // Look for rules that apply to everyone, to the individual user id and
+    // to the user's group
+
+    auth = match_rules(AclRule::ALL_ID,
+                       obj_type,
+                       obj_id,
+                       obj_gid,
+                       rights_req)
+           ||
+           match_rules(AclRule::INDIVIDUAL_ID | uid,
+                       obj_type,
+                       obj_id,
+                       obj_gid,
+                       rights_req)
+           ||
+           match_rules(AclRule::GROUP_ID | gid,
+                       obj_type,
+                       obj_id,
+                       obj_gid,
+                       rights_req);
+
+    pthread_rwlock_unlock(&index_lock);
+
+    if ( NebulaLog::enabled(Log::DEBUG) )
     {
-        resource_gid_req = AclRule::NONE_ID;
+        if ( auth == true )
+        {
+            NebulaLog::log("ACL",Log::DEBUG,"Permission granted");
+        }
+        else
+        {
+            NebulaLog::log("ACL",Log::DEBUG,
+                           "No more rules, permission not granted ");
+        }
     }
 
-    long long resource_all_req = obj_type | AclRule::ALL_ID;
-    long long rights_req       = op;
+    return auth;
+}
 
-    long long resource_oid_mask =
-            ( obj_type | AclRule::INDIVIDUAL_ID | 0x00000000FFFFFFFFLL );
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
 
-    long long resource_gid_mask  =
-            ( obj_type | AclRule::GROUP_ID | 0x00000000FFFFFFFFLL );
+bool AclManager::match_rules(
+        long long user_req,
+        long long obj_type,
+        int       obj_id,
+        int       obj_gid,
+        long long rights_req)
 
+{
+    map<long long, map<long long, AclRights> >::const_iterator  user_it;
+    map<long long, AclRights>::const_iterator                   type_it;
+    map<int, long long>::const_iterator                         it;
 
-    // Create a temporal rule, to log the request
-    long long log_resource;
+    user_it = acl_index.find(user_req);
 
-    if ( obj_id >= 0 )
-    {
-        log_resource = resource_oid_req;
-    }
-    else if ( obj_gid >= 0 )
+    if ( user_it == acl_index.end() )
     {
-        log_resource = resource_gid_req;
+        return false;
     }
-    else
+
+    type_it = user_it->second.find(obj_type);
+
+    if ( type_it == user_it->second.end() )
     {
-        log_resource = resource_all_req;
+        return false;
     }
 
-    AclRule log_rule(-1, 
-                     AclRule::INDIVIDUAL_ID | uid, 
-                     log_resource,
-                     rights_req);
-
-    oss << "Request " << log_rule.to_str();
-    NebulaLog::log("ACL",Log::DEBUG,oss);
-
-    // ---------------------------------------------------
-    // Look for rules that apply to everyone
-    // ---------------------------------------------------
-
-    user_req = AclRule::ALL_ID;
-    auth     = match_rules(user_req, 
-                           resource_oid_req, 
-                           resource_gid_req,
-                           resource_all_req, 
-                           rights_req, 
-                           resource_oid_mask, 
-                           resource_gid_mask);
-    if ( auth == true )
+    const AclRights& rights = type_it->second;
+
+    // Rules grant permission for all objects of this type
+    if ( ( rights.all & rights_req ) == rights_req )
     {
         return true;
     }
 
-    // ---------------------------------------------------
-    // Look for rules that apply to the individual user id
-    // ---------------------------------------------------
-
-    user_req = AclRule::INDIVIDUAL_ID | uid;
-    auth     = match_rules(user_req, 
-                           resource_oid_req, 
-                           resource_gid_req,
-                           resource_all_req, 
-                           rights_req, 
-                           resource_oid_mask, 
-                           resource_gid_mask);
-    if ( auth == true )
+    // Or rules for the object group ID
+    if ( obj_gid >= 0 )
     {
-        return true;
+        it = rights.gids.find(obj_gid);
+
+        if ( it != rights.gids.end() && (it->second & rights_req) == rights_req )
+        {
+            return true;
+        }
     }
 
-    // ----------------------------------------------------------
-    // Look for rules that apply to each one of the user's groups
-    // ----------------------------------------------------------
-
-    user_req = AclRule::GROUP_ID | gid;
-    auth     = match_rules(user_req, 
-                           resource_oid_req, 
-                           resource_gid_req,
-                           resource_all_req, 
-                           rights_req, 
-                           resource_oid_mask,
-                           resource_gid_mask);
-    if ( auth == true )
+    // Or rules for the individual object ID
+    if ( obj_id >= 0 )
     {
-        return true;
-    }
+        it = rights.oids.find(obj_id);
 
-    oss.str("No more rules, permission not granted ");
-    NebulaLog::log("ACL",Log::DEBUG,oss);
+        if ( it != rights.oids.end() && (it->second & rights_req) == rights_req )
+        {
+            return true;
+        }
+    }
 
     return false;
 }
@@ -245,61 +270,60 @@ const bool AclManager::authorize(
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-bool AclManager::match_rules(
-        long long user_req,
-        long long resource_oid_req,
-        long long resource_gid_req,
-        long long resource_all_req,
-        long long rights_req,
-        long long resource_oid_mask,
-        long long resource_gid_mask)
-
+void AclManager::rebuild_index()
 {
-    bool auth = false;
-    ostringstream oss;
+    static const long long obj_types[] = {
+        AuthRequest::VM,
+        AuthRequest::HOST,
+        AuthRequest::NET,
+        AuthRequest::IMAGE,
+        AuthRequest::USER,
+        AuthRequest::TEMPLATE,
+        AuthRequest::GROUP,
+        AuthRequest::ACL
+    };
 
-    multimap<long long, AclRule *>::iterator        it;
+    static const int num_types = sizeof(obj_types) / sizeof(long long);
 
-    pair<multimap<long long, AclRule *>::iterator,
-         multimap<long long, AclRule *>::iterator>  index;
+    multimap<long long, AclRule *>::iterator it;
 
-    lock();
+    pthread_rwlock_wrlock(&index_lock);
 
-    index = acl_rules.equal_range( user_req );
+    acl_index.clear();
 
-    for ( it = index.first; it != index.second; it++)
+    for ( it = acl_rules.begin(); it != acl_rules.end(); it++ )
     {
-        oss.str("");
-        oss << "> Rule  " << it->second->to_str();
-        NebulaLog::log("ACL",Log::DEBUG,oss);
+        const AclRule * rule = it->second;
 
-        auth =
-          // Rule grants the requested rights
-          ( ( it->second->rights & rights_req ) == rights_req )
-          &&
-          (
-            // Rule grants permission for all objects of this type
-            ( ( it->second->resource & resource_all_req ) == resource_all_req )
-            ||
-            // Or rule's object type and group object ID match
-            ( ( it->second->resource & resource_gid_mask ) == resource_gid_req )
-            ||
-            // Or rule's object type and individual object ID match
-            ( ( it->second->resource & resource_oid_mask ) == resource_oid_req )
-          );
+        int rid = static_cast<int>(rule->resource & 0x00000000FFFFFFFFLL);
 
-        if ( auth == true )
+        for ( int i = 0; i < num_types; i++ )
         {
-            oss.str("Permission granted");
-            NebulaLog::log("ACL",Log::DEBUG,oss);
-
-            break;
+            if ( (rule->resource & obj_types[i]) == 0 )
+            {
+                continue;
+            }
+
+            AclRights& rights = acl_index[rule->user][obj_types[i]];
+
+            if ( (rule->resource & AclRule::ALL_ID) != 0 )
+            {
+                rights.all |= rule->rights;
+            }
+
+            if ( (rule->resource & AclRule::GROUP_ID) != 0 )
+            {
+                rights.gids[rid] |= rule->rights;
+            }
+
+            if ( (rule->resource & AclRule::INDIVIDUAL_ID) != 0 )
+            {
+                rights.oids[rid] |= rule->rights;
+            }
         }
     }
 
-    unlock();
-
-    return auth;
+    pthread_rwlock_unlock(&index_lock);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -353,6 +377,8 @@ int AclManager::add_rule(long long user, long long resource, long long rights,
     acl_rules.insert( make_pair(rule->user, rule) );
     acl_rules_oids.insert( make_pair(rule->oid, rule) );
 
+    rebuild_index();
+
     update_lastOID();
 
     unlock();
@@ -467,6 +493,8 @@ int AclManager::del_rule(int oid, string& error_str)
     acl_rules.erase( it );
     acl_rules_oids.erase( oid );
 
+    rebuild_index();
+
     unlock();
     return 0;
 }
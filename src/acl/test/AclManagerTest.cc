@@ -0,0 +1,460 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <stdlib.h>
+
+#include "Nebula.h"
+#include "NebulaTest.h"
+#include "test/OneUnitTest.h"
+#include "AclManager.h"
+#include "AuthManager.h"
+
+using namespace std;
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class NebulaTestAcl: public NebulaTest
+{
+public:
+    NebulaTestAcl():NebulaTest()
+    {
+        NebulaTest::the_tester = this;
+
+        need_aclm = true;
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class AclManagerTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (AclManagerTest);
+
+    CPPUNIT_TEST (default_rules);
+    CPPUNIT_TEST (all_users);
+    CPPUNIT_TEST (individual_user);
+    CPPUNIT_TEST (group_user);
+    CPPUNIT_TEST (rights);
+    CPPUNIT_TEST (add_rule);
+    CPPUNIT_TEST (del_rule);
+    CPPUNIT_TEST (oneadmin);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+private:
+    NebulaTestAcl * tester;
+
+    AclManager *    aclm;
+
+public:
+    AclManagerTest()
+    {
+        xmlInitParser();
+    };
+
+    ~AclManagerTest()
+    {
+        xmlCleanupParser();
+    };
+
+    /* ********************************************************************* */
+    /* ********************************************************************* */
+
+    void setUp()
+    {
+        create_db();
+
+        tester = new NebulaTestAcl();
+
+        Nebula& neb = Nebula::instance();
+        neb.start();
+
+        aclm = neb.get_aclm();
+    };
+
+    void tearDown()
+    {
+        delete_db();
+
+        delete tester;
+    };
+
+    /* ********************************************************************* */
+    /* ********************************************************************* */
+
+    void default_rules()
+    {
+        // @1 VM+NET+IMAGE+TEMPLATE/* CREATE+INFO_POOL_MINE
+        CPPUNIT_ASSERT( aclm->authorize(5, 1, AuthRequest::VM, -1, -1,
+                                        AuthRequest::CREATE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 1, AuthRequest::TEMPLATE, -1, -1,
+                                        AuthRequest::INFO_POOL_MINE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 1, AuthRequest::HOST, -1, -1,
+                                        AuthRequest::CREATE) == false );
+
+        // @1 HOST/* USE
+        CPPUNIT_ASSERT( aclm->authorize(5, 1, AuthRequest::HOST, 3, 0,
+                                        AuthRequest::USE) == true );
+
+        // Not in the USERS group
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::VM, -1, -1,
+                                        AuthRequest::CREATE) == false );
+    };
+
+    /* ********************************************************************* */
+
+    void all_users()
+    {
+        string error_str;
+        int    rc;
+
+        // * IMAGE/* INFO
+        rc = aclm->add_rule(AclRule::ALL_ID,
+                            AuthRequest::IMAGE | AclRule::ALL_ID,
+                            AuthRequest::INFO,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        // * NET/@3 USE
+        rc = aclm->add_rule(AclRule::ALL_ID,
+                            AuthRequest::NET | AclRule::GROUP_ID | 3,
+                            AuthRequest::USE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        // * HOST/#7 MANAGE
+        rc = aclm->add_rule(AclRule::ALL_ID,
+                            AuthRequest::HOST | AclRule::INDIVIDUAL_ID | 7,
+                            AuthRequest::MANAGE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::IMAGE, 9, 4,
+                                        AuthRequest::INFO) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(6, 3, AuthRequest::IMAGE, 9, 4,
+                                        AuthRequest::INFO) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::IMAGE, 9, 4,
+                                        AuthRequest::MANAGE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::USE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 4,
+                                        AuthRequest::USE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::HOST, 7, 0,
+                                        AuthRequest::MANAGE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::HOST, 8, 0,
+                                        AuthRequest::MANAGE) == false );
+    };
+
+    /* ********************************************************************* */
+
+    void individual_user()
+    {
+        string error_str;
+        int    rc;
+
+        // #5 IMAGE/* USE
+        rc = aclm->add_rule(AclRule::INDIVIDUAL_ID | 5,
+                            AuthRequest::IMAGE | AclRule::ALL_ID,
+                            AuthRequest::USE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        // #5 NET/@3 MANAGE
+        rc = aclm->add_rule(AclRule::INDIVIDUAL_ID | 5,
+                            AuthRequest::NET | AclRule::GROUP_ID | 3,
+                            AuthRequest::MANAGE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        // #5 VM/#12 DELETE
+        rc = aclm->add_rule(AclRule::INDIVIDUAL_ID | 5,
+                            AuthRequest::VM | AclRule::INDIVIDUAL_ID | 12,
+                            AuthRequest::DELETE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::IMAGE, 9, 4,
+                                        AuthRequest::USE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(6, 2, AuthRequest::IMAGE, 9, 4,
+                                        AuthRequest::USE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::MANAGE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 4,
+                                        AuthRequest::MANAGE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(6, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::MANAGE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::VM, 12, 4,
+                                        AuthRequest::DELETE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::VM, 13, 4,
+                                        AuthRequest::DELETE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(6, 2, AuthRequest::VM, 12, 4,
+                                        AuthRequest::DELETE) == false );
+    };
+
+    /* ********************************************************************* */
+
+    void group_user()
+    {
+        string error_str;
+        int    rc;
+
+        // @2 TEMPLATE/* INFO
+        rc = aclm->add_rule(AclRule::GROUP_ID | 2,
+                            AuthRequest::TEMPLATE | AclRule::ALL_ID,
+                            AuthRequest::INFO,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        // @2 IMAGE/@2 MANAGE
+        rc = aclm->add_rule(AclRule::GROUP_ID | 2,
+                            AuthRequest::IMAGE | AclRule::GROUP_ID | 2,
+                            AuthRequest::MANAGE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        // @2 HOST/#4 DEPLOY
+        rc = aclm->add_rule(AclRule::GROUP_ID | 2,
+                            AuthRequest::HOST | AclRule::INDIVIDUAL_ID | 4,
+                            AuthRequest::DEPLOY,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::TEMPLATE, 9, 4,
+                                        AuthRequest::INFO) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(6, 2, AuthRequest::TEMPLATE, 9, 4,
+                                        AuthRequest::INFO) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 3, AuthRequest::TEMPLATE, 9, 4,
+                                        AuthRequest::INFO) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::IMAGE, 9, 2,
+                                        AuthRequest::MANAGE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::IMAGE, 9, 3,
+                                        AuthRequest::MANAGE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 3, AuthRequest::IMAGE, 9, 2,
+                                        AuthRequest::MANAGE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::HOST, 4, 0,
+                                        AuthRequest::DEPLOY) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::HOST, 5, 0,
+                                        AuthRequest::DEPLOY) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 3, AuthRequest::HOST, 4, 0,
+                                        AuthRequest::DEPLOY) == false );
+    };
+
+    /* ********************************************************************* */
+
+    void rights()
+    {
+        string error_str;
+        int    rc;
+
+        // #5 VM+IMAGE/@3 USE+MANAGE
+        rc = aclm->add_rule(AclRule::INDIVIDUAL_ID | 5,
+                            AuthRequest::VM | AuthRequest::IMAGE |
+                            AclRule::GROUP_ID | 3,
+                            AuthRequest::USE | AuthRequest::MANAGE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::VM, 9, 3,
+                                        AuthRequest::USE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::IMAGE, 9, 3,
+                                        AuthRequest::MANAGE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::IMAGE, 9, 3,
+                                        AuthRequest::DELETE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::USE) == false );
+
+        // Duplicated rules are rejected
+        rc = aclm->add_rule(AclRule::INDIVIDUAL_ID | 5,
+                            AuthRequest::VM | AuthRequest::IMAGE |
+                            AclRule::GROUP_ID | 3,
+                            AuthRequest::USE | AuthRequest::MANAGE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc == -1 );
+
+        // Malformed rules are rejected, user has two id bits
+        rc = aclm->add_rule(AclRule::INDIVIDUAL_ID | AclRule::GROUP_ID | 5,
+                            AuthRequest::VM | AclRule::ALL_ID,
+                            AuthRequest::USE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc == -2 );
+    };
+
+    /* ********************************************************************* */
+
+    void add_rule()
+    {
+        string error_str;
+        int    rc;
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::USE) == false );
+
+        // #5 NET/#9 USE
+        rc = aclm->add_rule(AclRule::INDIVIDUAL_ID | 5,
+                            AuthRequest::NET | AclRule::INDIVIDUAL_ID | 9,
+                            AuthRequest::USE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::USE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::MANAGE) == false );
+
+        // #5 NET/#9 MANAGE, rights for the same object are added
+        rc = aclm->add_rule(AclRule::INDIVIDUAL_ID | 5,
+                            AuthRequest::NET | AclRule::INDIVIDUAL_ID | 9,
+                            AuthRequest::MANAGE,
+                            error_str);
+
+        CPPUNIT_ASSERT( rc >= 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::USE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::MANAGE) == true );
+    };
+
+    /* ********************************************************************* */
+
+    void del_rule()
+    {
+        string error_str;
+        int    oid_use;
+        int    oid_manage;
+        int    rc;
+
+        // #5 NET/#9 USE
+        oid_use = aclm->add_rule(AclRule::INDIVIDUAL_ID | 5,
+                                 AuthRequest::NET | AclRule::INDIVIDUAL_ID | 9,
+                                 AuthRequest::USE,
+                                 error_str);
+
+        CPPUNIT_ASSERT( oid_use >= 0 );
+
+        // @2 NET/#9 MANAGE
+        oid_manage = aclm->add_rule(AclRule::GROUP_ID | 2,
+                                    AuthRequest::NET|AclRule::INDIVIDUAL_ID|9,
+                                    AuthRequest::MANAGE,
+                                    error_str);
+
+        CPPUNIT_ASSERT( oid_manage >= 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::USE) == true );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::MANAGE) == true );
+
+        rc = aclm->del_rule(oid_use, error_str);
+
+        CPPUNIT_ASSERT( rc == 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::USE) == false );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::MANAGE) == true );
+
+        rc = aclm->del_rule(oid_manage, error_str);
+
+        CPPUNIT_ASSERT( rc == 0 );
+
+        CPPUNIT_ASSERT( aclm->authorize(5, 2, AuthRequest::NET, 9, 3,
+                                        AuthRequest::MANAGE) == false );
+
+        // The rule does not exist any more
+        rc = aclm->del_rule(oid_manage, error_str);
+
+        CPPUNIT_ASSERT( rc == -1 );
+    };
+
+    /* ********************************************************************* */
+
+    void oneadmin()
+    {
+        AuthRequest ar(0, 1);
+        AuthRequest ar1(5, 0);
+        AuthRequest ar2(5, 2);
+
+        // No ACL rule grants these operations, but oneadmin and the users
+        // in the oneadmin group are always authorized
+        CPPUNIT_ASSERT( aclm->authorize(0, 1, AuthRequest::HOST, 4, 0,
+                                        AuthRequest::MANAGE) == false );
+
+        ar.add_auth(AuthRequest::HOST, 4, 0, AuthRequest::MANAGE, 0, false);
+        CPPUNIT_ASSERT( ar.core_authorize() == true );
+
+        ar1.add_auth(AuthRequest::HOST, 4, 0, AuthRequest::MANAGE, 0, false);
+        CPPUNIT_ASSERT( ar1.core_authorize() == true );
+
+        ar2.add_auth(AuthRequest::HOST, 4, 0, AuthRequest::MANAGE, 0, false);
+        CPPUNIT_ASSERT( ar2.core_authorize() == false );
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+int main(int argc, char ** argv)
+{
+    return OneUnitTest::main(argc, argv, AclManagerTest::suite());
+}
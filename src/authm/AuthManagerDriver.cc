@@ -64,7 +64,6 @@ void AuthManagerDriver::protocol(
     string&     message)
 {
     istringstream is(message);
-    ostringstream os;
 
     string        action;
     string        result;
@@ -72,8 +71,7 @@ void AuthManagerDriver::protocol(
 
     int           id;
 
-    os << "Message received: " << message;
-    NebulaLog::log("AuM", Log::DEBUG, os);
+    NEBULA_LOG("AuM", Log::DEBUG, "Message received: " << message);
 
     // Parse the driver message
     if ( is.good() )
@@ -67,14 +67,26 @@ string * VectorAttribute::marshall(const char * _sep) const
 
 string * VectorAttribute::to_xml() const
 {
-	map<string,string>::const_iterator    it;
-	ostringstream                   oss;
-	string * 						xml;
+    XMLWriter xml(256);
+    string *  str = new string;
 
-	oss << "<" << name() << ">";
+    to_xml(xml);
 
-	for (it=attribute_value.begin();it!=attribute_value.end();it++)
-	{
+    xml.swap(*str);
+
+    return str;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void VectorAttribute::to_xml(XMLWriter& xml) const
+{
+    map<string,string>::const_iterator it;
+
+    xml.open(name());
+
+    for (it=attribute_value.begin();it!=attribute_value.end();it++)
+    {
         if ( it->first.empty() )
         {
             continue;
@@ -82,22 +94,15 @@ string * VectorAttribute::to_xml() const
 
         if ( it->second.empty() )
         {
-            oss << "<" << it->first << "/>";
+            xml.empty(it->first);
         }
         else
         {
-	    	oss << "<" << it->first << "><![CDATA[" << it->second
-			    << "]]></"<< it->first << ">";
+            xml.cdata(it->first, it->second);
         }
-	}
-
-	oss << "</"<< name() << ">";
-
-	xml = new string;
-
-	*xml = oss.str();
+    }
 
-	return xml;
+    xml.close(name());
 }
 
 
@@ -185,6 +190,14 @@ void VectorAttribute::replace(const string& name, const string& value)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void VectorAttribute::remove(const string& name)
+{
+    attribute_value.erase(name);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 string VectorAttribute::vector_value(const char *name) const
 {
     map<string,string>::const_iterator it;
@@ -0,0 +1,115 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "XMLWriter.h"
+
+#include <string>
+#include <sstream>
+
+#include "test/OneUnitTest.h"
+
+using namespace std;
+
+class XMLWriterTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (XMLWriterTest);
+
+    CPPUNIT_TEST (test_elements);
+    CPPUNIT_TEST (test_numbers);
+    CPPUNIT_TEST (test_escape);
+    CPPUNIT_TEST (test_cdata);
+    CPPUNIT_TEST (test_swap);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+public:
+    void setUp(){};
+
+    void tearDown(){};
+
+    void test_elements()
+    {
+        XMLWriter xml;
+
+        xml.open("HOST")
+            .add("NAME", "host01")
+            .empty("DISK")
+            .raw("<RAW/>")
+        .close("HOST");
+
+        CPPUNIT_ASSERT(xml.str() ==
+            "<HOST><NAME>host01</NAME><DISK/><RAW/></HOST>");
+    }
+
+    void test_numbers()
+    {
+        XMLWriter     xml;
+        ostringstream oss;
+
+        time_t    t = 1317041234;
+        long long l = -12345678901LL;
+        float     f = 2.5;
+
+        xml.add("I", -3).add("U", 7U).add("T", t).add("L", l).add("F", f);
+
+        oss << "<I>" << -3 << "</I><U>" << 7U << "</U><T>" << t << "</T>"
+            << "<L>" << l  << "</L><F>" << f  << "</F>";
+
+        CPPUNIT_ASSERT(xml.str() == oss.str());
+    }
+
+    void test_escape()
+    {
+        XMLWriter xml;
+
+        xml.add("NAME", string("a&b <c> \"d\""));
+
+        CPPUNIT_ASSERT(xml.str() ==
+            "<NAME>a&amp;b &lt;c&gt; \"d\"</NAME>");
+    }
+
+    void test_cdata()
+    {
+        XMLWriter xml;
+
+        xml.cdata("A", "plain").cdata("B", "x]]>y");
+
+        CPPUNIT_ASSERT(xml.str() ==
+            "<A><![CDATA[plain]]></A>"
+            "<B><![CDATA[x]]]]><![CDATA[>y]]></B>");
+    }
+
+    void test_swap()
+    {
+        XMLWriter xml;
+        string    str = "old content";
+
+        xml.add("ID", 0);
+
+        CPPUNIT_ASSERT(xml.swap(str) == "<ID>0</ID>");
+        CPPUNIT_ASSERT(xml.str().empty());
+
+        xml.add("ID", 1);
+
+        CPPUNIT_ASSERT(xml.str() == "<ID>1</ID>");
+    }
+};
+
+int main(int argc, char ** argv)
+{
+    return OneUnitTest::main(argc, argv, XMLWriterTest::suite(),
+                            "xml_writer.xml");
+}
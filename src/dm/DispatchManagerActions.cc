@@ -582,6 +582,8 @@ int DispatchManager::finalize(
 
             vm->release_disk_images();
 
+            remove_monitoring(vid);
+
             vm->log("DiM", Log::INFO, "New VM state is DONE.");
         break;
 
@@ -16,6 +16,7 @@
 
 #include "DispatchManager.h"
 #include "NebulaLog.h"
+#include "Nebula.h"
 
 void  DispatchManager::suspend_success_action(int vid)
 {
@@ -130,6 +131,8 @@ void  DispatchManager::done_action(int vid)
         vm->release_network_leases();
 
         vm->release_disk_images();
+
+        remove_monitoring(vid);
     }
     else
     {
@@ -210,3 +213,16 @@ void  DispatchManager::resubmit_action(int vid)
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
+
+void  DispatchManager::remove_monitoring(int vid)
+{
+    MonitorStore * store = Nebula::instance().get_monitor_store();
+
+    if ( store != 0 )
+    {
+        store->remove(MonitorStore::VM, vid);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
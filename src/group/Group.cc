@@ -78,6 +78,8 @@ int Group::insert_replace(SqlDB *db, bool replace)
 
     rc = db->exec(oss);
 
+    update_xml_cache(&xml_body);
+
     db->free_str(sql_name);
     db->free_str(sql_xml);
 
@@ -94,21 +96,18 @@ error_name:
 
 string& Group::to_xml(string& xml) const
 {
-    ostringstream   oss;
-    string          collection_xml;
+    XMLWriter   writer(1024);
+    string      collection_xml;
 
     ObjectCollection::to_xml(collection_xml);
 
-    oss <<
-    "<GROUP>"    <<
-        "<ID>"   << oid  << "</ID>"   <<
-        "<NAME>" << name << "</NAME>" <<
-        collection_xml <<
-    "</GROUP>";
-
-    xml = oss.str();
+    writer.open("GROUP")
+        .add("ID",   oid)
+        .add("NAME", name)
+        .raw(collection_xml)
+    .close("GROUP");
 
-    return xml;
+    return writer.swap(xml);
 }
 
 /* ------------------------------------------------------------------------ */
@@ -117,27 +116,32 @@ string& Group::to_xml(string& xml) const
 int Group::from_xml(const string& xml)
 {
     int rc = 0;
-    vector<xmlNodePtr> content;
 
-    // Initialize the internal XML object
-    update_from_str(xml);
+    XMLReader  reader;
+    xmlNodePtr node;
+
+    const char * nodes[] = {"/GROUP/USERS", 0};
+
+    // Read the document in a single pass, the user set is kept as DOM
+    if ( reader.parse(xml, nodes) != 0 )
+    {
+        return -1;
+    }
 
     // Get class base attributes
-    rc += xpath(oid, "/GROUP/ID",   -1);
-    rc += xpath(name,"/GROUP/NAME", "not_found");
+    rc += reader.get(oid, "/GROUP/ID",   -1);
+    rc += reader.get(name,"/GROUP/NAME", "not_found");
 
     // Get associated classes
-    ObjectXML::get_nodes("/GROUP/USERS", content);
+    node = reader.get_node("/GROUP/USERS");
 
-    if (content.empty())
+    if (node == 0)
     {
         return -1;
     }
 
     // Set of IDs
-    rc += ObjectCollection::from_xml_node(content[0]);
-
-    ObjectXML::free_nodes(content);
+    rc += ObjectCollection::from_xml_node(node);
 
     if (rc != 0)
     {
@@ -164,6 +164,10 @@ int GroupPool::drop(PoolObjectSQL * objsql, string& error_msg)
         error_msg = "SQL DB error";
         rc = -1;
     }
+    else
+    {
+        log_change(group, ChangeLog::DROP);
+    }
 
     return rc;
 }
@@ -19,6 +19,8 @@
 
 const char * HookManager::hook_driver_name = "hook_exe";
 
+const unsigned int HookManager::MAX_HOOK_EVENTS = 4096;
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
@@ -107,12 +109,112 @@ int HookManager::start()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+int HookManager::queue(Hookable * hookable, const HookEvent& event)
+{
+    bool first;
+
+    pthread_mutex_lock(&queue_mutex);
+
+    if ( finalized )
+    {
+        pthread_mutex_unlock(&queue_mutex);
+
+        NEBULA_LOG("HKM", Log::WARNING, "Hook Manager stopped, discarding "
+                   "hook event " << event.hook_type << " of object "
+                   << event.oid << ".");
+        return -1;
+    }
+
+    if ( pending_events.size() >= MAX_HOOK_EVENTS )
+    {
+        if ( dropped_events++ == 0 )
+        {
+            NebulaLog::log("HKM", Log::ERROR,
+                "Hook event queue is full, discarding hook events.");
+        }
+
+        pthread_mutex_unlock(&queue_mutex);
+        return -1;
+    }
+
+    pending_events.push_back(HookAction(hookable, event));
+
+    first = ( pending_events.size() == 1 );
+
+    pthread_mutex_unlock(&queue_mutex);
+
+    if ( first )
+    {
+        am.trigger("HOOK_EVENT", 0);
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void HookManager::run_pending_events()
+{
+    vector<HookAction> actions;
+    unsigned int       dropped;
+
+    map<pair<Hookable *, int>, vector<HookEvent> >           objects;
+    map<pair<Hookable *, int>, vector<HookEvent> >::iterator it;
+
+    pthread_mutex_lock(&queue_mutex);
+
+    actions.swap(pending_events);
+
+    dropped        = dropped_events;
+    dropped_events = 0;
+
+    pthread_mutex_unlock(&queue_mutex);
+
+    // Events are grouped by object, keeping their order
+    for (vector<HookAction>::iterator ha = actions.begin();
+         ha != actions.end(); ha++)
+    {
+        objects[make_pair(ha->hookable, ha->event.oid)].push_back(ha->event);
+    }
+
+    for (it = objects.begin(); it != objects.end(); it++)
+    {
+        it->first.first->run_hooks(it->second);
+    }
+
+    if ( dropped != 0 )
+    {
+        ostringstream oss;
+
+        oss << dropped << " hook events were discarded, the queue was full";
+
+        NebulaLog::log("HKM", Log::ERROR, oss);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void HookManager::do_action(const string &action, void * arg)
 {
-    if (action == ACTION_FINALIZE)
+    if (action == "HOOK_EVENT")
+    {
+        run_pending_events();
+    }
+    else if (action == ACTION_FINALIZE)
     {
         NebulaLog::log("HKM",Log::INFO,"Stopping Hook Manager...");
 
+        pthread_mutex_lock(&queue_mutex);
+
+        finalized = true;
+
+        pthread_mutex_unlock(&queue_mutex);
+
+        // No more events are queued, process the ones still pending
+        run_pending_events();
+
         MadManager::stop();
     }
     else
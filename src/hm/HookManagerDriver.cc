@@ -85,14 +85,12 @@ void HookManagerDriver::protocol(
     //stores the action id of the asociated VM
     int             id;
 
-    ostringstream    os;
     string           hinfo;
     VirtualMachine * vm;
     
     // Parse the driver message
 
-    os << "Message received: " << message;
-    NebulaLog::log("HKM", Log::DEBUG, os);
+    NEBULA_LOG("HKM", Log::DEBUG, "Message received: " << message);
 
     // Parse the driver message
     if ( is.good() )
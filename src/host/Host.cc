@@ -142,6 +142,8 @@ int Host::insert_replace(SqlDB *db, bool replace)
 
     rc = db->exec(oss);
 
+    update_xml_cache(&xml_body);
+
     db->free_str(sql_hostname);
     db->free_str(sql_xml);
 
@@ -161,6 +163,8 @@ int Host::update_info(string &parse_str)
     char *  error_msg;
     int     rc;
 
+    set_dirty();
+
     rc = obj_template->parse(parse_str, &error_msg);
 
     if ( rc != 0 )
@@ -189,26 +193,24 @@ int Host::update_info(string &parse_str)
 
 string& Host::to_xml(string& xml) const
 {
-    string template_xml;
-    string share_xml;
-    ostringstream   oss;
+    XMLWriter writer(4096);
+
+    writer.open("HOST")
+        .add("ID",            oid)
+        .add("NAME",          name)
+        .add("STATE",         static_cast<int>(state))
+        .add("IM_MAD",        im_mad_name)
+        .add("VM_MAD",        vmm_mad_name)
+        .add("TM_MAD",        tm_mad_name)
+        .add("LAST_MON_TIME", last_monitored);
 
-    oss <<
-    "<HOST>"
-       "<ID>"            << oid       	   << "</ID>"            <<
-       "<NAME>"          << name 	       << "</NAME>"          <<
-       "<STATE>"         << state          << "</STATE>"         <<
-       "<IM_MAD>"        << im_mad_name    << "</IM_MAD>"        <<
-       "<VM_MAD>"        << vmm_mad_name   << "</VM_MAD>"        <<
-       "<TM_MAD>"        << tm_mad_name    << "</TM_MAD>"        <<
-       "<LAST_MON_TIME>" << last_monitored << "</LAST_MON_TIME>" <<
-       host_share.to_xml(share_xml)  <<
-       obj_template->to_xml(template_xml) <<
-    "</HOST>";
-
-    xml = oss.str();
-
-    return xml;
+    host_share.to_xml(writer);
+    image_cache.to_xml(writer);
+    obj_template->to_xml(writer);
+
+    writer.close("HOST");
+
+    return writer.swap(xml);
 }
 
 /* ------------------------------------------------------------------------ */
@@ -216,50 +218,47 @@ string& Host::to_xml(string& xml) const
 
 int Host::from_xml(const string& xml)
 {
-    vector<xmlNodePtr> content;
-    
+    XMLReader  reader;
+    xmlNodePtr node;
+
+    const char * nodes[] = {"/HOST/IMAGE_CACHE", "/HOST/TEMPLATE", 0};
+
     int int_state;
     int rc = 0;
 
-    // Initialize the internal XML object
-    update_from_str(xml);
+    // Read the document in a single pass, only the image cache and the
+    // template are kept as DOM
+    if ( reader.parse(xml, nodes) != 0 )
+    {
+        return -1;
+    }
 
     // Get class base attributes
-    rc += xpath(oid, "/HOST/ID", -1);
-    rc += xpath(name, "/HOST/NAME", "not_found");
-    rc += xpath(int_state, "/HOST/STATE", 0);
+    rc += reader.get(oid, "/HOST/ID", -1);
+    rc += reader.get(name, "/HOST/NAME", "not_found");
+    rc += reader.get(int_state, "/HOST/STATE", 0);
 
-    rc += xpath(im_mad_name, "/HOST/IM_MAD", "not_found");
-    rc += xpath(vmm_mad_name, "/HOST/VM_MAD", "not_found");
-    rc += xpath(tm_mad_name, "/HOST/TM_MAD", "not_found");
+    rc += reader.get(im_mad_name, "/HOST/IM_MAD", "not_found");
+    rc += reader.get(vmm_mad_name, "/HOST/VM_MAD", "not_found");
+    rc += reader.get(tm_mad_name, "/HOST/TM_MAD", "not_found");
 
-    rc += xpath(last_monitored, "/HOST/LAST_MON_TIME", 0);
+    rc += reader.get(last_monitored, "/HOST/LAST_MON_TIME", 0);
 
     state = static_cast<HostState>( int_state );
 
     // Get associated classes
-    ObjectXML::get_nodes("/HOST/HOST_SHARE", content);
-
-    if (content.empty())
-    {
-        return -1;
-    }
+    rc += host_share.from_xml(reader, "/HOST/HOST_SHARE");
 
-    rc += host_share.from_xml_node( content[0] );
+    rc += image_cache.from_xml_node(reader.get_node("/HOST/IMAGE_CACHE"));
 
-    ObjectXML::free_nodes(content);
-    content.clear();
-    
-    ObjectXML::get_nodes("/HOST/TEMPLATE", content);
+    node = reader.get_node("/HOST/TEMPLATE");
 
-    if( content.empty())
+    if( node == 0 )
     {
         return -1;
     }
 
-    rc += obj_template->from_xml_node( content[0] );
-
-    ObjectXML::free_nodes(content);
+    rc += obj_template->from_xml_node( node );
 
     if (rc != 0)
     {
@@ -45,7 +45,7 @@ static void parse_host_arguments(Host *host, string& parsed)
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 
-void HostAllocateHook::do_hook(void *arg)
+void HostAllocateHook::do_hook(const HookEvent& event, void *arg)
 {
     Host *  host;
 
@@ -140,59 +140,65 @@ void HostStateMapHook::remove_host (int id)
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 
-void HostStateHook::do_hook(void *arg)
+bool HostStateHook::needs_object(const HookEvent& event)
 {
-    Host * host;
-    int    rc;
+    int rc;
 
     Host::HostState prev_state, cur_state;
 
-    host = static_cast<Host *>(arg);
+    rc = get_state(event.oid, prev_state);
 
-    if ( host == 0 )
+    if ( rc != 0 )
     {
-        return;
+        return false;
     }
 
-    rc = get_state(host->get_oid(), prev_state);
+    // The host may be in other state now, use the one recorded in the event
+    cur_state = static_cast<Host::HostState>(event.state);
 
-    if ( rc != 0 )
+    if ( prev_state == cur_state ) //Still in the same state
     {
-        return;
+        return false;
     }
 
-    cur_state = host->get_state();
+    return ( cur_state == this->state );
+}
 
-    if ( prev_state == cur_state ) //Still in the same state
+// -----------------------------------------------------------------------------
+
+void HostStateHook::do_hook(const HookEvent& event, void *arg)
+{
+    Host * host;
+
+    host = static_cast<Host *>(arg);
+
+    if ( host == 0 || needs_object(event) == false )
     {
         return;
     }
 
-    if ( cur_state == this->state )
-    {
-        string  parsed_args = args;
+    string  parsed_args = args;
 
-        parse_host_arguments(host,parsed_args);
+    parse_host_arguments(host,parsed_args);
 
-        Nebula& ne        = Nebula::instance();
-        HookManager * hm  = ne.get_hm();
+    Nebula& ne        = Nebula::instance();
+    HookManager * hm  = ne.get_hm();
 
-        const HookManagerDriver * hmd = hm->get();
+    const HookManagerDriver * hmd = hm->get();
 
-        if ( hmd != 0 )
+    if ( hmd != 0 )
+    {
+        if ( remote == true)
         {
-            if ( remote == true)
-            {
-                hmd->execute(host->get_oid(),
-                             name,
-                             host->get_name(),
-                             cmd,
-                             parsed_args);
-            }
-            else
-            {
-                hmd->execute(host->get_oid(),name,cmd,parsed_args);
-            }
+            hmd->execute(host->get_oid(),
+                         name,
+                         host->get_name(),
+                         cmd,
+                         parsed_args);
+        }
+        else
+        {
+            hmd->execute(host->get_oid(),name,cmd,parsed_args);
         }
     }
 }
@@ -200,16 +206,14 @@ void HostStateHook::do_hook(void *arg)
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 
-void HostUpdateStateHook::do_hook(void *arg)
+void HostUpdateStateHook::do_hook(const HookEvent& event, void *arg)
 {
-    Host * host = static_cast<Host *>(arg);
-
-    if ( host == 0 )
+    if ( event.oid == -1 )
     {
         return;
     }
 
-    update_state(host->get_oid(), host->get_state());
+    update_state(event.oid, static_cast<Host::HostState>(event.state));
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,301 @@
+/* ------------------------------------------------------------------------ */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)           */
+/*                                                                          */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may  */
+/* not use this file except in compliance with the License. You may obtain  */
+/* a copy of the License at                                                 */
+/*                                                                          */
+/* http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                          */
+/* Unless required by applicable law or agreed to in writing, software      */
+/* distributed under the License is distributed on an "AS IS" BASIS,        */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and      */
+/* limitations under the License.                                           */
+/* ------------------------------------------------------------------------ */
+
+#include <stdlib.h>
+#include <algorithm>
+
+#include "HostImageCache.h"
+
+/* ------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------ */
+
+HostImageCache::EntryState HostImageCache::lookup(
+        int           iid,
+        const string& source,
+        time_t        now)
+{
+    map<int, Entry>::iterator it = images.find(iid);
+
+    if ( it == images.end() )
+    {
+        return MISS;
+    }
+
+    if ( it->second.vid != -1 )
+    {
+        return FILLING;
+    }
+
+    if ( it->second.source != source )
+    {
+        return MISS;
+    }
+
+    it->second.last_used = now;
+
+    return READY;
+}
+
+/* ------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------ */
+
+int HostImageCache::add(int            iid,
+                        const string&  source,
+                        int            size,
+                        int            vid,
+                        int            quota,
+                        time_t         now,
+                        vector<int>&   evicted)
+{
+    map<int, Entry>::iterator it;
+
+    vector<pair<time_t,int> > lru;
+    int                       needed;
+    Entry                     entry;
+
+    if ( size < 0 || size > quota )
+    {
+        return -1;
+    }
+
+    // A stale copy of the image is overwritten by the new one
+    it = images.find(iid);
+
+    if ( it != images.end() )
+    {
+        if ( it->second.vid != -1 )
+        {
+            return -1;
+        }
+
+        cache_size -= it->second.size;
+
+        images.erase(it);
+    }
+
+    // Select the least recently used images to make room for the new one
+    needed = cache_size + size - quota;
+
+    if ( needed > 0 )
+    {
+        for ( it = images.begin(); it != images.end(); it++ )
+        {
+            if ( it->second.vid == -1 &&
+                 it->second.last_used + EVICT_GRACE <= now )
+            {
+                lru.push_back(make_pair(it->second.last_used, it->first));
+            }
+        }
+
+        sort(lru.begin(), lru.end());
+
+        vector<pair<time_t,int> >::iterator jt;
+        int freed = 0;
+
+        for ( jt = lru.begin(); jt != lru.end() && freed < needed; jt++ )
+        {
+            freed += images[jt->second].size;
+        }
+
+        if ( freed < needed )
+        {
+            return -1;
+        }
+
+        for ( vector<pair<time_t,int> >::iterator kt = lru.begin();
+              kt != jt;
+              kt++ )
+        {
+            it = images.find(kt->second);
+
+            cache_size -= it->second.size;
+
+            images.erase(it);
+
+            evicted.push_back(kt->second);
+        }
+    }
+
+    entry.source    = source;
+    entry.size      = size;
+    entry.last_used = now;
+    entry.vid       = vid;
+
+    images.insert(make_pair(iid, entry));
+
+    cache_size += size;
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------ */
+
+int HostImageCache::ready(int vid)
+{
+    map<int, Entry>::iterator it;
+    int num = 0;
+
+    for ( it = images.begin(); it != images.end(); it++ )
+    {
+        if ( it->second.vid == vid )
+        {
+            it->second.vid = -1;
+            num++;
+        }
+    }
+
+    return num;
+}
+
+/* ------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------ */
+
+int HostImageCache::drop(int vid)
+{
+    map<int, Entry>::iterator it;
+    int num = 0;
+
+    for ( it = images.begin(); it != images.end(); )
+    {
+        if ( it->second.vid == vid )
+        {
+            cache_size -= it->second.size;
+
+            images.erase(it++);
+            num++;
+        }
+        else
+        {
+            it++;
+        }
+    }
+
+    return num;
+}
+
+/* ------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------ */
+
+void HostImageCache::to_xml(XMLWriter& xml) const
+{
+    map<int, Entry>::const_iterator it;
+
+    xml.open("IMAGE_CACHE")
+        .add("SIZE", cache_size);
+
+    for ( it = images.begin(); it != images.end(); it++ )
+    {
+        xml.open("IMAGE")
+            .add("ID",        it->first)
+            .add("SOURCE",    it->second.source)
+            .add("SIZE",      it->second.size)
+            .add("LAST_USED", it->second.last_used)
+            .add("VID",       it->second.vid)
+        .close("IMAGE");
+    }
+
+    xml.close("IMAGE_CACHE");
+}
+
+/* ------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------ */
+
+int HostImageCache::from_xml_node(const xmlNodePtr node)
+{
+    xmlNodePtr image;
+    xmlNodePtr attr;
+
+    images.clear();
+    cache_size = 0;
+
+    if ( node == 0 )
+    {
+        return 0;
+    }
+
+    for (image = node->children; image != 0; image = image->next)
+    {
+        int    iid = -1;
+        Entry  entry;
+
+        if ( image->type != XML_ELEMENT_NODE ||
+             xmlStrcmp(image->name, reinterpret_cast<const xmlChar *>("IMAGE")))
+        {
+            continue;
+        }
+
+        entry.size      = 0;
+        entry.last_used = 0;
+        entry.vid       = -1;
+
+        for (attr = image->children; attr != 0; attr = attr->next)
+        {
+            xmlChar * content;
+            string    name;
+            string    value;
+
+            if ( attr->type != XML_ELEMENT_NODE )
+            {
+                continue;
+            }
+
+            name    = reinterpret_cast<const char *>(attr->name);
+            content = xmlNodeGetContent(attr);
+
+            if ( content != 0 )
+            {
+                value = reinterpret_cast<const char *>(content);
+                xmlFree(content);
+            }
+
+            if ( name == "ID" )
+            {
+                iid = atoi(value.c_str());
+            }
+            else if ( name == "SOURCE" )
+            {
+                entry.source = value;
+            }
+            else if ( name == "SIZE" )
+            {
+                entry.size = atoi(value.c_str());
+            }
+            else if ( name == "LAST_USED" )
+            {
+                entry.last_used = static_cast<time_t>(atol(value.c_str()));
+            }
+            else if ( name == "VID" )
+            {
+                entry.vid = atoi(value.c_str());
+            }
+        }
+
+        if ( iid == -1 )
+        {
+            return -1;
+        }
+
+        images.insert(make_pair(iid, entry));
+
+        cache_size += entry.size;
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------ */
@@ -60,57 +60,58 @@ ostream& operator<<(ostream& os, HostShare& hs)
 
 string& HostShare::to_xml(string& xml) const
 {
-    string template_xml;
-    ostringstream   oss;
-
-    oss << "<HOST_SHARE>"
-          << "<DISK_USAGE>" << disk_usage << "</DISK_USAGE>"
-          << "<MEM_USAGE>"  << mem_usage  << "</MEM_USAGE>"
-          << "<CPU_USAGE>"  << cpu_usage  << "</CPU_USAGE>"
-          << "<MAX_DISK>"   << max_disk   << "</MAX_DISK>"
-          << "<MAX_MEM>"    << max_mem    << "</MAX_MEM>"
-          << "<MAX_CPU>"    << max_cpu    << "</MAX_CPU>"
-          << "<FREE_DISK>"  << free_disk  << "</FREE_DISK>"
-          << "<FREE_MEM>"   << free_mem   << "</FREE_MEM>"
-          << "<FREE_CPU>"   << free_cpu   << "</FREE_CPU>"
-          << "<USED_DISK>"  << used_disk  << "</USED_DISK>"
-          << "<USED_MEM>"   << used_mem   << "</USED_MEM>"
-          << "<USED_CPU>"   << used_cpu   << "</USED_CPU>"
-          << "<RUNNING_VMS>"<<running_vms <<"</RUNNING_VMS>"
-        << "</HOST_SHARE>";
-
-    xml = oss.str();
-
-    return xml;
+    XMLWriter writer(512);
+
+    to_xml(writer);
+
+    return writer.swap(xml);
+}
+
+/* ------------------------------------------------------------------------ */
+
+void HostShare::to_xml(XMLWriter& xml) const
+{
+    xml.open("HOST_SHARE")
+        .add("DISK_USAGE",  disk_usage)
+        .add("MEM_USAGE",   mem_usage)
+        .add("CPU_USAGE",   cpu_usage)
+        .add("MAX_DISK",    max_disk)
+        .add("MAX_MEM",     max_mem)
+        .add("MAX_CPU",     max_cpu)
+        .add("FREE_DISK",   free_disk)
+        .add("FREE_MEM",    free_mem)
+        .add("FREE_CPU",    free_cpu)
+        .add("USED_DISK",   used_disk)
+        .add("USED_MEM",    used_mem)
+        .add("USED_CPU",    used_cpu)
+        .add("RUNNING_VMS", running_vms)
+    .close("HOST_SHARE");
 }
 
 /* ------------------------------------------------------------------------ */
 /* ------------------------------------------------------------------------ */
 
-int HostShare::from_xml_node(const xmlNodePtr node)
+int HostShare::from_xml(const XMLReader& reader, const string& root)
 {
     int rc = 0;
 
-    // Initialize the internal XML object
-    ObjectXML::update_from_node(node);
-
-    rc += xpath(disk_usage, "/HOST_SHARE/DISK_USAGE", -1);
-    rc += xpath(mem_usage,  "/HOST_SHARE/MEM_USAGE",  -1);
-    rc += xpath(cpu_usage,  "/HOST_SHARE/CPU_USAGE",  -1);
+    rc += reader.get(disk_usage, root + "/DISK_USAGE", -1);
+    rc += reader.get(mem_usage,  root + "/MEM_USAGE",  -1);
+    rc += reader.get(cpu_usage,  root + "/CPU_USAGE",  -1);
 
-    rc += xpath(max_disk,   "/HOST_SHARE/MAX_DISK",   -1);
-    rc += xpath(max_mem ,   "/HOST_SHARE/MAX_MEM",    -1);
-    rc += xpath(max_cpu ,   "/HOST_SHARE/MAX_CPU",    -1);
+    rc += reader.get(max_disk,   root + "/MAX_DISK",   -1);
+    rc += reader.get(max_mem ,   root + "/MAX_MEM",    -1);
+    rc += reader.get(max_cpu ,   root + "/MAX_CPU",    -1);
 
-    rc += xpath(free_disk,  "/HOST_SHARE/FREE_DISK",  -1);
-    rc += xpath(free_mem ,  "/HOST_SHARE/FREE_MEM",   -1);
-    rc += xpath(free_cpu ,  "/HOST_SHARE/FREE_CPU",   -1);
+    rc += reader.get(free_disk,  root + "/FREE_DISK",  -1);
+    rc += reader.get(free_mem ,  root + "/FREE_MEM",   -1);
+    rc += reader.get(free_cpu ,  root + "/FREE_CPU",   -1);
 
-    rc += xpath(used_disk,  "/HOST_SHARE/USED_DISK",  -1);
-    rc += xpath(used_mem ,  "/HOST_SHARE/USED_MEM",   -1);
-    rc += xpath(used_cpu ,  "/HOST_SHARE/USED_CPU",   -1);
+    rc += reader.get(used_disk,  root + "/USED_DISK",  -1);
+    rc += reader.get(used_mem ,  root + "/USED_MEM",   -1);
+    rc += reader.get(used_cpu ,  root + "/USED_CPU",   -1);
 
-    rc += xpath(running_vms,"/HOST_SHARE/RUNNING_VMS",-1);
+    rc += reader.get(running_vms,root + "/RUNNING_VMS",-1);
 
     if (rc != 0)
     {
@@ -38,7 +38,8 @@ const string xmls[] =
     "<MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CPU>"
     "<FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU>"
     "<USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU>"
-    "<RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST>",
+    "<RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST>",
 
     "<HOST><ID>1</ID><NAME>Second host</NAME><STATE>0</STATE>"
     "<IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</VM_MAD><TM_MAD>tm_mad</TM_MAD>"
@@ -47,7 +48,8 @@ const string xmls[] =
     "<MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CPU>"
     "<FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU>"
     "<USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU>"
-    "<RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST>"
+    "<RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST>"
 };
 
 // This xml dump result has the LAST_MON_TIMEs modified to 0000000000
@@ -58,35 +60,40 @@ const string xml_dump =
     "_USAGE>0</MEM_USAGE><CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM"
     ">0</MAX_MEM><MAX_CPU>0</MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_"
     "MEM><FREE_CPU>0</FREE_CPU><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><U"
-    "SED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST><HOST>"
+    "SED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST><HOST>"
     "<ID>1</ID><NAME>a name</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MA"
     "D>vmm_mad</VM_MAD><TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_M"
     "ON_TIME><HOST_SHARE><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</ME"
     "M_USAGE><CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM>"
     "<MAX_CPU>0</MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CP"
     "U>0</FREE_CPU><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</U"
-    "SED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST><HOST><ID>2</ID><N"
+    "SED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST><HOST><ID>2</ID><N"
     "AME>a_name</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</V"
     "M_MAD><TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><HOS"
     "T_SHARE><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU"
     "_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</"
     "MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CP"
     "U><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUN"
-    "NING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST><HOST><ID>3</ID><NAME>another "
+    "NING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST><HOST><ID>3</ID><NAME>another "
     "name</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</VM_MAD>"
     "<TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><HOST_SHAR"
     "E><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU_USAGE"
     ">0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CP"
     "U><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU><USE"
     "D_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUNNING_V"
-    "MS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST><HOST><ID>4</ID><NAME>host</NAME><ST"
+    "MS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST><HOST><ID>4</ID><NAME>host</NAME><ST"
     "ATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</VM_MAD><TM_MAD>tm_mad"
     "</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><HOST_SHARE>"
     "<DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU_USAGE>0</CPU_USAGE>"
     "<MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CPU><FREE_DISK>0"
     "</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU><USED_DISK>0</USED"
     "_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_"
-    "VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST></HOST_POOL>";
+    "VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST></HOST_POOL>";
 
 const string xml_dump_like_a =
     "<HOST_POOL><HOST><ID>0</ID><NAME>a</NAME><STATE>0</STATE><IM_MAD>im_mad</I"
@@ -95,34 +102,40 @@ const string xml_dump_like_a =
     "_USAGE>0</MEM_USAGE><CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM"
     ">0</MAX_MEM><MAX_CPU>0</MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_"
     "MEM><FREE_CPU>0</FREE_CPU><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><U"
-    "SED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST><HOST>"
+    "SED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST><HOST>"
     "<ID>1</ID><NAME>a name</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MA"
     "D>vmm_mad</VM_MAD><TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_M"
     "ON_TIME><HOST_SHARE><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</ME"
     "M_USAGE><CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM>"
     "<MAX_CPU>0</MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CP"
     "U>0</FREE_CPU><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</U"
-    "SED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST><HOST><ID>2</ID><N"
+    "SED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST><HOST><ID>2</ID><N"
     "AME>a_name</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</V"
     "M_MAD><TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><HOS"
     "T_SHARE><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU"
     "_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</"
     "MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CP"
     "U><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUN"
-    "NING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST><HOST><ID>3</ID><NAME>another "
+    "NING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST><HOST><ID>3</ID><NAME>another "
     "name</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</VM_MAD>"
     "<TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><HOST_SHAR"
     "E><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU_USAGE"
     ">0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CP"
     "U><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU><USE"
     "D_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUNNING_V"
-    "MS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST></HOST_POOL>";
+    "MS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST></HOST_POOL>";
 
 const string host0_updated =
-    "<HOST><ID>0</ID><NAME>Host one</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</VM_MAD><TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><HOST_SHARE><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE><ATT_A><![CDATA[VALUE_A]]></ATT_A><ATT_B><![CDATA[VALUE_B]]></ATT_B></TEMPLATE></HOST>";
+    "<HOST><ID>0</ID><NAME>Host one</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</VM_MAD><TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><HOST_SHARE><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE><ATT_A><![CDATA[VALUE_A]]></ATT_A><ATT_B><![CDATA[VALUE_B]]></ATT_B></TEMPLATE></HOST>";
 
 const string host_0_cluster =
-    "<HOST><ID>0</ID><NAME>Host one</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</VM_MAD><TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><CLUSTER>cluster_a</CLUSTER><HOST_SHARE><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><TEMPLATE></TEMPLATE></HOST>";
+    "<HOST><ID>0</ID><NAME>Host one</NAME><STATE>0</STATE><IM_MAD>im_mad</IM_MAD><VM_MAD>vmm_mad</VM_MAD><TM_MAD>tm_mad</TM_MAD><LAST_MON_TIME>0</LAST_MON_TIME><CLUSTER>cluster_a</CLUSTER><HOST_SHARE><DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE><CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CPU><FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU><USED_DISK>0</USED_DISK><USED_MEM>0</USED_MEM><USED_CPU>0</USED_CPU><RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE>"
+    "<IMAGE_CACHE><SIZE>0</SIZE></IMAGE_CACHE><TEMPLATE></TEMPLATE></HOST>";
 /* ************************************************************************* */
 /* ************************************************************************* */
 
@@ -138,6 +151,8 @@ class HostPoolTest : public PoolTest
     CPPUNIT_TEST (discover);
     CPPUNIT_TEST (duplicates);
     CPPUNIT_TEST (update_info);
+    CPPUNIT_TEST (info_xml_cache);
+    CPPUNIT_TEST (image_cache);
 
 //    CPPUNIT_TEST (scale_test);
 
@@ -230,6 +245,88 @@ public:
 
     /* ********************************************************************* */
 
+    void info_xml_cache()
+    {
+        HostPool * hp = static_cast<HostPool *>(pool);
+        int oid_1 = allocate(0);
+        string xml;
+
+        Host* host = hp->get(oid_1, true);
+        CPPUNIT_ASSERT( host != 0 );
+
+        // The cached XML is the one stored in the DB
+        CPPUNIT_ASSERT( host->info_xml() == host->to_xml(xml) );
+
+        // Setters invalidate it, even before writing the host to the DB
+        host->set_state(Host::DISABLED);
+
+        CPPUNIT_ASSERT( host->info_xml() == host->to_xml(xml) );
+        CPPUNIT_ASSERT( xml.find("<STATE>4</STATE>") != string::npos );
+
+        pool->update(host);
+
+        CPPUNIT_ASSERT( host->info_xml() == host->to_xml(xml) );
+
+        host->unlock();
+    };
+
+    /* ********************************************************************* */
+
+    void image_cache()
+    {
+        HostPool *  hp = static_cast<HostPool *>(pool);
+        int         oid_1 = allocate(0);
+        vector<int> evicted;
+        string      xml;
+
+        Host* host = hp->get(oid_1, true);
+        CPPUNIT_ASSERT( host != 0 );
+
+        HostImageCache& cache = host->get_image_cache();
+
+        // Images are not used until the filling prolog succeeds
+        CPPUNIT_ASSERT( cache.lookup(3, "/img/3", 1000) == HostImageCache::MISS );
+        CPPUNIT_ASSERT( cache.add(3, "/img/3", 60, 10, 100, 1000, evicted) == 0 );
+        CPPUNIT_ASSERT( cache.lookup(3, "/img/3", 1000) ==
+                        HostImageCache::FILLING );
+
+        CPPUNIT_ASSERT( cache.ready(10) == 1 );
+        CPPUNIT_ASSERT( cache.lookup(3, "/img/3", 1000) == HostImageCache::READY );
+
+        // A new version of the image is not in the cache
+        CPPUNIT_ASSERT( cache.lookup(3, "/img/3.b", 1000) == HostImageCache::MISS );
+
+        // Recently used images are not evicted
+        CPPUNIT_ASSERT( cache.add(5, "/img/5", 50, 11, 100, 1100, evicted) == -1 );
+        CPPUNIT_ASSERT( evicted.empty() );
+
+        CPPUNIT_ASSERT( cache.add(5, "/img/5", 50, 11, 100, 2000, evicted) == 0 );
+        CPPUNIT_ASSERT( evicted.size() == 1 );
+        CPPUNIT_ASSERT( evicted[0] == 3 );
+        CPPUNIT_ASSERT( cache.get_size() == 50 );
+
+        // The cache is stored with the host
+        pool->update(host);
+        host->unlock();
+
+        pool->clean();
+
+        host = hp->get(oid_1, false);
+        CPPUNIT_ASSERT( host != 0 );
+
+        host->to_xml(xml);
+        CPPUNIT_ASSERT( xml.find("<IMAGE_CACHE><SIZE>50</SIZE><IMAGE><ID>5</ID>"
+                        "<SOURCE>/img/5</SOURCE><SIZE>50</SIZE><LAST_USED>2000"
+                        "</LAST_USED><VID>11</VID></IMAGE></IMAGE_CACHE>")
+                        != string::npos );
+
+        // A failed prolog removes the images it was copying
+        CPPUNIT_ASSERT( host->get_image_cache().drop(11) == 1 );
+        CPPUNIT_ASSERT( host->get_image_cache().get_size() == 0 );
+    };
+
+    /* ********************************************************************* */
+
     void duplicates()
     {
         int rc, oid_0, oid_1;
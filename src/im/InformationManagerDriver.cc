@@ -16,6 +16,7 @@
 
 #include "InformationManagerDriver.h"
 #include "NebulaLog.h"
+#include "Nebula.h"
 #include <sstream>
 
 
@@ -96,10 +97,9 @@ void InformationManagerDriver::protocol(
 
         if (result == "SUCCESS")
         {
-            size_t  pos;
-            int     rc;
-
-            ostringstream oss;
+            size_t          pos;
+            int             rc;
+            MonitorStore *  store;
 
             getline (is,hinfo);
 
@@ -110,8 +110,8 @@ void InformationManagerDriver::protocol(
 
             hinfo += "\n";
 
-            oss << "Host " << id << " successfully monitored."; 
-            NebulaLog::log("InM",Log::DEBUG,oss);
+            NEBULA_LOG("InM", Log::DEBUG,
+                       "Host " << id << " successfully monitored.");
 
             rc = host->update_info(hinfo);
 
@@ -119,6 +119,19 @@ void InformationManagerDriver::protocol(
             {
                 goto error_parse_info;
             }
+
+            store = Nebula::instance().get_monitor_store();
+
+            if ( store != 0 )
+            {
+                int values[MonitorStore::NUM_VALUES] = {
+                        host->get_share_used_mem(),
+                        host->get_share_used_cpu(),
+                        host->get_share_free_mem(),
+                        host->get_share_free_cpu()};
+
+                store->add(MonitorStore::HOST, id, time(0), values);
+            }
         }
         else
         {
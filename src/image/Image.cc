@@ -291,6 +291,8 @@ int Image::insert_replace(SqlDB *db, bool replace)
 
     rc = db->exec(oss);
 
+    update_xml_cache(&xml_body);
+
     db->free_str(sql_name);
     db->free_str(sql_xml);
 
@@ -308,33 +310,31 @@ error_name:
 
 string& Image::to_xml(string& xml) const
 {
-    string template_xml;
-    ostringstream   oss;
-
-    oss <<
-        "<IMAGE>" <<
-            "<ID>"             << oid             << "</ID>"          <<
-            "<UID>"            << uid             << "</UID>"         <<
-            "<GID>"            << gid             << "</GID>"         <<
-            "<UNAME>"          << uname           << "</UNAME>"       << 
-            "<GNAME>"          << gname           << "</GNAME>"       <<
-            "<NAME>"           << name            << "</NAME>"        <<
-            "<TYPE>"           << type            << "</TYPE>"        <<
-            "<PUBLIC>"         << public_obj      << "</PUBLIC>"      <<
-            "<PERSISTENT>"     << persistent_img  << "</PERSISTENT>"  <<
-            "<REGTIME>"        << regtime         << "</REGTIME>"     <<
-            "<SOURCE>"         << source          << "</SOURCE>"      <<
-            "<PATH>"           << path            << "</PATH>"        <<
-            "<FSTYPE>"         << fs_type         << "</FSTYPE>"      <<
-            "<SIZE>"           << size_mb         << "</SIZE>"        <<
-            "<STATE>"          << state           << "</STATE>"       <<
-            "<RUNNING_VMS>"    << running_vms     << "</RUNNING_VMS>" <<
-            obj_template->to_xml(template_xml)                        <<
-        "</IMAGE>";
-
-    xml = oss.str();
-
-    return xml;
+    XMLWriter writer(2048);
+
+    writer.open("IMAGE")
+        .add("ID",          oid)
+        .add("UID",         uid)
+        .add("GID",         gid)
+        .add("UNAME",       uname)
+        .add("GNAME",       gname)
+        .add("NAME",        name)
+        .add("TYPE",        static_cast<int>(type))
+        .add("PUBLIC",      public_obj)
+        .add("PERSISTENT",  persistent_img)
+        .add("REGTIME",     regtime)
+        .add("SOURCE",      source)
+        .add("PATH",        path)
+        .add("FSTYPE",      fs_type)
+        .add("SIZE",        size_mb)
+        .add("STATE",       static_cast<int>(state))
+        .add("RUNNING_VMS", running_vms);
+
+    obj_template->to_xml(writer);
+
+    writer.close("IMAGE");
+
+    return writer.swap(xml);
 }
 
 /* ------------------------------------------------------------------------ */
@@ -342,53 +342,58 @@ string& Image::to_xml(string& xml) const
 
 int Image::from_xml(const string& xml)
 {
-    vector<xmlNodePtr> content;
+    XMLReader  reader;
+    xmlNodePtr node;
+
+    const char * nodes[] = {"/IMAGE/TEMPLATE", 0};
+
     int int_state;
     int int_type;
 
     int rc = 0;
 
-    // Initialize the internal XML object
-    update_from_str(xml);
+    // Read the document in a single pass, only the template is kept as DOM
+    if ( reader.parse(xml, nodes) != 0 )
+    {
+        return -1;
+    }
 
     // Get class base attributes
-    rc += xpath(oid, "/IMAGE/ID",  -1);
-    rc += xpath(uid, "/IMAGE/UID", -1);
-    rc += xpath(gid, "/IMAGE/GID", -1);
+    rc += reader.get(oid, "/IMAGE/ID",  -1);
+    rc += reader.get(uid, "/IMAGE/UID", -1);
+    rc += reader.get(gid, "/IMAGE/GID", -1);
 
-    rc += xpath(uname, "/IMAGE/UNAME", "not_found");
-    rc += xpath(gname, "/IMAGE/GNAME", "not_found");
+    rc += reader.get(uname, "/IMAGE/UNAME", "not_found");
+    rc += reader.get(gname, "/IMAGE/GNAME", "not_found");
 
-    rc += xpath(name, "/IMAGE/NAME", "not_found");
+    rc += reader.get(name, "/IMAGE/NAME", "not_found");
 
-    rc += xpath(int_type, "/IMAGE/TYPE", 0);
-    rc += xpath(public_obj, "/IMAGE/PUBLIC", 0);
-    rc += xpath(persistent_img, "/IMAGE/PERSISTENT", 0);
-    rc += xpath(regtime, "/IMAGE/REGTIME", 0);
+    rc += reader.get(int_type, "/IMAGE/TYPE", 0);
+    rc += reader.get(public_obj, "/IMAGE/PUBLIC", 0);
+    rc += reader.get(persistent_img, "/IMAGE/PERSISTENT", 0);
+    rc += reader.get(regtime, "/IMAGE/REGTIME", 0);
+
+    rc += reader.get(source, "/IMAGE/SOURCE", "not_found");
+    rc += reader.get(size_mb, "/IMAGE/SIZE", 0);
+    rc += reader.get(int_state, "/IMAGE/STATE", 0);
+    rc += reader.get(running_vms, "/IMAGE/RUNNING_VMS", -1);
 
-    rc += xpath(source, "/IMAGE/SOURCE", "not_found");
-    rc += xpath(size_mb, "/IMAGE/SIZE", 0);
-    rc += xpath(int_state, "/IMAGE/STATE", 0);
-    rc += xpath(running_vms, "/IMAGE/RUNNING_VMS", -1);
-    
     //Optional image attributes
-    xpath(path,"/IMAGE/PATH", "");
-    xpath(fs_type,"/IMAGE/FSTYPE","");
+    reader.get(path,"/IMAGE/PATH", "");
+    reader.get(fs_type,"/IMAGE/FSTYPE","");
 
     type  = static_cast<ImageType>(int_type);
     state = static_cast<ImageState>(int_state);
 
     // Get associated classes
-    ObjectXML::get_nodes("/IMAGE/TEMPLATE", content);
+    node = reader.get_node("/IMAGE/TEMPLATE");
 
-    if (content.empty())
+    if (node == 0)
     {
         return -1;
     }
 
-    rc += obj_template->from_xml_node(content[0]);
-
-    ObjectXML::free_nodes(content);
+    rc += obj_template->from_xml_node(node);
 
     if (rc != 0)
     {
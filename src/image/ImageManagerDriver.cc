@@ -95,8 +95,7 @@ void ImageManagerDriver::protocol(
 
     string        info;
 
-    os << "Message received: " << message;
-    NebulaLog::log("ImG", Log::DEBUG, os);
+    NEBULA_LOG("ImG", Log::DEBUG, "Message received: " << message);
 
     // Parse the driver message
     if ( is.good() )
@@ -0,0 +1,467 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "LogWriter.h"
+
+#include <cstring>
+#include <algorithm>
+#include <signal.h>
+#include <sched.h>
+#include <sys/time.h>
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+const unsigned int LogWriter::DEFAULT_BUFFER_SIZE = 4096;
+
+const time_t LogWriter::IDLE_TIME      = 60;
+
+const long   LogWriter::DRAIN_INTERVAL = 100;
+
+volatile bool LogWriter::running      = false;
+
+volatile int  LogWriter::writers      = 0;
+
+volatile bool LogWriter::stopping     = false;
+
+volatile bool LogWriter::reopen_files = false;
+
+unsigned int  LogWriter::buffer_size  = LogWriter::DEFAULT_BUFFER_SIZE;
+
+string        LogWriter::main_file;
+
+unsigned long LogWriter::dropped      = 0;
+
+pthread_t     LogWriter::writer_thread;
+
+pthread_key_t LogWriter::buffer_key;
+
+pthread_once_t LogWriter::buffer_key_once = PTHREAD_ONCE_INIT;
+
+pthread_mutex_t LogWriter::writer_mutex  = PTHREAD_MUTEX_INITIALIZER;
+
+pthread_cond_t  LogWriter::writer_cond   = PTHREAD_COND_INITIALIZER;
+
+pthread_mutex_t LogWriter::buffers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+vector<LogWriter::Buffer *> LogWriter::buffers;
+
+map<string, LogWriter::File> LogWriter::files;
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int LogWriter::start(const string& _main_file, unsigned int _buffer_size)
+{
+    sigset_t    mask;
+    sigset_t    old_mask;
+    int         rc;
+
+    if ( running )
+    {
+        return 0;
+    }
+
+    main_file   = _main_file;
+    buffer_size = _buffer_size > 1 ? _buffer_size : DEFAULT_BUFFER_SIZE;
+
+    stopping     = false;
+    reopen_files = false;
+
+    // The key is kept after stop(), the buffers are reused by the next start
+    pthread_once(&buffer_key_once, LogWriter::create_buffer_key);
+
+    // The writer thread does not handle any signal
+    sigfillset(&mask);
+
+    pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+
+    running = true;
+
+    rc = pthread_create(&writer_thread, 0, LogWriter::writer_loop, 0);
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, 0);
+
+    if ( rc != 0 )
+    {
+        running = false;
+
+        return -1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void LogWriter::stop()
+{
+    if ( !running )
+    {
+        return;
+    }
+
+    // No new messages are queued, wait for the ones being queued
+    running = false;
+
+    __sync_synchronize();
+
+    while ( writers > 0 )
+    {
+        sched_yield();
+    }
+
+    // The writer thread drains the buffers once more before exiting
+    pthread_mutex_lock(&writer_mutex);
+
+    stopping = true;
+
+    pthread_cond_signal(&writer_cond);
+
+    pthread_mutex_unlock(&writer_mutex);
+
+    pthread_join(writer_thread, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void LogWriter::reopen()
+{
+    reopen_files = true;
+
+    pthread_cond_signal(&writer_cond);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void LogWriter::create_buffer_key()
+{
+    pthread_key_create(&buffer_key, LogWriter::orphan_buffer);
+}
+
+/* -------------------------------------------------------------------------- */
+
+LogWriter::Buffer * LogWriter::get_buffer()
+{
+    Buffer * buffer;
+
+    buffer = static_cast<Buffer *>(pthread_getspecific(buffer_key));
+
+    if ( buffer == 0 )
+    {
+        buffer = new Buffer(buffer_size);
+
+        pthread_mutex_lock(&buffers_mutex);
+
+        buffers.push_back(buffer);
+
+        pthread_mutex_unlock(&buffers_mutex);
+
+        pthread_setspecific(buffer_key, buffer);
+    }
+
+    return buffer;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void LogWriter::orphan_buffer(void * buffer)
+{
+    __sync_synchronize();
+
+    static_cast<Buffer *>(buffer)->orphan = true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+bool LogWriter::write(const string&          file,
+                      const char *           module,
+                      const Log::MessageType type,
+                      const char *           message)
+{
+    Buffer *     buffer;
+    Record *     record;
+    unsigned int head;
+    unsigned int next;
+    unsigned int used;
+
+    // stop() waits for the messages being queued, running is checked after
+    // writers is incremented (full barrier)
+    __sync_fetch_and_add(&writers, 1);
+
+    if ( !running )
+    {
+        __sync_fetch_and_sub(&writers, 1);
+        return false;
+    }
+
+    buffer = get_buffer();
+
+    head = buffer->head;
+    next = (head + 1) % buffer->size;
+
+    if ( next == buffer->tail )
+    {
+        buffer->dropped++;
+
+        __sync_fetch_and_sub(&writers, 1);
+        return true;
+    }
+
+    record = &(buffer->records[head]);
+
+    record->file    = file;
+    record->time    = time(0);
+    record->type    = type;
+    record->message = message;
+
+    strncpy(record->module, module, sizeof(record->module) - 1);
+    record->module[sizeof(record->module) - 1] = '\0';
+
+    // The record must be complete before the writer can see it
+    __sync_synchronize();
+
+    buffer->head = next;
+
+    used = (next + buffer->size - buffer->tail) % buffer->size;
+
+    // Errors and half full buffers are written without waiting the interval
+    if ( type == Log::ERROR || used == buffer->size / 2 )
+    {
+        pthread_cond_signal(&writer_cond);
+    }
+
+    __sync_fetch_and_sub(&writers, 1);
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void * LogWriter::writer_loop(void * arg)
+{
+    struct timeval  now;
+    struct timespec timeout;
+    bool            done;
+
+    do
+    {
+        gettimeofday(&now, 0);
+
+        timeout.tv_sec  = now.tv_sec  + DRAIN_INTERVAL / 1000;
+        timeout.tv_nsec = now.tv_usec * 1000
+                        + (DRAIN_INTERVAL % 1000) * 1000000;
+
+        if ( timeout.tv_nsec >= 1000000000 )
+        {
+            timeout.tv_sec  += 1;
+            timeout.tv_nsec -= 1000000000;
+        }
+
+        pthread_mutex_lock(&writer_mutex);
+
+        if ( !stopping )
+        {
+            pthread_cond_timedwait(&writer_cond, &writer_mutex, &timeout);
+        }
+
+        done = stopping;
+
+        pthread_mutex_unlock(&writer_mutex);
+
+        if ( reopen_files )
+        {
+            reopen_files = false;
+
+            close_files(true, 0);
+        }
+
+        drain(time(0));
+
+        close_files(false, time(0));
+    }
+    while (!done);
+
+    close_files(true, 0);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void LogWriter::drain(time_t now)
+{
+    vector<Buffer *>           active;
+    vector<Buffer *>           orphans;
+    vector<Buffer *>::iterator it;
+    unsigned long              dropped_now = 0;
+
+    // Buffers are only freed by this thread, no need to hold the lock while
+    // writing the messages
+
+    pthread_mutex_lock(&buffers_mutex);
+
+    active = buffers;
+
+    pthread_mutex_unlock(&buffers_mutex);
+
+    for (it = active.begin(); it != active.end(); it++)
+    {
+        Buffer * buffer = *it;
+        bool     orphan = buffer->orphan;
+
+        __sync_synchronize();
+
+        while ( buffer->tail != buffer->head )
+        {
+            Record * record = &(buffer->records[buffer->tail]);
+            char     type   = 'D';
+
+            if ( record->type <= Log::DEBUG )
+            {
+                type = Log::error_names[record->type];
+            }
+
+            write_line(record->file, record->time, record->module, type,
+                       record->message, now);
+
+            // The record can be reused once the tail is moved
+            __sync_synchronize();
+
+            buffer->tail = (buffer->tail + 1) % buffer->size;
+        }
+
+        dropped_now     += buffer->dropped - buffer->reported;
+        buffer->reported = buffer->dropped;
+
+        if ( orphan )
+        {
+            orphans.push_back(buffer);
+        }
+    }
+
+    if ( !orphans.empty() )
+    {
+        pthread_mutex_lock(&buffers_mutex);
+
+        for (it = orphans.begin(); it != orphans.end(); it++)
+        {
+            buffers.erase(find(buffers.begin(), buffers.end(), *it));
+        }
+
+        pthread_mutex_unlock(&buffers_mutex);
+
+        for (it = orphans.begin(); it != orphans.end(); it++)
+        {
+            delete *it;
+        }
+    }
+
+    if ( dropped_now > 0 )
+    {
+        char message[80];
+
+        dropped += dropped_now;
+
+        snprintf(message, sizeof(message),
+                 "%lu log messages dropped, log buffers are full.",
+                 dropped_now);
+
+        write_line(main_file, now, "ONE", 'W', message, now);
+    }
+
+    for (map<string, File>::iterator fit = files.begin(); fit != files.end();
+         fit++)
+    {
+        if ( fit->second.last_write == now )
+        {
+            fflush(fit->second.fd);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void LogWriter::write_line(const string& file,
+                           time_t        the_time,
+                           const char *  module,
+                           char          type,
+                           const string& message,
+                           time_t        now)
+{
+    static time_t last_time = 0;
+    static char   str[26]   = "";
+
+    map<string, File>::iterator it = files.find(file);
+
+    if ( it == files.end() )
+    {
+        File f;
+
+        f.fd = fopen(file.c_str(), "a");
+
+        if ( f.fd == 0 )
+        {
+            return;
+        }
+
+        it = files.insert(make_pair(file, f)).first;
+    }
+
+    it->second.last_write = now;
+
+    if ( the_time != last_time )
+    {
+#ifdef SOLARIS
+        ctime_r(&(the_time),str,sizeof(char)*26);
+#else
+        ctime_r(&(the_time),str);
+#endif
+        // Get rid of final enter character
+        str[24]   = '\0';
+        last_time = the_time;
+    }
+
+    fprintf(it->second.fd, "%s [%s][%c]: ", str, module, type);
+
+    fwrite(message.data(), 1, message.size(), it->second.fd);
+
+    fputc('\n', it->second.fd);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void LogWriter::close_files(bool all, time_t now)
+{
+    map<string, File>::iterator it;
+
+    for (it = files.begin(); it != files.end(); )
+    {
+        if ( all || now - it->second.last_write > IDLE_TIME )
+        {
+            fclose(it->second.fd);
+
+            files.erase(it++);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
@@ -22,6 +22,8 @@
 
 Log * NebulaLog::logger;
 
+NebulaLog::LogType NebulaLog::log_type = NebulaLog::CERR;
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
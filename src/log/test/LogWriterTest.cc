@@ -0,0 +1,289 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "test/OneUnitTest.h"
+#include "LogWriter.h"
+
+using namespace std;
+
+static const char * MAIN_FILE = "log_writer_test.log";
+static const char * VM_FILE   = "log_writer_vm.log";
+static const char * FIFO_FILE = "log_writer_fifo.log";
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+/**
+ *  Thread that logs messages until the writer is stopped
+ */
+struct Logger
+{
+    pthread_t   thread;
+    int         id;
+    int         queued;
+};
+
+extern "C" void * logger_loop(void *arg)
+{
+    Logger * logger = static_cast<Logger *>(arg);
+
+    for (int i = 0; i < 100000; i++)
+    {
+        ostringstream oss;
+
+        oss << "thread " << logger->id << " message " << i;
+
+        if (LogWriter::write(VM_FILE, "TST", Log::INFO, oss.str().c_str())
+            == false)
+        {
+            break;
+        }
+
+        logger->queued++;
+    }
+
+    return 0;
+}
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class LogWriterTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (LogWriterTest);
+
+    CPPUNIT_TEST (ring_wrap);
+    CPPUNIT_TEST (drop_count);
+    CPPUNIT_TEST (shutdown);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+private:
+
+    /**
+     *  Reads the messages of a log file
+     */
+    static void read_messages(const char * file, vector<string>& messages)
+    {
+        ifstream          is(file);
+        string            line;
+        string::size_type pos;
+
+        messages.clear();
+
+        while ( getline(is, line) )
+        {
+            pos = line.find("]: ");
+
+            if ( pos != string::npos )
+            {
+                messages.push_back(line.substr(pos + 3));
+            }
+        }
+    };
+
+    /**
+     *  Waits (up to 5s) until the file has num messages
+     */
+    static bool wait_messages(const char * file, unsigned int num)
+    {
+        vector<string> messages;
+
+        for (int i = 0; i < 500; i++)
+        {
+            read_messages(file, messages);
+
+            if ( messages.size() >= num )
+            {
+                return true;
+            }
+
+            usleep(10000);
+        }
+
+        return false;
+    };
+
+public:
+    void setUp()
+    {
+        unlink(MAIN_FILE);
+        unlink(VM_FILE);
+        unlink(FIFO_FILE);
+    };
+
+    void tearDown()
+    {
+        LogWriter::stop();
+
+        unlink(MAIN_FILE);
+        unlink(VM_FILE);
+        unlink(FIFO_FILE);
+    };
+
+    /* ********************************************************************* */
+
+    void ring_wrap()
+    {
+        vector<string> messages;
+        unsigned long  dropped = LogWriter::get_dropped();
+
+        CPPUNIT_ASSERT( LogWriter::start(MAIN_FILE, 4) == 0 );
+
+        // 10 messages go through a ring of 4 records, none is lost
+        for (int i = 0; i < 10; i++)
+        {
+            ostringstream oss;
+
+            oss << "message " << i;
+
+            CPPUNIT_ASSERT( LogWriter::write(VM_FILE, "TST", Log::ERROR,
+                                             oss.str().c_str()) == true );
+
+            CPPUNIT_ASSERT( wait_messages(VM_FILE, i + 1) == true );
+        }
+
+        LogWriter::stop();
+
+        read_messages(VM_FILE, messages);
+
+        CPPUNIT_ASSERT( messages.size() == 10 );
+        CPPUNIT_ASSERT( messages[0] == "message 0" );
+        CPPUNIT_ASSERT( messages[4] == "message 4" );
+        CPPUNIT_ASSERT( messages[9] == "message 9" );
+
+        CPPUNIT_ASSERT( LogWriter::get_dropped() == dropped );
+    };
+
+    /* ********************************************************************* */
+
+    void drop_count()
+    {
+        vector<string> messages;
+        unsigned long  dropped = LogWriter::get_dropped();
+        int            fd;
+
+        CPPUNIT_ASSERT( mkfifo(FIFO_FILE, 0600) == 0 );
+
+        CPPUNIT_ASSERT( LogWriter::start(MAIN_FILE, 4) == 0 );
+
+        // The writer blocks opening the FIFO, so the ring is not drained
+        LogWriter::write(FIFO_FILE, "TST", Log::ERROR, "blocked");
+
+        // The ring holds 3 records, the first one is still being written
+        for (int i = 0; i < 10; i++)
+        {
+            ostringstream oss;
+
+            oss << "message " << i;
+
+            CPPUNIT_ASSERT( LogWriter::write(VM_FILE, "TST", Log::INFO,
+                                             oss.str().c_str()) == true );
+        }
+
+        fd = open(FIFO_FILE, O_RDONLY | O_NONBLOCK);
+
+        CPPUNIT_ASSERT( fd != -1 );
+
+        LogWriter::stop();
+
+        close(fd);
+
+        read_messages(VM_FILE, messages);
+
+        CPPUNIT_ASSERT( messages.size() == 2 );
+        CPPUNIT_ASSERT( messages[0] == "message 0" );
+        CPPUNIT_ASSERT( messages[1] == "message 1" );
+
+        CPPUNIT_ASSERT( LogWriter::get_dropped() - dropped == 8 );
+
+        read_messages(MAIN_FILE, messages);
+
+        CPPUNIT_ASSERT( messages.size() == 1 );
+        CPPUNIT_ASSERT( messages[0] ==
+                        "8 log messages dropped, log buffers are full." );
+    };
+
+    /* ********************************************************************* */
+
+    void shutdown()
+    {
+        vector<string> messages;
+        Logger         loggers[4];
+        unsigned long  dropped = LogWriter::get_dropped();
+        unsigned long  queued  = 0;
+
+        CPPUNIT_ASSERT( LogWriter::start(MAIN_FILE, 64) == 0 );
+
+        for (int i = 0; i < 4; i++)
+        {
+            loggers[i].id     = i;
+            loggers[i].queued = 0;
+
+            pthread_create(&loggers[i].thread, 0, logger_loop, &loggers[i]);
+        }
+
+        usleep(50000);
+
+        // The threads keep logging while the writer stops
+        LogWriter::stop();
+
+        for (int i = 0; i < 4; i++)
+        {
+            pthread_join(loggers[i].thread, 0);
+
+            queued += loggers[i].queued;
+        }
+
+        CPPUNIT_ASSERT( LogWriter::write(VM_FILE, "TST", Log::ERROR, "late")
+                        == false );
+
+        // Every message queued before stop() is written or counted as dropped
+        read_messages(VM_FILE, messages);
+
+        CPPUNIT_ASSERT( messages.size() + LogWriter::get_dropped() - dropped
+                        == queued );
+
+        // The buffers of the finished threads are freed by the next writer
+        CPPUNIT_ASSERT( LogWriter::start(MAIN_FILE, 64) == 0 );
+
+        CPPUNIT_ASSERT( LogWriter::write(VM_FILE, "TST", Log::ERROR, "again")
+                        == true );
+
+        LogWriter::stop();
+
+        read_messages(VM_FILE, messages);
+
+        CPPUNIT_ASSERT( messages.back() == "again" );
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+int main(int argc, char ** argv)
+{
+    return OneUnitTest::main(argc, argv, LogWriterTest::suite());
+}
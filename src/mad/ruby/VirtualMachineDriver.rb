@@ -39,6 +39,7 @@ class VirtualMachineDriver < OpenNebulaDriver
         :restore    => "RESTORE",
         :migrate    => "MIGRATE",
         :poll       => "POLL",
+        :poll_host  => "POLL_HOST",
         :log        => "LOG"
     }
 
@@ -83,6 +84,7 @@ class VirtualMachineDriver < OpenNebulaDriver
         register_action(ACTION[:restore].to_sym,    method("restore"))
         register_action(ACTION[:migrate].to_sym,    method("migrate"))
         register_action(ACTION[:poll].to_sym,       method("poll"))
+        register_action(ACTION[:poll_host].to_sym,  method("poll_host"))
     end
 
     # Converts a deployment file from its remote path to the local (front-end)
@@ -153,6 +155,20 @@ class VirtualMachineDriver < OpenNebulaDriver
         send_message(ACTION[:poll],RESULT[:failure],id,error)
     end
 
+    # Polls all the VMs of a host, vms is a list of "vm_id:deploy_id" pairs
+    # separated by commas. The id is negative (-host_id-1), so the poll is
+    # never mixed up with the actions of a VM. The answer MUST be a single
+    # POLL_HOST message with the monitor info of each VM preceded by
+    # VM=vm_id. This implementation polls each VM, drivers should override
+    # it to poll the host at once.
+    def poll_host(id, host, vms, not_used)
+        vms.split(',').each do |vm|
+            vm_id, deploy_id = vm.split(':', 2)
+
+            poll(vm_id, host, deploy_id, not_used)
+        end
+    end
+
 private
     # Interface to handle the pending events from the ActionManager Interface
     def delete_running_action(action_id)
@@ -248,6 +264,19 @@ if __FILE__ == $0
 
             send_message(ACTION[:poll],RESULT[:success],id,monitor_info)
         end
+
+        def poll_host(id, host, vms, not_used)
+            # monitor_info: "VM=ID VAR=VAL ... VAR=VAL VM=ID VAR=VAL ..." with
+            # the information of each VM in the vms list
+            monitor_info = vms.split(',').map do |vm|
+                "VM=#{vm.split(':').first} " \
+                "#{POLL_ATTRIBUTE[:state]}=#{VM_STATE[:active]} " \
+                "#{POLL_ATTRIBUTE[:nettx]}=12345"
+            end
+
+            send_message(ACTION[:poll_host],RESULT[:success],id,
+                monitor_info.join(' '))
+        end
     end
 
     sd = TemplateDriver.new
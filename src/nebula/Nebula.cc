@@ -88,6 +88,9 @@ void Nebula::start()
         string              log_fname;
         int                 log_level_int;
         Log::MessageType    clevel = Log::ERROR;
+        string              log_system;
+        int                 log_buffer_size;
+        NebulaLog::LogType  log_type = NebulaLog::FILE_TS;
 
         log_fname = log_location + "oned.log";
 
@@ -98,12 +101,29 @@ void Nebula::start()
             clevel = static_cast<Log::MessageType>(log_level_int);
         }
 
+        nebula_configuration->get("LOG_SYSTEM", log_system);
+        nebula_configuration->get("LOG_BUFFER_SIZE", log_buffer_size);
+
+        transform(log_system.begin(), log_system.end(), log_system.begin(),
+                  (int(*)(int))tolower);
+
+        if ( log_system == "async" )
+        {
+            log_type = NebulaLog::FILE_ASYNC;
+        }
+
+        if ( log_buffer_size <= 0 )
+        {
+            log_buffer_size = LogWriter::DEFAULT_BUFFER_SIZE;
+        }
+
         // Initializing ONE Daemon log system
 
-        NebulaLog::init_log_system(NebulaLog::FILE_TS,
+        NebulaLog::init_log_system(log_type,
                                    clevel,
                                    log_fname.c_str(),
-                                   ios_base::trunc);
+                                   ios_base::trunc,
+                                   log_buffer_size);
 
         os << "Starting " << version() << endl;
         os << "----------------------------------------\n";
@@ -273,14 +293,70 @@ void Nebula::start()
         string  default_image_type;
         string  default_device_prefix;
         time_t  expiration_time;
+        int     change_log_size;
+        int     polling_delta;
+        int     monitoring_samples;
+        time_t  monitoring_period;
+        time_t  monitoring_expiration;
 
         vector<const Attribute *> vm_hooks;
         vector<const Attribute *> host_hooks;
 
+        nebula_configuration->get("CHANGE_LOG_SIZE", change_log_size);
+
+        if ( change_log_size > 0 )
+        {
+            int max_conn;
+            int max_waiters;
+
+            // Waiting calls hold a server thread, leave most of them free
+            nebula_configuration->get("MAX_CONN", max_conn);
+
+            max_waiters = max_conn / 3;
+
+            if ( max_waiters < 1 )
+            {
+                max_waiters = 1;
+            }
+
+            change_log = new ChangeLog(change_log_size, max_waiters);
+
+            PoolSQL::set_change_log(change_log);
+        }
+
+        nebula_configuration->get("MONITORING_SAMPLES", monitoring_samples);
+
+        if ( monitoring_samples > 0 )
+        {
+            nebula_configuration->get("MONITORING_PERIOD", monitoring_period);
+
+            nebula_configuration->get("MONITORING_EXPIRATION_TIME",
+                                      monitoring_expiration);
+
+            // The table is not created by older DB versions
+            if ( MonitorStore::bootstrap(db) != 0 )
+            {
+                throw runtime_error("Error bootstrapping monitoring table.");
+            }
+
+            monitor_store = new MonitorStore(db,
+                                             monitoring_samples,
+                                             monitoring_period,
+                                             monitoring_expiration);
+
+            if ( monitor_store->start() != 0 )
+            {
+                throw runtime_error("Could not start the Monitor Store");
+            }
+        }
+
         nebula_configuration->get("VM_HOOK", vm_hooks);
         nebula_configuration->get("HOST_HOOK", host_hooks);
 
-        vmpool = new VirtualMachinePool(db, vm_hooks, hook_location);
+        nebula_configuration->get("VM_POLLING_DELTA", polling_delta);
+
+        vmpool = new VirtualMachinePool(db, vm_hooks, hook_location,
+                                        polling_delta);
         hpool  = new HostPool(db, host_hooks, hook_location);
 
         nebula_configuration->get("MAC_PREFIX", mac_prefix);
@@ -483,6 +559,9 @@ void Nebula::start()
        throw runtime_error("Could not start the Hook Manager");
     }
 
+    vmpool->set_hook_queue(hm);
+    hpool->set_hook_queue(hm);
+
     // ---- Auth Manager ----
     try
     {
@@ -557,10 +636,61 @@ void Nebula::start()
     try
     {
         int             rm_port = 0;
+        int             max_conn;
+        int             max_conn_backlog;
+        int             keepalive_timeout;
+        int             keepalive_max_conn;
+        int             timeout;
+        time_t          stats_interval;
+
+        vector<const Attribute *> limits;
+        map<string,int>           method_limits;
 
         nebula_configuration->get("PORT", rm_port);
 
-        rm = new RequestManager(rm_port, log_location + "one_xmlrpc.log");
+        nebula_configuration->get("MAX_CONN", max_conn);
+        nebula_configuration->get("MAX_CONN_BACKLOG", max_conn_backlog);
+        nebula_configuration->get("KEEPALIVE_TIMEOUT", keepalive_timeout);
+        nebula_configuration->get("KEEPALIVE_MAX_CONN", keepalive_max_conn);
+        nebula_configuration->get("TIMEOUT", timeout);
+
+        nebula_configuration->get("XMLRPC_STATS_INTERVAL", stats_interval);
+
+        nebula_configuration->get("METHOD_LIMIT", limits);
+
+        for (unsigned int i = 0 ; i < limits.size() ; i++)
+        {
+            const VectorAttribute * limit;
+            istringstream           is;
+            string                  name;
+            int                     max = 0;
+
+            limit = static_cast<const VectorAttribute *>(limits[i]);
+
+            name = limit->vector_value("NAME");
+
+            is.str(limit->vector_value("MAX_CONCURRENT"));
+            is >> max;
+
+            if ( name.empty() || is.fail() || max <= 0 )
+            {
+                NebulaLog::log("ONE", Log::WARNING,
+                               "Wrong METHOD_LIMIT in oned.conf, ignored.");
+                continue;
+            }
+
+            method_limits[name] = max;
+        }
+
+        rm = new RequestManager(rm_port,
+                                max_conn,
+                                max_conn_backlog,
+                                keepalive_timeout,
+                                keepalive_max_conn,
+                                timeout,
+                                stats_interval,
+                                log_location + "one_xmlrpc.log",
+                                method_limits);
     }
     catch (bad_alloc&)
     {
@@ -594,15 +724,27 @@ void Nebula::start()
     }
 
     // -----------------------------------------------------------
-    // Wait for a SIGTERM or SIGINT signal
+    // Wait for a SIGTERM or SIGINT signal, SIGHUP reopens the logs
     // -----------------------------------------------------------
 
     sigemptyset(&mask);
 
     sigaddset(&mask, SIGINT);
     sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGHUP);
+
+    do
+    {
+        sigwait(&mask, &signal);
+
+        if ( signal == SIGHUP )
+        {
+            NebulaLog::log("ONE",Log::INFO,"SIGHUP received, reopening logs.");
 
-    sigwait(&mask, &signal);
+            LogWriter::reopen();
+        }
+    }
+    while ( signal == SIGHUP );
 
     // -----------------------------------------------------------
     // Stop the managers & free resources
@@ -616,7 +758,6 @@ void Nebula::start()
 
     im->finalize();
     rm->finalize();
-    hm->finalize();
     imagem->finalize();
 
     //sleep to wait drivers???
@@ -628,13 +769,28 @@ void Nebula::start()
 
     pthread_join(im->get_thread_id(),0);
     pthread_join(rm->get_thread_id(),0);
-    pthread_join(hm->get_thread_id(),0);
     pthread_join(imagem->get_thread_id(),0);
 
+    // The hooks of the last state changes are executed before stopping
+    hm->finalize();
+
+    pthread_join(hm->get_thread_id(),0);
+
+    // The drivers are stopped, write the last monitoring samples
+    if ( monitor_store != 0 )
+    {
+        monitor_store->finalize();
+
+        pthread_join(monitor_store->get_thread_id(),0);
+    }
+
     //XML Library
     xmlCleanupParser();
 
     NebulaLog::log("ONE", Log::INFO, "All modules finalized, exiting.\n");
+
+    // Write pending messages, from now on the log is synchronous
+    LogWriter::stop();
 }
 
 /* -------------------------------------------------------------------------- */
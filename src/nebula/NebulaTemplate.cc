@@ -50,11 +50,24 @@ NebulaTemplate::NebulaTemplate(string& etc_location, string& var_location)
 #  HOST_PER_INTERVAL
 #  VM_POLLING_INTERVAL
 #  VM_PER_INTERVAL
+#  VM_POLLING_DELTA
+#  MONITORING_SAMPLES
+#  MONITORING_PERIOD
+#  MONITORING_EXPIRATION_TIME
 #  VM_DIR
 #  PORT
+#  MAX_CONN
+#  MAX_CONN_BACKLOG
+#  KEEPALIVE_TIMEOUT
+#  KEEPALIVE_MAX_CONN
+#  TIMEOUT
+#  XMLRPC_STATS_INTERVAL
+#  CHANGE_LOG_SIZE
 #  DB
 #  VNC_BASE_PORT
 #  SCRIPTS_REMOTE_DIR
+#  LOG_SYSTEM
+#  LOG_BUFFER_SIZE
 #*******************************************************************************
 */
     // MONITOR_INTERVAL
@@ -81,6 +94,30 @@ NebulaTemplate::NebulaTemplate(string& etc_location, string& var_location)
     attribute = new SingleAttribute("VM_PER_INTERVAL",value);
     conf_default.insert(make_pair(attribute->name(),attribute));
 
+    // VM_POLLING_DELTA
+    value = "5";
+
+    attribute = new SingleAttribute("VM_POLLING_DELTA",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    // MONITORING_SAMPLES
+    value = "60";
+
+    attribute = new SingleAttribute("MONITORING_SAMPLES",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    // MONITORING_PERIOD
+    value = "3600";
+
+    attribute = new SingleAttribute("MONITORING_PERIOD",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    // MONITORING_EXPIRATION_TIME
+    value = "604800";
+
+    attribute = new SingleAttribute("MONITORING_EXPIRATION_TIME",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
     //VM_DIR
     attribute = new SingleAttribute("VM_DIR",var_location);
     conf_default.insert(make_pair(attribute->name(),attribute));
@@ -91,6 +128,48 @@ NebulaTemplate::NebulaTemplate(string& etc_location, string& var_location)
     attribute = new SingleAttribute("PORT",value);
     conf_default.insert(make_pair(attribute->name(),attribute));
 
+    //XML-RPC Server MAX_CONN
+    value = "15";
+
+    attribute = new SingleAttribute("MAX_CONN",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    //XML-RPC Server MAX_CONN_BACKLOG
+    value = "15";
+
+    attribute = new SingleAttribute("MAX_CONN_BACKLOG",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    //XML-RPC Server KEEPALIVE_TIMEOUT
+    value = "15";
+
+    attribute = new SingleAttribute("KEEPALIVE_TIMEOUT",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    //XML-RPC Server KEEPALIVE_MAX_CONN
+    value = "30";
+
+    attribute = new SingleAttribute("KEEPALIVE_MAX_CONN",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    //XML-RPC Server TIMEOUT
+    value = "15";
+
+    attribute = new SingleAttribute("TIMEOUT",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    //XML-RPC Server XMLRPC_STATS_INTERVAL
+    value = "600";
+
+    attribute = new SingleAttribute("XMLRPC_STATS_INTERVAL",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    //CHANGE_LOG_SIZE
+    value = "10000";
+
+    attribute = new SingleAttribute("CHANGE_LOG_SIZE",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
     //DB CONFIGURATION
     map<string,string> vvalue;
     vvalue.insert(make_pair("BACKEND","sqlite"));
@@ -116,6 +195,18 @@ NebulaTemplate::NebulaTemplate(string& etc_location, string& var_location)
     attribute = new SingleAttribute("SCRIPTS_REMOTE_DIR",value);
     conf_default.insert(make_pair(attribute->name(),attribute));
 
+    //LOG_SYSTEM
+    value = "file";
+
+    attribute = new SingleAttribute("LOG_SYSTEM",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
+    //LOG_BUFFER_SIZE
+    value = "4096";
+
+    attribute = new SingleAttribute("LOG_BUFFER_SIZE",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
 /*
 #*******************************************************************************
 # Physical Networks configuration
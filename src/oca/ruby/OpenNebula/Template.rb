@@ -27,6 +27,7 @@ module OpenNebula
         TEMPLATE_METHODS = {
             :allocate    => "template.allocate",
             :instantiate => "template.instantiate",
+            :batchinstantiate => "template.batchinstantiate",
             :info        => "template.info",
             :update      => "template.update",
             :publish     => "template.publish",
@@ -92,6 +93,20 @@ module OpenNebula
             return rc
         end
 
+        # Creates a number of VM instances from a Template with a single
+        # call. The network leases of all the VMs are taken in one operation
+        #
+        # +count+ number of VMs
+        # +name+ A string with the name of the VMs, "-<n>" is appended to it
+        # [return] Array with the result of each VM, [success, id|error, code]
+        def batch_instantiate(count, name="")
+            return Error.new('ID not defined') if !@pe_id
+
+            name ||= ""
+            @client.call(TEMPLATE_METHODS[:batchinstantiate], @pe_id, name,
+                         count.to_i)
+        end
+
         # Replaces the template contents
         #
         # +new_template+ New template contents
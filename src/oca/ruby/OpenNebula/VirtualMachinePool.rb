@@ -25,7 +25,9 @@ module OpenNebula
 
 
         VM_POOL_METHODS = {
-            :info => "vmpool.info"
+            :info        => "vmpool.info",
+            :batchaction => "vm.batchaction",
+            :batchdeploy => "vm.batchdeploy"
         }
 
         # Constants for info queries (include/RequestManagerPoolInfoFilter.h)
@@ -111,6 +113,25 @@ module OpenNebula
                                INFO_NOT_DONE)
         end
 
+        # Performs the same action ("shutdown", "finalize", ...) on a list
+        # of VMs with a single call.
+        # +action+ name of the action
+        # +ids+ Array of VM ids
+        # Returns an Array with the result of each VM, [success, id|error, code]
+        def batch_action(action, ids)
+            @client.call(VM_POOL_METHODS[:batchaction],
+                         action.to_s,
+                         ids.collect { |id| id.to_i })
+        end
+
+        # Deploys a list of VMs with a single call.
+        # +deployments+ Array of [vm_id, host_id]
+        # Returns an Array with the result of each VM, [success, id|error, code]
+        def batch_deploy(deployments)
+            @client.call(VM_POOL_METHODS[:batchdeploy],
+                         deployments.collect { |vid, hid| [vid.to_i, hid.to_i] })
+        end
+
         private
 
         def info_filter(xml_method, who, start_id, end_id, state)
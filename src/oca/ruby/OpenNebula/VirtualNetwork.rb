@@ -31,6 +31,8 @@ module OpenNebula
             :delete     => "vn.delete",
             :addleases  => "vn.addleases",
             :rmleases   => "vn.rmleases",
+            :hold       => "vn.hold",
+            :release    => "vn.release",
             :chown      => "vn.chown",
             :update     => "vn.update"
         }
@@ -130,6 +132,30 @@ module OpenNebula
             return rc
         end
 
+        # Holds a block of free leases of the VirtualNetwork. The leases can
+        # be used later by NICs with a fixed IP, or freed with release
+        # +count+ number of leases
+        # [return] Array of [ip, mac] or an Error object
+        def hold(count)
+            return Error.new('ID not defined') if !@pe_id
+
+            @client.call(VN_METHODS[:hold], @pe_id, count.to_i)
+        end
+
+        # Releases held leases of the VirtualNetwork
+        # +ips+ an IP or an Array of IPs
+        def release(ips)
+            return Error.new('ID not defined') if !@pe_id
+
+            lease_template = ""
+            [ips].flatten.each { |ip| lease_template << "LEASES = [ IP = #{ip} ]\n" }
+
+            rc = @client.call(VN_METHODS[:release], @pe_id, lease_template)
+            rc = nil if !OpenNebula.is_error?(rc)
+
+            return rc
+        end
+
         # Changes the owner/group
         # uid:: _Integer_ the new owner id. Set to -1 to leave the current one
         # gid:: _Integer_ the new group id. Set to -1 to leave the current one
@@ -0,0 +1,69 @@
+# -------------------------------------------------------------------------- *
+# Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             #
+# Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+# not use this file except in compliance with the License. You may obtain    *
+# a copy of the License at                                                   *
+#                                                                            *
+# http://www.apache.org/licenses/LICENSE-2.0                                 *
+#                                                                            *
+# Unless required by applicable law or agreed to in writing, software        *
+# distributed under the License is distributed on an "AS IS" BASIS,          *
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+# See the License for the specific language governing permissions and        *
+# limitations under the License.                                             *
+# -------------------------------------------------------------------------- *
+
+require "rexml/document"
+include REXML
+
+module Migrator
+    def db_version
+        "3.1.80"
+    end
+
+    def one_version
+        "OpenNebula 3.1.80"
+    end
+
+    def up
+        ########################################################################
+        # Leases are stored in columns instead of a XML body
+        ########################################################################
+
+        # 3.1.0:
+        # CREATE TABLE leases (oid INTEGER, ip BIGINT, body TEXT, PRIMARY KEY(oid,ip));
+
+        @db.run "ALTER TABLE leases RENAME TO old_leases;"
+        @db.run "CREATE TABLE leases (oid INTEGER, ip BIGINT, mac_prefix BIGINT, mac_suffix BIGINT, vid INTEGER, used INTEGER, PRIMARY KEY(oid,ip));"
+
+        @db.fetch("SELECT * FROM old_leases") do |row|
+            doc = Document.new(row[:body])
+
+            lease = {}
+
+            ["MAC_PREFIX", "MAC_SUFFIX", "VID", "USED"].each { |name|
+                doc.root.each_element(name) { |e|
+                    lease[name] = e.text.to_i
+                }
+            }
+
+            @db[:leases].insert(
+                :oid        => row[:oid],
+                :ip         => row[:ip],
+                :mac_prefix => lease["MAC_PREFIX"],
+                :mac_suffix => lease["MAC_SUFFIX"],
+                :vid        => lease["VID"],
+                :used       => lease["USED"])
+        end
+
+        @db.run "DROP TABLE old_leases;"
+
+        ########################################################################
+        # New table for the monitoring samples of VMs and Hosts
+        ########################################################################
+
+        @db.run "CREATE TABLE IF NOT EXISTS monitoring (type INTEGER, oid INTEGER, time INTEGER, val0 INTEGER, val1 INTEGER, val2 INTEGER, val3 INTEGER, PRIMARY KEY(type,oid,time));"
+
+        return true
+    end
+end
@@ -0,0 +1,168 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "ChangeLog.h"
+
+#include <sys/time.h>
+#include <errno.h>
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+ChangeLog::ChangeLog(unsigned int _max_size, unsigned int _max_waiters):
+    max_size(_max_size),
+    max_waiters(_max_waiters),
+    waiters(0),
+    last_seq(0)
+{
+    pthread_mutex_init(&mutex,0);
+
+    pthread_cond_init(&cond,0);
+};
+
+/* -------------------------------------------------------------------------- */
+
+ChangeLog::~ChangeLog()
+{
+    pthread_mutex_destroy(&mutex);
+
+    pthread_cond_destroy(&cond);
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void ChangeLog::add(const string&  table,
+                    int            oid,
+                    EventType      event,
+                    int            state,
+                    int            sub_state)
+{
+    Change            change;
+    string::size_type pos = table.rfind("_pool");
+
+    if ( pos != string::npos )
+    {
+        change.type = table.substr(0,pos);
+    }
+    else
+    {
+        change.type = table;
+    }
+
+    change.oid       = oid;
+    change.event     = event;
+    change.state     = state;
+    change.sub_state = sub_state;
+
+    pthread_mutex_lock(&mutex);
+
+    change.seq = ++last_seq;
+
+    changes.push_back(change);
+
+    while ( changes.size() > max_size )
+    {
+        changes.pop_front();
+    }
+
+    pthread_cond_broadcast(&cond);
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+string& ChangeLog::to_xml(unsigned long long seq, int timeout, string& xml)
+{
+    ostringstream   oss;
+    struct timeval  now;
+    struct timespec deadline;
+
+    unsigned long long first_seq;
+    bool               truncated;
+
+    deque<Change>::iterator it;
+
+    gettimeofday(&now, 0);
+
+    deadline.tv_sec  = now.tv_sec + timeout;
+    deadline.tv_nsec = now.tv_usec * 1000;
+
+    pthread_mutex_lock(&mutex);
+
+    // Wait for a change after seq, a seq in the future means that the client
+    // comes from a previous oned run and will get a truncated log at once.
+    // Calls over max_waiters do not wait, so they can not take every thread
+
+    if ( timeout > 0 && seq == last_seq && waiters < max_waiters )
+    {
+        waiters++;
+
+        while ( seq == last_seq )
+        {
+            if (pthread_cond_timedwait(&cond, &mutex, &deadline) == ETIMEDOUT)
+            {
+                break;
+            }
+        }
+
+        waiters--;
+    }
+
+    first_seq = changes.empty() ? last_seq + 1 : changes.front().seq;
+    truncated = ( seq > last_seq ) || ( seq + 1 < first_seq );
+
+    oss << "<CHANGES>"
+        <<   "<LAST_SEQ>"  << last_seq  << "</LAST_SEQ>"
+        <<   "<TRUNCATED>" << truncated << "</TRUNCATED>";
+
+    if ( seq < last_seq )
+    {
+        // Changes are consecutive, the first one after seq is at seq-first_seq+1
+
+        it = changes.begin();
+
+        if ( seq >= first_seq )
+        {
+            it += (seq - first_seq + 1);
+        }
+
+        for ( ; it != changes.end(); it++ )
+        {
+            oss << "<CHANGE>"
+                <<   "<SEQ>"       << it->seq                  << "</SEQ>"
+                <<   "<TYPE>"      << it->type                 << "</TYPE>"
+                <<   "<ID>"        << it->oid                  << "</ID>"
+                <<   "<EVENT>"     << event_to_str(it->event)  << "</EVENT>"
+                <<   "<STATE>"     << it->state                << "</STATE>"
+                <<   "<SUB_STATE>" << it->sub_state            << "</SUB_STATE>"
+                << "</CHANGE>";
+        }
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    oss << "</CHANGES>";
+
+    xml = oss.str();
+
+    return xml;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
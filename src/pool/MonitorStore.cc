@@ -0,0 +1,763 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "MonitorStore.h"
+#include "NebulaLog.h"
+
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+const unsigned int MonitorStore::BATCH_SIZE = 100;
+
+const time_t MonitorStore::FLUSH_INTERVAL = 60;
+
+const time_t MonitorStore::PURGE_INTERVAL = 3600;
+
+const char * MonitorStore::table = "monitoring";
+
+const char * MonitorStore::db_names =
+    "type, oid, time, val0, val1, val2, val3";
+
+const char * MonitorStore::db_bootstrap = "CREATE TABLE IF NOT EXISTS "
+    "monitoring (type INTEGER, oid INTEGER, time INTEGER, val0 INTEGER, "
+    "val1 INTEGER, val2 INTEGER, val3 INTEGER, PRIMARY KEY(type,oid,time))";
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+const char * MonitorStore::value_name(ObjectType type, int i)
+{
+    static const char * vm_names[]   = {"USEDMEMORY", "USEDCPU",
+                                        "NETTX",      "NETRX"};
+    static const char * host_names[] = {"USEDMEMORY", "USEDCPU",
+                                        "FREEMEMORY", "FREECPU"};
+
+    if ( i < 0 || i >= NUM_VALUES )
+    {
+        return "-";
+    }
+
+    return ( type == VM ) ? vm_names[i] : host_names[i];
+}
+
+/* ************************************************************************** */
+/* SampleRing                                                                 */
+/* ************************************************************************** */
+
+void MonitorStore::SampleRing::encode(long long value)
+{
+    unsigned long long zigzag;
+
+    zigzag = (static_cast<unsigned long long>(value) << 1) ^
+             static_cast<unsigned long long>(value >> 63);
+
+    while ( zigzag >= 0x80 )
+    {
+        deltas.push_back(static_cast<unsigned char>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+
+    deltas.push_back(static_cast<unsigned char>(zigzag));
+}
+
+/* -------------------------------------------------------------------------- */
+
+long long MonitorStore::SampleRing::decode(unsigned int& pos) const
+{
+    unsigned long long zigzag = 0;
+    int                shift  = 0;
+    unsigned char      byte;
+
+    do
+    {
+        byte    = deltas[pos++];
+        zigzag |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+        shift  += 7;
+    }
+    while ( byte & 0x80 );
+
+    return static_cast<long long>(zigzag >> 1) ^
+           -static_cast<long long>(zigzag & 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool MonitorStore::SampleRing::push(const Sample&   sample,
+                                    unsigned int    max_size,
+                                    Sample&         evicted)
+{
+    unsigned int pos = 0;
+
+    if ( size == 0 )
+    {
+        first_time = sample.time;
+
+        for (int i = 0; i < NUM_VALUES; i++)
+        {
+            first_values[i] = sample.values[i];
+        }
+    }
+    else
+    {
+        encode(static_cast<long long>(sample.time) - last_time);
+
+        for (int i = 0; i < NUM_VALUES; i++)
+        {
+            encode(static_cast<long long>(sample.values[i]) - last_values[i]);
+        }
+    }
+
+    size++;
+
+    last_time = sample.time;
+
+    for (int i = 0; i < NUM_VALUES; i++)
+    {
+        last_values[i] = sample.values[i];
+    }
+
+    if ( size <= max_size )
+    {
+        return false;
+    }
+
+    // The second sample becomes the oldest one, with absolute values
+
+    evicted.time = first_time;
+
+    for (int i = 0; i < NUM_VALUES; i++)
+    {
+        evicted.values[i] = first_values[i];
+    }
+
+    first_time += decode(pos);
+
+    for (int i = 0; i < NUM_VALUES; i++)
+    {
+        first_values[i] += decode(pos);
+    }
+
+    deltas.erase(deltas.begin(), deltas.begin() + pos);
+
+    size--;
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitorStore::SampleRing::get(time_t           start,
+                                   time_t           end,
+                                   vector<Sample>&  samples) const
+{
+    Sample       sample;
+    unsigned int pos = 0;
+
+    sample.time = first_time;
+
+    for (int i = 0; i < NUM_VALUES; i++)
+    {
+        sample.values[i] = first_values[i];
+    }
+
+    for (unsigned int j = 0; j < size; j++)
+    {
+        if ( j > 0 )
+        {
+            sample.time += decode(pos);
+
+            for (int i = 0; i < NUM_VALUES; i++)
+            {
+                sample.values[i] += decode(pos);
+            }
+        }
+
+        if ( end >= 0 && sample.time > end )
+        {
+            break;
+        }
+
+        if ( sample.time >= start )
+        {
+            samples.push_back(sample);
+        }
+    }
+}
+
+/* ************************************************************************** */
+/* MonitorStore                                                               */
+/* ************************************************************************** */
+
+MonitorStore::MonitorStore(SqlDB *      _db,
+                           unsigned int _max_samples,
+                           time_t       _period,
+                           time_t       _expiration):
+    db(_db),
+    max_samples(_max_samples),
+    period(_period),
+    expiration(_expiration)
+{
+    if ( max_samples == 0 )
+    {
+        max_samples = 1;
+    }
+
+    last_purge = time(0);
+
+    pthread_mutex_init(&mutex,0);
+
+    pthread_mutex_init(&flush_mutex,0);
+
+    am.addListener(this);
+};
+
+/* -------------------------------------------------------------------------- */
+
+MonitorStore::~MonitorStore()
+{
+    map<pair<int,int>, Series *>::iterator it;
+
+    flush();
+
+    for ( it = series.begin(); it != series.end(); it++ )
+    {
+        delete it->second;
+    }
+
+    pthread_mutex_destroy(&mutex);
+
+    pthread_mutex_destroy(&flush_mutex);
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+extern "C" void * ms_action_loop(void *arg)
+{
+    MonitorStore *  ms;
+
+    if ( arg == 0 )
+    {
+        return 0;
+    }
+
+    ms = static_cast<MonitorStore *>(arg);
+
+    NebulaLog::log("MON",Log::INFO,"Monitor Store started.");
+
+    ms->am.loop(MonitorStore::FLUSH_INTERVAL,0);
+
+    NebulaLog::log("MON",Log::INFO,"Monitor Store stopped.");
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitorStore::start()
+{
+    int               rc;
+    pthread_attr_t    pattr;
+
+    pthread_attr_init (&pattr);
+    pthread_attr_setdetachstate (&pattr, PTHREAD_CREATE_JOINABLE);
+
+    NebulaLog::log("MON",Log::INFO,"Starting Monitor Store...");
+
+    rc = pthread_create(&ms_thread,&pattr,ms_action_loop,(void *) this);
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitorStore::do_action(const string& action, void * arg)
+{
+    if (action == ACTION_TIMER)
+    {
+        if ( flush() != 0 )
+        {
+            NebulaLog::log("MON",Log::ERROR,
+                           "Error writing monitoring samples to the DB.");
+        }
+    }
+    else if (action == ACTION_FINALIZE)
+    {
+        NebulaLog::log("MON",Log::INFO,"Stopping Monitor Store...");
+
+        flush();
+    }
+    else
+    {
+        ostringstream oss;
+        oss << "Unknown action name: " << action;
+
+        NebulaLog::log("MON", Log::ERROR, oss);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorStore::add(ObjectType type,
+                       int        oid,
+                       time_t     timestamp,
+                       const int  values[])
+{
+    Series * s;
+    Sample   sample;
+    Sample   previous;
+    Sample   evicted;
+    Row      row;
+
+    pair<int,int>                          key(static_cast<int>(type), oid);
+    map<pair<int,int>, Series *>::iterator it;
+
+    pthread_mutex_lock(&mutex);
+
+    it = series.find(key);
+
+    if ( it == series.end() )
+    {
+        s = new Series;
+
+        s->period_start   = 0;
+        s->period_samples = 0;
+
+        series.insert(make_pair(key, s));
+    }
+    else
+    {
+        s = it->second;
+
+        s->raw.last(previous);
+
+        if ( timestamp <= previous.time )
+        {
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+    }
+
+    sample.time = timestamp;
+
+    for (int i = 0; i < NUM_VALUES; i++)
+    {
+        if ( values[i] >= 0 )
+        {
+            sample.values[i] = values[i];
+        }
+        else if ( it != series.end() )
+        {
+            sample.values[i] = previous.values[i];
+        }
+        else
+        {
+            sample.values[i] = 0;
+        }
+    }
+
+    if ( s->raw.push(sample, max_samples, evicted) )
+    {
+        add_to_average(s, evicted);
+    }
+
+    if ( db != 0 )
+    {
+        row.type   = type;
+        row.oid    = oid;
+        row.sample = sample;
+
+        pending.push_back(row);
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitorStore::remove(ObjectType type, int oid)
+{
+    map<pair<int,int>, Series *>::iterator it;
+
+    pthread_mutex_lock(&mutex);
+
+    it = series.find(make_pair(static_cast<int>(type), oid));
+
+    if ( it != series.end() )
+    {
+        delete it->second;
+
+        series.erase(it);
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitorStore::add_to_average(Series * s, const Sample& sample)
+{
+    Sample average;
+    Sample evicted;
+    time_t start;
+
+    if ( period <= 0 )
+    {
+        return;
+    }
+
+    start = sample.time - (sample.time % period);
+
+    if ( s->period_samples > 0 && start != s->period_start )
+    {
+        average.time = s->period_start;
+
+        for (int i = 0; i < NUM_VALUES; i++)
+        {
+            average.values[i] = s->period_sum[i] / s->period_samples;
+        }
+
+        s->averages.push(average, max_samples, evicted);
+
+        s->period_samples = 0;
+    }
+
+    if ( s->period_samples == 0 )
+    {
+        s->period_start = start;
+
+        for (int i = 0; i < NUM_VALUES; i++)
+        {
+            s->period_sum[i] = 0;
+        }
+    }
+
+    for (int i = 0; i < NUM_VALUES; i++)
+    {
+        s->period_sum[i] += sample.values[i];
+    }
+
+    s->period_samples++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitorStore::purge_series(time_t now)
+{
+    time_t idle;
+
+    map<pair<int,int>, Series *>::iterator it;
+
+    // A series is kept for the time its averages span
+
+    idle = max_samples * period;
+
+    if ( idle < PURGE_INTERVAL )
+    {
+        idle = PURGE_INTERVAL;
+    }
+
+    for ( it = series.begin(); it != series.end(); )
+    {
+        if ( now - it->second->raw.get_last_time() > idle )
+        {
+            delete it->second;
+
+            series.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitorStore::flush()
+{
+    vector<Row>   rows;
+    time_t        now = time(0);
+    bool          purge;
+    int           rc  = 0;
+    ostringstream oss;
+
+    pthread_mutex_lock(&flush_mutex);
+
+    pthread_mutex_lock(&mutex);
+
+    rows.swap(pending);
+
+    purge      = ( now - last_purge >= PURGE_INTERVAL );
+
+    if ( purge )
+    {
+        last_purge = now;
+
+        purge_series(now);
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    if ( db != 0 )
+    {
+        for (unsigned int i = 0; i < rows.size(); i += BATCH_SIZE)
+        {
+            unsigned int last = i + BATCH_SIZE;
+
+            if ( last > rows.size() )
+            {
+                last = rows.size();
+            }
+
+            rc += insert(rows, i, last);
+        }
+
+        if ( purge && expiration > 0 )
+        {
+            oss << "DELETE FROM " << table << " WHERE time < "
+                << now - expiration;
+
+            rc += db->exec(oss);
+        }
+    }
+
+    pthread_mutex_unlock(&flush_mutex);
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitorStore::insert(const vector<Row>& rows,
+                         unsigned int       first,
+                         unsigned int       last)
+{
+    ostringstream oss;
+
+    if ( first >= last )
+    {
+        return 0;
+    }
+
+    oss << "REPLACE INTO " << table << " (" << db_names << ") ";
+
+    for (unsigned int i = first; i < last; i++)
+    {
+        const Row& row = rows[i];
+
+        if ( i != first )
+        {
+            oss << " UNION ALL ";
+        }
+
+        oss << "SELECT " << row.type << "," << row.oid << ","
+            << row.sample.time;
+
+        for (int j = 0; j < NUM_VALUES; j++)
+        {
+            oss << "," << row.sample.values[j];
+        }
+    }
+
+    return db->exec(oss);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitorStore::select_cb(void * _samples, int num, char **values,
+                            char **names)
+{
+    vector<Sample> * samples;
+    Sample           sample;
+
+    samples = static_cast<vector<Sample> *>(_samples);
+
+    if ( num != NUM_VALUES + 1 || values == 0 || values[0] == 0 )
+    {
+        return -1;
+    }
+
+    sample.time = static_cast<time_t>(strtoll(values[0], 0, 10));
+
+    for (int i = 0; i < NUM_VALUES; i++)
+    {
+        sample.values[i] = ( values[i+1] == 0 ) ? 0 : atoi(values[i+1]);
+    }
+
+    samples->push_back(sample);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitorStore::select(ObjectType       type,
+                         int              oid,
+                         time_t           start,
+                         time_t           end,
+                         vector<Sample>&  samples)
+{
+    ostringstream oss;
+    int           rc;
+
+    set_callback(static_cast<Callbackable::Callback>(&MonitorStore::select_cb),
+                 static_cast<void *>(&samples));
+
+    oss << "SELECT time, val0, val1, val2, val3 FROM " << table
+        << " WHERE type = " << type << " AND oid = " << oid
+        << " AND time >= " << start;
+
+    if ( end >= 0 )
+    {
+        oss << " AND time <= " << end;
+    }
+
+    oss << " ORDER BY time";
+
+    rc = db->exec(oss, this);
+
+    unset_callback();
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorStore::samples_to_xml(ObjectType               type,
+                                  time_t                   sample_period,
+                                  const vector<Sample>&    samples,
+                                  ostringstream&           oss)
+{
+    vector<Sample>::const_iterator it;
+
+    for ( it = samples.begin(); it != samples.end(); it++ )
+    {
+        oss << "<MONITORING>"
+            <<   "<TIMESTAMP>" << it->time       << "</TIMESTAMP>"
+            <<   "<PERIOD>"    << sample_period  << "</PERIOD>";
+
+        for (int i = 0; i < NUM_VALUES; i++)
+        {
+            oss << "<"  << value_name(type, i) << ">"
+                << it->values[i]
+                << "</" << value_name(type, i) << ">";
+        }
+
+        oss << "</MONITORING>";
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+string& MonitorStore::to_xml(ObjectType   type,
+                             int          oid,
+                             time_t       start,
+                             time_t       end,
+                             string&      xml)
+{
+    ostringstream  oss;
+    vector<Sample> stored;
+    vector<Sample> averages;
+    vector<Sample> raw;
+    time_t         mem_start = -1;
+    time_t         db_end;
+
+    map<pair<int,int>, Series *>::iterator it;
+
+    // Samples not yet written to the DB are in memory, only those older than
+    // the in memory ones are read from the DB
+
+    pthread_mutex_lock(&mutex);
+
+    it = series.find(make_pair(static_cast<int>(type), oid));
+
+    if ( it != series.end() )
+    {
+        Series * s = it->second;
+
+        s->averages.get(start, end, averages);
+
+        if ( s->period_samples > 0 && s->period_start >= start &&
+             ( end < 0 || s->period_start <= end ) )
+        {
+            Sample average;
+
+            average.time = s->period_start;
+
+            for (int i = 0; i < NUM_VALUES; i++)
+            {
+                average.values[i] = s->period_sum[i] / s->period_samples;
+            }
+
+            averages.push_back(average);
+        }
+
+        s->raw.get(start, end, raw);
+
+        if ( !s->averages.empty() )
+        {
+            mem_start = s->averages.get_first_time();
+        }
+        else if ( s->period_samples > 0 )
+        {
+            mem_start = s->period_start;
+        }
+        else
+        {
+            mem_start = s->raw.get_first_time();
+        }
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    if ( db != 0 && ( mem_start == -1 || start < mem_start ) )
+    {
+        db_end = end;
+
+        if ( mem_start != -1 && ( end < 0 || end >= mem_start ) )
+        {
+            db_end = mem_start - 1;
+        }
+
+        select(type, oid, start, db_end, stored);
+    }
+
+    oss << "<MONITORING_DATA>"
+        <<   "<TYPE>" << type_to_str(type) << "</TYPE>"
+        <<   "<ID>"   << oid               << "</ID>";
+
+    samples_to_xml(type, 0, stored, oss);
+
+    samples_to_xml(type, period, averages, oss);
+
+    samples_to_xml(type, 0, raw, oss);
+
+    oss << "</MONITORING_DATA>";
+
+    xml = oss.str();
+
+    return xml;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
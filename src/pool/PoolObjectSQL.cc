@@ -56,6 +56,8 @@ int PoolObjectSQL::select(SqlDB *db)
 
     unset_callback();
 
+    set_dirty();
+
     if ((rc != 0) || (oid != boid ))
     {
         return -1;
@@ -98,6 +100,8 @@ int PoolObjectSQL::select(SqlDB *db, const string& _name, int _uid)
 
     unset_callback();
 
+    set_dirty();
+
     db->free_str(sql_name);
 
     if ((rc != 0) || (_name != name) || (_uid != uid))
@@ -157,6 +161,8 @@ void PoolObjectSQL::set_template_error_message(const string& message)
     attr = new VectorAttribute(error_attribute_name,error_value);
 
     obj_template->set(attr);
+
+    set_dirty();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -193,6 +199,8 @@ int PoolObjectSQL::replace_template(const string& tmpl_str, string& error)
 
     obj_template = new_tmpl;
 
+    set_dirty();
+
     return 0;
 } 
 
@@ -33,6 +33,8 @@
 
 const unsigned int PoolSQL::MAX_POOL_SIZE = 15000;
 
+ChangeLog * PoolSQL::change_log = 0;
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
@@ -123,6 +125,8 @@ int PoolSQL::allocate(
     {
         rc = lastOID;
         do_hooks(objsql, Hook::ALLOCATE);
+
+        log_change(objsql, ChangeLog::ALLOCATE);
     }
 
     objsql->unlock();
@@ -162,6 +166,44 @@ void PoolSQL::update_lastOID()
 PoolObjectSQL * PoolSQL::get(
     int     oid,
     bool    olock)
+{
+    PoolObjectSQL * objectsql = get_object(oid, olock);
+
+    if ( objectsql != 0 && olock == true )
+    {
+        objectsql->set_dirty();
+    }
+
+    return objectsql;
+}
+
+/* -------------------------------------------------------------------------- */
+
+PoolObjectSQL * PoolSQL::get_ro(int oid)
+{
+    return get_object(oid, true);
+}
+
+/* -------------------------------------------------------------------------- */
+
+PoolObjectSQL * PoolSQL::get(const string& name, int ouid, bool olock)
+{
+    PoolObjectSQL * objectsql = get_object(name, ouid, olock);
+
+    if ( objectsql != 0 && olock == true )
+    {
+        objectsql->set_dirty();
+    }
+
+    return objectsql;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+PoolObjectSQL * PoolSQL::get_object(
+    int     oid,
+    bool    olock)
 {
     map<int,PoolObjectSQL *>::iterator  index;
     PoolObjectSQL *                     objectsql;
@@ -239,7 +281,10 @@ PoolObjectSQL * PoolSQL::get(
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-PoolObjectSQL * PoolSQL::get(const string& name, int ouid, bool olock)
+PoolObjectSQL * PoolSQL::get_object(
+    const string&   name,
+    int             ouid,
+    bool            olock)
 {
     map<string,PoolObjectSQL *>::iterator  index;
     
@@ -324,6 +369,33 @@ PoolObjectSQL * PoolSQL::get(const string& name, int ouid, bool olock)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void PoolSQL::run_hooks(const vector<HookEvent>& events)
+{
+    PoolObjectSQL * objsql = 0;
+
+    vector<HookEvent>::const_iterator it;
+
+    // State hooks only use the object when they fire, most events just
+    // update the state maps
+    for (it = events.begin(); it != events.end(); it++)
+    {
+        if ( objsql == 0 && it->oid != -1 && needs_object(*it) )
+        {
+            objsql = get_ro(it->oid);
+        }
+
+        execute_hooks(*it, objsql);
+    }
+
+    if ( objsql != 0 )
+    {
+        objsql->unlock();
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void PoolSQL::replace()
 {
     bool removed = false;
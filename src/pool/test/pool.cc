@@ -17,10 +17,13 @@
 #include <string>
 #include <iostream>
 #include <getopt.h>
+#include <time.h>
 
 #include "test/OneUnitTest.h"
 #include "PoolSQL.h"
 #include "TestPoolSQL.h"
+#include "ObjectXML.h"
+#include "MonitorStore.h"
 
 using namespace std;
 
@@ -35,11 +38,26 @@ class PoolTest : public OneUnitTest
     CPPUNIT_TEST (search);
     CPPUNIT_TEST (cache_test);
     CPPUNIT_TEST (cache_name_test);
+    CPPUNIT_TEST (info_xml_cache);
+    CPPUNIT_TEST (change_log);
+    CPPUNIT_TEST (change_log_waiters);
+    CPPUNIT_TEST (monitor_store);
+    CPPUNIT_TEST (monitor_store_deltas);
+    CPPUNIT_TEST (monitor_store_flush);
     CPPUNIT_TEST_SUITE_END ();
 
 private:
     TestPool * pool;
 
+    string value(ObjectXML * xml, const char * xpath)
+    {
+        string val;
+
+        xml->xpath(val, xpath, "");
+
+        return val;
+    };
+
     int create_allocate(int n, string st)
     {
         string err;
@@ -283,6 +301,407 @@ public:
             }
         }
     };
+
+    void info_xml_cache()
+    {
+        TestObjectSQL * obj;
+        int             oid;
+
+        oid = create_allocate(1, "cached object");
+
+        obj = static_cast<TestObjectSQL *>(pool->get_ro(oid));
+        CPPUNIT_ASSERT(obj != 0);
+
+        CPPUNIT_ASSERT(obj->info_xml().find("<NUMBER>1</NUMBER>")
+                       != string::npos);
+
+        obj->unlock();
+
+        // The cached XML is kept while the object is only read
+        obj->number = 2;
+
+        obj = static_cast<TestObjectSQL *>(pool->get_ro(oid));
+
+        CPPUNIT_ASSERT(obj->info_xml().find("<NUMBER>1</NUMBER>")
+                       != string::npos);
+
+        obj->unlock();
+
+        // A locked object may be modified, even without calling set_dirty
+        obj = pool->get(oid, true);
+
+        obj->number = 3;
+
+        obj->unlock();
+
+        obj = static_cast<TestObjectSQL *>(pool->get_ro(oid));
+
+        CPPUNIT_ASSERT(obj->info_xml().find("<NUMBER>3</NUMBER>")
+                       != string::npos);
+
+        obj->unlock();
+
+        // Also when it is got by name
+        obj = pool->get("cached object", 0, true);
+
+        obj->number = 4;
+
+        obj->unlock();
+
+        obj = static_cast<TestObjectSQL *>(pool->get_ro(oid));
+
+        CPPUNIT_ASSERT(obj->info_xml().find("<NUMBER>4</NUMBER>")
+                       != string::npos);
+
+        obj->unlock();
+    };
+
+    void change_log()
+    {
+        ChangeLog       changes(3, 1);
+        TestObjectSQL * obj;
+        ObjectXML *     xml;
+
+        string err_str;
+        string str;
+        int    oid;
+
+        PoolSQL::set_change_log(&changes);
+
+        oid = create_allocate(1, "first object");
+
+        obj = pool->get(oid, true);
+        CPPUNIT_ASSERT(obj != 0);
+
+        pool->update(obj);
+        pool->drop(obj, err_str);
+
+        obj->unlock();
+
+        PoolSQL::set_change_log(0);
+
+        CPPUNIT_ASSERT(changes.get_last_seq() == 3);
+
+        // All the changes after seq 1
+        xml = new ObjectXML(changes.to_xml(1, 0, str));
+
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/TRUNCATED") == "0");
+        CPPUNIT_ASSERT((*xml)["/CHANGES/CHANGE/SEQ"].size() == 2);
+
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/CHANGE[1]/SEQ") == "2");
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/CHANGE[1]/TYPE") == "test");
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/CHANGE[1]/EVENT") == "UPDATE");
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/CHANGE[2]/EVENT") == "DROP");
+
+        delete xml;
+
+        // Changes are not recorded without a change log
+        create_allocate(2, "second object");
+        create_allocate(3, "third object");
+
+        CPPUNIT_ASSERT(changes.get_last_seq() == 3);
+
+        // Only 3 changes are kept, seq 1 and 2 are lost
+        PoolSQL::set_change_log(&changes);
+
+        create_allocate(4, "fourth object");
+        create_allocate(5, "fifth object");
+
+        PoolSQL::set_change_log(0);
+
+        xml = new ObjectXML(changes.to_xml(0, 0, str));
+
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/LAST_SEQ") == "5");
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/TRUNCATED") == "1");
+        CPPUNIT_ASSERT((*xml)["/CHANGES/CHANGE/SEQ"].size() == 3);
+
+        delete xml;
+
+        // Nothing new after the last seq, do not wait
+        xml = new ObjectXML(changes.to_xml(5, 0, str));
+
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/TRUNCATED") == "0");
+        CPPUNIT_ASSERT((*xml)["/CHANGES/CHANGE/SEQ"].size() == 0);
+
+        delete xml;
+    };
+
+    void change_log_waiters()
+    {
+        ChangeLog   changes(3, 0);
+        ObjectXML * xml;
+
+        string str;
+        time_t start;
+
+        changes.add("test_pool", 0, ChangeLog::ALLOCATE, -1, -1);
+
+        // No calls can wait, nothing new is returned at once
+        start = time(0);
+
+        xml = new ObjectXML(changes.to_xml(1, 60, str));
+
+        CPPUNIT_ASSERT(time(0) - start < 5);
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/LAST_SEQ") == "1");
+        CPPUNIT_ASSERT((*xml)["/CHANGES/CHANGE/SEQ"].size() == 0);
+
+        delete xml;
+
+        // Sequence numbers over 32 bits
+        xml = new ObjectXML(changes.to_xml(5000000000ULL, 60, str));
+
+        CPPUNIT_ASSERT(time(0) - start < 5);
+        CPPUNIT_ASSERT(value(xml, "/CHANGES/TRUNCATED") == "1");
+
+        delete xml;
+    };
+
+    void monitor_store()
+    {
+        MonitorStore *  store;
+        ObjectXML *     xml;
+        string          str;
+
+        int samples[][MonitorStore::NUM_VALUES] = {
+                {100, 1, 2, 3},
+                {110, 1, 2, 3},
+                {120, 1, 2, 3},
+                {130, 1, 2, 3},
+                {-1,  1, 2, 3},     // Not known, takes 130
+                {250, 1, 2, 3}};
+
+        time_t times[] = {100, 110, 120, 130, 140, 250};
+
+        CPPUNIT_ASSERT(MonitorStore::bootstrap(db) == 0);
+
+        // 3 raw samples, averages of 100s, samples never expire
+        store = new MonitorStore(db, 3, 100, 0);
+
+        for (int i = 0; i < 6; i++)
+        {
+            store->add(MonitorStore::VM, 1, times[i], samples[i]);
+        }
+
+        // Samples not newer than the last one are ignored
+        store->add(MonitorStore::VM, 1, 250, samples[0]);
+
+        // Raw samples 130, 140 and 250, the older ones are in the 100 average
+        xml = new ObjectXML(store->to_xml(MonitorStore::VM, 1, 0, -1, str));
+
+        CPPUNIT_ASSERT(value(xml, "/MONITORING_DATA/TYPE") == "VM");
+        CPPUNIT_ASSERT(value(xml, "/MONITORING_DATA/ID") == "1");
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 4);
+
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[1]/TIMESTAMP") == "100");
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[1]/PERIOD") == "100");
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[1]/USEDMEMORY") == "110");
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[3]/USEDMEMORY") == "130");
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[3]/NETRX") == "3");
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[4]/TIMESTAMP") == "250");
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[4]/PERIOD") == "0");
+
+        delete xml;
+
+        // Time range
+        xml = new ObjectXML(store->to_xml(MonitorStore::VM, 1, 135, 200, str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 1);
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING/TIMESTAMP") == "140");
+
+        delete xml;
+
+        // Samples of other objects are kept apart
+        xml = new ObjectXML(store->to_xml(MonitorStore::HOST, 1, 0, -1, str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 0);
+
+        delete xml;
+
+        // The average of 100 is closed when a sample of 200 is evicted
+        store->add(MonitorStore::VM, 1, 300, samples[0]);
+        store->add(MonitorStore::VM, 1, 310, samples[0]);
+        store->add(MonitorStore::VM, 1, 320, samples[0]);
+
+        xml = new ObjectXML(store->to_xml(MonitorStore::VM, 1, 0, -1, str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 5);
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[1]/USEDMEMORY") == "118");
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[2]/TIMESTAMP") == "200");
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[2]/USEDMEMORY") == "250");
+
+        delete xml;
+
+        delete store;
+
+        // Every raw sample is in the DB
+        store = new MonitorStore(db, 3, 100, 0);
+
+        xml = new ObjectXML(store->to_xml(MonitorStore::VM, 1, 0, -1, str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 9);
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[5]/USEDMEMORY") == "130");
+
+        delete xml;
+
+        delete store;
+    };
+
+    void monitor_store_deltas()
+    {
+        MonitorStore *  store;
+        ObjectXML *     xml;
+        string          str;
+
+        int samples[][MonitorStore::NUM_VALUES] = {
+                {2147483647, 0,          1,       2147483000},
+                {0,          2147483647, 1000000, 5},
+                {2147483647, 0,          0,       2147483647},
+                {1,          1,          1,       1},
+                {0,          0,          0,       0},
+                {2147483647, 2147483647, 7,       2147483647}};
+
+        time_t times[] = {100, 1000000000, 1000000001, 1000000060,
+                          2000000000, 2000000001};
+
+        // 4 raw samples, no averages and no DB
+        store = new MonitorStore(0, 4, 0, 0);
+
+        for (int i = 0; i < 6; i++)
+        {
+            store->add(MonitorStore::VM, 1, times[i], samples[i]);
+        }
+
+        // Large and negative differences are kept after evicting samples
+        xml = new ObjectXML(store->to_xml(MonitorStore::VM, 1, 0, -1, str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 4);
+
+        for (int i = 0; i < 4; i++)
+        {
+            ostringstream oss;
+
+            oss << "/MONITORING_DATA/MONITORING[" << i + 1 << "]/";
+
+            for (int j = 0; j < MonitorStore::NUM_VALUES; j++)
+            {
+                ostringstream val;
+
+                val << samples[i + 2][j];
+
+                CPPUNIT_ASSERT(value(xml, (oss.str() +
+                    MonitorStore::value_name(MonitorStore::VM, j)).c_str())
+                    == val.str());
+            }
+
+            ostringstream ts;
+
+            ts << times[i + 2];
+
+            CPPUNIT_ASSERT(value(xml, (oss.str() + "TIMESTAMP").c_str())
+                            == ts.str());
+        }
+
+        delete xml;
+
+        // The series of a deleted object is removed
+        store->remove(MonitorStore::VM, 1);
+        store->remove(MonitorStore::VM, 2);
+
+        xml = new ObjectXML(store->to_xml(MonitorStore::VM, 1, 0, -1, str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 0);
+
+        delete xml;
+
+        // A new series starts with any timestamp
+        store->add(MonitorStore::VM, 1, 50, samples[3]);
+
+        xml = new ObjectXML(store->to_xml(MonitorStore::VM, 1, 0, -1, str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 1);
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING/TIMESTAMP") == "50");
+
+        delete xml;
+
+        delete store;
+    };
+
+    void monitor_store_flush()
+    {
+        MonitorStore *  store;
+        MonitorStore *  reader;
+        ObjectXML *     xml;
+        string          str;
+
+        int sample[MonitorStore::NUM_VALUES] = {100, 1, 2, 3};
+
+        CPPUNIT_ASSERT(MonitorStore::bootstrap(db) == 0);
+
+        store  = new MonitorStore(db, 3, 0, 0);
+        reader = new MonitorStore(db, 3, 0, 0);
+
+        store->add(MonitorStore::HOST, 2, 100, sample);
+        store->add(MonitorStore::HOST, 2, 110, sample);
+
+        // Adding a sample does not write it to the DB
+        xml = new ObjectXML(reader->to_xml(MonitorStore::HOST,2,0,-1,str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 0);
+
+        delete xml;
+
+        CPPUNIT_ASSERT(store->flush() == 0);
+
+        xml = new ObjectXML(reader->to_xml(MonitorStore::HOST,2,0,-1,str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 2);
+
+        delete xml;
+
+        // The store thread writes the pending samples when it is finalized
+        store->add(MonitorStore::HOST, 2, 120, sample);
+
+        CPPUNIT_ASSERT(store->start() == 0);
+
+        store->finalize();
+
+        pthread_join(store->get_thread_id(), 0);
+
+        xml = new ObjectXML(reader->to_xml(MonitorStore::HOST,2,0,-1,str));
+
+        CPPUNIT_ASSERT((*xml)["/MONITORING_DATA/MONITORING/TIMESTAMP"].size()
+                        == 3);
+        CPPUNIT_ASSERT(value(xml,
+            "/MONITORING_DATA/MONITORING[3]/TIMESTAMP") == "120");
+
+        delete xml;
+
+        delete reader;
+        delete store;
+    };
 };
 
 /* ************************************************************************* */
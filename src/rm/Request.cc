@@ -26,20 +26,54 @@ void Request::execute(
         xmlrpc_c::value *   const  _retval)
 {
     RequestAttributes att;
+    struct timeval    start;
+    unsigned long     authn_time;
 
-    att.retval  = _retval;
-    att.session = xmlrpc_c::value_string (_paramList.getString(0));
+    gettimeofday(&start, 0);
+
+    att.retval     = _retval;
+    att.session    = xmlrpc_c::value_string (_paramList.getString(0));
+    att.failed     = false;
+    att.authz_time = 0;
+    att.resp_time  = 0;
 
     Nebula& nd = Nebula::instance();
     UserPool* upool = nd.get_upool();
 
-    NebulaLog::log("ReM",Log::DEBUG, method_name + " method invoked");
+    NEBULA_LOG("ReM", Log::DEBUG, method_name << " method invoked");
+
+    if ( max_concurrent > 0 )
+    {
+        bool busy;
+
+        pthread_mutex_lock(&running_mutex);
+
+        busy = ( running >= max_concurrent );
+
+        if ( !busy )
+        {
+            running++;
+        }
+
+        pthread_mutex_unlock(&running_mutex);
 
-    if ( upool->authenticate(att.session,
-                             att.uid,
-                             att.gid,
-                             att.uname,
-                             att.gname) == false )
+        if ( busy )
+        {
+            failure_response(INTERNAL, concurrency_error(), att);
+
+            update_stats(att, 0, elapsed(start), true);
+            return;
+        }
+    }
+
+    bool authenticated = upool->authenticate(att.session,
+                                             att.uid,
+                                             att.gid,
+                                             att.uname,
+                                             att.gname);
+    authn_time = elapsed(start);
+
+    if ( authenticated == false )
     {
         failure_response(AUTHENTICATION, authenticate_error(), att);
     }
@@ -47,14 +81,202 @@ void Request::execute(
     {
         request_execute(_paramList, att);
     }
+
+    update_stats(att, authn_time, elapsed(start), false);
+
+    if ( max_concurrent > 0 )
+    {
+        pthread_mutex_lock(&running_mutex);
+
+        running--;
+
+        pthread_mutex_unlock(&running_mutex);
+    }
 };
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+const unsigned long Request::BUCKET_LIMITS[] = {
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000,
+    2000000 };
+
+/* -------------------------------------------------------------------------- */
+
+void Request::update_stats(RequestAttributes& att,
+                           unsigned long      authn_time,
+                           unsigned long      total_time,
+                           bool               rejected)
+{
+    unsigned long exec_time = 0;
+    int           bucket;
+
+    if ( total_time > authn_time + att.authz_time + att.resp_time )
+    {
+        exec_time = total_time - authn_time - att.authz_time - att.resp_time;
+    }
+
+    for (bucket = 0; bucket < NUM_BUCKETS - 1; bucket++)
+    {
+        if ( total_time <= BUCKET_LIMITS[bucket] )
+        {
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&stats_mutex);
+
+    stats.calls++;
+
+    // Rejected calls also get a failure response, they are only counted once
+    if ( rejected )
+    {
+        stats.rejected++;
+    }
+    else if ( att.failed )
+    {
+        stats.errors++;
+    }
+
+    stats.total_time += total_time;
+    stats.authn_time += authn_time;
+    stats.authz_time += att.authz_time;
+    stats.exec_time  += exec_time;
+    stats.resp_time  += att.resp_time;
+
+    if ( total_time > stats.max_time )
+    {
+        stats.max_time = total_time;
+    }
+
+    stats.histogram[bucket]++;
+
+    pthread_mutex_unlock(&stats_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+
+unsigned long Request::percentile(const MethodStats& st, unsigned int pct)
+{
+    unsigned long count  = 0;
+    unsigned long target = (st.calls * pct + 99) / 100;
+
+    for (int i = 0; i < NUM_BUCKETS - 1; i++)
+    {
+        count += st.histogram[i];
+
+        if ( count >= target )
+        {
+            return BUCKET_LIMITS[i];
+        }
+    }
+
+    return st.max_time;
+}
+
+/* -------------------------------------------------------------------------- */
+
+string& Request::stats_to_xml(const string& name, string& xml)
+{
+    ostringstream oss;
+    MethodStats   st;
+
+    pthread_mutex_lock(&stats_mutex);
+
+    st = stats;
+
+    pthread_mutex_unlock(&stats_mutex);
+
+    oss << "<METHOD>"
+        <<   "<NAME>"       << name          << "</NAME>"
+        <<   "<CALLS>"      << st.calls      << "</CALLS>"
+        <<   "<ERRORS>"     << st.errors     << "</ERRORS>"
+        <<   "<REJECTED>"   << st.rejected   << "</REJECTED>"
+        <<   "<TOTAL_TIME>" << st.total_time << "</TOTAL_TIME>"
+        <<   "<AUTHN_TIME>" << st.authn_time << "</AUTHN_TIME>"
+        <<   "<AUTHZ_TIME>" << st.authz_time << "</AUTHZ_TIME>"
+        <<   "<EXEC_TIME>"  << st.exec_time  << "</EXEC_TIME>"
+        <<   "<RESP_TIME>"  << st.resp_time  << "</RESP_TIME>"
+        <<   "<MAX_TIME>"   << st.max_time   << "</MAX_TIME>"
+        <<   "<HISTOGRAM>";
+
+    for (int i = 0; i < NUM_BUCKETS; i++)
+    {
+        oss << "<BUCKET>";
+
+        if ( i < NUM_BUCKETS - 1 )
+        {
+            oss << "<LIMIT>" << BUCKET_LIMITS[i] << "</LIMIT>";
+        }
+
+        oss << "<COUNT>" << st.histogram[i] << "</COUNT></BUCKET>";
+    }
+
+    oss <<   "</HISTOGRAM>"
+        << "</METHOD>";
+
+    xml = oss.str();
+
+    return xml;
+}
+
+/* -------------------------------------------------------------------------- */
+
+string& Request::stats_to_str(const string& name, string& str)
+{
+    ostringstream oss;
+    MethodStats   st;
+
+    pthread_mutex_lock(&stats_mutex);
+
+    st = stats;
+
+    pthread_mutex_unlock(&stats_mutex);
+
+    oss << name << ": " << st.calls << " calls, " << st.errors << " errors, "
+        << st.rejected << " rejected";
+
+    if ( st.calls > 0 )
+    {
+        oss << ", avg " << st.total_time / st.calls << "us"
+            << " (authn " << st.authn_time / st.calls
+            << ", authz " << st.authz_time / st.calls
+            << ", exec "  << st.exec_time  / st.calls
+            << ", resp "  << st.resp_time  / st.calls << ")"
+            << ", p50 <= " << percentile(st, 50) << "us"
+            << ", p90 <= " << percentile(st, 90) << "us"
+            << ", p99 <= " << percentile(st, 99) << "us"
+            << ", max " << st.max_time << "us";
+    }
+
+    str = oss.str();
+
+    return str;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 bool Request::basic_authorization(int oid,
                                   AuthRequest::Operation op,
                                   RequestAttributes& att)
+{
+    struct timeval start;
+
+    gettimeofday(&start, 0);
+
+    bool rc = authorize(oid, op, att);
+
+    att.authz_time += elapsed(start);
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Request::authorize(int oid,
+                        AuthRequest::Operation op,
+                        RequestAttributes& att)
 {
     PoolObjectSQL * object;
 
@@ -69,7 +291,7 @@ bool Request::basic_authorization(int oid,
 
     if ( oid >= 0 )
     {
-        object = pool->get(oid,true);
+        object = pool->get_ro(oid);
 
         if ( object == 0 )
         {
@@ -107,7 +329,11 @@ bool Request::basic_authorization(int oid,
 
 void Request::failure_response(ErrorCode ec, const string& str_val,
                                RequestAttributes& att)
-{    
+{
+    struct timeval start;
+
+    gettimeofday(&start, 0);
+
     vector<xmlrpc_c::value> arrayData;
 
     arrayData.push_back(xmlrpc_c::value_boolean(false));
@@ -118,6 +344,9 @@ void Request::failure_response(ErrorCode ec, const string& str_val,
 
     *(att.retval) = arrayresult;
 
+    att.failed     = true;
+    att.resp_time += elapsed(start);
+
     NebulaLog::log("ReM",Log::ERROR,str_val);
 }
 
@@ -125,7 +354,11 @@ void Request::failure_response(ErrorCode ec, const string& str_val,
 /* -------------------------------------------------------------------------- */
 
 void Request::success_response(int id, RequestAttributes& att)
-{    
+{
+    struct timeval start;
+
+    gettimeofday(&start, 0);
+
     vector<xmlrpc_c::value> arrayData;
 
     arrayData.push_back(xmlrpc_c::value_boolean(true));
@@ -136,12 +369,18 @@ void Request::success_response(int id, RequestAttributes& att)
     xmlrpc_c::value_array arrayresult(arrayData);
 
     *(att.retval) = arrayresult;
+
+    att.resp_time += elapsed(start);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Request::success_response(const string& val, RequestAttributes& att)
-{    
+{
+    struct timeval start;
+
+    gettimeofday(&start, 0);
+
     vector<xmlrpc_c::value> arrayData;
 
     arrayData.push_back(xmlrpc_c::value_boolean(true));
@@ -151,6 +390,30 @@ void Request::success_response(const string& val, RequestAttributes& att)
     xmlrpc_c::value_array arrayresult(arrayData);
 
     *(att.retval) = arrayresult;
+
+    att.resp_time += elapsed(start);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Request::success_response(const xmlrpc_c::value& val,
+                               RequestAttributes&     att)
+{
+    struct timeval start;
+
+    gettimeofday(&start, 0);
+
+    vector<xmlrpc_c::value> arrayData;
+
+    arrayData.push_back(xmlrpc_c::value_boolean(true));
+    arrayData.push_back(val);
+    arrayData.push_back(xmlrpc_c::value_int(SUCCESS));
+
+    xmlrpc_c::value_array arrayresult(arrayData);
+
+    *(att.retval) = arrayresult;
+
+    att.resp_time += elapsed(start);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -218,6 +481,18 @@ string Request::authenticate_error()
 
 /* -------------------------------------------------------------------------- */
 
+string Request::concurrency_error()
+{
+    ostringstream oss;
+
+    oss << "[" << method_name << "]" << " Too many concurrent calls (limit "
+        << max_concurrent << "), try again later.";
+
+    return oss.str();
+}
+
+/* -------------------------------------------------------------------------- */
+
 string Request::get_error (const string &object,
                            int id)
 {
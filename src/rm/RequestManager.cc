@@ -34,6 +34,8 @@
 #include "RequestManagerImage.h"
 #include "RequestManagerUser.h"
 #include "RequestManagerAcl.h"
+#include "RequestManagerSystem.h"
+#include "RequestManagerMonitoring.h"
 
 #include <sys/signal.h>
 #include <sys/socket.h>
@@ -60,7 +62,7 @@ extern "C" void * rm_action_loop(void *arg)
 
     rm = static_cast<RequestManager *>(arg);
     
-    rm->am.loop(0,0);
+    rm->am.loop(rm->stats_interval,0);
 
     NebulaLog::log("ReM",Log::INFO,"Request Manager stopped.");
     
@@ -92,7 +94,14 @@ extern "C" void * rm_xml_server_loop(void *arg)
     rm->AbyssServer = new xmlrpc_c::serverAbyss(xmlrpc_c::serverAbyss::constrOpt()
         .registryP(&rm->RequestManagerRegistry)
         .logFileName(rm->xml_log_file)
-        .socketFd(rm->socket_fd));
+        .socketFd(rm->socket_fd)
+#ifndef OLD_XMLRPC
+        .maxConn(rm->max_conn)
+        .maxConnBacklog(rm->max_conn_backlog)
+#endif
+        .keepaliveTimeout(rm->keepalive_timeout)
+        .keepaliveMaxConn(rm->keepalive_max_conn)
+        .timeout(rm->timeout));
         
     rm->AbyssServer->run();
 
@@ -184,7 +193,8 @@ int RequestManager::start()
     pthread_attr_init (&pattr);
     pthread_attr_setdetachstate (&pattr, PTHREAD_CREATE_JOINABLE);
     
-    oss << "Starting XML-RPC server, port " << port << " ...";
+    oss << "Starting XML-RPC server, port " << port << ", max connections "
+        << max_conn << ", backlog " << max_conn_backlog << " ...";
     NebulaLog::log("ReM",Log::INFO,oss);
     
     pthread_create(&rm_xml_server_thread,&pattr,rm_xml_server_loop,(void *)this);
@@ -199,7 +209,11 @@ void RequestManager::do_action(
         const string &  action,
         void *          arg)
 {
-    if (action == ACTION_FINALIZE)
+    if (action == ACTION_TIMER)
+    {
+        log_stats();
+    }
+    else if (action == ACTION_FINALIZE)
     {
         NebulaLog::log("ReM",Log::INFO,"Stopping Request Manager...");
         
@@ -225,6 +239,82 @@ void RequestManager::do_action(
     }    
 };
 
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void RequestManager::add_method(const string&         name,
+                                xmlrpc_c::methodPtr&  method)
+{
+    map<string,int>::iterator it = method_limits.find(name);
+    Request *                 rq = dynamic_cast<Request *>(method.get());
+
+    if ( rq != 0 )
+    {
+        methods.insert(make_pair(name, rq));
+    }
+
+    if ( it != method_limits.end() )
+    {
+        if ( rq != 0 )
+        {
+            ostringstream oss;
+
+            rq->set_max_concurrent(it->second);
+
+            oss << "Method " << name << " limited to " << it->second
+                << " concurrent calls.";
+
+            NebulaLog::log("ReM",Log::INFO,oss);
+        }
+    }
+
+    RequestManagerRegistry.addMethod(name, method);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+string& RequestManager::stats_to_xml(string& xml)
+{
+    ostringstream oss;
+    string        method_xml;
+
+    map<string,Request *>::iterator it;
+
+    oss << "<REQUEST_STATS>";
+
+    for (it = methods.begin(); it != methods.end(); it++)
+    {
+        oss << it->second->stats_to_xml(it->first, method_xml);
+    }
+
+    oss << "</REQUEST_STATS>";
+
+    xml = oss.str();
+
+    return xml;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RequestManager::log_stats()
+{
+    string str;
+
+    map<string,Request *>::iterator it;
+
+    for (it = methods.begin(); it != methods.end(); it++)
+    {
+        if ( it->second->get_calls() == 0 )
+        {
+            continue;
+        }
+
+        NebulaLog::log("ReM", Log::INFO,
+                       it->second->stats_to_str(it->first, str));
+    }
+}
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
         
@@ -236,16 +326,22 @@ void RequestManager::register_xml_methods()
 
     // VMTemplate Methods
     xmlrpc_c::methodPtr template_instantiate(new VMTemplateInstantiate());
+    xmlrpc_c::methodPtr template_batchinstantiate(
+                                        new VMTemplateInstantiateBatch());
 
     // VirtualMachine Methods
     xmlrpc_c::methodPtr vm_deploy(new VirtualMachineDeploy());
     xmlrpc_c::methodPtr vm_migrate(new VirtualMachineMigrate());
     xmlrpc_c::methodPtr vm_action(new VirtualMachineAction()); 
     xmlrpc_c::methodPtr vm_savedisk(new VirtualMachineSaveDisk());
+    xmlrpc_c::methodPtr vm_batchaction(new VirtualMachineActionBatch());
+    xmlrpc_c::methodPtr vm_batchdeploy(new VirtualMachineDeployBatch());
 
     // VirtualNetwork Methods
     xmlrpc_c::methodPtr vn_addleases(new VirtualNetworkAddLeases());
     xmlrpc_c::methodPtr vn_rmleases(new VirtualNetworkRemoveLeases());
+    xmlrpc_c::methodPtr vn_hold(new VirtualNetworkHoldLeases());
+    xmlrpc_c::methodPtr vn_release(new VirtualNetworkReleaseLeases());
 
     // Update Template Methods
     xmlrpc_c::methodPtr image_update(new ImageUpdateTemplate());
@@ -311,89 +407,108 @@ void RequestManager::register_xml_methods()
     xmlrpc_c::methodPtr image_chown(new ImageChown());
     xmlrpc_c::methodPtr user_chown(new UserChown());
 
+    // Monitoring Methods
+    xmlrpc_c::methodPtr vm_monitoring(new VirtualMachineMonitoring());
+    xmlrpc_c::methodPtr host_monitoring(new HostMonitoring());
+
     // ACL Methods
     xmlrpc_c::methodPtr acl_addrule(new AclAddRule());
     xmlrpc_c::methodPtr acl_delrule(new AclDelRule());
     xmlrpc_c::methodPtr acl_info(new AclInfo());
 
-    /* VM related methods  */    
-    RequestManagerRegistry.addMethod("one.vm.deploy", vm_deploy);
-    RequestManagerRegistry.addMethod("one.vm.action", vm_action);
-    RequestManagerRegistry.addMethod("one.vm.migrate", vm_migrate);
-    RequestManagerRegistry.addMethod("one.vm.savedisk", vm_savedisk);
-    RequestManagerRegistry.addMethod("one.vm.allocate", vm_allocate);
-    RequestManagerRegistry.addMethod("one.vm.info", vm_info);
-    RequestManagerRegistry.addMethod("one.vm.chown", vm_chown);
+    // System Methods
+    xmlrpc_c::methodPtr system_stats(new SystemStats(this));
+    xmlrpc_c::methodPtr system_changes(new SystemChanges());
 
-    RequestManagerRegistry.addMethod("one.vmpool.info", vm_pool_info);
+    /* VM related methods  */    
+    add_method("one.vm.deploy", vm_deploy);
+    add_method("one.vm.action", vm_action);
+    add_method("one.vm.migrate", vm_migrate);
+    add_method("one.vm.savedisk", vm_savedisk);
+    add_method("one.vm.allocate", vm_allocate);
+    add_method("one.vm.info", vm_info);
+    add_method("one.vm.monitoring", vm_monitoring);
+    add_method("one.vm.chown", vm_chown);
+    add_method("one.vm.batchaction", vm_batchaction);
+    add_method("one.vm.batchdeploy", vm_batchdeploy);
+
+    add_method("one.vmpool.info", vm_pool_info);
 
     /* VM Template related methods*/
-    RequestManagerRegistry.addMethod("one.template.update", template_update);
-    RequestManagerRegistry.addMethod("one.template.instantiate",template_instantiate);
-    RequestManagerRegistry.addMethod("one.template.allocate",template_allocate);
-    RequestManagerRegistry.addMethod("one.template.publish", template_publish);
-    RequestManagerRegistry.addMethod("one.template.delete", template_delete);
-    RequestManagerRegistry.addMethod("one.template.info", template_info);
-    RequestManagerRegistry.addMethod("one.template.chown", template_chown);
+    add_method("one.template.update", template_update);
+    add_method("one.template.instantiate",template_instantiate);
+    add_method("one.template.batchinstantiate",template_batchinstantiate);
+    add_method("one.template.allocate",template_allocate);
+    add_method("one.template.publish", template_publish);
+    add_method("one.template.delete", template_delete);
+    add_method("one.template.info", template_info);
+    add_method("one.template.chown", template_chown);
 
-    RequestManagerRegistry.addMethod("one.templatepool.info",template_pool_info);
+    add_method("one.templatepool.info",template_pool_info);
 
     /* Host related methods*/
-    RequestManagerRegistry.addMethod("one.host.enable", host_enable);
-    RequestManagerRegistry.addMethod("one.host.update", host_update);
-    RequestManagerRegistry.addMethod("one.host.allocate", host_allocate);   
-    RequestManagerRegistry.addMethod("one.host.delete", host_delete);
-    RequestManagerRegistry.addMethod("one.host.info", host_info);
+    add_method("one.host.enable", host_enable);
+    add_method("one.host.update", host_update);
+    add_method("one.host.allocate", host_allocate);
+    add_method("one.host.delete", host_delete);
+    add_method("one.host.info", host_info);
+    add_method("one.host.monitoring", host_monitoring);
 
-    RequestManagerRegistry.addMethod("one.hostpool.info", hostpool_info); 
+    add_method("one.hostpool.info", hostpool_info);
 
     /* Group related methods */
-    RequestManagerRegistry.addMethod("one.group.allocate",  group_allocate);
-    RequestManagerRegistry.addMethod("one.group.delete",    group_delete);
-    RequestManagerRegistry.addMethod("one.group.info",      group_info);
+    add_method("one.group.allocate",  group_allocate);
+    add_method("one.group.delete",    group_delete);
+    add_method("one.group.info",      group_info);
 
-    RequestManagerRegistry.addMethod("one.grouppool.info",  grouppool_info);
+    add_method("one.grouppool.info",  grouppool_info);
 
     /* Network related methods*/
-    RequestManagerRegistry.addMethod("one.vn.addleases", vn_addleases);
-    RequestManagerRegistry.addMethod("one.vn.rmleases", vn_rmleases);
-    RequestManagerRegistry.addMethod("one.vn.allocate", vn_allocate);   
-    RequestManagerRegistry.addMethod("one.vn.publish", vn_publish);
-    RequestManagerRegistry.addMethod("one.vn.update", vn_update);
-    RequestManagerRegistry.addMethod("one.vn.delete", vn_delete);
-    RequestManagerRegistry.addMethod("one.vn.info", vn_info); 
-    RequestManagerRegistry.addMethod("one.vn.chown", vn_chown);
-
-    RequestManagerRegistry.addMethod("one.vnpool.info", vnpool_info); 
+    add_method("one.vn.addleases", vn_addleases);
+    add_method("one.vn.rmleases", vn_rmleases);
+    add_method("one.vn.hold", vn_hold);
+    add_method("one.vn.release", vn_release);
+    add_method("one.vn.allocate", vn_allocate);
+    add_method("one.vn.publish", vn_publish);
+    add_method("one.vn.update", vn_update);
+    add_method("one.vn.delete", vn_delete);
+    add_method("one.vn.info", vn_info);
+    add_method("one.vn.chown", vn_chown);
+
+    add_method("one.vnpool.info", vnpool_info);
     
     /* User related methods*/
-    RequestManagerRegistry.addMethod("one.user.allocate", user_allocate);
-    RequestManagerRegistry.addMethod("one.user.update", user_update);
-    RequestManagerRegistry.addMethod("one.user.delete", user_delete);
-    RequestManagerRegistry.addMethod("one.user.info", user_info);
-    RequestManagerRegistry.addMethod("one.user.passwd", user_change_password);
-    RequestManagerRegistry.addMethod("one.user.chgrp", user_chown);
-    RequestManagerRegistry.addMethod("one.user.chauth", user_change_auth);
-
-    RequestManagerRegistry.addMethod("one.userpool.info", userpool_info);
+    add_method("one.user.allocate", user_allocate);
+    add_method("one.user.update", user_update);
+    add_method("one.user.delete", user_delete);
+    add_method("one.user.info", user_info);
+    add_method("one.user.passwd", user_change_password);
+    add_method("one.user.chgrp", user_chown);
+    add_method("one.user.chauth", user_change_auth);
+
+    add_method("one.userpool.info", userpool_info);
     
     /* Image related methods*/
-    RequestManagerRegistry.addMethod("one.image.persistent", image_persistent);
-    RequestManagerRegistry.addMethod("one.image.enable", image_enable);
-    RequestManagerRegistry.addMethod("one.image.update", image_update);     
-    RequestManagerRegistry.addMethod("one.image.allocate", image_allocate);
-    RequestManagerRegistry.addMethod("one.image.publish", image_publish);
-    RequestManagerRegistry.addMethod("one.image.delete", image_delete);
-    RequestManagerRegistry.addMethod("one.image.info", image_info);
-    RequestManagerRegistry.addMethod("one.image.chown", image_chown);
-    RequestManagerRegistry.addMethod("one.image.chtype", image_chtype);
-
-    RequestManagerRegistry.addMethod("one.imagepool.info", imagepool_info);
+    add_method("one.image.persistent", image_persistent);
+    add_method("one.image.enable", image_enable);
+    add_method("one.image.update", image_update);
+    add_method("one.image.allocate", image_allocate);
+    add_method("one.image.publish", image_publish);
+    add_method("one.image.delete", image_delete);
+    add_method("one.image.info", image_info);
+    add_method("one.image.chown", image_chown);
+    add_method("one.image.chtype", image_chtype);
+
+    add_method("one.imagepool.info", imagepool_info);
 
     /* ACL related methods */
-    RequestManagerRegistry.addMethod("one.acl.addrule", acl_addrule);
-    RequestManagerRegistry.addMethod("one.acl.delrule", acl_delrule);
-    RequestManagerRegistry.addMethod("one.acl.info",    acl_info);
+    add_method("one.acl.addrule", acl_addrule);
+    add_method("one.acl.delrule", acl_delrule);
+    add_method("one.acl.info",    acl_info);
+
+    /* System related methods */
+    add_method("one.system.stats",   system_stats);
+    add_method("one.system.changes", system_changes);
 };
 
 /* -------------------------------------------------------------------------- */
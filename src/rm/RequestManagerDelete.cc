@@ -72,6 +72,25 @@ int ImageDelete::drop(int oid, PoolObjectSQL * object, string& error_msg)
 
 /* ------------------------------------------------------------------------- */
 
+int HostDelete::drop(int oid, PoolObjectSQL * object, string& error_msg)
+{
+    int rc = RequestManagerDelete::drop(oid, object, error_msg);
+
+    if ( rc == 0 )
+    {
+        MonitorStore * store = Nebula::instance().get_monitor_store();
+
+        if ( store != 0 )
+        {
+            store->remove(MonitorStore::HOST, oid);
+        }
+    }
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------- */
+
 int UserDelete::drop(int oid, PoolObjectSQL * object, string& error_msg)
 {
     User * user  = static_cast<User *>(object);
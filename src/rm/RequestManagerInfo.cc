@@ -45,7 +45,7 @@ void RequestManagerInfo::request_execute(xmlrpc_c::paramList const& paramList,
         return;
     }
 
-    object = pool->get(oid,true);
+    object = pool->get_ro(oid);
 
     if ( object == 0 )                             
     {                                            
@@ -0,0 +1,66 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "RequestManagerMonitoring.h"
+
+using namespace std;
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+void RequestManagerMonitoring::request_execute(
+        xmlrpc_c::paramList const&  paramList,
+        RequestAttributes&          att)
+{
+    int oid   = xmlrpc_c::value_int(paramList.getInt(1));
+    int start = xmlrpc_c::value_int(paramList.getInt(2));
+    int end   = xmlrpc_c::value_int(paramList.getInt(3));
+
+    string xml;
+
+    if ( basic_authorization(oid, att) == false )
+    {
+        return;
+    }
+
+    if ( monitor_store == 0 )
+    {
+        failure_response(ACTION,
+                request_error("The monitoring store is disabled in oned.conf",
+                              ""),
+                att);
+        return;
+    }
+
+    if ( start < 0 )
+    {
+        start = 0;
+    }
+
+    if ( end < 0 )
+    {
+        end = -1;
+    }
+
+    monitor_store->to_xml(monitor_type, oid, start, end, xml);
+
+    success_response(xml, att);
+
+    return;
+}
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
@@ -0,0 +1,89 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "RequestManagerSystem.h"
+
+using namespace std;
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+void SystemStats::request_execute(xmlrpc_c::paramList const& paramList,
+                                  RequestAttributes& att)
+{
+    string xml;
+
+    // Statistics are only available to the users that can manage the ACLs
+    if ( basic_authorization(-1, att) == false )
+    {
+        return;
+    }
+
+    success_response(rm->stats_to_xml(xml), att);
+
+    return;
+}
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+const int SystemChanges::MAX_WAIT = 60;
+
+/* ------------------------------------------------------------------------- */
+
+void SystemChanges::request_execute(xmlrpc_c::paramList const& paramList,
+                                    RequestAttributes& att)
+{
+    long long seq     = xmlrpc_c::value_i8(paramList.getI8(1));
+    int       timeout = xmlrpc_c::value_int(paramList.getInt(2));
+
+    string xml;
+
+    // The changes reveal every object in the pools, same rights as the ACLs
+    if ( basic_authorization(-1, att) == false )
+    {
+        return;
+    }
+
+    if ( change_log == 0 )
+    {
+        failure_response(ACTION,
+                request_error("The change log is disabled in oned.conf",""),
+                att);
+        return;
+    }
+
+    if ( seq < 0 )
+    {
+        seq = 0;
+    }
+
+    if ( timeout < 0 )
+    {
+        timeout = 0;
+    }
+    else if ( timeout > MAX_WAIT )
+    {
+        timeout = MAX_WAIT;
+    }
+
+    success_response(change_log->to_xml(seq, timeout, xml), att);
+
+    return;
+}
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
@@ -20,24 +20,19 @@
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-void VMTemplateInstantiate::request_execute(xmlrpc_c::paramList const& paramList,
-                                            RequestAttributes& att)
+VirtualMachineTemplate * RequestManagerVMTemplate::instance_template(
+        int                id,
+        const string&      name,
+        RequestAttributes& att)
 {
-    int    id   = xmlrpc_c::value_int(paramList.getInt(1));
-    string name = xmlrpc_c::value_string(paramList.getString(2));
-
-    int    rc, ouid, ogid, vid;
+    int    ouid, ogid;
     bool   pub;
 
-    Nebula& nd = Nebula::instance();
-    VirtualMachinePool* vmpool = nd.get_vmpool();
-    VMTemplatePool * tpool     = static_cast<VMTemplatePool *>(pool);
+    VMTemplatePool * tpool = static_cast<VMTemplatePool *>(pool);
 
     VirtualMachineTemplate * tmpl;
     VMTemplate *             rtmpl;
 
-    string error_str;
-
     rtmpl = tpool->get(id,true);
 
     if ( rtmpl == 0 )
@@ -46,7 +41,7 @@ void VMTemplateInstantiate::request_execute(xmlrpc_c::paramList const& paramList
                 get_error(object_name(auth_object),id),
                 att);
 
-        return;
+        return 0;
     }
 
     tmpl = rtmpl->clone_template();
@@ -81,10 +76,38 @@ void VMTemplateInstantiate::request_execute(xmlrpc_c::paramList const& paramList
                     att);
 
             delete tmpl;
-            return;
+            return 0;
         }
     }
 
+    return tmpl;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void VMTemplateInstantiate::request_execute(xmlrpc_c::paramList const& paramList,
+                                            RequestAttributes& att)
+{
+    int    id   = xmlrpc_c::value_int(paramList.getInt(1));
+    string name = xmlrpc_c::value_string(paramList.getString(2));
+
+    int    rc, vid;
+
+    Nebula& nd = Nebula::instance();
+    VirtualMachinePool* vmpool = nd.get_vmpool();
+
+    VirtualMachineTemplate * tmpl;
+
+    string error_str;
+
+    tmpl = instance_template(id, name, att);
+
+    if ( tmpl == 0 )
+    {
+        return;
+    }
+
     rc = vmpool->allocate(att.uid, att.gid, att.uname, att.gname, tmpl, &vid,
             error_str, false);
 
@@ -103,3 +126,230 @@ void VMTemplateInstantiate::request_execute(xmlrpc_c::paramList const& paramList
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void VMTemplateInstantiateBatch::request_execute(
+        xmlrpc_c::paramList const& paramList,
+        RequestAttributes&         att)
+{
+    int    id    = xmlrpc_c::value_int(paramList.getInt(1));
+    string name  = xmlrpc_c::value_string(paramList.getString(2));
+    int    count = xmlrpc_c::value_int(paramList.getInt(3));
+
+    int    rc, num_nics;
+
+    Nebula& nd = Nebula::instance();
+    VirtualMachinePool* vmpool = nd.get_vmpool();
+    VirtualNetworkPool* vnpool = nd.get_vnpool();
+
+    VirtualMachineTemplate * tmpl;
+    vector<Attribute *>      nics;
+    vector<int>              nids;
+    vector< vector<string> > held_ips;
+    vector< vector<string> > held_macs;
+    vector<int>              vids;
+    vector<xmlrpc_c::value>  results;
+    ostringstream            oss;
+
+    if ( count <= 0 || count > MAX_VMS )
+    {
+        oss << "It must be between 1 and " << MAX_VMS;
+
+        failure_response(XML_RPC_API,
+                request_error("Wrong number of virtual machines",oss.str()),
+                att);
+        return;
+    }
+
+    tmpl = instance_template(id, name, att);
+
+    if ( tmpl == 0 )
+    {
+        return;
+    }
+
+    // -------------------------------------------------------------------------
+    // Hold the leases of all the VMs, a single operation for each NIC. The
+    // network attributes are set in the NICs of the template
+    // -------------------------------------------------------------------------
+
+    num_nics = tmpl->get("NIC", nics);
+
+    for (int i = 0; i < num_nics; i++)
+    {
+        VectorAttribute * nic = dynamic_cast<VectorAttribute *>(nics[i]);
+
+        vector<string> ips;
+        vector<string> macs;
+        istringstream  is;
+        int            nid = -1;
+
+        if ( nic != 0 && ( !nic->vector_value("NETWORK").empty() ||
+                           !nic->vector_value("NETWORK_ID").empty() ) )
+        {
+            if ( !nic->vector_value("IP").empty() )
+            {
+                oss << "NIC with a fixed IP can not be used by a set of VMs.";
+                goto error_leases;
+            }
+
+            rc = vnpool->hold_nic_leases(nic, count, ips, macs);
+
+            if ( rc == -1 )
+            {
+                oss << "Could not get virtual network "
+                    << nic->vector_value("NETWORK_ID") << ".";
+                goto error_leases;
+            }
+            else if ( rc == -2 )
+            {
+                oss << "Not enough free leases in virtual network "
+                    << nic->vector_value("NETWORK_ID") << ".";
+                goto error_leases;
+            }
+            else if ( rc == -3 )
+            {
+                oss << "NETWORK is not supported for NIC. "
+                    << "Use NETWORK_ID instead.";
+                goto error_leases;
+            }
+
+            is.str(nic->vector_value("NETWORK_ID"));
+            is >> nid;
+        }
+
+        nids.push_back(nid);
+        held_ips.push_back(ips);
+        held_macs.push_back(macs);
+    }
+
+    // -------------------------------------------------------------------------
+    // Allocate the VMs, their NICs get the held leases
+    // -------------------------------------------------------------------------
+
+    for (int i = 0; i < count; i++)
+    {
+        VirtualMachineTemplate * vm_tmpl = new VirtualMachineTemplate(*tmpl);
+        vector<Attribute *>      vm_nics;
+        xmlrpc_c::value          result;
+        RequestAttributes        item_att = att;
+
+        string error_str;
+        int    vid;
+
+        item_att.retval = &result;
+        item_att.failed = false;
+
+        if ( !name.empty() && count > 1 )
+        {
+            ostringstream vm_name;
+
+            vm_name << name << "-" << i;
+
+            vm_tmpl->erase("NAME");
+            vm_tmpl->set(new SingleAttribute("NAME",vm_name.str()));
+        }
+
+        vm_tmpl->get("NIC", vm_nics);
+
+        for (unsigned int j = 0; j < nids.size() && j < vm_nics.size(); j++)
+        {
+            VectorAttribute * nic = dynamic_cast<VectorAttribute *>(vm_nics[j]);
+
+            if ( nids[j] != -1 && nic != 0 )
+            {
+                nic->replace("IP",  held_ips[j][i]);
+                nic->replace("MAC", held_macs[j][i]);
+            }
+        }
+
+        rc = vmpool->allocate(att.uid, att.gid, att.uname, att.gname, vm_tmpl,
+                &vid, error_str, false, true);
+
+        if ( rc < 0 )
+        {
+            failure_response(INTERNAL,
+                    allocate_error(AuthRequest::VM,error_str),
+                    item_att);
+
+            vids.push_back(-1);
+        }
+        else
+        {
+            success_response(vid, item_att);
+
+            vids.push_back(vid);
+        }
+
+        att.resp_time = item_att.resp_time;
+
+        results.push_back(result);
+    }
+
+    // -------------------------------------------------------------------------
+    // Set the held leases for the new VMs, a single operation for each NIC.
+    // The leases of the VMs that could not be allocated are released
+    // -------------------------------------------------------------------------
+
+    for (unsigned int j = 0; j < nids.size(); j++)
+    {
+        vector<string> bound_ips;
+        vector<int>    bound_vids;
+        vector<string> free_ips;
+
+        if ( nids[j] == -1 )
+        {
+            continue;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            if ( vids[i] != -1 )
+            {
+                bound_ips.push_back(held_ips[j][i]);
+                bound_vids.push_back(vids[i]);
+            }
+            else
+            {
+                free_ips.push_back(held_ips[j][i]);
+            }
+        }
+
+        if ( !bound_ips.empty() &&
+             vnpool->bind_held_leases(nids[j], bound_ips, bound_vids) != 0 )
+        {
+            oss.str("");
+            oss << "Could not set the held leases of virtual network "
+                << nids[j] << " for the new VMs.";
+
+            NebulaLog::log("ReM", Log::ERROR, oss);
+        }
+
+        if ( !free_ips.empty() )
+        {
+            vnpool->release_held_leases(nids[j], free_ips);
+        }
+    }
+
+    delete tmpl;
+
+    success_response(xmlrpc_c::value_array(results), att);
+
+    return;
+
+error_leases:
+    for (unsigned int j = 0; j < nids.size(); j++)
+    {
+        if ( nids[j] != -1 )
+        {
+            vnpool->release_held_leases(nids[j], held_ips[j]);
+        }
+    }
+
+    delete tmpl;
+
+    failure_response(ACTION,
+            request_error("Error holding network leases", oss.str()),
+            att);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
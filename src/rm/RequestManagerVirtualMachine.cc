@@ -86,6 +86,51 @@ bool RequestManagerVirtualMachine::vm_authorization(int oid,
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+bool RequestManagerVirtualMachine::bulk_authorization(const vector<int>& ids,
+                                                      const set<int>&    hids,
+                                                      RequestAttributes& att)
+{
+    PoolObjectSQL * object;
+
+    set<int>::const_iterator it;
+
+    if ( att.uid == 0 )
+    {
+        return true;
+    }
+
+    AuthRequest ar(att.uid, att.gid);
+
+    for (unsigned int i = 0; i < ids.size(); i++)
+    {
+        object = pool->get(ids[i],true);
+
+        if ( object == 0 )
+        {
+            return false;
+        }
+
+        ar.add_auth(auth_object,
+                    ids[i],
+                    object->get_gid(),
+                    auth_op,
+                    object->get_uid(),
+                    false);
+
+        object->unlock();
+    }
+
+    for (it = hids.begin(); it != hids.end(); it++)
+    {
+        ar.add_auth(AuthRequest::HOST,*it,-1,AuthRequest::USE,0,false);
+    }
+
+    return (UserPool::authorize(ar) != -1);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 int RequestManagerVirtualMachine::get_host_information(int hid, 
                                                 string& name, 
                                                 string& vmm, 
@@ -174,22 +219,15 @@ int RequestManagerVirtualMachine::add_history(VirtualMachine * vm,
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
-void VirtualMachineAction::request_execute(xmlrpc_c::paramList const& paramList,
-                                           RequestAttributes& att)
+void RequestManagerVirtualMachine::vm_action(const string&      action,
+                                             int                id,
+                                             RequestAttributes& att)
 {
-    string action = xmlrpc_c::value_string(paramList.getString(1));
-    int    id     = xmlrpc_c::value_int(paramList.getInt(2));
-
-    int    rc;
+    int    rc = -3;
 
     Nebula& nd = Nebula::instance();
     DispatchManager * dm = nd.get_dm();
 
-    if ( vm_authorization(id,-1,0,att) == false )
-    {
-        return;
-    }
-
     if (action == "shutdown")
     {
         rc = dm->shutdown(id);
@@ -263,8 +301,71 @@ void VirtualMachineAction::request_execute(xmlrpc_c::paramList const& paramList,
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-void VirtualMachineDeploy::request_execute(xmlrpc_c::paramList const& paramList,
+void VirtualMachineAction::request_execute(xmlrpc_c::paramList const& paramList,
                                            RequestAttributes& att)
+{
+    string action = xmlrpc_c::value_string(paramList.getString(1));
+    int    id     = xmlrpc_c::value_int(paramList.getInt(2));
+
+    if ( vm_authorization(id,-1,0,att) == false )
+    {
+        return;
+    }
+
+    vm_action(action, id, att);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void VirtualMachineActionBatch::request_execute(
+        xmlrpc_c::paramList const& paramList,
+        RequestAttributes&         att)
+{
+    string action = xmlrpc_c::value_string(paramList.getString(1));
+
+    vector<xmlrpc_c::value> id_array = paramList.getArray(2);
+    vector<xmlrpc_c::value> results;
+    vector<int>             ids;
+    set<int>                hids;
+
+    bool authorized;
+
+    for (unsigned int i = 0; i < id_array.size(); i++)
+    {
+        ids.push_back(xmlrpc_c::value_int(id_array[i]));
+    }
+
+    authorized = bulk_authorization(ids, hids, att);
+
+    for (unsigned int i = 0; i < ids.size(); i++)
+    {
+        xmlrpc_c::value   result;
+        RequestAttributes item_att = att;
+
+        item_att.retval = &result;
+        item_att.failed = false;
+
+        if ( authorized || vm_authorization(ids[i],-1,0,item_att) )
+        {
+            vm_action(action, ids[i], item_att);
+        }
+
+        att.authz_time = item_att.authz_time;
+        att.resp_time  = item_att.resp_time;
+
+        results.push_back(result);
+    }
+
+    success_response(xmlrpc_c::value_array(results), att);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void RequestManagerVirtualMachine::vm_deploy(int                id,
+                                             int                hid,
+                                             RequestAttributes& att)
 {
     Nebula&             nd = Nebula::instance();
     DispatchManager *   dm = nd.get_dm();
@@ -275,14 +376,6 @@ void VirtualMachineDeploy::request_execute(xmlrpc_c::paramList const& paramList,
     string vmm_mad;
     string tm_mad;
 
-    int id  = xmlrpc_c::value_int(paramList.getInt(1));
-    int hid = xmlrpc_c::value_int(paramList.getInt(2));
-
-    if ( vm_authorization(id,hid,0,att) == false )
-    {
-        return;
-    }
-
     if (get_host_information(hid,hostname,vmm_mad,tm_mad, att) != 0)
     {
         return;
@@ -319,6 +412,82 @@ void VirtualMachineDeploy::request_execute(xmlrpc_c::paramList const& paramList,
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void VirtualMachineDeploy::request_execute(xmlrpc_c::paramList const& paramList,
+                                           RequestAttributes& att)
+{
+    int id  = xmlrpc_c::value_int(paramList.getInt(1));
+    int hid = xmlrpc_c::value_int(paramList.getInt(2));
+
+    if ( vm_authorization(id,hid,0,att) == false )
+    {
+        return;
+    }
+
+    vm_deploy(id, hid, att);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void VirtualMachineDeployBatch::request_execute(
+        xmlrpc_c::paramList const& paramList,
+        RequestAttributes&         att)
+{
+    vector<xmlrpc_c::value> deploy_array = paramList.getArray(1);
+    vector<xmlrpc_c::value> results;
+    vector<int>             ids;
+    vector<int>             host_ids;
+    set<int>                hids;
+
+    bool authorized;
+
+    for (unsigned int i = 0; i < deploy_array.size(); i++)
+    {
+        vector<xmlrpc_c::value> deployment =
+            xmlrpc_c::value_array(deploy_array[i]).vectorValueValue();
+
+        if ( deployment.size() != 2 )
+        {
+            failure_response(XML_RPC_API,
+                    request_error("Wrong deployment, expected [vm id, host id]",
+                                  ""),
+                    att);
+            return;
+        }
+
+        ids.push_back(xmlrpc_c::value_int(deployment[0]));
+        host_ids.push_back(xmlrpc_c::value_int(deployment[1]));
+
+        hids.insert(host_ids.back());
+    }
+
+    authorized = bulk_authorization(ids, hids, att);
+
+    for (unsigned int i = 0; i < ids.size(); i++)
+    {
+        xmlrpc_c::value   result;
+        RequestAttributes item_att = att;
+
+        item_att.retval = &result;
+        item_att.failed = false;
+
+        if ( authorized || vm_authorization(ids[i],host_ids[i],0,item_att) )
+        {
+            vm_deploy(ids[i], host_ids[i], item_att);
+        }
+
+        att.authz_time = item_att.authz_time;
+        att.resp_time  = item_att.resp_time;
+
+        results.push_back(result);
+    }
+
+    success_response(xmlrpc_c::value_array(results), att);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void VirtualMachineMigrate::request_execute(xmlrpc_c::paramList const& paramList,
                                             RequestAttributes& att)
 {
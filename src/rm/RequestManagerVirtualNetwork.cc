@@ -94,3 +94,65 @@ void RequestManagerVirtualNetwork::
     success_response(id, att);
 }
 
+/* ------------------------------------------------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+void VirtualNetworkHoldLeases::request_execute(
+        xmlrpc_c::paramList const& paramList,
+        RequestAttributes&         att)
+{
+    int id  = xmlrpc_c::value_int(paramList.getInt(1));
+    int num = xmlrpc_c::value_int(paramList.getInt(2));
+
+    VirtualNetworkPool *    vnpool = static_cast<VirtualNetworkPool *>(pool);
+    vector<string>          ips;
+    vector<string>          macs;
+    vector<xmlrpc_c::value> leases;
+
+    int rc;
+
+    if ( num <= 0 || num > MAX_LEASES )
+    {
+        ostringstream oss;
+
+        oss << "It must be between 1 and " << MAX_LEASES;
+
+        failure_response(XML_RPC_API,
+                request_error("Wrong number of leases",oss.str()),
+                att);
+        return;
+    }
+
+    if ( basic_authorization(id, att) == false )
+    {
+        return;
+    }
+
+    rc = vnpool->hold_leases(id, num, ips, macs);
+
+    if ( rc == -1 )
+    {
+        failure_response(NO_EXISTS, get_error(object_name(auth_object),id),att);
+        return;
+    }
+    else if ( rc != 0 )
+    {
+        failure_response(ACTION,
+                request_error("Error holding network leases",
+                              "Not enough free leases"),
+                att);
+        return;
+    }
+
+    for (unsigned int i = 0; i < ips.size(); i++)
+    {
+        vector<xmlrpc_c::value> lease;
+
+        lease.push_back(xmlrpc_c::value_string(ips[i]));
+        lease.push_back(xmlrpc_c::value_string(macs[i]));
+
+        leases.push_back(xmlrpc_c::value_array(lease));
+    }
+
+    success_response(xmlrpc_c::value_array(leases), att);
+}
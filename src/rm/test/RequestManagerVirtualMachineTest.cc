@@ -0,0 +1,600 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <stdlib.h>
+
+#include "Nebula.h"
+#include "NebulaTest.h"
+#include "test/OneUnitTest.h"
+#include "DummyManager.h"
+#include "RequestManagerVirtualMachine.h"
+#include "RequestManagerInfo.h"
+
+using namespace std;
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+const string admin_session = "one_user_test:password";
+const string user_session  = "user_a:pass_a";
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class NebulaTestRMVM: public NebulaTest
+{
+public:
+    NebulaTestRMVM():NebulaTest()
+    {
+        NebulaTest::the_tester = this;
+
+        need_vm_pool    = true;
+        need_host_pool  = true;
+        need_user_pool  = true;
+        need_group_pool = true;
+        need_vnet_pool  = true;
+        need_image_pool = true;
+
+        need_vmm  = true;
+        need_lcm  = true;
+        need_tm   = true;
+        need_dm   = true;
+        need_aclm = true;
+    };
+
+    // The VMM and TM ignore the actions, so the VMs stay in the state set
+    // by the requests
+
+    TransferManager* create_tm(VirtualMachinePool* vmpool,
+                               HostPool*           hpool)
+    {
+        vector<const Attribute *> tm_mads;
+
+        return new TransferManagerTest(vmpool, hpool, tm_mads);
+    };
+
+    VirtualMachineManager* create_vmm(VirtualMachinePool* vmpool,
+                                      HostPool*           hpool,
+                                      time_t              timer_period,
+                                      time_t              poll_period)
+    {
+        vector<const Attribute *> vmm_mads;
+
+        return new VirtualMachineManagerTest(vmpool,
+                                             hpool,
+                                             timer_period,
+                                             poll_period,
+                                             vmm_mads);
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class RequestManagerVirtualMachineTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (RequestManagerVirtualMachineTest);
+
+    CPPUNIT_TEST (batch_action);
+    CPPUNIT_TEST (batch_action_partial);
+    CPPUNIT_TEST (batch_action_authorization);
+    CPPUNIT_TEST (batch_deploy);
+    CPPUNIT_TEST (batch_deploy_authorization);
+    CPPUNIT_TEST (batch_deploy_malformed);
+    CPPUNIT_TEST (info_cache);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+private:
+    NebulaTestRMVM *     tester;
+
+    VirtualMachinePool * vmpool;
+
+    int uid_a;    /**< A user in the USERS group */
+    int hid;      /**< A host */
+
+    int vm_a[2];  /**< VMs owned by user_a */
+    int vm_admin; /**< A VM owned by oneadmin */
+
+    /**
+     *  Allocates a VM for the given user
+     */
+    int allocate(int uid, int gid, const string& uname, const string& gname)
+    {
+        VirtualMachineTemplate * vm_template;
+
+        char * error_msg = 0;
+        string error_str;
+        int    oid;
+
+        vm_template = new VirtualMachineTemplate;
+
+        vm_template->parse("NAME = test\nMEMORY = 128\nCPU = 1", &error_msg);
+
+        vmpool->allocate(uid, gid, uname, gname, vm_template, &oid, error_str);
+
+        return oid;
+    };
+
+    /**
+     *  Gets the state of a VM
+     */
+    VirtualMachine::VmState state(int oid)
+    {
+        VirtualMachine *        vm;
+        VirtualMachine::VmState st;
+
+        vm = vmpool->get(oid, true);
+
+        st = vm->get_state();
+
+        vm->unlock();
+
+        return st;
+    };
+
+    /**
+     *  Gets the values of a method response, and checks that the call did
+     *  not fail as a whole
+     */
+    static vector<xmlrpc_c::value> batch_results(const xmlrpc_c::value& rv)
+    {
+        vector<xmlrpc_c::value> values =
+            xmlrpc_c::value_array(rv).vectorValueValue();
+
+        CPPUNIT_ASSERT( xmlrpc_c::value_boolean(values[0]) == true );
+
+        return xmlrpc_c::value_array(values[1]).vectorValueValue();
+    };
+
+    /**
+     *  Gets the success flag and error code of a single VM result
+     */
+    static bool vm_result(const xmlrpc_c::value& result, int& code)
+    {
+        vector<xmlrpc_c::value> values =
+            xmlrpc_c::value_array(result).vectorValueValue();
+
+        code = xmlrpc_c::value_int(values[2]);
+
+        return xmlrpc_c::value_boolean(values[0]);
+    };
+
+    /**
+     *  Executes a one.vm.batchaction call
+     */
+    xmlrpc_c::value batch_action(const string&      session,
+                                 const string&      action,
+                                 const vector<int>& ids)
+    {
+        VirtualMachineActionBatch method;
+
+        xmlrpc_c::paramList     params;
+        xmlrpc_c::value         rv;
+        vector<xmlrpc_c::value> id_array;
+
+        for (unsigned int i = 0; i < ids.size(); i++)
+        {
+            id_array.push_back(xmlrpc_c::value_int(ids[i]));
+        }
+
+        params.add(xmlrpc_c::value_string(session));
+        params.add(xmlrpc_c::value_string(action));
+        params.add(xmlrpc_c::value_array(id_array));
+
+        method.execute(params, &rv);
+
+        return rv;
+    };
+
+    /**
+     *  Executes a one.vm.batchdeploy call
+     */
+    xmlrpc_c::value batch_deploy(const string&             session,
+                                 const vector<vector<int> >& deployments)
+    {
+        VirtualMachineDeployBatch method;
+
+        xmlrpc_c::paramList     params;
+        xmlrpc_c::value         rv;
+        vector<xmlrpc_c::value> deploy_array;
+
+        for (unsigned int i = 0; i < deployments.size(); i++)
+        {
+            vector<xmlrpc_c::value> deployment;
+
+            for (unsigned int j = 0; j < deployments[i].size(); j++)
+            {
+                deployment.push_back(xmlrpc_c::value_int(deployments[i][j]));
+            }
+
+            deploy_array.push_back(xmlrpc_c::value_array(deployment));
+        }
+
+        params.add(xmlrpc_c::value_string(session));
+        params.add(xmlrpc_c::value_array(deploy_array));
+
+        method.execute(params, &rv);
+
+        return rv;
+    };
+
+    /**
+     *  Executes a one.vm.info call, returns the XML of the VM
+     */
+    string info(const string& session, int oid)
+    {
+        VirtualMachineInfo method;
+
+        xmlrpc_c::paramList     params;
+        xmlrpc_c::value         rv;
+        vector<xmlrpc_c::value> values;
+
+        params.add(xmlrpc_c::value_string(session));
+        params.add(xmlrpc_c::value_int(oid));
+
+        method.execute(params, &rv);
+
+        values = xmlrpc_c::value_array(rv).vectorValueValue();
+
+        CPPUNIT_ASSERT( xmlrpc_c::value_boolean(values[0]) == true );
+
+        return xmlrpc_c::value_string(values[1]);
+    };
+
+    static vector<int> deployment(int vid, int hid)
+    {
+        vector<int> d;
+
+        d.push_back(vid);
+        d.push_back(hid);
+
+        return d;
+    };
+
+public:
+    RequestManagerVirtualMachineTest()
+    {
+        xmlInitParser();
+    };
+
+    ~RequestManagerVirtualMachineTest()
+    {
+        xmlCleanupParser();
+    };
+
+    /* ********************************************************************* */
+    /* ********************************************************************* */
+
+    void setUp()
+    {
+        string error_str;
+
+        create_db();
+
+        tester = new NebulaTestRMVM();
+
+        Nebula& neb = Nebula::instance();
+        neb.start();
+
+        vmpool = neb.get_vmpool();
+
+        neb.get_upool()->allocate(&uid_a, 1, "user_a", "users", "pass_a",
+                                  UserPool::CORE_AUTH, true, error_str);
+
+        neb.get_hpool()->allocate(&hid, "host_a", "im_mad", "vmm_mad",
+                                  "tm_mad", error_str);
+
+        vm_a[0]  = allocate(uid_a, 1, "user_a", "users");
+        vm_a[1]  = allocate(uid_a, 1, "user_a", "users");
+        vm_admin = allocate(0, 0, "one_user_test", "oneadmin");
+    };
+
+    void tearDown()
+    {
+        Nebula& neb = Nebula::instance();
+
+        // -----------------------------------------------------------
+        // Stop the managers & free resources
+        // -----------------------------------------------------------
+
+        neb.get_vmm()->trigger(VirtualMachineManager::FINALIZE,0);
+        neb.get_lcm()->trigger(LifeCycleManager::FINALIZE,0);
+
+        neb.get_tm()->trigger(TransferManager::FINALIZE,0);
+        neb.get_dm()->trigger(DispatchManager::FINALIZE,0);
+
+        pthread_join(neb.get_vmm()->get_thread_id(),0);
+        pthread_join(neb.get_lcm()->get_thread_id(),0);
+        pthread_join(neb.get_tm()->get_thread_id(),0);
+        pthread_join(neb.get_dm()->get_thread_id(),0);
+
+        delete_db();
+
+        delete tester;
+    };
+
+    /* ********************************************************************* */
+    /* ********************************************************************* */
+
+    void batch_action()
+    {
+        vector<xmlrpc_c::value> results;
+        vector<int>             ids;
+
+        int  code;
+        bool success;
+
+        ids.push_back(vm_a[0]);
+        ids.push_back(vm_admin);
+        ids.push_back(1234);
+
+        results = batch_results(batch_action(admin_session, "hold", ids));
+
+        // A result for each VM, in the order of the request
+        CPPUNIT_ASSERT( results.size() == 3 );
+
+        success = vm_result(results[0], code);
+
+        CPPUNIT_ASSERT( success == true );
+        CPPUNIT_ASSERT( code == Request::SUCCESS );
+
+        success = vm_result(results[1], code);
+
+        CPPUNIT_ASSERT( success == true );
+        CPPUNIT_ASSERT( code == Request::SUCCESS );
+
+        success = vm_result(results[2], code);
+
+        CPPUNIT_ASSERT( success == false );
+        CPPUNIT_ASSERT( code == Request::NO_EXISTS );
+
+        CPPUNIT_ASSERT( state(vm_a[0])   == VirtualMachine::HOLD );
+        CPPUNIT_ASSERT( state(vm_a[1])   == VirtualMachine::PENDING );
+        CPPUNIT_ASSERT( state(vm_admin)  == VirtualMachine::HOLD );
+    };
+
+    /* ********************************************************************* */
+
+    void batch_action_partial()
+    {
+        vector<xmlrpc_c::value> results;
+        vector<int>             ids;
+
+        int  code;
+        bool success;
+
+        ids.push_back(vm_a[0]);
+
+        batch_action(admin_session, "hold", ids);
+
+        ids.push_back(vm_a[1]);
+
+        // The first VM is already on hold, the second one is still executed
+        results = batch_results(batch_action(admin_session, "hold", ids));
+
+        CPPUNIT_ASSERT( results.size() == 2 );
+
+        success = vm_result(results[0], code);
+
+        CPPUNIT_ASSERT( success == false );
+        CPPUNIT_ASSERT( code == Request::ACTION );
+
+        success = vm_result(results[1], code);
+
+        CPPUNIT_ASSERT( success == true );
+
+        CPPUNIT_ASSERT( state(vm_a[0]) == VirtualMachine::HOLD );
+        CPPUNIT_ASSERT( state(vm_a[1]) == VirtualMachine::HOLD );
+    };
+
+    /* ********************************************************************* */
+
+    void batch_action_authorization()
+    {
+        vector<xmlrpc_c::value> results;
+        vector<int>             ids;
+
+        int  code;
+        bool success;
+
+        ids.push_back(vm_a[0]);
+        ids.push_back(vm_admin);
+        ids.push_back(vm_a[1]);
+
+        // user_a can not manage the oneadmin VM, each VM is authorized
+        results = batch_results(batch_action(user_session, "hold", ids));
+
+        CPPUNIT_ASSERT( results.size() == 3 );
+
+        success = vm_result(results[0], code);
+
+        CPPUNIT_ASSERT( success == true );
+
+        success = vm_result(results[1], code);
+
+        CPPUNIT_ASSERT( success == false );
+        CPPUNIT_ASSERT( code == Request::AUTHORIZATION );
+
+        success = vm_result(results[2], code);
+
+        CPPUNIT_ASSERT( success == true );
+
+        CPPUNIT_ASSERT( state(vm_a[0])  == VirtualMachine::HOLD );
+        CPPUNIT_ASSERT( state(vm_admin) == VirtualMachine::PENDING );
+        CPPUNIT_ASSERT( state(vm_a[1])  == VirtualMachine::HOLD );
+    };
+
+    /* ********************************************************************* */
+
+    void batch_deploy()
+    {
+        vector<xmlrpc_c::value> results;
+        vector<vector<int> >    deployments;
+
+        int  code;
+        bool success;
+
+        deployments.push_back(deployment(vm_a[0], hid));
+        deployments.push_back(deployment(vm_a[1], 1234));
+        deployments.push_back(deployment(vm_admin, hid));
+
+        results = batch_results(batch_deploy(admin_session, deployments));
+
+        CPPUNIT_ASSERT( results.size() == 3 );
+
+        success = vm_result(results[0], code);
+
+        CPPUNIT_ASSERT( success == true );
+        CPPUNIT_ASSERT( code == Request::SUCCESS );
+
+        success = vm_result(results[1], code);
+
+        CPPUNIT_ASSERT( success == false );
+        CPPUNIT_ASSERT( code == Request::NO_EXISTS );
+
+        success = vm_result(results[2], code);
+
+        CPPUNIT_ASSERT( success == true );
+
+        CPPUNIT_ASSERT( state(vm_a[0])  == VirtualMachine::ACTIVE );
+        CPPUNIT_ASSERT( state(vm_a[1])  == VirtualMachine::PENDING );
+        CPPUNIT_ASSERT( state(vm_admin) == VirtualMachine::ACTIVE );
+
+        // The VMs are no longer pending
+        deployments.clear();
+        deployments.push_back(deployment(vm_a[0], hid));
+        deployments.push_back(deployment(vm_a[1], hid));
+
+        results = batch_results(batch_deploy(admin_session, deployments));
+
+        success = vm_result(results[0], code);
+
+        CPPUNIT_ASSERT( success == false );
+        CPPUNIT_ASSERT( code == Request::ACTION );
+
+        success = vm_result(results[1], code);
+
+        CPPUNIT_ASSERT( success == true );
+        CPPUNIT_ASSERT( state(vm_a[1]) == VirtualMachine::ACTIVE );
+    };
+
+    /* ********************************************************************* */
+
+    void batch_deploy_authorization()
+    {
+        vector<xmlrpc_c::value> results;
+        vector<vector<int> >    deployments;
+
+        string error_str;
+        int    code;
+        bool   success;
+
+        // #uid_a VM/@1 DEPLOY, the HOST USE right is granted to the USERS
+        // group by the default rules
+        Nebula::instance().get_aclm()->add_rule(
+                AclRule::INDIVIDUAL_ID | uid_a,
+                AuthRequest::VM | AclRule::GROUP_ID | 1,
+                AuthRequest::DEPLOY,
+                error_str);
+
+        deployments.push_back(deployment(vm_admin, hid));
+        deployments.push_back(deployment(vm_a[0], hid));
+
+        results = batch_results(batch_deploy(user_session, deployments));
+
+        CPPUNIT_ASSERT( results.size() == 2 );
+
+        success = vm_result(results[0], code);
+
+        CPPUNIT_ASSERT( success == false );
+        CPPUNIT_ASSERT( code == Request::AUTHORIZATION );
+
+        success = vm_result(results[1], code);
+
+        CPPUNIT_ASSERT( success == true );
+
+        CPPUNIT_ASSERT( state(vm_admin) == VirtualMachine::PENDING );
+        CPPUNIT_ASSERT( state(vm_a[0])  == VirtualMachine::ACTIVE );
+    };
+
+    /* ********************************************************************* */
+
+    void batch_deploy_malformed()
+    {
+        xmlrpc_c::value         rv;
+        vector<xmlrpc_c::value> values;
+        vector<vector<int> >    deployments;
+        vector<int>             no_host;
+
+        no_host.push_back(vm_a[1]);
+
+        deployments.push_back(deployment(vm_a[0], hid));
+        deployments.push_back(no_host);
+
+        // The call fails as a whole, no VM is deployed
+        rv     = batch_deploy(admin_session, deployments);
+        values = xmlrpc_c::value_array(rv).vectorValueValue();
+
+        CPPUNIT_ASSERT( xmlrpc_c::value_boolean(values[0]) == false );
+        CPPUNIT_ASSERT( xmlrpc_c::value_int(values[2]) == Request::XML_RPC_API);
+
+        CPPUNIT_ASSERT( state(vm_a[0]) == VirtualMachine::PENDING );
+        CPPUNIT_ASSERT( state(vm_a[1]) == VirtualMachine::PENDING );
+    };
+
+    /* ********************************************************************* */
+
+    void info_cache()
+    {
+        VirtualMachine * vm;
+
+        CPPUNIT_ASSERT( info(user_session, vm_a[0]).find("<ETIME>0</ETIME>")
+                        != string::npos );
+
+        // set_exit_time does not invalidate the cached XML
+        vm = static_cast<VirtualMachine *>(vmpool->get_ro(vm_a[0]));
+
+        vm->set_exit_time(1234);
+
+        vm->unlock();
+
+        // The authorization of a regular user keeps the cached XML
+        CPPUNIT_ASSERT( info(user_session, vm_a[0]).find("<ETIME>0</ETIME>")
+                        != string::npos );
+
+        // A locked VM may be modified, the XML is rebuilt
+        vm = vmpool->get(vm_a[0], true);
+
+        vm->unlock();
+
+        CPPUNIT_ASSERT( info(user_session, vm_a[0]).find("<ETIME>1234</ETIME>")
+                        != string::npos );
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+int main(int argc, char ** argv)
+{
+    OneUnitTest::set_one_auth();
+
+    return OneUnitTest::main(argc, argv,
+                             RequestManagerVirtualMachineTest::suite());
+}
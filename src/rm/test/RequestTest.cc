@@ -0,0 +1,449 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "Nebula.h"
+#include "NebulaTest.h"
+#include "test/OneUnitTest.h"
+#include "Request.h"
+
+using namespace std;
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class NebulaTestRequest: public NebulaTest
+{
+public:
+    NebulaTestRequest():NebulaTest()
+    {
+        NebulaTest::the_tester = this;
+
+        need_group_pool = true;
+        need_user_pool  = true;
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+/**
+ *  A method that does not return until it is released, used to have calls
+ *  in progress
+ */
+class BlockingRequest : public Request
+{
+public:
+    BlockingRequest():
+        Request("BlockingRequest","A:s","Waits until it is released"),
+        executing(0),
+        released(false)
+    {
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&cond, 0);
+    };
+
+    ~BlockingRequest()
+    {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&cond);
+    };
+
+    /**
+     *  Waits until num calls are executing the method
+     */
+    void wait_executing(int num)
+    {
+        pthread_mutex_lock(&mutex);
+
+        while ( executing < num )
+        {
+            pthread_cond_wait(&cond, &mutex);
+        }
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    /**
+     *  Lets the calls in progress return
+     */
+    void release()
+    {
+        pthread_mutex_lock(&mutex);
+
+        released = true;
+
+        pthread_cond_broadcast(&cond);
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    unsigned long get_rejected()
+    {
+        unsigned long rejected;
+
+        pthread_mutex_lock(&stats_mutex);
+
+        rejected = stats.rejected;
+
+        pthread_mutex_unlock(&stats_mutex);
+
+        return rejected;
+    };
+
+    unsigned long get_errors()
+    {
+        unsigned long errors;
+
+        pthread_mutex_lock(&stats_mutex);
+
+        errors = stats.errors;
+
+        pthread_mutex_unlock(&stats_mutex);
+
+        return errors;
+    };
+
+protected:
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+                         RequestAttributes& att)
+    {
+        pthread_mutex_lock(&mutex);
+
+        executing++;
+
+        pthread_cond_broadcast(&cond);
+
+        while ( !released )
+        {
+            pthread_cond_wait(&cond, &mutex);
+        }
+
+        pthread_mutex_unlock(&mutex);
+
+        success_response(0, att);
+    };
+
+private:
+    int             executing;
+    bool            released;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+/**
+ *  A method that always succeeds, calls can also be added to its statistics
+ *  with a given latency
+ */
+class StatsRequest : public Request
+{
+public:
+    StatsRequest():Request("StatsRequest","A:s","Returns success"){};
+
+    ~StatsRequest(){};
+
+    void add_call(unsigned long total_time)
+    {
+        RequestAttributes att;
+
+        att.failed     = false;
+        att.authz_time = 0;
+        att.resp_time  = 0;
+
+        update_stats(att, 0, total_time, false);
+    };
+
+    unsigned long get_bucket(int i)
+    {
+        unsigned long count;
+
+        pthread_mutex_lock(&stats_mutex);
+
+        count = stats.histogram[i];
+
+        pthread_mutex_unlock(&stats_mutex);
+
+        return count;
+    };
+
+protected:
+    void request_execute(xmlrpc_c::paramList const& _paramList,
+                         RequestAttributes& att)
+    {
+        success_response(0, att);
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+/**
+ *  A call to a method, executed in its own thread
+ */
+struct Call
+{
+    Request *       method;
+    xmlrpc_c::value result;
+    pthread_t       thread;
+};
+
+extern "C" void * call_execute(void *arg)
+{
+    Call * call = static_cast<Call *>(arg);
+
+    xmlrpc_c::paramList params;
+
+    params.add(xmlrpc_c::value_string("one_user_test:password"));
+
+    call->method->execute(params, &call->result);
+
+    return 0;
+}
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class RequestTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (RequestTest);
+
+    CPPUNIT_TEST (max_concurrent);
+    CPPUNIT_TEST (no_limit);
+    CPPUNIT_TEST (histogram);
+    CPPUNIT_TEST (stats_output);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+private:
+    NebulaTestRequest * tester;
+
+    /**
+     *  Gets the success flag and the error code of a method response
+     */
+    static bool response(const xmlrpc_c::value& result, int& code)
+    {
+        vector<xmlrpc_c::value> values =
+            xmlrpc_c::value_array(result).vectorValueValue();
+
+        code = xmlrpc_c::value_int(values[2]);
+
+        return xmlrpc_c::value_boolean(values[0]);
+    };
+
+public:
+    RequestTest()
+    {
+        xmlInitParser();
+    };
+
+    ~RequestTest()
+    {
+        xmlCleanupParser();
+    };
+
+    /* ********************************************************************* */
+    /* ********************************************************************* */
+
+    void setUp()
+    {
+        create_db();
+
+        tester = new NebulaTestRequest();
+
+        Nebula& neb = Nebula::instance();
+        neb.start();
+    };
+
+    void tearDown()
+    {
+        delete_db();
+
+        delete tester;
+    };
+
+    /* ********************************************************************* */
+    /* ********************************************************************* */
+
+    void max_concurrent()
+    {
+        BlockingRequest method;
+
+        Call calls[2];
+        Call over;
+
+        int  code;
+        bool success;
+
+        method.set_max_concurrent(2);
+
+        for (int i = 0; i < 2; i++)
+        {
+            calls[i].method = &method;
+            pthread_create(&calls[i].thread, 0, call_execute, &calls[i]);
+        }
+
+        method.wait_executing(2);
+
+        // The limit is reached, the call is rejected without waiting
+        over.method = &method;
+        call_execute(&over);
+
+        success = response(over.result, code);
+
+        CPPUNIT_ASSERT( success == false );
+        CPPUNIT_ASSERT( code == Request::INTERNAL );
+        CPPUNIT_ASSERT( method.get_rejected() == 1 );
+        CPPUNIT_ASSERT( method.get_errors() == 0 );
+
+        method.release();
+
+        for (int i = 0; i < 2; i++)
+        {
+            pthread_join(calls[i].thread, 0);
+
+            success = response(calls[i].result, code);
+
+            CPPUNIT_ASSERT( success == true );
+            CPPUNIT_ASSERT( code == Request::SUCCESS );
+        }
+
+        // The finished calls are not counted any more
+        call_execute(&over);
+
+        success = response(over.result, code);
+
+        CPPUNIT_ASSERT( success == true );
+        CPPUNIT_ASSERT( method.get_calls() == 4 );
+        CPPUNIT_ASSERT( method.get_rejected() == 1 );
+        CPPUNIT_ASSERT( method.get_errors() == 0 );
+    };
+
+    /* ********************************************************************* */
+
+    void no_limit()
+    {
+        BlockingRequest method;
+
+        Call calls[5];
+
+        int  code;
+        bool success;
+
+        for (int i = 0; i < 5; i++)
+        {
+            calls[i].method = &method;
+            pthread_create(&calls[i].thread, 0, call_execute, &calls[i]);
+        }
+
+        // All the calls are executed at the same time
+        method.wait_executing(5);
+
+        method.release();
+
+        for (int i = 0; i < 5; i++)
+        {
+            pthread_join(calls[i].thread, 0);
+
+            success = response(calls[i].result, code);
+
+            CPPUNIT_ASSERT( success == true );
+        }
+
+        CPPUNIT_ASSERT( method.get_calls() == 5 );
+        CPPUNIT_ASSERT( method.get_rejected() == 0 );
+    };
+
+    /* ********************************************************************* */
+
+    void histogram()
+    {
+        StatsRequest  method;
+        Call          call;
+        unsigned long total = 0;
+
+        // Bucket limits are inclusive
+        method.add_call(500);
+        method.add_call(1000);
+        method.add_call(1001);
+        method.add_call(2000000);
+        method.add_call(2000001);
+
+        CPPUNIT_ASSERT( method.get_bucket(0) == 2 );
+        CPPUNIT_ASSERT( method.get_bucket(1) == 1 );
+        CPPUNIT_ASSERT( method.get_bucket(Request::NUM_BUCKETS - 2) == 1 );
+        CPPUNIT_ASSERT( method.get_bucket(Request::NUM_BUCKETS - 1) == 1 );
+
+        // Calls through execute() are also added to the histogram
+        call.method = &method;
+        call_execute(&call);
+
+        for (int i = 0; i < Request::NUM_BUCKETS; i++)
+        {
+            total += method.get_bucket(i);
+        }
+
+        CPPUNIT_ASSERT( method.get_calls() == 6 );
+        CPPUNIT_ASSERT( total == 6 );
+    };
+
+    /* ********************************************************************* */
+
+    void stats_output()
+    {
+        StatsRequest method;
+        string       str;
+
+        method.add_call(500);
+        method.add_call(1000);
+        method.add_call(1500);
+        method.add_call(3000000);
+
+        method.stats_to_xml("one.test", str);
+
+        CPPUNIT_ASSERT( str.find("<NAME>one.test</NAME><CALLS>4</CALLS>")
+                        != string::npos );
+        CPPUNIT_ASSERT( str.find("<BUCKET><LIMIT>1000</LIMIT><COUNT>2</COUNT>")
+                        != string::npos );
+        CPPUNIT_ASSERT( str.find("<BUCKET><LIMIT>2000</LIMIT><COUNT>1</COUNT>")
+                        != string::npos );
+        CPPUNIT_ASSERT( str.find("<BUCKET><COUNT>1</COUNT></BUCKET>"
+                                 "</HISTOGRAM>") != string::npos );
+
+        method.stats_to_str("one.test", str);
+
+        CPPUNIT_ASSERT( str.find("p50 <= 1000us") != string::npos );
+        CPPUNIT_ASSERT( str.find("p90 <= 3000000us") != string::npos );
+        CPPUNIT_ASSERT( str.find("max 3000000us") != string::npos );
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+int main(int argc, char ** argv)
+{
+    OneUnitTest::set_one_auth();
+
+    return OneUnitTest::main(argc, argv, RequestTest::suite());
+}
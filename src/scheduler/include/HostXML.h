@@ -18,6 +18,8 @@
 #ifndef HOST_XML_H_
 #define HOST_XML_H_
 
+#include <set>
+
 #include "ObjectXML.h"
 
 using namespace std;
@@ -79,6 +81,72 @@ public:
         running_vms++;
     };
 
+    /**
+     *  Gets the capacity allocated to VMs in the host, including the VMs
+     *  dispatched (add_capacity) in the current scheduling cycle
+     *    @param cpu allocated (percentage)
+     *    @param mem allocated (in Kb)
+     *    @param disk allocated
+     */
+    void get_usage(int& cpu, int& mem, int& disk) const
+    {
+        cpu  = cpu_usage;
+        mem  = mem_usage;
+        disk = disk_usage;
+    };
+
+    /**
+     *  Gets the total capacity of the host
+     *    @param cpu total (percentage)
+     *    @param mem total (in Kb)
+     *    @param disk total
+     */
+    void get_max_capacity(int& cpu, int& mem, int& disk) const
+    {
+        cpu  = max_cpu;
+        mem  = max_mem;
+        disk = max_disk;
+    };
+
+    /**
+     *  Gets the free capacity of the host as reported by the IM monitor
+     *    @param cpu free (percentage)
+     *    @param mem free (in Kb)
+     *    @param disk free
+     */
+    void get_free_capacity(int& cpu, int& mem, int& disk) const
+    {
+        cpu  = free_cpu;
+        mem  = free_mem;
+        disk = free_disk;
+    };
+
+    /**
+     *  Number of VMs running in the host, including the VMs dispatched in
+     *  the current scheduling cycle
+     */
+    int get_running_vms() const
+    {
+        return running_vms;
+    };
+
+    /**
+     *  Number of images available in the host image cache
+     *    @param iids the image ids to look for
+     *    @return the number of images in the cache
+     */
+    int get_cached_images(const vector<int>& iids) const
+    {
+        int num = 0;
+
+        for (unsigned int i = 0; i < iids.size(); i++)
+        {
+            num += cached_images.count(iids[i]);
+        }
+
+        return num;
+    };
+
 
 private:
     int oid;
@@ -98,6 +166,8 @@ private:
 
     int running_vms; /**< Number of running VMs in this Host   */
 
+    set<int> cached_images; /**< Images ready in the host cache   */
+
     void init_attributes();
 };
 
@@ -0,0 +1,89 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef LOAD_AWARE_POLICY_H_
+#define LOAD_AWARE_POLICY_H_
+
+#include "SchedulerPolicy.h"
+
+using namespace std;
+
+/**
+ *  The LoadAwarePolicy favors the hosts with more free resources. The free
+ *  CPU and memory of a host is the minimum of the values reported by the IM
+ *  monitor and the unallocated capacity, so VMs dispatched in the current
+ *  cycle are accounted for.
+ */
+class LoadAwarePolicy : public SchedulerHostPolicy
+{
+public:
+
+    LoadAwarePolicy(
+        VirtualMachinePoolXML *   vmpool,
+        HostPoolXML *             hpool,
+        float w=1.0):SchedulerHostPolicy(vmpool,hpool,w){};
+
+    ~LoadAwarePolicy(){};
+
+private:
+
+    void policy(
+        VirtualMachineXML * vm)
+    {
+        vector<int>     hids;
+        unsigned int    i;
+
+        HostXML * host;
+
+        int cpu, mem, disk;
+        int max_cpu, max_mem, max_disk;
+        int free_cpu, free_mem, free_disk;
+
+        float rank;
+
+        vm->get_matching_hosts(hids);
+
+        for (i=0;i<hids.size();i++)
+        {
+            rank = 0;
+            host = hpool->get(hids[i]);
+
+            if ( host != 0 )
+            {
+                host->get_usage(cpu, mem, disk);
+                host->get_max_capacity(max_cpu, max_mem, max_disk);
+                host->get_free_capacity(free_cpu, free_mem, free_disk);
+
+                free_cpu = min(free_cpu, max_cpu - cpu);
+                free_mem = min(free_mem, max_mem - mem);
+
+                if ( max_mem > 0 )
+                {
+                    rank += static_cast<float>(free_mem) / max_mem;
+                }
+
+                if ( max_cpu > 0 )
+                {
+                    rank += static_cast<float>(free_cpu) / max_cpu;
+                }
+            }
+
+            priority.push_back(rank);
+        }
+    }
+};
+
+#endif /*LOAD_AWARE_POLICY_H_*/
@@ -0,0 +1,87 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef PACKING_POLICY_H_
+#define PACKING_POLICY_H_
+
+#include "SchedulerPolicy.h"
+
+using namespace std;
+
+/**
+ *  The PackingPolicy favors the hosts that would be the most allocated after
+ *  placing the VM (best-fit). Combined with the batch dispatch of the
+ *  scheduler (VMs are placed in decreasing size order) it implements a
+ *  first-fit-decreasing packing, reducing the capacity stranded in partially
+ *  used hosts.
+ */
+class PackingPolicy : public SchedulerHostPolicy
+{
+public:
+
+    PackingPolicy(
+        VirtualMachinePoolXML *   vmpool,
+        HostPoolXML *             hpool,
+        float w=1.0):SchedulerHostPolicy(vmpool,hpool,w){};
+
+    ~PackingPolicy(){};
+
+private:
+
+    void policy(
+        VirtualMachineXML * vm)
+    {
+        vector<int>     hids;
+        unsigned int    i;
+
+        HostXML * host;
+
+        int vm_cpu, vm_mem, vm_disk;
+        int cpu, mem, disk;
+        int max_cpu, max_mem, max_disk;
+
+        float rank;
+
+        vm->get_matching_hosts(hids);
+        vm->get_requirements(vm_cpu, vm_mem, vm_disk);
+
+        for (i=0;i<hids.size();i++)
+        {
+            rank = 0;
+            host = hpool->get(hids[i]);
+
+            if ( host != 0 )
+            {
+                host->get_usage(cpu, mem, disk);
+                host->get_max_capacity(max_cpu, max_mem, max_disk);
+
+                if ( max_mem > 0 )
+                {
+                    rank += static_cast<float>(mem + vm_mem) / max_mem;
+                }
+
+                if ( max_cpu > 0 )
+                {
+                    rank += static_cast<float>(cpu + vm_cpu) / max_cpu;
+                }
+            }
+
+            priority.push_back(rank);
+        }
+    }
+};
+
+#endif /*PACKING_POLICY_H_*/
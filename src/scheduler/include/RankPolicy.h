@@ -17,6 +17,8 @@
 #ifndef RANK_POLICY_H_
 #define RANK_POLICY_H_
 
+#include <ctype.h>
+
 #include "SchedulerPolicy.h"
 #include "Scheduler.h"
 
@@ -35,6 +37,47 @@ public:
 
 private:
 
+    /**
+     *  Replaces the CACHED_IMAGES variable of a rank expression with its
+     *  value, the number of VM images in the image cache of the host
+     *    @param srank the rank expression
+     *    @param cached number of VM images in the host cache
+     *    @return the rank expression to evaluate
+     */
+    static string cached_rank(const string& srank, int cached)
+    {
+        static const string var = "CACHED_IMAGES";
+
+        string::size_type pos = 0;
+        string            rank(srank);
+        ostringstream     oss;
+
+        oss << cached;
+
+        while ((pos = rank.find(var, pos)) != string::npos)
+        {
+            string::size_type end = pos + var.length();
+
+            if ((pos > 0 && is_var_char(rank[pos-1])) ||
+                (end < rank.length() && is_var_char(rank[end])))
+            {
+                pos = end;
+                continue;
+            }
+
+            rank.replace(pos, var.length(), oss.str());
+
+            pos += oss.str().length();
+        }
+
+        return rank;
+    };
+
+    static bool is_var_char(char c)
+    {
+        return isalnum(c) || c == '_';
+    };
+
     void policy(
         VirtualMachineXML * vm)
     {
@@ -58,6 +101,8 @@ private:
             NebulaLog::log("RANK",Log::WARNING,"No rank defined for VM");
         }
 
+        bool has_cached = (srank.find("CACHED_IMAGES") != string::npos);
+
         for (i=0;i<hids.size();i++)
         {
             rank = 0;
@@ -68,7 +113,17 @@ private:
 
                 if ( host != 0 )
                 {
-                    rc = host->eval_arith(srank, rank, &errmsg);
+                    string hrank = srank;
+
+                    if ( has_cached )
+                    {
+                        int cached;
+
+                        cached = host->get_cached_images(vm->get_image_ids());
+                        hrank  = cached_rank(srank, cached);
+                    }
+
+                    rc = host->eval_arith(hrank, rank, &errmsg);
 
                     if (rc != 0)
                     {
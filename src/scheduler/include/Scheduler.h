@@ -39,6 +39,17 @@ class Scheduler: public ActionListener
 {
 public:
 
+    /**
+     *  Host placement policies, all but RANK use batch dispatch
+     */
+    enum PlacementPolicy
+    {
+        RANK     = 0, /**< Greedy placement using the VM RANK expression */
+        PACKING  = 1, /**< First-fit-decreasing, minimize used hosts     */
+        STRIPING = 2, /**< Spread VMs across hosts                       */
+        LOAD     = 3  /**< Favor hosts with more free resources          */
+    };
+
     void start();
 
     virtual void register_policies() = 0;
@@ -46,7 +57,8 @@ public:
 protected:
 
     Scheduler(string& _url, time_t _timer,
-              int _machines_limit, int _dispatch_limit, int _host_dispatch_limit):
+              int _machines_limit, int _dispatch_limit, int _host_dispatch_limit,
+              bool _batch_dispatch):
         hpool(0),
         vmpool(0),
         acls(0),
@@ -55,6 +67,7 @@ protected:
         machines_limit(_machines_limit),
         dispatch_limit(_dispatch_limit),
         host_dispatch_limit(_host_dispatch_limit),
+        batch_dispatch(_batch_dispatch),
         threshold(0.9),
         client(0)
     {
@@ -82,6 +95,11 @@ protected:
         {
             delete client;
         }
+
+        for (unsigned int i = 0; i < placement_policies.size(); i++)
+        {
+            delete placement_policies[i];
+        }
     };
 
     // ---------------------------------------------------------------
@@ -102,6 +120,16 @@ protected:
         host_policies.push_back(policy);
     }
 
+    /**
+     *  Adds the host policies of a placement. The RANK of the VMs is always
+     *  evaluated. In batch mode the placement policy is added to it with the
+     *  same weight, so it decides between hosts with the same rank and it is
+     *  the only criteria for VMs without RANK. The policies are freed by the
+     *  Scheduler.
+     *    @param placement the placement policy
+     */
+    void add_placement_policies(PlacementPolicy placement);
+
     // ---------------------------------------------------------------
     // Scheduler main methods
     // ---------------------------------------------------------------
@@ -113,10 +141,24 @@ protected:
      */
     virtual void match();
 
+    /**
+     *  Dispatches the pending VMs to the highest priority host with enough
+     *  capacity. In batch mode all the pending VMs are placed together: they
+     *  are processed in decreasing size order and the host priorities of
+     *  each VM are re-evaluated with the capacity allocated to the VMs
+     *  already placed in this cycle.
+     */
     virtual void dispatch();
 
     virtual int schedule();
 
+    /**
+     *  Computes the priority of the matching hosts of a VM using the
+     *  scheduler host policies
+     *    @param vm the virtual machine
+     */
+    void prioritize(VirtualMachineXML * vm);
+
     virtual int set_up_pools();
 
 private:
@@ -133,6 +175,11 @@ private:
 
     vector<SchedulerHostPolicy *>   host_policies;
 
+    /**
+     *  Policies created by add_placement_policies
+     */
+    vector<SchedulerHostPolicy *>   placement_policies;
+
     // ---------------------------------------------------------------
     // Configuration attributes
     // ---------------------------------------------------------------
@@ -156,6 +203,14 @@ private:
      */
     unsigned int host_dispatch_limit;
 
+    /**
+     *  Place all the pending VMs together (capacity-aware) instead of
+     *  following the pool order with the initial priorities. Note that no
+     *  more than host_dispatch_limit VMs are placed in a host per cycle, so
+     *  packing needs a limit greater than 1.
+     */
+    bool batch_dispatch;
+
     /**
      *  Threshold value to round up freecpu
      */
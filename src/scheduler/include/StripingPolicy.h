@@ -0,0 +1,67 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef STRIPING_POLICY_H_
+#define STRIPING_POLICY_H_
+
+#include "SchedulerPolicy.h"
+
+using namespace std;
+
+/**
+ *  The StripingPolicy spreads the VMs across the hosts, it favors the hosts
+ *  with less running VMs (including those dispatched in the current cycle).
+ */
+class StripingPolicy : public SchedulerHostPolicy
+{
+public:
+
+    StripingPolicy(
+        VirtualMachinePoolXML *   vmpool,
+        HostPoolXML *             hpool,
+        float w=1.0):SchedulerHostPolicy(vmpool,hpool,w){};
+
+    ~StripingPolicy(){};
+
+private:
+
+    void policy(
+        VirtualMachineXML * vm)
+    {
+        vector<int>     hids;
+        unsigned int    i;
+
+        HostXML * host;
+        float     rank;
+
+        vm->get_matching_hosts(hids);
+
+        for (i=0;i<hids.size();i++)
+        {
+            rank = 0;
+            host = hpool->get(hids[i]);
+
+            if ( host != 0 )
+            {
+                rank = - host->get_running_vms();
+            }
+
+            priority.push_back(rank);
+        }
+    }
+};
+
+#endif /*STRIPING_POLICY_H_*/
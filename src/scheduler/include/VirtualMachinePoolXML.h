@@ -32,7 +32,7 @@ public:
                              unsigned int   machines_limit
                          ):PoolXML(client, machines_limit){};
 
-    ~VirtualMachinePoolXML(){};
+    virtual ~VirtualMachinePoolXML(){};
 
     int set_up();
 
@@ -47,8 +47,26 @@ public:
         return static_cast<VirtualMachineXML *>(PoolXML::get(oid));
     };
 
+    /**
+     *  Dispatches a VM to the given host (one.vm.deploy)
+     *    @param vid of the VM
+     *    @param hid of the target host
+     *    @return 0 on success
+     */
     int dispatch(int vid, int hid) const;
 
+    /**
+     *  Dispatches a set of VMs in a single system.multicall request, so
+     *  all the deployments of a scheduling cycle take one round-trip. If
+     *  the request fails the VMs are not dispatched again, as oned could
+     *  have processed part of it.
+     *    @param vms pairs of <vid, hid> to deploy
+     *    @param rcs the result of each deployment, 0 on success, -1 if it
+     *    failed and -2 if the result is unknown
+     */
+    virtual void dispatch(const vector<pair<int,int> >& vms,
+                          vector<int>&                  rcs) const;
+
 protected:
 
     int get_suitable_nodes(vector<xmlNodePtr>& content)
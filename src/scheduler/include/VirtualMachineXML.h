@@ -94,6 +94,15 @@ public:
         return requirements;
     };
 
+    /**
+     *  Ids of the images cloned for the VM disks, they can be copied from
+     *  the host image cache
+     */
+    const vector<int>& get_image_ids()
+    {
+        return image_ids;
+    };
+
     /**
      *  Function to write a Virtual Machine in an output stream
      */
@@ -157,6 +166,8 @@ protected:
     string  rank;
     string  requirements;
 
+    vector<int> image_ids;
+
     /**
      *  Matching hosts
      */
@@ -0,0 +1,520 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+/* -------------------------------------------------------------------------- */
+/* Offline scheduler benchmark. Runs the match, schedule and dispatch phases  */
+/* of the scheduler over host, VM and ACL pool dumps (as returned by          */
+/* one.hostpool.info, one.vmpool.info and one.acl.info) or synthetic pools,   */
+/* without oned. Deployments are recorded instead of sent to oned.            */
+/* -------------------------------------------------------------------------- */
+
+#include "Scheduler.h"
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <sys/time.h>
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Builds the XML-RPC response of a pool info call
+ */
+static void xml_result(const string& xml, xmlrpc_c::value& result)
+{
+    vector<xmlrpc_c::value> values;
+
+    values.push_back(xmlrpc_c::value_boolean(true));
+    values.push_back(xmlrpc_c::value_string(xml));
+
+    result = xmlrpc_c::value_array(values);
+}
+
+/* -------------------------------------------------------------------------- */
+
+class BenchHostPool : public HostPoolXML
+{
+public:
+    BenchHostPool(const string& _xml):HostPoolXML(0), xml(_xml){};
+
+protected:
+    int load_info(xmlrpc_c::value &result)
+    {
+        xml_result(xml, result);
+        return 0;
+    };
+
+private:
+    const string& xml;
+};
+
+/* -------------------------------------------------------------------------- */
+
+class BenchVirtualMachinePool : public VirtualMachinePoolXML
+{
+public:
+    BenchVirtualMachinePool(const string& _xml, unsigned int machines_limit)
+        :VirtualMachinePoolXML(0, machines_limit), xml(_xml){};
+
+    /**
+     *  Records the deployments instead of calling one.vm.deploy
+     */
+    void dispatch(const vector<pair<int,int> >& vms, vector<int>& rcs) const
+    {
+        rcs.assign(vms.size(), 0);
+
+        placed.insert(vms.begin(), vms.end());
+    };
+
+    /**
+     *  VMs placed in the last scheduling cycle, <vid, hid>
+     */
+    mutable map<int,int> placed;
+
+protected:
+    int load_info(xmlrpc_c::value &result)
+    {
+        placed.clear();
+
+        xml_result(xml, result);
+        return 0;
+    };
+
+private:
+    const string& xml;
+};
+
+/* -------------------------------------------------------------------------- */
+
+class BenchAcl : public AclXML
+{
+public:
+    BenchAcl(const string& _xml):AclXML(0), xml(_xml){};
+
+protected:
+    int load_info(xmlrpc_c::value &result)
+    {
+        xml_result(xml, result);
+        return 0;
+    };
+
+private:
+    const string& xml;
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+class BenchScheduler : public Scheduler
+{
+public:
+
+    BenchScheduler(string&       url,
+                   const string& host_xml,
+                   const string& vm_xml,
+                   const string& acl_xml,
+                   unsigned int  machines_limit,
+                   unsigned int  dispatch_limit,
+                   unsigned int  host_dispatch_limit,
+                   PlacementPolicy _placement
+                   ):Scheduler(url,
+                               0,
+                               machines_limit,
+                               dispatch_limit,
+                               host_dispatch_limit,
+                               _placement != RANK),
+                     placement(_placement)
+    {
+        hpool  = new BenchHostPool(host_xml);
+        vmpool = new BenchVirtualMachinePool(vm_xml, machines_limit);
+        acls   = new BenchAcl(acl_xml);
+
+        register_policies();
+    };
+
+    ~BenchScheduler(){};
+
+    /**
+     *  The same policies used by mm_sched
+     */
+    void register_policies()
+    {
+        add_placement_policies(placement);
+    };
+
+    /**
+     *  Runs a scheduling cycle, and prints the time spent in each phase and
+     *  the quality of the placement
+     *    @param os to print the results
+     *    @return 0 on success
+     */
+    int cycle(ostream& os);
+
+private:
+    PlacementPolicy placement;
+
+    static double now()
+    {
+        struct timeval tv;
+
+        gettimeofday(&tv, 0);
+
+        return tv.tv_sec + tv.tv_usec / 1000000.0;
+    };
+
+    void placement_quality(ostream& os);
+};
+
+/* -------------------------------------------------------------------------- */
+
+int BenchScheduler::cycle(ostream& os)
+{
+    double t0, t1, t2, t3, t4;
+
+    t0 = now();
+
+    if ( hpool->set_up() != 0 || vmpool->set_up() != 0 || acls->set_up() != 0 )
+    {
+        return -1;
+    }
+
+    t1 = now();
+
+    match();
+
+    t2 = now();
+
+    schedule();
+
+    t3 = now();
+
+    dispatch();
+
+    t4 = now();
+
+    os << fixed << setprecision(4)
+       << "set_up: "   << t1 - t0 << "s  "
+       << "match: "    << t2 - t1 << "s  "
+       << "schedule: " << t3 - t2 << "s  "
+       << "dispatch: " << t4 - t3 << "s  "
+       << "total: "    << t4 - t0 << "s" << endl;
+
+    placement_quality(os);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void BenchScheduler::placement_quality(ostream& os)
+{
+    const map<int, ObjectXML*>& hosts = hpool->get_objects();
+    const map<int, ObjectXML*>& vms   = vmpool->get_objects();
+
+    map<int, ObjectXML*>::const_iterator it;
+
+    int min_cpu = INT_MAX;
+    int min_mem = INT_MAX;
+
+    int cpu, mem, disk;
+    int max_cpu, max_mem, max_disk;
+
+    long long total_mem    = 0;
+    long long alloc_mem    = 0;
+    long long stranded_mem = 0;
+    long long stranded_cpu = 0;
+
+    int used_hosts = 0;
+
+    const map<int,int>& placed =
+                static_cast<BenchVirtualMachinePool *>(vmpool)->placed;
+
+    for (it = vms.begin(); it != vms.end(); it++)
+    {
+        static_cast<VirtualMachineXML*>(it->second)->get_requirements(
+                cpu, mem, disk);
+
+        if ( cpu > 0 && cpu < min_cpu )
+        {
+            min_cpu = cpu;
+        }
+
+        if ( mem > 0 && mem < min_mem )
+        {
+            min_mem = mem;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Capacity left in a host that cannot be used by the smallest VM, because
+    // the other resource is exhausted, is stranded
+    // -------------------------------------------------------------------------
+
+    for (it = hosts.begin(); it != hosts.end(); it++)
+    {
+        HostXML * host = static_cast<HostXML *>(it->second);
+
+        host->get_usage(cpu, mem, disk);
+        host->get_max_capacity(max_cpu, max_mem, max_disk);
+
+        total_mem += max_mem;
+        alloc_mem += mem;
+
+        if ( host->get_running_vms() > 0 )
+        {
+            used_hosts++;
+        }
+
+        if ( max_cpu - cpu < min_cpu && max_mem - mem >= min_mem )
+        {
+            stranded_mem += max_mem - mem;
+        }
+        else if ( max_mem - mem < min_mem && max_cpu - cpu >= min_cpu )
+        {
+            stranded_cpu += max_cpu - cpu;
+        }
+    }
+
+    os << "VMs placed: " << placed.size() << "/" << vms.size()
+       << "  hosts used: " << used_hosts << "/" << hosts.size();
+
+    if ( total_mem > 0 )
+    {
+        os << setprecision(2)
+           << "  memory allocated: " << 100.0 * alloc_mem / total_mem << "%"
+           << "  memory stranded: " << 100.0 * stranded_mem / total_mem << "%";
+    }
+
+    os << "  cpu stranded: " << stranded_cpu << endl;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Generates a synthetic host pool, hosts have 8 cores and 16GB to 64GB
+ */
+static void synthetic_hosts(int num, string& xml)
+{
+    ostringstream oss;
+
+    oss << "<HOST_POOL>";
+
+    for (int i = 0; i < num; i++)
+    {
+        int max_cpu  = 800;
+        int max_mem  = (16 << (i % 3)) * 1024 * 1024;
+        int cpu      = (rand() % 4) * 100;
+        int mem      = (rand() % 4) * 1024 * 1024;
+
+        oss << "<HOST><ID>" << i << "</ID><NAME>host" << i << "</NAME>"
+            << "<STATE>2</STATE><HOST_SHARE>"
+            << "<DISK_USAGE>0</DISK_USAGE>"
+            << "<MEM_USAGE>"   << mem << "</MEM_USAGE>"
+            << "<CPU_USAGE>"   << cpu << "</CPU_USAGE>"
+            << "<MAX_DISK>0</MAX_DISK>"
+            << "<MAX_MEM>"     << max_mem << "</MAX_MEM>"
+            << "<MAX_CPU>"     << max_cpu << "</MAX_CPU>"
+            << "<FREE_DISK>0</FREE_DISK>"
+            << "<FREE_MEM>"    << max_mem - mem << "</FREE_MEM>"
+            << "<FREE_CPU>"    << max_cpu - cpu << "</FREE_CPU>"
+            << "<RUNNING_VMS>" << cpu / 100 << "</RUNNING_VMS>"
+            << "</HOST_SHARE><TEMPLATE>"
+            << "<HYPERVISOR>" << (i % 4 == 0 ? "xen" : "kvm") << "</HYPERVISOR>"
+            << "</TEMPLATE></HOST>";
+    }
+
+    oss << "</HOST_POOL>";
+
+    xml = oss.str();
+}
+
+/**
+ *  Generates a synthetic pending VM pool, VMs use 0.5 to 4 CPUs and 512MB
+ *  to 8GB
+ */
+static void synthetic_vms(int num, string& xml)
+{
+    ostringstream oss;
+
+    oss << "<VM_POOL>";
+
+    for (int i = 0; i < num; i++)
+    {
+        oss << "<VM><ID>" << i << "</ID><UID>0</UID><GID>0</GID>"
+            << "<NAME>vm" << i << "</NAME><STATE>1</STATE><TEMPLATE>"
+            << "<CPU>"    << 0.5 * (1 << (rand() % 4)) << "</CPU>"
+            << "<MEMORY>" << (512 << (rand() % 5)) << "</MEMORY>"
+            << "<REQUIREMENTS>HYPERVISOR = \"kvm\"</REQUIREMENTS>"
+            << "<RANK>FREE_CPU</RANK>"
+            << "</TEMPLATE></VM>";
+    }
+
+    oss << "</VM_POOL>";
+
+    xml = oss.str();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int read_file(const char * file, string& xml)
+{
+    ifstream      ifs(file);
+    ostringstream oss;
+
+    if ( !ifs.good() )
+    {
+        cerr << "Could not open file: " << file << endl;
+        return -1;
+    }
+
+    oss << ifs.rdbuf();
+
+    xml = oss.str();
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    string host_xml;
+    string vm_xml;
+    string acl_xml = "<ACL_POOL/>";
+    string url     = "";
+
+    int             num_hosts = 1000;
+    int             num_vms   = 1000;
+    int             cycles    = 1;
+    int             placement = Scheduler::RANK;
+    int             level     = Log::ERROR;
+    unsigned int    machines_limit = 0;
+    unsigned int    dispatch_limit = 0;
+    unsigned int    host_dispatch_limit = INT_MAX;
+    char            opt;
+
+    BenchScheduler * bs;
+
+    srand(1);
+
+    while((opt = getopt(argc,argv,"H:V:A:n:v:c:s:m:d:h:l:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'H':
+                if ( read_file(optarg, host_xml) != 0 ) exit(-1);
+                break;
+            case 'V':
+                if ( read_file(optarg, vm_xml) != 0 ) exit(-1);
+                break;
+            case 'A':
+                if ( read_file(optarg, acl_xml) != 0 ) exit(-1);
+                break;
+            case 'n':
+                num_hosts = atoi(optarg);
+                break;
+            case 'v':
+                num_vms = atoi(optarg);
+                break;
+            case 'c':
+                cycles = atoi(optarg);
+                break;
+            case 's':
+                placement = atoi(optarg);
+                break;
+            case 'm':
+                machines_limit = atoi(optarg);
+                break;
+            case 'd':
+                dispatch_limit = atoi(optarg);
+                break;
+            case 'h':
+                host_dispatch_limit = atoi(optarg);
+                break;
+            case 'l':
+                level = atoi(optarg);
+                break;
+            default:
+                cerr << "usage: " << argv[0] << " [-H host pool xml] "
+                     << "[-V vm pool xml] [-A acl pool xml] "
+                     << "[-n synthetic hosts] [-v synthetic vms] [-c cycles] "
+                     << "[-s placement policy (0 rank, 1 packing, 2 striping, "
+                     << "3 load)] [-m machines limit] [-d dispatch limit] "
+                     << "[-h host dispatch limit] [-l log level]\n";
+                exit(-1);
+                break;
+        }
+    };
+
+    if ( placement < Scheduler::RANK || placement > Scheduler::LOAD )
+    {
+        cerr << "Wrong placement policy: " << placement << endl;
+        exit(-1);
+    }
+
+    if ( host_xml.empty() )
+    {
+        synthetic_hosts(num_hosts, host_xml);
+    }
+
+    if ( vm_xml.empty() )
+    {
+        synthetic_vms(num_vms, vm_xml);
+    }
+
+    NebulaLog::init_log_system(NebulaLog::CERR,
+                               static_cast<Log::MessageType>(level));
+
+    xmlInitParser();
+
+    bs = new BenchScheduler(url,
+                            host_xml,
+                            vm_xml,
+                            acl_xml,
+                            machines_limit,
+                            dispatch_limit,
+                            host_dispatch_limit,
+                            static_cast<Scheduler::PlacementPolicy>(placement));
+
+    for (int i = 0; i < cycles; i++)
+    {
+        cout << "Cycle " << i << ": ";
+
+        if ( bs->cycle(cout) != 0 )
+        {
+            cerr << "Error loading the pools" << endl;
+            break;
+        }
+    }
+
+    delete bs;
+
+    xmlCleanupParser();
+
+    NebulaLog::finalize_log_system();
+
+    return 0;
+}
@@ -22,38 +22,50 @@
 /* -------------------------------------------------------------------------- */
 
 int AclXML::set_up()
-{    
+{
     xmlrpc_c::value result;
 
-    try
+    if ( load_info(result) != 0 )
     {
-        client->call(client->get_endpoint(),        // serverUrl
-                     "one.acl.info",                // methodName
-                     "s",                           // arguments format
-                     &result,                       // resultP
-                     client->get_oneauth().c_str());// argument
-        
-        vector<xmlrpc_c::value> values =
-                        xmlrpc_c::value_array(result).vectorValueValue();
+        return -1;
+    }
 
-        bool   success = xmlrpc_c::value_boolean(values[0]);
-        string message = xmlrpc_c::value_string(values[1]);
+    vector<xmlrpc_c::value> values =
+                    xmlrpc_c::value_array(result).vectorValueValue();
 
-        if( !success )
-        {
-            ostringstream oss;
+    bool   success = xmlrpc_c::value_boolean(values[0]);
+    string message = xmlrpc_c::value_string(values[1]);
 
-            oss << "ONE returned error while retrieving the acls:" << endl;
-            oss << message;
+    if( !success )
+    {
+        ostringstream oss;
 
-            NebulaLog::log("ACL", Log::ERROR, oss);
-            return -1;
-        }
+        oss << "ONE returned error while retrieving the acls:" << endl;
+        oss << message;
+
+        NebulaLog::log("ACL", Log::ERROR, oss);
+        return -1;
+    }
 
-        flush_rules();
+    flush_rules();
 
-        load_rules(message);
+    load_rules(message);
 
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int AclXML::load_info(xmlrpc_c::value &result)
+{
+    try
+    {
+        client->call(client->get_endpoint(),        // serverUrl
+                     "one.acl.info",                // methodName
+                     "s",                           // arguments format
+                     &result,                       // resultP
+                     client->get_oneauth().c_str());// argument
         return 0;
     }
     catch (exception const& e)
@@ -93,6 +105,8 @@ int AclXML::load_rules(const string& xml_str)
 
     acl_xml.free_nodes(rules);
 
+    rebuild_index();
+
     return 0;    
 }
 
@@ -110,5 +124,7 @@ void AclXML::flush_rules()
 
     acl_rules.clear();
     acl_rules_oids.clear();
+
+    rebuild_index();
 }
 
@@ -37,6 +37,8 @@ void HostXML::get_capacity(int& cpu, int& memory, float threshold) const
 
 void HostXML::init_attributes()
 {
+    vector<string> result;
+
     oid         = atoi(((*this)["/HOST/ID"] )[0].c_str() );
 
     disk_usage  = atoi(((*this)["/HOST/HOST_SHARE/DISK_USAGE"])[0].c_str());
@@ -52,6 +54,14 @@ void HostXML::init_attributes()
     free_cpu    = atoi(((*this)["/HOST/HOST_SHARE/FREE_CPU"])[0].c_str());
 
     running_vms = atoi(((*this)["/HOST/HOST_SHARE/RUNNING_VMS"])[0].c_str());
+
+    // Images being copied to the cache (VID != -1) are not available yet
+    result = ((*this)["/HOST/IMAGE_CACHE/IMAGE[VID=-1]/ID"]);
+
+    for (unsigned int i = 0; i < result.size(); i++)
+    {
+        cached_images.insert(atoi(result[i].c_str()));
+    }
 }
 
 /* -------------------------------------------------------------------------- */
@@ -144,3 +144,148 @@ int VirtualMachinePoolXML::dispatch(int vid, int hid) const
 
     return 0;
 }
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void VirtualMachinePoolXML::dispatch(const vector<pair<int,int> >& vms,
+                                     vector<int>&                  rcs) const
+{
+    ostringstream               oss;
+    xmlrpc_c::value             multi_result;
+    xmlrpc_c::paramList         multi_params;
+
+    vector<xmlrpc_c::value>     calls;
+    vector<xmlrpc_c::value>     results;
+
+    unsigned int i;
+
+    rcs.clear();
+
+    if ( vms.empty() )
+    {
+        return;
+    }
+
+    for (i = 0; i < vms.size(); i++)
+    {
+        map<string, xmlrpc_c::value> call;
+        vector<xmlrpc_c::value>      params;
+
+        params.push_back(xmlrpc_c::value_string(client->get_oneauth()));
+        params.push_back(xmlrpc_c::value_int(vms[i].first));
+        params.push_back(xmlrpc_c::value_int(vms[i].second));
+
+        call["methodName"] = xmlrpc_c::value_string("one.vm.deploy");
+        call["params"]     = xmlrpc_c::value_array(params);
+
+        calls.push_back(xmlrpc_c::value_struct(call));
+
+        oss.str("");
+        oss << "Dispatching virtual machine " << vms[i].first
+            << " to HID: " << vms[i].second;
+
+        NebulaLog::log("VM",Log::INFO,oss);
+    }
+
+    multi_params.add(xmlrpc_c::value_array(calls));
+
+    try
+    {
+        client->call(client->get_endpoint(),    // serverUrl
+                     "system.multicall",        // methodName
+                     multi_params,              // array of one.vm.deploy
+                     &multi_result);            // resultP
+
+        results = xmlrpc_c::value_array(multi_result).vectorValueValue();
+    }
+    catch (exception const& e)
+    {
+        oss.str("");
+        oss << "Exception raised in system.multicall: " << e.what();
+
+        NebulaLog::log("VM",Log::ERROR,oss);
+
+        results.clear();
+    }
+
+    // The request may have been (partially) processed by oned, the VMs are
+    // not dispatched again. Those still pending are scheduled next cycle.
+    if ( results.size() != vms.size() )
+    {
+        oss.str("");
+        oss << "Unknown result for the deployment of " << vms.size()
+            << " virtual machines, they will be checked in the next cycle.";
+
+        NebulaLog::log("VM",Log::WARNING,oss);
+
+        rcs.assign(vms.size(), -2);
+
+        return;
+    }
+
+    // See how ONE handled each deployment. A successful call is returned
+    // as a one element array, a failed one as a fault struct
+
+    for (i = 0; i < results.size(); i++)
+    {
+        string message = "Wrong result format";
+        bool   success = false;
+
+        try
+        {
+            if ( results[i].type() == xmlrpc_c::value::TYPE_ARRAY )
+            {
+                vector<xmlrpc_c::value> call_result =
+                        xmlrpc_c::value_array(results[i]).vectorValueValue();
+
+                vector<xmlrpc_c::value> values;
+
+                if ( call_result.size() > 0 )
+                {
+                    values = xmlrpc_c::value_array(
+                                call_result[0]).vectorValueValue();
+                }
+
+                if ( values.size() > 0 )
+                {
+                    success = xmlrpc_c::value_boolean(values[0]);
+                }
+
+                if ( !success && values.size() > 1 )
+                {
+                    message = xmlrpc_c::value_string(values[1]);
+                }
+            }
+            else
+            {
+                map<string, xmlrpc_c::value> fault =
+                        xmlrpc_c::value_struct(results[i]);
+
+                if ( fault.count("faultString") > 0 )
+                {
+                    message = xmlrpc_c::value_string(fault["faultString"]);
+                }
+            }
+        }
+        catch (exception const& e)
+        {
+            success = false;
+        }
+
+        if ( !success )
+        {
+            oss.str("");
+            oss << "Error deploying virtual machine " << vms[i].first
+                << " to HID: " << vms[i].second << ". Reason: " << message;
+
+            NebulaLog::log("VM",Log::ERROR,oss);
+
+            rcs.push_back(-1);
+        }
+        else
+        {
+            rcs.push_back(0);
+        }
+    }
+}
@@ -67,6 +67,13 @@ void VirtualMachineXML::init_attributes()
     {
         requirements = "";
     }
+
+    result = ((*this)["/VM/TEMPLATE/DISK[not(CLONE=\"NO\")]/IMAGE_ID"]);
+
+    for (unsigned int i=0; i < result.size(); i++)
+    {
+        image_ids.push_back(atoi(result[i].c_str()));
+    }
 }
 
 /* -------------------------------------------------------------------------- */
@@ -85,6 +85,7 @@ class HostXMLTest : public OneUnitTest
     CPPUNIT_TEST( get_capacity );
     CPPUNIT_TEST( test_capacity );
     CPPUNIT_TEST( add_capacity );
+    CPPUNIT_TEST( cached_images );
 
     CPPUNIT_TEST_SUITE_END ();
 
@@ -242,6 +243,46 @@ public:
             bool test = host->test_capacity(cpu[i], mem[i], disk[i]);
             CPPUNIT_ASSERT(test == result[i]);
         }
+
+        // Allocated capacity is visible to the placement policies
+        int u_cpu, u_mem, u_disk;
+
+        host->get_usage(u_cpu, u_mem, u_disk);
+
+        CPPUNIT_ASSERT(u_cpu  == 120);
+        CPPUNIT_ASSERT(u_mem  == 256);
+        CPPUNIT_ASSERT(u_disk == 384);
+    };
+
+    void cached_images()
+    {
+        HostXML host(
+            "<HOST><ID>2</ID><HOST_SHARE><DISK_USAGE>0</DISK_USAGE>"
+            "<MEM_USAGE>0</MEM_USAGE><CPU_USAGE>0</CPU_USAGE>"
+            "<MAX_DISK>0</MAX_DISK><MAX_MEM>0</MAX_MEM><MAX_CPU>0</MAX_CPU>"
+            "<FREE_DISK>0</FREE_DISK><FREE_MEM>0</FREE_MEM><FREE_CPU>0</FREE_CPU>"
+            "<RUNNING_VMS>0</RUNNING_VMS></HOST_SHARE><IMAGE_CACHE>"
+            "<SIZE>30</SIZE>"
+            "<IMAGE><ID>3</ID><SOURCE>/img/3</SOURCE><SIZE>10</SIZE>"
+            "<LAST_USED>0</LAST_USED><VID>-1</VID></IMAGE>"
+            "<IMAGE><ID>4</ID><SOURCE>/img/4</SOURCE><SIZE>10</SIZE>"
+            "<LAST_USED>0</LAST_USED><VID>-1</VID></IMAGE>"
+            "<IMAGE><ID>5</ID><SOURCE>/img/5</SOURCE><SIZE>10</SIZE>"
+            "<LAST_USED>0</LAST_USED><VID>8</VID></IMAGE>"
+            "</IMAGE_CACHE></HOST>");
+
+        vector<int> iids;
+
+        iids.push_back(3);
+        iids.push_back(5);
+        iids.push_back(7);
+
+        // Image 5 is still being copied to the host
+        CPPUNIT_ASSERT(host.get_cached_images(iids) == 1);
+
+        iids.push_back(4);
+
+        CPPUNIT_ASSERT(host.get_cached_images(iids) == 2);
     };
 };
 
@@ -0,0 +1,272 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <stdexcept>
+
+#include "HostPoolXML.h"
+#include "VirtualMachinePoolXML.h"
+#include "RankPolicy.h"
+#include "PackingPolicy.h"
+#include "StripingPolicy.h"
+#include "LoadAwarePolicy.h"
+
+#include "test/OneUnitTest.h"
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class FriendHostPool : public HostPoolXML
+{
+public:
+    FriendHostPool():HostPoolXML(0){};
+
+    /**
+     *  Adds a host with the given usage, all hosts have 800 CPU and 8GB
+     */
+    void add_host(int hid, int cpu_usage, int mem_usage, int running_vms)
+    {
+        ostringstream oss;
+
+        oss << "<HOST><ID>" << hid << "</ID><HOST_SHARE>"
+            << "<DISK_USAGE>0</DISK_USAGE>"
+            << "<MEM_USAGE>"   << mem_usage << "</MEM_USAGE>"
+            << "<CPU_USAGE>"   << cpu_usage << "</CPU_USAGE>"
+            << "<MAX_DISK>0</MAX_DISK>"
+            << "<MAX_MEM>8388608</MAX_MEM>"
+            << "<MAX_CPU>800</MAX_CPU>"
+            << "<FREE_DISK>0</FREE_DISK>"
+            << "<FREE_MEM>"    << 8388608 - mem_usage << "</FREE_MEM>"
+            << "<FREE_CPU>"    << 800 - cpu_usage << "</FREE_CPU>"
+            << "<RUNNING_VMS>" << running_vms << "</RUNNING_VMS>"
+            << "</HOST_SHARE><TEMPLATE>"
+            << "<FREECPU>"     << 800 - cpu_usage << "</FREECPU>"
+            << "</TEMPLATE></HOST>";
+
+        objects.insert(make_pair(hid, new HostXML(oss.str())));
+    };
+
+protected:
+
+    void add_object(xmlNodePtr node){};
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class PolicyTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE( PolicyTest );
+
+    CPPUNIT_TEST( rank );
+    CPPUNIT_TEST( packing );
+    CPPUNIT_TEST( striping );
+    CPPUNIT_TEST( load_aware );
+    CPPUNIT_TEST( allocated_capacity );
+    CPPUNIT_TEST( rank_and_placement );
+
+    CPPUNIT_TEST_SUITE_END ();
+
+private:
+    FriendHostPool *    hp;
+    VirtualMachineXML * vm;
+
+    /**
+     *  Creates a VM with 1 CPU and 1GB matching hosts 0, 1 and 2
+     */
+    VirtualMachineXML * create_vm(const string& rank)
+    {
+        VirtualMachineXML * new_vm;
+        ostringstream       oss;
+
+        oss << "<VM><ID>0</ID><UID>0</UID><GID>0</GID><TEMPLATE>"
+            << "<CPU>1</CPU><MEMORY>1024</MEMORY>";
+
+        if ( !rank.empty() )
+        {
+            oss << "<RANK>" << rank << "</RANK>";
+        }
+
+        oss << "</TEMPLATE></VM>";
+
+        new_vm = new VirtualMachineXML(oss.str());
+
+        new_vm->add_host(0);
+        new_vm->add_host(1);
+        new_vm->add_host(2);
+
+        return new_vm;
+    };
+
+    /**
+     *  Index of the host with the highest priority
+     */
+    static int best(const vector<float>& priority)
+    {
+        return max_element(priority.begin(), priority.end())
+               - priority.begin();
+    };
+
+public:
+    void setUp()
+    {
+        xmlInitParser();
+
+        hp = new FriendHostPool();
+
+        hp->add_host(0, 400, 4194304, 2);
+        hp->add_host(1, 0,   0,       0);
+        hp->add_host(2, 700, 7340032, 7);
+
+        vm = 0;
+    };
+
+    void tearDown()
+    {
+        if ( vm != 0 )
+        {
+            delete vm;
+        }
+
+        delete hp;
+
+        xmlCleanupParser();
+    };
+
+    PolicyTest(){};
+
+    ~PolicyTest(){};
+
+    /* ********************************************************************* */
+
+    void rank()
+    {
+        RankPolicy  policy(0, hp);
+
+        vm = create_vm("FREECPU");
+
+        const vector<float>& priority = policy.get(vm);
+
+        CPPUNIT_ASSERT( priority.size() == 3 );
+        CPPUNIT_ASSERT( best(priority) == 1 );
+        CPPUNIT_ASSERT( priority[0] > priority[2] );
+    };
+
+    void packing()
+    {
+        PackingPolicy policy(0, hp);
+
+        vm = create_vm("");
+
+        const vector<float>& priority = policy.get(vm);
+
+        CPPUNIT_ASSERT( priority.size() == 3 );
+        CPPUNIT_ASSERT( best(priority) == 2 );
+        CPPUNIT_ASSERT( priority[0] > priority[1] );
+    };
+
+    void striping()
+    {
+        StripingPolicy policy(0, hp);
+
+        vm = create_vm("");
+
+        const vector<float>& priority = policy.get(vm);
+
+        CPPUNIT_ASSERT( priority.size() == 3 );
+        CPPUNIT_ASSERT( best(priority) == 1 );
+        CPPUNIT_ASSERT( priority[0] > priority[2] );
+    };
+
+    void load_aware()
+    {
+        LoadAwarePolicy policy(0, hp);
+
+        vm = create_vm("");
+
+        const vector<float>& priority = policy.get(vm);
+
+        CPPUNIT_ASSERT( priority.size() == 3 );
+        CPPUNIT_ASSERT( best(priority) == 1 );
+        CPPUNIT_ASSERT( priority[0] > priority[2] );
+    };
+
+    void allocated_capacity()
+    {
+        StripingPolicy  striping(0, hp);
+        PackingPolicy   packing(0, hp);
+
+        vm = create_vm("");
+
+        // The VMs placed in the cycle change the host priorities
+        hp->get(1)->add_capacity(500, 5242880, 0);
+        hp->get(1)->add_capacity(100, 1048576, 0);
+        hp->get(1)->add_capacity(100, 1048576, 0);
+        hp->get(1)->add_capacity(50,  524288,  0);
+
+        CPPUNIT_ASSERT( best(striping.get(vm)) == 0 );
+        CPPUNIT_ASSERT( best(packing.get(vm))  == 1 );
+    };
+
+    void rank_and_placement()
+    {
+        RankPolicy    rank(0, hp);
+        PackingPolicy packing(0, hp);
+
+        vector<float> total;
+        vector<float> placement;
+
+        // All the hosts have the same rank, the placement policy decides
+        vm = create_vm("FREECPU / FREECPU");
+
+        total     = rank.get(vm);
+        placement = packing.get(vm);
+
+        for (unsigned int i = 0; i < total.size(); i++)
+        {
+            total[i] += placement[i];
+        }
+
+        CPPUNIT_ASSERT( best(total) == 2 );
+
+        delete vm;
+
+        // The RANK is added to the placement policy
+        vm = create_vm("- RUNNING_VMS");
+
+        total     = rank.get(vm);
+        placement = packing.get(vm);
+
+        for (unsigned int i = 0; i < total.size(); i++)
+        {
+            total[i] += placement[i];
+        }
+
+        CPPUNIT_ASSERT( best(total) == 0 );
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+int main(int argc, char ** argv)
+{
+    return OneUnitTest::main(argc, argv, PolicyTest::suite(),
+                            "PolicyTest.xml");
+}
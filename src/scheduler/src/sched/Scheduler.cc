@@ -28,9 +28,13 @@
 #include <pthread.h>
 
 #include <cmath>
+#include <algorithm>
 
 #include "Scheduler.h"
 #include "RankPolicy.h"
+#include "PackingPolicy.h"
+#include "StripingPolicy.h"
+#include "LoadAwarePolicy.h"
 #include "NebulaLog.h"
 
 using namespace std;
@@ -322,12 +326,8 @@ void Scheduler::match()
             
             if ( matched == false )
             {
-                ostringstream oss;
-
-                oss << "Host " << host->get_hid() << 
-                    " filtered out. It does not fullfil REQUIREMENTS.";
-
-                NebulaLog::log("SCHED",Log::DEBUG,oss);
+                NEBULA_LOG("SCHED", Log::DEBUG, "Host " << host->get_hid() <<
+                    " filtered out. It does not fullfil REQUIREMENTS.");
                 continue;
             }
             
@@ -353,12 +353,8 @@ void Scheduler::match()
 
             if ( matched == false )
             {
-                ostringstream oss;
-
-                oss << "Host " << host->get_hid() << 
-                    " filtered out. User is not authorized to use it.";
-
-                NebulaLog::log("SCHED",Log::DEBUG,oss);
+                NEBULA_LOG("SCHED", Log::DEBUG, "Host " << host->get_hid() <<
+                    " filtered out. User is not authorized to use it.");
                 continue;
             }
             // -----------------------------------------------------------------
@@ -378,13 +374,8 @@ void Scheduler::match()
             }
             else
             {
-                ostringstream oss;
-
-                oss << "Host " << host->get_hid() << 
-                    " filtered out. It does not have enough capacity.";
-
-                NebulaLog::log("SCHED",Log::DEBUG,oss);
-                
+                NEBULA_LOG("SCHED", Log::DEBUG, "Host " << host->get_hid() <<
+                    " filtered out. It does not have enough capacity.");
             }
         }
     }
@@ -393,6 +384,43 @@ void Scheduler::match()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void Scheduler::add_placement_policies(PlacementPolicy placement)
+{
+    SchedulerHostPolicy * hp = 0;
+
+    placement_policies.push_back(new RankPolicy(vmpool,hpool,1.0));
+
+    switch (placement)
+    {
+        case PACKING:
+            hp = new PackingPolicy(vmpool,hpool,1.0);
+            break;
+
+        case STRIPING:
+            hp = new StripingPolicy(vmpool,hpool,1.0);
+            break;
+
+        case LOAD:
+            hp = new LoadAwarePolicy(vmpool,hpool,1.0);
+            break;
+
+        default:
+            break;
+    }
+
+    if ( hp != 0 )
+    {
+        placement_policies.push_back(hp);
+    }
+
+    for (unsigned int i = 0; i < placement_policies.size(); i++)
+    {
+        add_host_policy(placement_policies[i]);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
 static float sum_operator (float i, float j)
 {
     return i+j;
@@ -400,16 +428,41 @@ static float sum_operator (float i, float j)
 
 /* -------------------------------------------------------------------------- */
 
-int Scheduler::schedule()
+void Scheduler::prioritize(VirtualMachineXML * vm)
 {
     vector<SchedulerHostPolicy *>::iterator it;
 
-    VirtualMachineXML * vm;
-    ostringstream       oss;
-
     vector<float>   total;
     vector<float>   policy;
 
+    for ( it=host_policies.begin();it!=host_policies.end();it++)
+    {
+        policy = (*it)->get(vm);
+
+        if (total.empty() == true)
+        {
+            total = policy;
+        }
+        else
+        {
+            transform(
+                total.begin(),
+                total.end(),
+                policy.begin(),
+                total.begin(),
+                sum_operator);
+        }
+    }
+
+    vm->set_priorities(total);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int Scheduler::schedule()
+{
+    VirtualMachineXML * vm;
+
     map<int, ObjectXML*>::const_iterator  vm_it;
 
     const map<int, ObjectXML*> pending_vms = vmpool->get_objects();
@@ -418,28 +471,7 @@ int Scheduler::schedule()
     {
         vm = static_cast<VirtualMachineXML*>(vm_it->second);
 
-        total.clear();
-
-        for ( it=host_policies.begin();it!=host_policies.end();it++)
-        {
-            policy = (*it)->get(vm);
-
-            if (total.empty() == true)
-            {
-                total = policy;
-            }
-            else
-            {
-                transform(
-                    total.begin(),
-                    total.end(),
-                    policy.begin(),
-                    total.begin(),
-                    sum_operator);
-            }
-        }
-
-        vm->set_priorities(total);
+        prioritize(vm);
     }
 
     return 0;
@@ -448,6 +480,27 @@ int Scheduler::schedule()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+/**
+ *  Sorts VMs by decreasing memory and then cpu requirements
+ */
+static bool vm_size_cmp(VirtualMachineXML * a, VirtualMachineXML * b)
+{
+    int a_cpu, a_mem, a_disk;
+    int b_cpu, b_mem, b_disk;
+
+    a->get_requirements(a_cpu, a_mem, a_disk);
+    b->get_requirements(b_cpu, b_mem, b_disk);
+
+    if ( a_mem != b_mem )
+    {
+        return a_mem > b_mem;
+    }
+
+    return a_cpu > b_cpu;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Scheduler::dispatch()
 {
     VirtualMachineXML * vm;
@@ -455,46 +508,86 @@ void Scheduler::dispatch()
 
     int             hid;
     int             rc;
+    unsigned int    selected_vms;
     unsigned int    dispatched_vms;
 
     map<int, ObjectXML*>::const_iterator  vm_it;
     const map<int, ObjectXML*>            pending_vms = vmpool->get_objects();
 
-    map<int, int>  host_vms;
+    vector<VirtualMachineXML *>           vms;
+    vector<VirtualMachineXML *>::iterator it;
 
-    oss << "Select hosts" << endl;
-    oss << "\tPRI\tHID" << endl;
-    oss << "\t-------------------" << endl;
+    vector<pair<int,int> >                deploys;
+    vector<int>                           rcs;
+
+    map<int, int>  host_vms;
 
     for (vm_it=pending_vms.begin(); vm_it != pending_vms.end(); vm_it++)
     {
-        vm = static_cast<VirtualMachineXML*>(vm_it->second);
+        vms.push_back(static_cast<VirtualMachineXML*>(vm_it->second));
+    }
+
+    // Dumping the host selection of every pending VM is expensive, skip it
+    // unless the log is going to show it
+    if ( NebulaLog::enabled(Log::INFO) )
+    {
+        oss << "Select hosts" << endl;
+        oss << "\tPRI\tHID" << endl;
+        oss << "\t-------------------" << endl;
 
-        oss << "Virtual Machine: " << vm->get_oid() << "\n" << *vm << endl;
+        for (it = vms.begin(); it != vms.end(); it++)
+        {
+            oss << "Virtual Machine: " << (*it)->get_oid() << "\n" << **it
+                << endl;
+        }
+
+        NebulaLog::log("SCHED",Log::INFO,oss);
     }
 
-    NebulaLog::log("SCHED",Log::INFO,oss);
+    if ( batch_dispatch )
+    {
+        stable_sort(vms.begin(), vms.end(), vm_size_cmp);
+    }
 
-    dispatched_vms = 0;
-    for (vm_it=pending_vms.begin();
-         vm_it != pending_vms.end() && ( dispatch_limit <= 0 ||
-                                         dispatched_vms < dispatch_limit );
-         vm_it++)
+    selected_vms = 0;
+    for (it=vms.begin();
+         it != vms.end() && ( dispatch_limit <= 0 ||
+                              selected_vms < dispatch_limit );
+         it++)
     {
-        vm = static_cast<VirtualMachineXML*>(vm_it->second);
+        vm = *it;
+
+        if ( batch_dispatch )
+        {
+            prioritize(vm);
+        }
 
         rc = vm->get_host(hid,hpool,host_vms,host_dispatch_limit);
 
         if (rc == 0)
         {
-            rc = vmpool->dispatch(vm_it->first,hid);
+            deploys.push_back(make_pair(vm->get_oid(),hid));
 
-            if (rc == 0)
-            {
-                dispatched_vms++;
-            }
+            selected_vms++;
         }
     }
+
+    // -------------------------------------------------------------------------
+    // Deploy the VMs in a single request
+    // -------------------------------------------------------------------------
+
+    vmpool->dispatch(deploys, rcs);
+
+    dispatched_vms = count(rcs.begin(), rcs.end(), 0);
+
+    if ( !deploys.empty() )
+    {
+        oss.str("");
+        oss << "Dispatched " << dispatched_vms << " of " << deploys.size()
+            << " virtual machines.";
+
+        NebulaLog::log("SCHED",Log::INFO,oss);
+    }
 }
 
 /* -------------------------------------------------------------------------- */
@@ -15,7 +15,6 @@
 /* -------------------------------------------------------------------------- */
 
 #include "Scheduler.h"
-#include "RankPolicy.h"
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -31,35 +30,39 @@ class RankScheduler : public Scheduler
 {
 public:
 
-    RankScheduler(string       url,
-                  time_t       timer,
-                  unsigned int machines_limit,
-                  unsigned int dispatch_limit,
-                  unsigned int host_dispatch_limit
+    RankScheduler(string          url,
+                  time_t          timer,
+                  unsigned int    machines_limit,
+                  unsigned int    dispatch_limit,
+                  unsigned int    host_dispatch_limit,
+                  PlacementPolicy _placement
                   ):Scheduler(url,
                               timer,
                               machines_limit,
                               dispatch_limit,
-                              host_dispatch_limit),rp(0){};
+                              host_dispatch_limit,
+                              _placement != RANK),
+                    placement(_placement),
+                    host_limit(host_dispatch_limit){};
 
-    ~RankScheduler()
-    {
-        if ( rp != 0 )
-        {
-            delete rp;
-        }
-    };
+    ~RankScheduler(){};
 
     void register_policies()
     {
-        rp = new RankPolicy(vmpool,hpool,1.0);
+        add_placement_policies(placement);
 
-        add_host_policy(rp);
+        if ( placement == PACKING && host_limit <= 1 )
+        {
+            NebulaLog::log("SCHED", Log::WARNING, "Packing policy with a host "
+                "dispatch limit of 1 (-h), only one VM per host is placed in "
+                "each cycle so the VMs are not packed.");
+        }
     };
 
 private:
-    RankPolicy * rp;
+    PlacementPolicy       placement;
 
+    unsigned int          host_limit;
 };
 
 int main(int argc, char **argv)
@@ -70,11 +73,12 @@ int main(int argc, char **argv)
     unsigned int    machines_limit = 300;
     unsigned int    dispatch_limit = 30;
     unsigned int    host_dispatch_limit = 1;
+    int             placement = RankScheduler::RANK;
     char            opt;
 
     ostringstream  oss;
 
-    while((opt = getopt(argc,argv,"p:t:m:d:h:")) != -1)
+    while((opt = getopt(argc,argv,"p:t:m:d:h:s:")) != -1)
     {
         switch(opt)
         {
@@ -93,14 +97,25 @@ int main(int argc, char **argv)
             case 'h':
                 host_dispatch_limit = atoi(optarg);
                 break;
+            case 's':
+                placement = atoi(optarg);
+                break;
             default:
                 cerr << "usage: " << argv[0] << " [-p port] [-t timer] ";
-                cerr << "[-m machines limit] [-d dispatch limit] [-h host_dispatch_limit]\n";
+                cerr << "[-m machines limit] [-d dispatch limit] [-h host_dispatch_limit] ";
+                cerr << "[-s placement policy (0 rank, 1 packing, 2 striping, 3 load)]\n";
+                cerr << "The packing policy needs a host dispatch limit greater than 1\n";
                 exit(-1);
                 break;
         }
     };
 
+    if ( placement < RankScheduler::RANK || placement > RankScheduler::LOAD )
+    {
+        cerr << "Wrong placement policy: " << placement << endl;
+        exit(-1);
+    }
+
     /* ---------------------------------------------------------------------- */
 
     oss << "http://localhost:" << port << "/RPC2";
@@ -109,7 +124,8 @@ int main(int argc, char **argv)
                            timer,
                            machines_limit,
                            dispatch_limit,
-                           host_dispatch_limit);
+                           host_dispatch_limit,
+                           static_cast<RankScheduler::PlacementPolicy>(placement));
 
     try
     {
@@ -334,27 +334,29 @@ bool Template::get(
 
 string& Template::to_xml(string& xml) const
 {
-    multimap<string,Attribute *>::const_iterator  it;
-    ostringstream                   		oss;
-    string *                                s;
+    XMLWriter writer;
 
-    oss << "<" << xml_root << ">";
+    to_xml(writer);
 
-    for ( it = attributes.begin(); it!=attributes.end(); it++)
-    {
-        s = it->second->to_xml();
+    return writer.swap(xml);
+}
 
-        oss << *s;
+/* -------------------------------------------------------------------------- */
 
-        delete s;
-    }
+void Template::to_xml(XMLWriter& xml) const
+{
+    multimap<string,Attribute *>::const_iterator it;
 
-    oss << "</" << xml_root << ">";
+    xml.open(xml_root);
 
-    xml = oss.str();
+    for ( it = attributes.begin(); it!=attributes.end(); it++)
+    {
+        it->second->to_xml(xml);
+    }
 
-	return xml;
+    xml.close(xml_root);
 }
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
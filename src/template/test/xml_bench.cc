@@ -0,0 +1,272 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+/* -------------------------------------------------------------------------- */
+/* Throughput of the XML serializers. Compares the former ostringstream       */
+/* based implementation of Template and VirtualMachine with XMLWriter.        */
+/*                                                                            */
+/*   ./xml_bench [iterations]                                                 */
+/* -------------------------------------------------------------------------- */
+
+#include "Template.h"
+#include "XMLWriter.h"
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <sys/time.h>
+
+using namespace std;
+
+static const char * template_str =
+    "NAME   = \"bench_vm\"\n"
+    "CPU    = 0.5\n"
+    "VCPU   = 2\n"
+    "MEMORY = 512\n"
+    "OS     = [ ARCH = \"x86_64\", BOOT = \"hd\", KERNEL = \"\" ]\n"
+    "DISK   = [ IMAGE_ID = 12, SOURCE = \"/var/lib/one/images/abcdef0123\","
+    " TARGET = \"hda\", TYPE = \"disk\", READONLY = \"no\" ]\n"
+    "DISK   = [ TYPE = \"swap\", SIZE = 1024, TARGET = \"hdb\" ]\n"
+    "NIC    = [ NETWORK = \"public\", NETWORK_ID = 3, IP = \"10.0.0.21\","
+    " MAC = \"02:00:0a:00:00:15\", BRIDGE = \"br0\" ]\n"
+    "NIC    = [ NETWORK = \"private\", NETWORK_ID = 4, IP = \"192.168.0.7\","
+    " MAC = \"02:00:c0:a8:00:07\", BRIDGE = \"br1\" ]\n"
+    "GRAPHICS = [ TYPE = \"vnc\", LISTEN = \"0.0.0.0\", PORT = 5921 ]\n"
+    "CONTEXT  = [ HOSTNAME = \"bench_vm\", FILES = \"/srv/init.sh\","
+    " TARGET = \"hdc\" ]\n"
+    "REQUIREMENTS = \"FREECPU > 50 & HYPERVISOR = \\\"kvm\\\"\"\n"
+    "RANK     = \"FREECPU\"\n";
+
+/* -------------------------------------------------------------------------- */
+/* Former ostringstream based serializers                                     */
+/* -------------------------------------------------------------------------- */
+
+static string& attribute_oss(const Attribute * attr, string& xml)
+{
+    ostringstream oss;
+
+    const SingleAttribute * sa = dynamic_cast<const SingleAttribute *>(attr);
+
+    if ( sa != 0 )
+    {
+        xml = "<" + sa->name() + "><![CDATA[" + sa->value()
+            + "]]></"+ sa->name() + ">";
+
+        return xml;
+    }
+
+    const VectorAttribute * va = static_cast<const VectorAttribute *>(attr);
+    const map<string,string>& values = va->value();
+
+    map<string,string>::const_iterator it;
+
+    oss << "<" << va->name() << ">";
+
+    for (it = values.begin(); it != values.end(); it++)
+    {
+        if ( it->second.empty() )
+        {
+            oss << "<" << it->first << "/>";
+        }
+        else
+        {
+            oss << "<" << it->first << "><![CDATA[" << it->second
+                << "]]></"<< it->first << ">";
+        }
+    }
+
+    oss << "</"<< va->name() << ">";
+
+    xml = oss.str();
+
+    return xml;
+}
+
+static string& template_oss(const vector<const Attribute *>& attrs,
+                            string& xml)
+{
+    ostringstream oss;
+    string        attr_xml;
+
+    oss << "<TEMPLATE>";
+
+    for (unsigned int i = 0; i < attrs.size(); i++)
+    {
+        oss << attribute_oss(attrs[i], attr_xml);
+    }
+
+    oss << "</TEMPLATE>";
+
+    xml = oss.str();
+
+    return xml;
+}
+
+static string& vm_oss(const vector<const Attribute *>& attrs, int oid,
+                      string& xml)
+{
+    ostringstream oss;
+    string        template_xml;
+    time_t        now = 1317041234;
+
+    oss << "<VM>"
+        << "<ID>"        << oid       << "</ID>"
+        << "<UID>"       << 2         << "</UID>"
+        << "<GID>"       << 1         << "</GID>"
+        << "<UNAME>"     << "oneuser" << "</UNAME>"
+        << "<GNAME>"     << "users"   << "</GNAME>"
+        << "<NAME>"      << "bench"   << "</NAME>"
+        << "<LAST_POLL>" << now       << "</LAST_POLL>"
+        << "<STATE>"     << 3         << "</STATE>"
+        << "<LCM_STATE>" << 3         << "</LCM_STATE>"
+        << "<STIME>"     << now       << "</STIME>"
+        << "<ETIME>"     << 0         << "</ETIME>"
+        << "<DEPLOY_ID>" << "one-12"  << "</DEPLOY_ID>"
+        << "<MEMORY>"    << 524288    << "</MEMORY>"
+        << "<CPU>"       << 12        << "</CPU>"
+        << "<NET_TX>"    << 1048576   << "</NET_TX>"
+        << "<NET_RX>"    << 2097152   << "</NET_RX>"
+        << template_oss(attrs, template_xml)
+        << "</VM>";
+
+    xml = oss.str();
+
+    return xml;
+}
+
+/* -------------------------------------------------------------------------- */
+/* XMLWriter serializers                                                      */
+/* -------------------------------------------------------------------------- */
+
+static string& vm_writer(const Template& tmpl, int oid, string& xml)
+{
+    XMLWriter writer(4096);
+    time_t    now = 1317041234;
+
+    writer.open("VM")
+        .add("ID",        oid)
+        .add("UID",       2)
+        .add("GID",       1)
+        .add("UNAME",     "oneuser")
+        .add("GNAME",     "users")
+        .add("NAME",      "bench")
+        .add("LAST_POLL", now)
+        .add("STATE",     3)
+        .add("LCM_STATE", 3)
+        .add("STIME",     now)
+        .add("ETIME",     0)
+        .add("DEPLOY_ID", "one-12")
+        .add("MEMORY",    524288)
+        .add("CPU",       12)
+        .add("NET_TX",    1048576)
+        .add("NET_RX",    2097152);
+
+    tmpl.to_xml(writer);
+
+    writer.close("VM");
+
+    return writer.swap(xml);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+static double now_ms()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, 0);
+
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static void report(const char * name, int n, size_t bytes, double ms)
+{
+    cout << "  " << name << ": " << ms << " ms, " << n * 1000.0 / ms
+         << " docs/s, " << bytes * 1000.0 / ms / (1024 * 1024) << " MB/s"
+         << endl;
+}
+
+int main(int argc, char ** argv)
+{
+    int n = 100000;
+
+    Template  tmpl(false, '=', "TEMPLATE");
+    char *    error = 0;
+
+    vector<const Attribute *> attrs;
+
+    string xml_oss;
+    string xml_writer;
+    size_t bytes = 0;
+    double start;
+
+    if ( argc > 1 )
+    {
+        n = atoi(argv[1]);
+    }
+
+    if ( tmpl.parse(string(template_str), &error) != 0 )
+    {
+        cerr << "Error parsing template: " << error << endl;
+        free(error);
+
+        return -1;
+    }
+
+    // Attributes in the same order as the Template multimap
+    const char * names[] = {"CONTEXT", "CPU", "DISK", "GRAPHICS", "MEMORY",
+        "NAME", "NIC", "OS", "RANK", "REQUIREMENTS", "VCPU"};
+
+    for (unsigned int i = 0; i < sizeof(names)/sizeof(names[0]); i++)
+    {
+        tmpl.get(names[i], attrs);
+    }
+
+    vm_oss(attrs, 0, xml_oss);
+    vm_writer(tmpl, 0, xml_writer);
+
+    if ( xml_oss != xml_writer )
+    {
+        cerr << "Serializers differ:" << endl << xml_oss << endl
+             << xml_writer << endl;
+
+        return -1;
+    }
+
+    cout << n << " VM documents of " << xml_oss.size() << " bytes" << endl;
+
+    start = now_ms();
+
+    for (int i = 0; i < n; i++)
+    {
+        bytes += vm_oss(attrs, i, xml_oss).size();
+    }
+
+    report("ostringstream", n, bytes, now_ms() - start);
+
+    bytes = 0;
+    start = now_ms();
+
+    for (int i = 0; i < n; i++)
+    {
+        bytes += vm_writer(tmpl, i, xml_writer).size();
+    }
+
+    report("XMLWriter    ", n, bytes, now_ms() - start);
+
+    return 0;
+}
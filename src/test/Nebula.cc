@@ -156,10 +156,8 @@ void Nebula::start()
     hook_location    = nebula_location + "hooks/";
     remotes_location = nebula_location + "var/remotes/";
 
-    if ( nebula_configuration != 0)
-    {
-        delete nebula_configuration;
-    }
+    // The configuration file is not loaded, attributes are not defined
+    nebula_configuration = new NebulaTemplate(etc_location, var_location);
 
     xmlInitParser();
 
@@ -392,6 +390,19 @@ void Nebula::start()
         {
            throw runtime_error("Could not start the Hook Manager");
         }
+
+        if( hm != 0 )
+        {
+            if ( vmpool != 0 )
+            {
+                vmpool->set_hook_queue(hm);
+            }
+
+            if ( hpool != 0 )
+            {
+                hpool->set_hook_queue(hm);
+            }
+        }
     }
 
     // ---- Auth Manager ----
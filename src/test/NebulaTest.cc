@@ -112,9 +112,11 @@ DispatchManager* NebulaTest::create_dm(VirtualMachinePool* vmpool,
 
 RequestManager* NebulaTest::create_rm(string log_file)
 {
-    int rm_port = 2633;
+    int             rm_port = 2633;
+    map<string,int> method_limits;
 
-    return new RequestManager(rm_port, log_file);
+    return new RequestManager(rm_port, 15, 15, 15, 30, 15, 0, log_file,
+                              method_limits);
 }
 
 HookManager* NebulaTest::create_hm(VirtualMachinePool * vmpool)
@@ -196,12 +196,138 @@ void TransferManager::do_action(const string &action, void * arg)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+string TransferManager::cache_image(
+    VirtualMachine *              vm,
+    const TransferManagerDriver * tm_md,
+    const VectorAttribute *       disk,
+    ostringstream&                evict_xfr,
+    ostringstream&                fill_xfr)
+{
+    Nebula&         nd    = Nebula::instance();
+    ImagePool *     ipool = nd.get_ipool();
+
+    Image *         img;
+    Host *          host;
+
+    string          source;
+    string          squota;
+    ostringstream   cached;
+    istringstream   iss;
+
+    int             iid;
+    int             size;
+    int             quota;
+    time_t          the_time;
+    vector<int>     evicted;
+
+    HostImageCache::EntryState state;
+
+    if ( tm_md->image_cache.empty() )
+    {
+        return "";
+    }
+
+    // Only images from the repository are cached, not TM specific URLs
+    source = disk->vector_value("SOURCE");
+
+    if ( source.empty() || source.find(":") != string::npos )
+    {
+        return "";
+    }
+
+    iss.str(disk->vector_value("IMAGE_ID"));
+    iss >> iid;
+
+    if ( iss.fail() )
+    {
+        return "";
+    }
+
+    img = ipool->get(iid, true);
+
+    if ( img == 0 )
+    {
+        return "";
+    }
+
+    size = img->get_size();
+
+    img->unlock();
+
+    // ------------------------------------------------------------------------
+    // Look for the image in the host cache, add it if it is not there
+    // ------------------------------------------------------------------------
+
+    host = hpool->get(vm->get_hid(), true);
+
+    if ( host == 0 )
+    {
+        return "";
+    }
+
+    quota = tm_md->image_cache_size;
+
+    host->get_template_attribute("IMAGE_CACHE_SIZE", squota);
+
+    if ( !squota.empty() )
+    {
+        host->get_template_attribute("IMAGE_CACHE_SIZE", quota);
+    }
+
+    cached << vm->get_hostname() << ":" << tm_md->image_cache << "/" << iid;
+
+    the_time = time(0);
+
+    state = host->get_image_cache().lookup(iid, source, the_time);
+
+    switch (state)
+    {
+        case HostImageCache::READY:
+            break;
+
+        case HostImageCache::FILLING: // Clone it while it is being copied
+            host->unlock();
+            return "";
+
+        case HostImageCache::MISS:
+            if ( host->get_image_cache().add(iid, source, size, vm->get_oid(),
+                    quota, the_time, evicted) != 0 )
+            {
+                host->unlock();
+                return "";
+            }
+
+            for (unsigned int i = 0; i < evicted.size(); i++)
+            {
+                evict_xfr << "DELETE " << vm->get_hostname() << ":"
+                          << tm_md->image_cache << "/" << evicted[i] << endl;
+            }
+
+            fill_xfr << "CLONE " << nd.get_nebula_hostname() << ":" << source
+                     << " " << cached.str() << endl;
+            break;
+    }
+
+    hpool->update(host);
+
+    host->unlock();
+
+    return cached.str();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void TransferManager::prolog_action(int vid)
 {
-    ofstream      xfr;
+    ostringstream xfr;
     ostringstream os;
     string        xfr_name;
 
+    ostringstream evict_xfr;
+    ostringstream fill_xfr;
+    string        cached;
+
     const VectorAttribute * disk;
     string source;
     string type;
@@ -213,7 +339,7 @@ void TransferManager::prolog_action(int vid)
     VirtualMachine * vm;
     Nebula&          nd = Nebula::instance();
 
-    const TransferManagerDriver * tm_md;
+    const TransferManagerDriver * tm_md = 0;
 
     vector<const Attribute *> attrs;
     int                       num;
@@ -244,17 +370,14 @@ void TransferManager::prolog_action(int vid)
     }
 
     xfr_name = vm->get_transfer_file() + ".prolog";
-    xfr.open(xfr_name.c_str(), ios::out | ios::trunc);
-
-    if (xfr.fail() == true)
-    {
-        goto error_file;
-    }
 
     // ------------------------------------------------------------------------
-    // Swap and image Commands
+    // Swap and image Commands. Each one creates a different disk.i file, so
+    // they can be executed at the same time (PARALLEL block)
     // ------------------------------------------------------------------------
 
+    xfr << "# PARALLEL" << endl;
+
     num = vm->get_template_attribute("DISK",attrs);
 
     for (int i=0; i < num ;i++,source="",type="",clon="")
@@ -346,7 +469,20 @@ void TransferManager::prolog_action(int vid)
                 goto error_empty_disk;
             }
 
-            if ( source.find(":") == string::npos ) //Regular file
+            if ( clon == "YES" )
+            {
+                cached = cache_image(vm, tm_md, disk, evict_xfr, fill_xfr);
+            }
+            else
+            {
+                cached = "";
+            }
+
+            if ( !cached.empty() ) //Local copy from the host image cache
+            {
+                xfr << cached << " ";
+            }
+            else if ( source.find(":") == string::npos ) //Regular file
             {
                 xfr << nd.get_nebula_hostname() << ":" << source << " ";
             }
@@ -391,9 +527,21 @@ void TransferManager::prolog_action(int vid)
             << "/disk." << num << endl;
     }
 
-    xfr.close();
+    xfr << "# END" << endl;
 
-    tm_md->transfer(vid,xfr_name);
+    // ------------------------------------------------------------------------
+    // The images are copied to the host cache before cloning the disks
+    // ------------------------------------------------------------------------
+
+    if ( !fill_xfr.str().empty() )
+    {
+        evict_xfr << "# PARALLEL" << endl << fill_xfr.str() << "# END" << endl;
+    }
+
+    if ( tm_md->transfer(vid, xfr_name, evict_xfr.str() + xfr.str()) != 0 )
+    {
+        goto error_file;
+    }
 
     vm->unlock();
 
@@ -411,7 +559,7 @@ error_history:
 
 error_file:
     os.str("");
-    os << "prolog, could not open file: " << xfr_name;
+    os << "prolog, could not write transfer file: " << xfr_name;
     goto error_common;
 
 error_driver:
@@ -422,9 +570,13 @@ error_driver:
 error_empty_disk:
     os.str("");
     os << "prolog, undefined source disk image in VM template";
-    xfr.close();
 
 error_common:
+    if ( tm_md != 0 )
+    {
+        tm_md->update_image_cache(vm, false);
+    }
+
     (nd.get_lcm())->trigger(LifeCycleManager::PROLOG_FAILURE,vid);
     vm->log("TM", Log::ERROR, os);
 
@@ -437,7 +589,7 @@ error_common:
 
 void TransferManager::prolog_migr_action(int vid)
 {
-    ofstream        xfr;
+    ostringstream   xfr;
     ostringstream   os;
     string          xfr_name;
 
@@ -471,12 +623,6 @@ void TransferManager::prolog_migr_action(int vid)
     }
 
     xfr_name = vm->get_transfer_file() + ".migrate";
-    xfr.open(xfr_name.c_str(), ios::out | ios::trunc);
-
-    if (xfr.fail() == true)
-    {
-        goto error_file;
-    }
 
     // ------------------------------------------------------------------------
     // Move image directory
@@ -486,9 +632,10 @@ void TransferManager::prolog_migr_action(int vid)
     xfr << vm->get_previous_hostname() << ":" << vm->get_remote_dir() << " ";
     xfr << vm->get_hostname() << ":" << vm->get_remote_dir() << endl;
 
-    xfr.close();
-
-    tm_md->transfer(vid,xfr_name);
+    if ( tm_md->transfer(vid, xfr_name, xfr.str()) != 0 )
+    {
+        goto error_file;
+    }
 
     vm->unlock();
 
@@ -501,7 +648,7 @@ error_history:
 
 error_file:
     os.str("");
-    os << "prolog_migr, could not open file: " << xfr_name;
+    os << "prolog_migr, could not write transfer file: " << xfr_name;
     goto error_common;
 
 error_driver:
@@ -521,7 +668,7 @@ error_common:
 
 void TransferManager::prolog_resume_action(int vid)
 {
-    ofstream        xfr;
+    ostringstream   xfr;
     ostringstream   os;
     string          xfr_name;
 
@@ -555,12 +702,6 @@ void TransferManager::prolog_resume_action(int vid)
     }
 
     xfr_name = vm->get_transfer_file() + ".resume";
-    xfr.open(xfr_name.c_str(), ios::out | ios::trunc);
-
-    if (xfr.fail() == true)
-    {
-        goto error_file;
-    }
 
     // ------------------------------------------------------------------------
     // Move image directory
@@ -570,9 +711,10 @@ void TransferManager::prolog_resume_action(int vid)
     xfr << nd.get_nebula_hostname() << ":" << vm->get_local_dir() << "/images ";
     xfr << vm->get_hostname() << ":" << vm->get_remote_dir() << endl;
 
-    xfr.close();
-
-    tm_md->transfer(vid,xfr_name);
+    if ( tm_md->transfer(vid, xfr_name, xfr.str()) != 0 )
+    {
+        goto error_file;
+    }
 
     vm->unlock();
 
@@ -585,7 +727,7 @@ error_history:
 
 error_file:
     os.str("");
-    os << "prolog_resume, could not open file: " << xfr_name;
+    os << "prolog_resume, could not write transfer file: " << xfr_name;
     goto error_common;
 
 error_driver:
@@ -606,7 +748,7 @@ error_common:
 
 void TransferManager::epilog_action(int vid)
 {
-    ofstream        xfr;
+    ostringstream   xfr;
     ostringstream   os;
     string          xfr_name;
 
@@ -645,17 +787,14 @@ void TransferManager::epilog_action(int vid)
     }
 
     xfr_name = vm->get_transfer_file() + ".epilog";
-    xfr.open(xfr_name.c_str(), ios::out | ios::trunc);
-
-    if (xfr.fail() == true)
-    {
-        goto error_file;
-    }
 
     // ------------------------------------------------------------------------
-    // copy back VM image (DISK with SAVE="yes")
+    // copy back VM image (DISK with SAVE="yes"), the images are independent
+    // but the VM directory is deleted after all of them
     // ------------------------------------------------------------------------
 
+    xfr << "# PARALLEL" << endl;
+
     num = vm->get_template_attribute("DISK",attrs);
 
     for (int i=0; i < num ;i++,save="")
@@ -685,11 +824,14 @@ void TransferManager::epilog_action(int vid)
         }
     }
 
-    xfr << "DELETE " << vm->get_hostname() <<":"<< vm->get_remote_dir() << endl;
+    xfr << "# END" << endl;
 
-    xfr.close();
+    xfr << "DELETE " << vm->get_hostname() <<":"<< vm->get_remote_dir() << endl;
 
-    tm_md->transfer(vid,xfr_name);
+    if ( tm_md->transfer(vid, xfr_name, xfr.str()) != 0 )
+    {
+        goto error_file;
+    }
 
     vm->unlock();
 
@@ -702,7 +844,7 @@ error_history:
 
 error_file:
     os.str("");
-    os << "epilog, could not open file: " << xfr_name;
+    os << "epilog, could not write transfer file: " << xfr_name;
     goto error_common;
 
 error_driver:
@@ -722,7 +864,7 @@ error_common:
 
 void TransferManager::epilog_stop_action(int vid)
 {
-    ofstream        xfr;
+    ostringstream   xfr;
     ostringstream   os;
     string          xfr_name;
 
@@ -756,12 +898,6 @@ void TransferManager::epilog_stop_action(int vid)
     }
 
     xfr_name = vm->get_transfer_file() + ".stop";
-    xfr.open(xfr_name.c_str(), ios::out | ios::trunc);
-
-    if (xfr.fail() == true)
-    {
-        goto error_file;
-    }
 
     // ------------------------------------------------------------------------
     // Move image directory
@@ -771,9 +907,10 @@ void TransferManager::epilog_stop_action(int vid)
     xfr << vm->get_hostname() << ":" << vm->get_remote_dir() << " ";
     xfr << nd.get_nebula_hostname() << ":" << vm->get_local_dir() << endl;
 
-    xfr.close();
-
-    tm_md->transfer(vid,xfr_name);
+    if ( tm_md->transfer(vid, xfr_name, xfr.str()) != 0 )
+    {
+        goto error_file;
+    }
 
     vm->unlock();
 
@@ -786,7 +923,7 @@ error_history:
 
 error_file:
     os.str("");
-    os << "epilog_stop, could not open file: " << xfr_name;
+    os << "epilog_stop, could not write transfer file: " << xfr_name;
     goto error_common;
 
 error_driver:
@@ -807,7 +944,7 @@ error_common:
 
 void TransferManager::epilog_delete_action(int vid)
 {
-    ofstream        xfr;
+    ostringstream   xfr;
     ostringstream   os;
     string          xfr_name;
 
@@ -839,12 +976,6 @@ void TransferManager::epilog_delete_action(int vid)
     }
     
     xfr_name = vm->get_transfer_file() + ".delete";
-    xfr.open(xfr_name.c_str(), ios::out | ios::trunc);
-
-    if (xfr.fail() == true)
-    {
-        goto error_file;
-    }
 
     // ------------------------------------------------------------------------
     // Delete the remote VM Directory
@@ -852,9 +983,10 @@ void TransferManager::epilog_delete_action(int vid)
     
     xfr << "DELETE " << vm->get_hostname() <<":"<< vm->get_remote_dir() << endl;
 
-    xfr.close();
-
-    tm_md->transfer(vid,xfr_name);
+    if ( tm_md->transfer(vid, xfr_name, xfr.str()) != 0 )
+    {
+        goto error_file;
+    }
 
     vm->unlock();
 
@@ -867,7 +999,7 @@ error_history:
 
 error_file:
     os.str("");
-    os << "epilog_delete, could not open file: " << xfr_name;
+    os << "epilog_delete, could not write transfer file: " << xfr_name;
     os << ". You may need to manually clean " << vm->get_hostname() 
        << ":" << vm->get_remote_dir();
     goto error_common;
@@ -890,7 +1022,7 @@ error_common:
 
 void TransferManager::epilog_delete_previous_action(int vid)
 {
-    ofstream        xfr;
+    ostringstream   xfr;
     ostringstream   os;
     string          xfr_name;
 
@@ -922,12 +1054,6 @@ void TransferManager::epilog_delete_previous_action(int vid)
     }
 
     xfr_name = vm->get_transfer_file() + ".delete_prev";
-    xfr.open(xfr_name.c_str(),ios::out | ios::trunc);
-
-    if (xfr.fail() == true)
-    {
-        goto error_file;
-    }
 
     // ------------------------------------------------------------------------
     // Delete the remote VM Directory
@@ -936,9 +1062,10 @@ void TransferManager::epilog_delete_previous_action(int vid)
     xfr << "DELETE " << vm->get_previous_hostname() <<":"<< vm->get_remote_dir()
         << endl;
 
-    xfr.close();
-
-    tm_md->transfer(vid,xfr_name);
+    if ( tm_md->transfer(vid, xfr_name, xfr.str()) != 0 )
+    {
+        goto error_file;
+    }
 
     vm->unlock();
 
@@ -951,7 +1078,7 @@ error_history:
 
 error_file:
     os.str("");
-    os << "epilog_delete, could not open file: " << xfr_name;
+    os << "epilog_delete, could not write transfer file: " << xfr_name;
     os << ". You may need to manually clean " << vm->get_previous_hostname() 
        << ":" << vm->get_remote_dir();
     goto error_common;
@@ -1011,6 +1138,9 @@ void TransferManager::driver_cancel_action(int vid)
     
     tm_md->driver_cancel(vid);
 
+    // Images being copied to the host cache by a cancelled prolog
+    tm_md->update_image_cache(vm, false);
+
     vm->unlock();
 
     return;
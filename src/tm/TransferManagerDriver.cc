@@ -19,21 +19,116 @@
 #include "LifeCycleManager.h"
 
 #include "Nebula.h"
+#include "SSLTools.h"
 #include <sstream>
+#include <fstream>
+#include <algorithm>
+
+#define TO_UPPER(S) transform(S.begin(),S.end(),S.begin(),(int(*)(int))toupper)
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+TransferManagerDriver::TransferManagerDriver(
+    int                         userid,
+    const map<string,string>&   attrs,
+    bool                        sudo,
+    VirtualMachinePool *        pool):
+        Mad(userid,attrs,sudo), vmpool(pool), inline_xfr(false),
+        xfr_files(false), image_cache_size(0)
+{
+    map<string,string>::const_iterator it;
+    string                             value;
+
+    it = attrs.find("INLINE");
+
+    if ( it != attrs.end() )
+    {
+        value = it->second;
+        TO_UPPER(value);
+
+        inline_xfr = ( value == "YES" );
+    }
+
+    it = attrs.find("XFR_FILES");
+
+    if ( it != attrs.end() )
+    {
+        value = it->second;
+        TO_UPPER(value);
+
+        xfr_files = ( value == "YES" );
+    }
+
+    it = attrs.find("IMAGE_CACHE");
+
+    if ( it != attrs.end() )
+    {
+        image_cache = it->second;
+    }
+
+    it = attrs.find("IMAGE_CACHE_SIZE");
+
+    if ( it != attrs.end() )
+    {
+        istringstream iss(it->second);
+
+        iss >> image_cache_size;
+
+        if ( iss.fail() )
+        {
+            image_cache_size = 0;
+        }
+    }
+}
 
 /* ************************************************************************** */
 /* Driver ASCII Protocol Implementation                                       */
 /* ************************************************************************** */
 
-void TransferManagerDriver::transfer (
-        const int oid,
-        const string& xfr_file) const
+int TransferManagerDriver::transfer (
+        const int       oid,
+        const string&   xfr_file,
+        const string&   xfr) const
 {
     ostringstream os;
+    string *      xfr64;
+
+    if ( !inline_xfr || xfr_files )
+    {
+        ofstream file(xfr_file.c_str(), ios::out | ios::trunc);
+
+        if (file.fail() == true)
+        {
+            return -1;
+        }
+
+        file << xfr;
+
+        file.close();
+    }
+
+    os << "TRANSFER " << oid << " " << xfr_file;
 
-    os << "TRANSFER " << oid << " " << xfr_file << endl;
+    if ( inline_xfr )
+    {
+        xfr64 = SSLTools::base64_encode(xfr);
+
+        if ( xfr64 == 0 )
+        {
+            return -1;
+        }
+
+        os << " " << *xfr64;
+
+        delete xfr64;
+    }
+
+    os << endl;
 
     write(os);
+
+    return 0;
 };
 
 
@@ -53,8 +148,7 @@ void TransferManagerDriver::protocol(
     int                     id;
     VirtualMachine *        vm;
 
-    os << "Message received: " << message;
-    NebulaLog::log("TM", Log::DEBUG, os);
+    NEBULA_LOG("TM", Log::DEBUG, "Message received: " << message);
 
     // Parse the driver message
     if ( is.good() )
@@ -116,6 +210,11 @@ void TransferManagerDriver::protocol(
 
         LifeCycleManager::Actions lcm_action;
 
+        if ( vm->get_lcm_state() == VirtualMachine::PROLOG )
+        {
+            update_image_cache(vm, result == "SUCCESS");
+        }
+
         if (result == "SUCCESS")
         {
             switch (vm->get_lcm_state())
@@ -200,6 +299,48 @@ error_state:
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void TransferManagerDriver::update_image_cache(
+        VirtualMachine * vm,
+        bool             success) const
+{
+    Nebula&     nd    = Nebula::instance();
+    HostPool *  hpool = nd.get_hpool();
+    Host *      host;
+
+    int         num;
+
+    if ( image_cache.empty() || !vm->hasHistory() )
+    {
+        return;
+    }
+
+    host = hpool->get(vm->get_hid(), true);
+
+    if ( host == 0 )
+    {
+        return;
+    }
+
+    if ( success )
+    {
+        num = host->get_image_cache().ready(vm->get_oid());
+    }
+    else
+    {
+        num = host->get_image_cache().drop(vm->get_oid());
+    }
+
+    if ( num > 0 )
+    {
+        hpool->update(host);
+    }
+
+    host->unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void TransferManagerDriver::recover()
 {
     NebulaLog::log("TM",Log::INFO,"Recovering TM drivers");
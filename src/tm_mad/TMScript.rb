@@ -17,6 +17,7 @@
 
 require 'pp'
 require 'open3'
+require 'thread'
 require 'CommandManager'
 
 =begin rdoc
@@ -109,14 +110,31 @@ class TMPlugin < Hash
 end
 
 # This class will parse and execute TransferManager scripts.
+#
+# Commands are executed in order, except those between "# PARALLEL" and
+# "# END" lines that are independent and executed at the same time. The
+# number of commands executed at the same time for a host, the one in the
+# last host:path argument, is limited by TMScript.host_limit.
 class TMScript
     attr_accessor :lines
-    
+
+    # Max. number of commands executed at the same time for each host by all
+    # the scripts, 0 for no limit
+    @@host_limit   = 0
+    @@host_running = Hash.new(0)
+    @@host_mutex   = Mutex.new
+    @@host_cond    = ConditionVariable.new
+
+    def self.host_limit=(limit)
+        @@host_limit = limit.to_i
+    end
+
     # +script_text+ contains the script to be executed.
     # +logger+ is a lambda that receives a message and sends it
     # to OpenNebula server
     def initialize(script_text, logger=nil)
         @lines  = Array.new
+        @steps  = Array.new
         @logger = logger
 
         parse_script(script_text)
@@ -126,35 +144,103 @@ class TMScript
     # Returns an array where first element tells if succeded and the
     # second one is the error message in case of failure.
     def execute(plugin)
-        return [true,""] if @lines.empty?
-        
-        result = @lines.each {|line|
-            res = plugin.execute(@logger, *line)
+        @steps.each {|step|
+            if step.length == 1
+                res = execute_command(plugin, step[0])
+            else
+                threads = step.collect {|line|
+                    Thread.new { execute_command(plugin, line) }
+                }
 
-            if !res
-                @logger.call("COMMAND not found: #{line.join(" ")}.") if @logger
+                results = threads.collect {|thread| thread.value }
 
-                res = [false, "COMMAND not found: #{line.join(" ")}."]
-            else
-                if res.code == 0
-                    res = [true, ""]
-                else
-                    res = [false, res.get_error_message]
-                end
+                res = results.find {|r| !r[0] } || [true, ""]
             end
 
             # do not continue if command failed
-            break res if !res[0]
+            return res if !res[0]
         }
-        
-        result
+
+        [true, ""]
     end
     
     private
+
+    # Executes a command of the script, waiting for a free slot in its host
+    def execute_command(plugin, line)
+        host = command_host(line)
+
+        acquire_host(host)
+
+        begin
+            res = plugin.execute(@logger, *line)
+        ensure
+            release_host(host)
+        end
+
+        if !res
+            @logger.call("COMMAND not found: #{line.join(" ")}.") if @logger
+
+            res = [false, "COMMAND not found: #{line.join(" ")}."]
+        else
+            if res.code == 0
+                res = [true, ""]
+            else
+                res = [false, res.get_error_message]
+            end
+        end
+
+        res
+    end
+
+    # Gets the host of the last host:path argument of a command
+    def command_host(line)
+        line[1..-1].reverse.each {|arg|
+            m = arg.match(/^([^:\/]+):/)
+            return m[1] if m
+        }
+
+        nil
+    end
+
+    def acquire_host(host)
+        return if @@host_limit <= 0 || !host
+
+        @@host_mutex.synchronize {
+            while @@host_running[host] >= @@host_limit
+                @@host_cond.wait(@@host_mutex)
+            end
+
+            @@host_running[host] += 1
+        }
+    end
+
+    def release_host(host)
+        return if @@host_limit <= 0 || !host
+
+        @@host_mutex.synchronize {
+            @@host_running[host] -= 1
+            @@host_running.delete(host) if @@host_running[host] <= 0
+
+            @@host_cond.broadcast
+        }
+    end
     
-    # Gets commands from the script and populates +@lines+
+    # Gets commands from the script and populates +@lines+, and +@steps+
+    # with the groups of commands executed at the same time
     def parse_script(script_text)
+        parallel = false
+
         script_text.each_line {|line|
+            if line.match(/^\s*#\s*PARALLEL\s*$/i)
+                parallel = true
+                @steps << Array.new
+                next
+            elsif line.match(/^\s*#\s*END\s*$/i)
+                parallel = false
+                next
+            end
+
             # skip if the line is commented
             next if line.match(/^\s*#/)
             # skip if the line is empty
@@ -163,7 +249,16 @@ class TMScript
             command=line.split(" ")
             command[0].upcase!
             @lines<< command
+
+            if parallel
+                @steps.last << command
+            else
+                @steps << [command]
+            end
         }
+
+        # Empty PARALLEL blocks
+        @steps.delete_if {|step| step.empty? }
     end
 end
 
@@ -29,6 +29,7 @@ end
 $: << RUBY_LIB_LOCATION
 
 require 'pp'
+require 'getoptlong'
 require 'OpenNebulaDriver'
 require 'CommandManager'
 require 'TMScript'
@@ -49,30 +50,59 @@ class TransferManager < OpenNebulaDriver
         register_action(:TRANSFER, method("action_transfer"))
     end
 
-    def action_transfer(number, script_file)
+    # The script is read from script_file unless it is sent inline, base64
+    # encoded, after the file name
+    def action_transfer(number, script_file, *script64)
         script_text=""
 
-        if File.exist?(script_file)
+        script64.flatten!
+
+        if script64.length > 0
+            script_text=script64[0].unpack('m')[0]
+        elsif File.exist?(script_file)
             open(script_file) {|f|
                 script_text=f.read
             }
-
-            script=TMScript.new(script_text, log_method(number))
-            res=script.execute(@plugin)
-
-            if res[0]
-                send_message("TRANSFER", RESULT[:success], number)
-            else
-                send_message("TRANSFER", RESULT[:failure], number, res[1])
-            end
         else
             send_message("TRANSFER", RESULT[:failure], number,
                 "Transfer file not found: #{script_file}")
+            return
+        end
+
+        script=TMScript.new(script_text, log_method(number))
+        res=script.execute(@plugin)
+
+        if res[0]
+            send_message("TRANSFER", RESULT[:success], number)
+        else
+            send_message("TRANSFER", RESULT[:failure], number, res[1])
         end
     end
 
 end
 
+# TM Driver Main program, one_tm <config file> [-t threads] [-p per_host]
+opts = GetoptLong.new(
+    [ '--threads',    '-t', GetoptLong::REQUIRED_ARGUMENT ],
+    [ '--per-host',   '-p', GetoptLong::REQUIRED_ARGUMENT ]
+)
+
+threads  = 15
+per_host = 0
+
+begin
+    opts.each do |opt, arg|
+        case opt
+            when '--threads'
+                threads  = arg.to_i
+            when '--per-host'
+                per_host = arg.to_i
+        end
+    end
+rescue Exception => e
+    exit(-1)
+end
+
 tm_conf=ARGV[0]
 
 if !tm_conf
@@ -84,8 +114,10 @@ tm_conf=ETC_LOCATION+tm_conf if tm_conf[0] != ?/
 
 plugin=TMPlugin.new(tm_conf)
 
+TMScript.host_limit = per_host
+
 tm=TransferManager.new(plugin,
-    :concurrency => 15)
+    :concurrency => threads)
 
 tm.start_driver
 
@@ -51,9 +51,16 @@ http://*)
     ;;
 
 *)
-    log "Cloning $SRC"
-    exec_and_log "$SCP $SRC $DST" \
-        "Error copying $SRC to $DST"
+    if [ "$SRC_HOST" = "$DST_HOST" ]; then
+        # Image cache copy, a copy-on-write clone if the FS supports it
+        log "Cloning $SRC_PATH locally"
+        exec_and_log "$SSH $DST_HOST cp --reflink=auto $SRC_PATH $DST_PATH" \
+            "Error copying $SRC to $DST"
+    else
+        log "Cloning $SRC"
+        exec_and_log "$SCP $SRC $DST" \
+            "Error copying $SRC to $DST"
+    fi
     ;;
 esac
 
@@ -105,6 +105,8 @@ int User::insert_replace(SqlDB *db, bool replace)
 
     rc = db->exec(oss);
 
+    update_xml_cache(&xml_body);
+
     db->free_str(sql_username);
     db->free_str(sql_xml);
 
@@ -122,26 +124,24 @@ error_username:
 
 string& User::to_xml(string& xml) const
 {
-    ostringstream   oss;
-    string          template_xml;
+    XMLWriter writer(1024);
 
     int  enabled_int = enabled?1:0;
 
-    oss <<
-    "<USER>"
-         "<ID>"          << oid         <<"</ID>"         <<
-         "<GID>"         << gid         <<"</GID>"        <<
-         "<GNAME>"       << gname       <<"</GNAME>"      <<
-         "<NAME>"        << name        <<"</NAME>"       <<
-         "<PASSWORD>"    << password    <<"</PASSWORD>"   <<
-         "<AUTH_DRIVER>" << auth_driver <<"</AUTH_DRIVER>"<<
-         "<ENABLED>"     << enabled_int <<"</ENABLED>"    <<
-        obj_template->to_xml(template_xml)                <<
-    "</USER>";
-
-    xml = oss.str();
-
-    return xml;
+    writer.open("USER")
+        .add("ID",          oid)
+        .add("GID",         gid)
+        .add("GNAME",       gname)
+        .add("NAME",        name)
+        .add("PASSWORD",    password)
+        .add("AUTH_DRIVER", auth_driver)
+        .add("ENABLED",     enabled_int);
+
+    obj_template->to_xml(writer);
+
+    writer.close("USER");
+
+    return writer.swap(xml);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -151,32 +151,37 @@ int User::from_xml(const string& xml)
 {
     int rc = 0;
     int int_enabled;
-    vector<xmlNodePtr> content;
 
-    // Initialize the internal XML object
-    update_from_str(xml);
+    XMLReader  reader;
+    xmlNodePtr node;
 
-    rc += xpath(oid,        "/USER/ID",          -1);
-    rc += xpath(gid,        "/USER/GID",         -1);
-    rc += xpath(gname,      "/USER/GNAME",       "not_found");
-    rc += xpath(name,       "/USER/NAME",        "not_found");
-    rc += xpath(password,   "/USER/PASSWORD",    "not_found");
-    rc += xpath(auth_driver,"/USER/AUTH_DRIVER", UserPool::CORE_AUTH);
-    rc += xpath(int_enabled,"/USER/ENABLED",     0);
+    const char * nodes[] = {"/USER/TEMPLATE", 0};
+
+    // Read the document in a single pass, only the template is kept as DOM
+    if ( reader.parse(xml, nodes) != 0 )
+    {
+        return -1;
+    }
+
+    rc += reader.get(oid,        "/USER/ID",          -1);
+    rc += reader.get(gid,        "/USER/GID",         -1);
+    rc += reader.get(gname,      "/USER/GNAME",       "not_found");
+    rc += reader.get(name,       "/USER/NAME",        "not_found");
+    rc += reader.get(password,   "/USER/PASSWORD",    "not_found");
+    rc += reader.get(auth_driver,"/USER/AUTH_DRIVER", UserPool::CORE_AUTH);
+    rc += reader.get(int_enabled,"/USER/ENABLED",     0);
 
     enabled = int_enabled;
 
     // Get associated metadata for the user
-    ObjectXML::get_nodes("/USER/TEMPLATE", content);
+    node = reader.get_node("/USER/TEMPLATE");
 
-    if (content.empty())
+    if (node == 0)
     {
         return -1;
     }
 
-    rc += obj_template->from_xml_node(content[0]);
-
-    ObjectXML::free_nodes(content);
+    rc += obj_template->from_xml_node(node);
 
     if (rc != 0)
     {
@@ -45,12 +45,14 @@ const char * UserPool::SERVER_NAME  = "serveradmin";
 
 time_t UserPool::_session_expiration_time;
 
+const unsigned int UserPool::MAX_SESSIONS = 4096;
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
 UserPool::UserPool(SqlDB * db,
                    time_t  __session_expiration_time):
-                       PoolSQL(db,User::table)
+                       PoolSQL(db,User::table), session_generation(0)
 {
     int           one_uid    = -1;
     int           server_uid = -1;
@@ -74,6 +76,8 @@ UserPool::UserPool(SqlDB * db,
 
     _session_expiration_time = __session_expiration_time;
 
+    pthread_mutex_init(&session_mutex, 0);
+
     if (get(0,false) != 0)
     {
         return;
@@ -330,7 +334,8 @@ bool UserPool::authenticate_internal(User *        user,
                                      int&          user_id,
                                      int&          group_id,
                                      string&       uname,
-                                     string&       gname)
+                                     string&       gname,
+                                     time_t&       valid_until)
 {
     bool result = false;
 
@@ -354,7 +359,8 @@ bool UserPool::authenticate_internal(User *        user,
 
     auth_driver = user->auth_driver;
 
-    result = user->valid_session(token);
+    result      = user->valid_session(token);
+    valid_until = user->session_expiration_time;
 
     user->unlock();
 
@@ -401,6 +407,8 @@ bool UserPool::authenticate_internal(User *        user,
     if (user != 0)
     {
         user->set_session(token, _session_expiration_time);
+        valid_until = user->session_expiration_time;
+
         user->unlock();
     }
 
@@ -430,6 +438,8 @@ auth_failure:
     uname = "";
     gname = "";
 
+    valid_until = 0;
+
     return false;
 }
 
@@ -441,7 +451,8 @@ bool UserPool::authenticate_server(User *        user,
                                    int&          user_id,
                                    int&          group_id,
                                    string&       uname,
-                                   string&       gname)
+                                   string&       gname,
+                                   time_t&       valid_until)
 {
     bool result = false;
 
@@ -487,7 +498,8 @@ bool UserPool::authenticate_server(User *        user,
     uname  = user->name;
     gname  = user->gname;
 
-    result = user->valid_session(second_token);
+    result      = user->valid_session(second_token);
+    valid_until = user->session_expiration_time;
 
     user->unlock();
 
@@ -520,6 +532,8 @@ bool UserPool::authenticate_server(User *        user,
     if (user != 0)
     {
         user->set_session(second_token, _session_expiration_time);
+        valid_until = user->session_expiration_time;
+
         user->unlock();
     }
 
@@ -556,6 +570,8 @@ auth_failure:
     uname = "";
     gname = "";
 
+    valid_until = 0;
+
     return false;
 }
 
@@ -685,6 +701,23 @@ bool UserPool::authenticate(const string& session,
     int  rc;
     bool ar;
 
+    time_t        valid_until = 0;
+    unsigned long generation;
+
+    // The cache never stores the session string, as it includes the password
+    string session_key = SSLTools::sha1_digest(session);
+
+    if ( get_session(session_key, user_id, group_id, uname, gname) )
+    {
+        return true;
+    }
+
+    pthread_mutex_lock(&session_mutex);
+
+    generation = session_generation;
+
+    pthread_mutex_unlock(&session_mutex);
+
     rc = User::split_secret(session,username,token);
 
     if ( rc != 0 )
@@ -700,11 +733,13 @@ bool UserPool::authenticate(const string& session,
 
         if ( fnmatch(UserPool::SERVER_AUTH, driver.c_str(), 0) == 0 )
         {
-            ar = authenticate_server(user,token,user_id,group_id,uname,gname);
+            ar = authenticate_server(user,token,user_id,group_id,uname,gname,
+                                     valid_until);
         }
         else
         {
-            ar = authenticate_internal(user,token,user_id,group_id,uname,gname);
+            ar = authenticate_internal(user,token,user_id,group_id,uname,gname,
+                                       valid_until);
         }
     }
     else
@@ -712,12 +747,141 @@ bool UserPool::authenticate(const string& session,
         ar = authenticate_external(username,token,user_id,group_id,uname,gname);
     }
 
+    if ( ar )
+    {
+        set_session(session_key, generation, user_id, group_id, uname, gname,
+                    valid_until);
+    }
+
    return ar;
 }
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+bool UserPool::get_session(const string& session_key,
+                           int&          uid,
+                           int&          gid,
+                           string&       uname,
+                           string&       gname)
+{
+    map<string, Session>::iterator it;
+
+    bool found = false;
+
+    pthread_mutex_lock(&session_mutex);
+
+    it = session_cache.find(session_key);
+
+    if ( it != session_cache.end() )
+    {
+        if ( time(0) < it->second.valid_until )
+        {
+            uid   = it->second.uid;
+            gid   = it->second.gid;
+            uname = it->second.uname;
+            gname = it->second.gname;
+
+            found = true;
+        }
+        else
+        {
+            session_cache.erase(it);
+        }
+    }
+
+    pthread_mutex_unlock(&session_mutex);
+
+    return found;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void UserPool::set_session(const string& session_key,
+                           unsigned long generation,
+                           int           uid,
+                           int           gid,
+                           const string& uname,
+                           const string& gname,
+                           time_t        valid_until)
+{
+    map<string, Session>::iterator it;
+
+    time_t the_time = time(0);
+
+    if ( valid_until <= the_time )
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&session_mutex);
+
+    // The user was updated while authenticating, the session may be stale
+    if ( generation != session_generation )
+    {
+        pthread_mutex_unlock(&session_mutex);
+        return;
+    }
+
+    if ( session_cache.size() >= MAX_SESSIONS )
+    {
+        for ( it = session_cache.begin(); it != session_cache.end(); )
+        {
+            if ( it->second.valid_until <= the_time )
+            {
+                session_cache.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if ( session_cache.size() >= MAX_SESSIONS )
+        {
+            session_cache.clear();
+        }
+    }
+
+    Session& cached = session_cache[session_key];
+
+    cached.uid         = uid;
+    cached.gid         = gid;
+    cached.uname       = uname;
+    cached.gname       = gname;
+    cached.valid_until = valid_until;
+
+    pthread_mutex_unlock(&session_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void UserPool::invalidate_sessions(int uid)
+{
+    map<string, Session>::iterator it;
+
+    pthread_mutex_lock(&session_mutex);
+
+    session_generation++;
+
+    for ( it = session_cache.begin(); it != session_cache.end(); )
+    {
+        if ( it->second.uid == uid )
+        {
+            session_cache.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    pthread_mutex_unlock(&session_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 int UserPool::authorize(AuthRequest& ar)
 {
     Nebula&       nd    = Nebula::instance();
@@ -71,6 +71,7 @@ class UserPoolTest : public PoolTest
     CPPUNIT_TEST (split_secret);
     CPPUNIT_TEST (initial_user);
     CPPUNIT_TEST (authenticate);
+    CPPUNIT_TEST (session_cache);
     CPPUNIT_TEST (get_using_name);
     CPPUNIT_TEST (wrong_get_name);
     CPPUNIT_TEST (update);
@@ -220,6 +221,46 @@ public:
         CPPUNIT_ASSERT( gid == -1 );
     }
 
+    void session_cache()
+    {
+        UserPool* user_pool = (UserPool*) pool;
+        User*     user;
+
+        bool   rc;
+        int    oid, gid;
+        string uname, gname, error_str;
+
+        string session="one_user_test:password";
+
+        // Authenticate twice, the second one is served from the cache
+        rc = user_pool->authenticate( session, oid, gid, uname, gname);
+        CPPUNIT_ASSERT( rc == true );
+
+        rc = user_pool->authenticate( session, oid, gid, uname, gname);
+        CPPUNIT_ASSERT( rc == true );
+        CPPUNIT_ASSERT( oid == 0 );
+        CPPUNIT_ASSERT( gid == 0 );
+        CPPUNIT_ASSERT( uname == "one_user_test" );
+        CPPUNIT_ASSERT( gname == "oneadmin" );
+
+        // Changing the password invalidates the cached session
+        user = user_pool->get(0, true);
+        CPPUNIT_ASSERT( user != 0 );
+
+        user->set_password(SSLTools::sha1_digest("new_password"), error_str);
+        user_pool->update(user);
+
+        user->unlock();
+
+        rc = user_pool->authenticate( session, oid, gid, uname, gname);
+        CPPUNIT_ASSERT( rc == false );
+
+        session = "one_user_test:new_password";
+        rc = user_pool->authenticate( session, oid, gid, uname, gname);
+        CPPUNIT_ASSERT( rc == true );
+        CPPUNIT_ASSERT( oid == 0 );
+    }
+
     void get_using_name()
     {
         int oid_0;
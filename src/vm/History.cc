@@ -256,55 +256,59 @@ ostream& operator<<(ostream& os, const History& history)
 
 string& History::to_xml(string& xml) const
 {
-    ostringstream oss;
-
-    oss <<
-        "<HISTORY>" <<
-          "<SEQ>"     << seq           << "</SEQ>"   <<
-          "<HOSTNAME>"<< hostname      << "</HOSTNAME>"<<
-          "<VM_DIR>"  << vm_dir        << "</VM_DIR>"<<
-          "<HID>"     << hid           << "</HID>"   <<
-          "<STIME>"   << stime         << "</STIME>" <<
-          "<ETIME>"   << etime         << "</ETIME>" <<
-          "<VMMMAD>"  << vmm_mad_name  << "</VMMMAD>"<<
-          "<TMMAD>"   << tm_mad_name   << "</TMMAD>" <<
-          "<PSTIME>"  << prolog_stime  << "</PSTIME>"<<
-          "<PETIME>"  << prolog_etime  << "</PETIME>"<<
-          "<RSTIME>"  << running_stime << "</RSTIME>"<<
-          "<RETIME>"  << running_etime << "</RETIME>"<<
-          "<ESTIME>"  << epilog_stime  << "</ESTIME>"<<
-          "<EETIME>"  << epilog_etime  << "</EETIME>"<<
-          "<REASON>"  << reason        << "</REASON>"<<
-        "</HISTORY>";
-
-   xml = oss.str();
-
-   return xml;
+    XMLWriter writer(512);
+
+    to_xml(writer);
+
+    return writer.swap(xml);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void History::to_xml(XMLWriter& xml) const
+{
+    xml.open("HISTORY")
+        .add("SEQ",      seq)
+        .add("HOSTNAME", hostname)
+        .add("VM_DIR",   vm_dir)
+        .add("HID",      hid)
+        .add("STIME",    stime)
+        .add("ETIME",    etime)
+        .add("VMMMAD",   vmm_mad_name)
+        .add("TMMAD",    tm_mad_name)
+        .add("PSTIME",   prolog_stime)
+        .add("PETIME",   prolog_etime)
+        .add("RSTIME",   running_stime)
+        .add("RETIME",   running_etime)
+        .add("ESTIME",   epilog_stime)
+        .add("EETIME",   epilog_etime)
+        .add("REASON",   static_cast<int>(reason))
+    .close("HISTORY");
 }
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int History::rebuild_attributes()
+int History::from_xml(const XMLReader& reader, const string& root)
 {
     int int_reason;
     int rc = 0;
 
-    rc += xpath(seq          , "/HISTORY/SEQ",      -1);
-    rc += xpath(hostname     , "/HISTORY/HOSTNAME", "not_found");
-    rc += xpath(vm_dir       , "/HISTORY/VM_DIR",   "not_found");
-    rc += xpath(hid          , "/HISTORY/HID",      -1);
-    rc += xpath(stime        , "/HISTORY/STIME",    0);
-    rc += xpath(etime        , "/HISTORY/ETIME",    0);
-    rc += xpath(vmm_mad_name , "/HISTORY/VMMMAD",   "not_found");
-    rc += xpath(tm_mad_name  , "/HISTORY/TMMAD",    "not_found");
-    rc += xpath(prolog_stime , "/HISTORY/PSTIME",   0);
-    rc += xpath(prolog_etime , "/HISTORY/PETIME",   0);
-    rc += xpath(running_stime, "/HISTORY/RSTIME",   0);
-    rc += xpath(running_etime, "/HISTORY/RETIME",   0);
-    rc += xpath(epilog_stime , "/HISTORY/ESTIME",   0);
-    rc += xpath(epilog_etime , "/HISTORY/EETIME",   0);
-    rc += xpath(int_reason   , "/HISTORY/REASON",   0);
+    rc += reader.get(seq          , root + "/SEQ",      -1);
+    rc += reader.get(hostname     , root + "/HOSTNAME", "not_found");
+    rc += reader.get(vm_dir       , root + "/VM_DIR",   "not_found");
+    rc += reader.get(hid          , root + "/HID",      -1);
+    rc += reader.get(stime        , root + "/STIME",    0);
+    rc += reader.get(etime        , root + "/ETIME",    0);
+    rc += reader.get(vmm_mad_name , root + "/VMMMAD",   "not_found");
+    rc += reader.get(tm_mad_name  , root + "/TMMAD",    "not_found");
+    rc += reader.get(prolog_stime , root + "/PSTIME",   0);
+    rc += reader.get(prolog_etime , root + "/PETIME",   0);
+    rc += reader.get(running_stime, root + "/RSTIME",   0);
+    rc += reader.get(running_etime, root + "/RETIME",   0);
+    rc += reader.get(epilog_stime , root + "/ESTIME",   0);
+    rc += reader.get(epilog_etime , root + "/EETIME",   0);
+    rc += reader.get(int_reason   , root + "/REASON",   0);
 
     reason = static_cast<MigrationReason>(int_reason);
 
@@ -56,7 +56,8 @@ VirtualMachine::VirtualMachine(int           id,
         net_rx(0),
         history(0),
         previous_history(0),
-        _log(0)
+        _log(0),
+        leases_held(false)
 {
     if (_vm_template != 0)
     {
@@ -70,9 +71,14 @@ VirtualMachine::VirtualMachine(int           id,
 
 VirtualMachine::~VirtualMachine()
 {
-    for (unsigned int i=0 ; i < history_records.size() ; i++)
+    if ( history != 0 )
     {
-            delete history_records[i];
+        delete history;
+    }
+
+    if ( previous_history != 0 )
+    {
+        delete previous_history;
     }
 
     if ( _log != 0 )
@@ -108,7 +114,6 @@ int VirtualMachine::select(SqlDB * db)
     ostringstream   ose;
 
     int             rc;
-    int             last_seq;
 
     Nebula&         nd = Nebula::instance();
 
@@ -120,29 +125,17 @@ int VirtualMachine::select(SqlDB * db)
         return rc;
     }
 
-    //Get History Records. Current history is built in from_xml() (if any).
-    if( hasHistory() )
+    //Get the previous History Record. Current history is built in from_xml()
+    //(if any), older records are not needed by the drivers.
+    if( hasHistory() && history->seq > 0 )
     {
-        last_seq = history->seq - 1;
-
-        for (int i = last_seq; i >= 0; i--)
-        {
-            History * hp;
-
-            hp = new History(oid, i);
-            rc = hp->select(db);
+        previous_history = new History(oid, history->seq - 1);
 
-            if ( rc != 0)
-            {
-                goto error_previous_history;
-            }
-
-            history_records[i] = hp;
+        rc = previous_history->select(db);
 
-            if ( i == last_seq )
-            {
-                previous_history = hp;
-            }
+        if ( rc != 0)
+        {
+            goto error_previous_history;
         }
     }
 
@@ -156,7 +149,7 @@ int VirtualMachine::select(SqlDB * db)
     //Create Log support for this VM
     try
     {
-        _log = new FileLog(nd.get_vm_log_filename(oid),Log::DEBUG);
+        _log = NebulaLog::new_file_log(nd.get_vm_log_filename(oid),Log::DEBUG);
     }
     catch(exception &e)
     {
@@ -237,11 +230,14 @@ int VirtualMachine::insert(SqlDB * db, string& error_str)
     // Get network leases
     // ------------------------------------------------------------------------
 
-    rc = get_network_leases(error_str);
-
-    if ( rc != 0 )
+    if ( !leases_held )
     {
-        goto error_leases_rollback;
+        rc = get_network_leases(error_str);
+
+        if ( rc != 0 )
+        {
+            goto error_leases_rollback;
+        }
     }
 
     // ------------------------------------------------------------------------
@@ -304,7 +300,10 @@ error_rollback:
     release_disk_images();
 
 error_leases_rollback:
-    release_network_leases();
+    if ( !leases_held )
+    {
+        release_network_leases();
+    }
     goto error_common;
 
 error_restricted:
@@ -562,6 +561,8 @@ int VirtualMachine::insert_replace(SqlDB *db, bool replace)
 
     rc = db->exec(oss);
 
+    update_xml_cache(0);
+
     return rc;
 
 
@@ -594,12 +595,16 @@ void VirtualMachine::add_history(
     {
         seq = history->seq + 1;
 
+        // Older records are already in the DB, and never updated
+        if ( previous_history != 0 )
+        {
+            delete previous_history;
+        }
+
         previous_history = history;
     }
 
     history = new History(oid,seq,hid,hostname,vm_dir,vmm_mad,tm_mad);
-
-    history_records.push_back(history);
 };
 
 /* -------------------------------------------------------------------------- */
@@ -622,11 +627,13 @@ void VirtualMachine::cp_history()
                        history->vmm_mad_name,
                        history->tm_mad_name);
 
+    if ( previous_history != 0 )
+    {
+        delete previous_history;
+    }
 
     previous_history = history;
     history          = htmp;
-
-    history_records.push_back(history);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -649,10 +656,10 @@ void VirtualMachine::cp_previous_history()
                        previous_history->vmm_mad_name,
                        previous_history->tm_mad_name);
 
+    delete previous_history;
+
     previous_history = history;
     history          = htmp;
-
-    history_records.push_back(history);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1240,55 +1247,45 @@ string& VirtualMachine::to_xml_extended(string& xml) const
 
 string& VirtualMachine::to_xml_extended(string& xml, bool extended) const
 {
-
-    string template_xml;
-    string history_xml;
-
-    ostringstream	oss;
-
-    oss << "<VM>"
-        << "<ID>"        << oid       << "</ID>"
-        << "<UID>"       << uid       << "</UID>"
-        << "<GID>"       << gid       << "</GID>"
-        << "<UNAME>"     << uname     << "</UNAME>" 
-        << "<GNAME>"     << gname     << "</GNAME>" 
-        << "<NAME>"      << name      << "</NAME>"
-        << "<LAST_POLL>" << last_poll << "</LAST_POLL>"
-        << "<STATE>"     << state     << "</STATE>"
-        << "<LCM_STATE>" << lcm_state << "</LCM_STATE>"
-        << "<STIME>"     << stime     << "</STIME>"
-        << "<ETIME>"     << etime     << "</ETIME>"
-        << "<DEPLOY_ID>" << deploy_id << "</DEPLOY_ID>"
-        << "<MEMORY>"    << memory    << "</MEMORY>"
-        << "<CPU>"       << cpu       << "</CPU>"
-        << "<NET_TX>"    << net_tx    << "</NET_TX>"
-        << "<NET_RX>"    << net_rx    << "</NET_RX>"
-        << obj_template->to_xml(template_xml);
+    XMLWriter writer(4096);
+
+    writer.open("VM")
+        .add("ID",        oid)
+        .add("UID",       uid)
+        .add("GID",       gid)
+        .add("UNAME",     uname)
+        .add("GNAME",     gname)
+        .add("NAME",      name)
+        .add("LAST_POLL", last_poll)
+        .add("STATE",     static_cast<int>(state))
+        .add("LCM_STATE", static_cast<int>(lcm_state))
+        .add("STIME",     stime)
+        .add("ETIME",     etime)
+        .add("DEPLOY_ID", deploy_id)
+        .add("MEMORY",    memory)
+        .add("CPU",       cpu)
+        .add("NET_TX",    net_tx)
+        .add("NET_RX",    net_rx);
+
+    obj_template->to_xml(writer);
 
     if ( hasHistory() )
     {
-        oss << "<HISTORY_RECORDS>";
+        writer.open("HISTORY_RECORDS");
 
-        if ( extended )
+        if ( extended && hasPreviousHistory() )
         {
-            for (unsigned int i=0; i < history_records.size(); i++)
-            {
-                oss << history_records[i]->to_xml(history_xml);
-            }
-        }
-        else
-        {
-            oss << history->to_xml(history_xml);
+            previous_history->to_xml(writer);
         }
 
-        oss << "</HISTORY_RECORDS>";
-    }
+        history->to_xml(writer);
 
-    oss << "</VM>";
+        writer.close("HISTORY_RECORDS");
+    }
 
-    xml = oss.str();
+    writer.close("VM");
 
-    return xml;
+    return writer.swap(xml);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1296,67 +1293,64 @@ string& VirtualMachine::to_xml_extended(string& xml, bool extended) const
 
 int VirtualMachine::from_xml(const string &xml_str)
 {
-    vector<xmlNodePtr> content;
+    XMLReader  reader;
+    xmlNodePtr node;
+
+    const char * nodes[] = {"/VM/TEMPLATE", 0};
 
     int istate;
     int ilcmstate;
+    int history_seq;
     int rc = 0;
 
-    // Initialize the internal XML object
-    update_from_str(xml_str);
+    // Read the document in a single pass, only the template is kept as DOM
+    if ( reader.parse(xml_str, nodes) != 0 )
+    {
+        return -1;
+    }
 
     // Get class base attributes
-    rc += xpath(oid,       "/VM/ID",    -1);
+    rc += reader.get(oid,       "/VM/ID",    -1);
 
-    rc += xpath(uid,       "/VM/UID",   -1);
-    rc += xpath(gid,       "/VM/GID",   -1);
+    rc += reader.get(uid,       "/VM/UID",   -1);
+    rc += reader.get(gid,       "/VM/GID",   -1);
 
-    rc += xpath(uname,     "/VM/UNAME", "not_found");
-    rc += xpath(gname,     "/VM/GNAME", "not_found");
-    rc += xpath(name,      "/VM/NAME",  "not_found");
+    rc += reader.get(uname,     "/VM/UNAME", "not_found");
+    rc += reader.get(gname,     "/VM/GNAME", "not_found");
+    rc += reader.get(name,      "/VM/NAME",  "not_found");
 
-    rc += xpath(last_poll, "/VM/LAST_POLL", 0);
-    rc += xpath(istate,    "/VM/STATE",     0);
-    rc += xpath(ilcmstate, "/VM/LCM_STATE", 0);
+    rc += reader.get(last_poll, "/VM/LAST_POLL", 0);
+    rc += reader.get(istate,    "/VM/STATE",     0);
+    rc += reader.get(ilcmstate, "/VM/LCM_STATE", 0);
 
-    rc += xpath(stime,     "/VM/STIME",    0);
-    rc += xpath(etime,     "/VM/ETIME",    0);
-    rc += xpath(deploy_id, "/VM/DEPLOY_ID","");
+    rc += reader.get(stime,     "/VM/STIME",    0);
+    rc += reader.get(etime,     "/VM/ETIME",    0);
+    rc += reader.get(deploy_id, "/VM/DEPLOY_ID","");
 
-    rc += xpath(memory,    "/VM/MEMORY",   0);
-    rc += xpath(cpu,       "/VM/CPU",      0);
-    rc += xpath(net_tx,    "/VM/NET_TX",   0);
-    rc += xpath(net_rx,    "/VM/NET_RX",   0);
+    rc += reader.get(memory,    "/VM/MEMORY",   0);
+    rc += reader.get(cpu,       "/VM/CPU",      0);
+    rc += reader.get(net_tx,    "/VM/NET_TX",   0);
+    rc += reader.get(net_rx,    "/VM/NET_RX",   0);
 
     state     = static_cast<VmState>(istate);
     lcm_state = static_cast<LcmState>(ilcmstate);
 
     // Get associated classes
-    ObjectXML::get_nodes("/VM/TEMPLATE", content);
+    node = reader.get_node("/VM/TEMPLATE");
 
-    if (content.empty())
+    if (node == 0)
     {
         return -1;
     }
 
     // Virtual Machine template
-    rc += obj_template->from_xml_node(content[0]);
+    rc += obj_template->from_xml_node(node);
 
     // Last history entry
-    ObjectXML::free_nodes(content);
-    content.clear();
-
-    ObjectXML::get_nodes("/VM/HISTORY_RECORDS/HISTORY", content);
-
-    if (!content.empty())
+    if (reader.get(history_seq, "/VM/HISTORY_RECORDS/HISTORY/SEQ", -1) == 0)
     {
         history = new History(oid);
-        rc += history->from_xml_node(content[0]);
-
-        history_records.resize(history->seq + 1);
-        history_records[history->seq] = history;
-
-        ObjectXML::free_nodes(content);
+        rc += history->from_xml(reader, "/VM/HISTORY_RECORDS/HISTORY");
     }
 
     if (rc != 0)
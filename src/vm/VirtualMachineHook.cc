@@ -47,7 +47,7 @@ static void parse_vm_arguments(VirtualMachine *vm, string& parsed)
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 
-void VirtualMachineAllocateHook::do_hook(void *arg)
+void VirtualMachineAllocateHook::do_hook(const HookEvent& event, void *arg)
 {
     VirtualMachine * vm;
     string           parsed_args = args;
@@ -132,62 +132,67 @@ void VirtualMachineStateMapHook::update_state (int id,
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 
-void VirtualMachineStateHook::do_hook(void *arg)
+bool VirtualMachineStateHook::needs_object(const HookEvent& event)
 {
-
-    VirtualMachine * vm;
-    int              rc;
+    int rc;
 
     VirtualMachine::LcmState prev_lcm, cur_lcm;
     VirtualMachine::VmState  prev_vm, cur_vm;
 
-    vm = static_cast<VirtualMachine *>(arg);
+    rc = get_state(event.oid, prev_lcm, prev_vm);
 
-    if ( vm == 0 )
+    if ( rc != 0 )
     {
-        return;
+        return false;
     }
 
-    rc = get_state(vm->get_oid(), prev_lcm, prev_vm);
+    // The VM may be in other state now, use the one recorded in the event
+    cur_lcm = static_cast<VirtualMachine::LcmState>(event.sub_state);
+    cur_vm  = static_cast<VirtualMachine::VmState>(event.state);
 
-    if ( rc != 0 )
+    if ( prev_lcm == cur_lcm && prev_vm == cur_vm ) //Still in the same state
     {
-        return;
+        return false;
     }
 
-    cur_lcm = vm->get_lcm_state();
-    cur_vm  = vm->get_state();
+    return ( cur_lcm == lcm && cur_vm == this->vm );
+}
+
+// -----------------------------------------------------------------------------
 
-    if ( prev_lcm == cur_lcm && prev_vm == cur_vm ) //Still in the same state
+void VirtualMachineStateHook::do_hook(const HookEvent& event, void *arg)
+{
+    VirtualMachine * vm;
+
+    vm = static_cast<VirtualMachine *>(arg);
+
+    if ( vm == 0 || needs_object(event) == false )
     {
         return;
     }
 
-    if ( cur_lcm == lcm && cur_vm == this->vm )
-    {
-        string  parsed_args = args;
+    string  parsed_args = args;
 
-        parse_vm_arguments(vm,parsed_args);
+    parse_vm_arguments(vm,parsed_args);
 
-        Nebula& ne        = Nebula::instance();
-        HookManager * hm  = ne.get_hm();
+    Nebula& ne        = Nebula::instance();
+    HookManager * hm  = ne.get_hm();
 
-        const HookManagerDriver * hmd = hm->get();
+    const HookManagerDriver * hmd = hm->get();
 
-        if ( hmd != 0 )
+    if ( hmd != 0 )
+    {
+        if ( ! remote )
+        {
+            hmd->execute(vm->get_oid(),name,cmd,parsed_args);
+        }
+        else if ( vm->hasHistory() )
         {
-            if ( ! remote )
-            {
-                hmd->execute(vm->get_oid(),name,cmd,parsed_args);
-            }
-            else if ( vm->hasHistory() )
-            {
-                hmd->execute(vm->get_oid(),
-                     name,
-                     vm->get_hostname(),
-                     cmd,
-                     parsed_args);
-            }
+            hmd->execute(vm->get_oid(),
+                 name,
+                 vm->get_hostname(),
+                 cmd,
+                 parsed_args);
         }
     }
 }
@@ -195,16 +200,16 @@ void VirtualMachineStateHook::do_hook(void *arg)
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 
-void VirtualMachineUpdateStateHook::do_hook(void *arg)
+void VirtualMachineUpdateStateHook::do_hook(const HookEvent& event, void *arg)
 {
-    VirtualMachine * vm = static_cast<VirtualMachine *>(arg);
-
-    if ( vm == 0 )
+    if ( event.oid == -1 )
     {
         return;
     }
 
-    update_state(vm->get_oid(), vm->get_lcm_state(), vm->get_state());
+    update_state(event.oid,
+                 static_cast<VirtualMachine::LcmState>(event.sub_state),
+                 static_cast<VirtualMachine::VmState>(event.state));
 }
 
 // -----------------------------------------------------------------------------
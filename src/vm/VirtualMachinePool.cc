@@ -26,8 +26,9 @@
 
 VirtualMachinePool::VirtualMachinePool(SqlDB *                   db,
                                        vector<const Attribute *> hook_mads,
-                                       const string& hook_location)
-    : PoolSQL(db,VirtualMachine::table)
+                                       const string& hook_location,
+                                       int           _polling_delta)
+    : PoolSQL(db,VirtualMachine::table), polling_delta(_polling_delta)
 {
     const VectorAttribute * vattr;
 
@@ -183,7 +184,8 @@ int VirtualMachinePool::allocate (
     VirtualMachineTemplate * vm_template,
     int *          oid,
     string&        error_str,
-    bool           on_hold)
+    bool           on_hold,
+    bool           leases_held)
 {
     VirtualMachine * vm;
 
@@ -201,6 +203,8 @@ int VirtualMachinePool::allocate (
         vm->state = VirtualMachine::PENDING;
     }
 
+    vm->leases_held = leases_held;
+
     // ------------------------------------------------------------------------
     // Insert the Object in the pool
     // ------------------------------------------------------------------------
@@ -235,6 +239,39 @@ int VirtualMachinePool::get_running(
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+int VirtualMachinePool::update_last_poll(
+    const vector<int>& oids,
+    time_t             last_poll)
+{
+    ostringstream              oss;
+    vector<int>::const_iterator it;
+
+    if ( oids.empty() )
+    {
+        return 0;
+    }
+
+    oss << "UPDATE " << VirtualMachine::table << " SET last_poll = "
+        << last_poll << " WHERE oid IN (";
+
+    for ( it = oids.begin(); it != oids.end(); it++ )
+    {
+        if ( it != oids.begin() )
+        {
+            oss << ",";
+        }
+
+        oss << *it;
+    }
+
+    oss << ")";
+
+    return db->exec(oss);
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 int VirtualMachinePool::get_pending(
     vector<int>&    oids)
 {
@@ -250,3 +287,72 @@ int VirtualMachinePool::get_pending(
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
+
+int VirtualMachinePool::history_cb(
+    void *  _records,
+    int     num,
+    char ** values,
+    char ** names)
+{
+    string * records;
+
+    records = static_cast<string *>(_records);
+
+    if ( num != 1 || values == 0 || values[0] == 0 )
+    {
+        return -1;
+    }
+
+    records->append(values[0]);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int VirtualMachinePool::info_xml(VirtualMachine * vm, string& xml)
+{
+    ostringstream     oss;
+    string            records;
+    string::size_type pos;
+    int               rc;
+
+    xml = vm->info_xml();
+
+    // Records older than the previous one, seq < history->seq - 1
+    if ( !vm->hasHistory() || vm->history->seq < 2 )
+    {
+        return 0;
+    }
+
+    set_callback(static_cast<Callbackable::Callback>(
+                    &VirtualMachinePool::history_cb),
+                 static_cast<void *>(&records));
+
+    oss << "SELECT body FROM " << History::table
+        << " WHERE vid = " << vm->get_oid()
+        << " AND seq < "   << vm->history->seq - 1
+        << " ORDER BY seq";
+
+    rc = db->exec(oss, this);
+
+    unset_callback();
+
+    if ( rc != 0 )
+    {
+        return rc;
+    }
+
+    // The history records are the last element of the VM
+    pos = xml.rfind("<HISTORY_RECORDS>");
+
+    if ( pos != string::npos )
+    {
+        xml.insert(pos + sizeof("<HISTORY_RECORDS>") - 1, records);
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
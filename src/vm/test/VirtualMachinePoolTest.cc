@@ -134,6 +134,8 @@ class VirtualMachinePoolTest : public PoolTest
     CPPUNIT_TEST (dump_where);
     CPPUNIT_TEST (dump_history);
     CPPUNIT_TEST (history);
+    CPPUNIT_TEST (history_info);
+    CPPUNIT_TEST (update_info);
 
     CPPUNIT_TEST_SUITE_END ();
 
@@ -456,6 +458,128 @@ public:
 
         CPPUNIT_ASSERT( vm->get_previous_reason() == History::ERROR );
     }
+
+/* -------------------------------------------------------------------------- */
+
+    void history_info()
+    {
+        VirtualMachine *           vm;
+        VirtualMachinePoolFriend * vmp =
+                                static_cast<VirtualMachinePoolFriend*>(pool);
+
+        int               rc, oid;
+        string            xml;
+        string::size_type pos;
+
+        string hostnames[] = {"A_hostname", "B_hostname", "C_hostname",
+                              "D_hostname"};
+        string vm_dir      = "vm_dir";
+        string vmm_mad     = "vm_mad";
+        string tm_mad      = "tm_mad";
+
+        // Allocate a VM with 4 history records
+        oid = allocate(0);
+        CPPUNIT_ASSERT( oid != -1 );
+
+        vm = vmp->get(oid, false);
+        CPPUNIT_ASSERT( vm != 0 );
+
+        for (int i = 0; i < 4; i++)
+        {
+            vm->add_history(i, hostnames[i], vm_dir, vmm_mad, tm_mad);
+
+            rc = vmp->update_history(vm);
+            CPPUNIT_ASSERT( rc == 0 );
+        }
+
+        rc = vmp->update(vm);
+        CPPUNIT_ASSERT( rc == 0 );
+
+        // Clean the DB cache, only the last two records are loaded
+        pool->clean();
+
+        vm = vmp->get(oid, false);
+
+        CPPUNIT_ASSERT( vm != 0 );
+        CPPUNIT_ASSERT( vm->get_hostname() == hostnames[3] );
+        CPPUNIT_ASSERT( vm->get_previous_hostname() == hostnames[2] );
+
+        xml = vm->info_xml();
+
+        CPPUNIT_ASSERT( xml.find("<SEQ>1</SEQ>") == string::npos );
+        CPPUNIT_ASSERT( xml.find("<SEQ>2</SEQ>") != string::npos );
+
+        // The info XML has every record, oldest first
+        rc = vmp->info_xml(vm, xml);
+        CPPUNIT_ASSERT( rc == 0 );
+
+        pos = 0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            ostringstream oss;
+
+            oss << "<SEQ>" << i << "</SEQ>";
+
+            pos = xml.find(oss.str(), pos);
+
+            CPPUNIT_ASSERT( pos != string::npos );
+        }
+    }
+
+/* -------------------------------------------------------------------------- */
+
+    void update_info()
+    {
+        VirtualMachinePool * vmp = static_cast<VirtualMachinePool*>(pool);
+        VirtualMachine *     vm;
+        vector<int>          oids;
+        int                  oid;
+        int                  rc;
+
+        oid = allocate(0);
+        CPPUNIT_ASSERT( oid != -1 );
+
+        vm = vmp->get(oid, true);
+        CPPUNIT_ASSERT( vm != 0 );
+
+        // Any change is an update with no delta, unknown values are skipped
+        CPPUNIT_ASSERT( vm->update_info(1000, 50, 2000, 3000) == true );
+        CPPUNIT_ASSERT( vm->update_info(1000, 50, 2000, 3000) == false );
+        CPPUNIT_ASSERT( vm->update_info(-1, -1, -1, -1) == false );
+        CPPUNIT_ASSERT( vm->update_info(1001, -1, -1, -1) == true );
+
+        // Changes within 5% are ignored, and do not accumulate
+        CPPUNIT_ASSERT( vm->update_info(1040, 52, 2100, 3100, 5) == false );
+        CPPUNIT_ASSERT( vm->update_info(1050, 52, 2100, 3100, 5) == false );
+        CPPUNIT_ASSERT( vm->update_info(1060, 52, 2100, 3100, 5) == true );
+        CPPUNIT_ASSERT( vm->update_info(1060, 52, 2100, 3100, 5) == false );
+        CPPUNIT_ASSERT( vm->update_info(1060, 40, 2100, 3100, 5) == true );
+
+        vm->set_state(VirtualMachine::ACTIVE);
+        vm->set_state(VirtualMachine::RUNNING);
+
+        vmp->update(vm);
+
+        vm->unlock();
+
+        // The last poll column is set without writing the VM
+        rc = vmp->get_running(oids, 10, 100);
+
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( oids.size() == 1 );
+
+        rc = vmp->update_last_poll(oids, 200);
+
+        CPPUNIT_ASSERT( rc == 0 );
+
+        oids.clear();
+
+        rc = vmp->get_running(oids, 10, 100);
+
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( oids.empty() );
+    }
 };
 
 
@@ -173,6 +173,8 @@ int VMTemplate::insert_replace(SqlDB *db, bool replace)
 
     rc = db->exec(oss);
 
+    update_xml_cache(&xml_body);
+
     db->free_str(sql_name);
     db->free_str(sql_xml);
 
@@ -190,24 +192,23 @@ error_name:
 
 string& VMTemplate::to_xml(string& xml) const
 {
-    ostringstream   oss;
-    string          template_xml;
-
-    oss << "<VMTEMPLATE>"
-            << "<ID>"       << oid        << "</ID>"
-            << "<UID>"      << uid        << "</UID>"
-            << "<GID>"      << gid        << "</GID>"
-            << "<UNAME>"    << uname      << "</UNAME>" 
-            << "<GNAME>"    << gname      << "</GNAME>" 
-            << "<NAME>"     << name       << "</NAME>"
-            << "<PUBLIC>"   << public_obj << "</PUBLIC>"
-            << "<REGTIME>"  << regtime    << "</REGTIME>"
-            << obj_template->to_xml(template_xml)
-        << "</VMTEMPLATE>";
-
-    xml = oss.str();
-
-    return xml;
+    XMLWriter writer(2048);
+
+    writer.open("VMTEMPLATE")
+        .add("ID",      oid)
+        .add("UID",     uid)
+        .add("GID",     gid)
+        .add("UNAME",   uname)
+        .add("GNAME",   gname)
+        .add("NAME",    name)
+        .add("PUBLIC",  public_obj)
+        .add("REGTIME", regtime);
+
+    obj_template->to_xml(writer);
+
+    writer.close("VMTEMPLATE");
+
+    return writer.swap(xml);
 }
 
 /* ------------------------------------------------------------------------ */
@@ -215,34 +216,39 @@ string& VMTemplate::to_xml(string& xml) const
 
 int VMTemplate::from_xml(const string& xml)
 {
-    vector<xmlNodePtr> content;
+    XMLReader  reader;
+    xmlNodePtr node;
+
+    const char * nodes[] = {"/VMTEMPLATE/TEMPLATE", 0};
+
     int rc = 0;
 
-    // Initialize the internal XML object
-    update_from_str(xml);
+    // Read the document in a single pass, only the template is kept as DOM
+    if ( reader.parse(xml, nodes) != 0 )
+    {
+        return -1;
+    }
 
     // Get class base attributes
-    rc += xpath(oid,        "/VMTEMPLATE/ID",      -1);
-    rc += xpath(uid,        "/VMTEMPLATE/UID",     -1);
-    rc += xpath(gid,        "/VMTEMPLATE/GID",     -1);
-    rc += xpath(uname,      "/VMTEMPLATE/UNAME",   "not_found");
-    rc += xpath(gname,      "/VMTEMPLATE/GNAME",   "not_found");
-    rc += xpath(name,       "/VMTEMPLATE/NAME",    "not_found");
-    rc += xpath(public_obj, "/VMTEMPLATE/PUBLIC",  0);
-    rc += xpath(regtime,    "/VMTEMPLATE/REGTIME", 0);
+    rc += reader.get(oid,        "/VMTEMPLATE/ID",      -1);
+    rc += reader.get(uid,        "/VMTEMPLATE/UID",     -1);
+    rc += reader.get(gid,        "/VMTEMPLATE/GID",     -1);
+    rc += reader.get(uname,      "/VMTEMPLATE/UNAME",   "not_found");
+    rc += reader.get(gname,      "/VMTEMPLATE/GNAME",   "not_found");
+    rc += reader.get(name,       "/VMTEMPLATE/NAME",    "not_found");
+    rc += reader.get(public_obj, "/VMTEMPLATE/PUBLIC",  0);
+    rc += reader.get(regtime,    "/VMTEMPLATE/REGTIME", 0);
 
     // Get associated classes
-    ObjectXML::get_nodes("/VMTEMPLATE/TEMPLATE", content);
+    node = reader.get_node("/VMTEMPLATE/TEMPLATE");
 
-    if (content.empty())
+    if (node == 0)
     {
         return -1;
     }
 
     // Template contents
-    rc += obj_template->from_xml_node(content[0]);
-
-    ObjectXML::free_nodes(content);
+    rc += obj_template->from_xml_node(node);
 
     if (rc != 0)
     {
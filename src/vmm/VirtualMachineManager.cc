@@ -816,6 +816,7 @@ void VirtualMachineManager::timer_action()
 
     VirtualMachine *        vm;
     vector<int>             oids;
+    vector<int>             polled;
     vector<int>::iterator   it;
     int                     rc;
     ostringstream           os;
@@ -824,6 +825,10 @@ void VirtualMachineManager::timer_action()
 
     const VirtualMachineManagerDriver * vmd;
 
+    // VMs to poll by host, one poll request is sent for each host
+    map<int, HostPoll>           hosts;
+    map<int, HostPoll>::iterator hit;
+
     mark = mark + timer_period;
 
     if ( mark >= 600 )
@@ -859,13 +864,12 @@ void VirtualMachineManager::timer_action()
             continue;
         }
 
-        os.str("");
-
-        os << "Monitoring VM " << *it << ".";
-        NebulaLog::log("VMM", Log::INFO, os);
+        NEBULA_LOG("VMM", Log::INFO, "Monitoring VM " << *it << ".");
 
         vm->set_last_poll(thetime);
 
+        polled.push_back(*it);
+
         vmd = get(vm->get_vmm_mad());
 
         if ( vmd == 0 )
@@ -874,12 +878,31 @@ void VirtualMachineManager::timer_action()
             continue;
         }
 
-        vmd->poll(*it,vm->get_hostname(),vm->get_deploy_id());
+        hit = hosts.find(vm->get_hid());
+
+        if ( hit == hosts.end() )
+        {
+            HostPoll hp;
+
+            hp.vmd  = vmd;
+            hp.name = vm->get_hostname();
 
-        vmpool->update(vm);
+            hit = hosts.insert(make_pair(vm->get_hid(), hp)).first;
+        }
+
+        hit->second.vms.push_back(make_pair(*it, vm->get_deploy_id()));
 
         vm->unlock();
     }
+
+    vmpool->update_last_poll(polled, thetime);
+
+    for ( hit = hosts.begin(); hit != hosts.end(); hit++ )
+    {
+        hit->second.vmd->poll_host(hit->first,
+                                   hit->second.name,
+                                   hit->second.vms);
+    }
 }
 
 /* ************************************************************************** */
@@ -223,6 +223,39 @@ void VirtualMachineManagerDriver::poll (
     write(os);
 };
 
+/* -------------------------------------------------------------------------- */
+
+void VirtualMachineManagerDriver::poll_host (
+    const int                       hid,
+    const string&                   host,
+    const vector<pair<int,string> >& vms) const
+{
+    ostringstream os;
+
+    vector<pair<int,string> >::const_iterator it;
+
+    if ( vms.empty() )
+    {
+        return;
+    }
+
+    os << "POLL_HOST " << host_action_id(hid) << " " << host << " ";
+
+    for ( it = vms.begin(); it != vms.end(); it++ )
+    {
+        if ( it != vms.begin() )
+        {
+            os << ",";
+        }
+
+        os << it->first << ":" << it->second;
+    }
+
+    os << " -" << endl;
+
+    write(os);
+};
+
 /* ************************************************************************** */
 /* MAD Interface                                                              */
 /* ************************************************************************** */
@@ -255,6 +288,273 @@ static void log_error(VirtualMachine* vm,
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void VirtualMachineManagerDriver::process_poll(
+    VirtualMachine * vm,
+    istringstream&   is)
+{
+    size_t          pos;
+
+    string          tmp;
+    string          var;
+    ostringstream   os;
+    istringstream   tiss;
+
+    int             cpu    = -1;
+    int             memory = -1;
+    int             net_tx = -1;
+    int             net_rx = -1;
+    char            state  = '-';
+
+    string monitor_str = is.str();
+    bool   parse_error = false;
+    bool   updated     = false;
+
+    while(is.good())
+    {
+        is >> tmp >> ws;
+
+        pos = tmp.find('=');
+
+        if ( pos == string::npos )
+        {
+            parse_error = true;
+            continue;
+        }
+
+        tmp.replace(pos,1," ");
+
+        tiss.clear();
+
+        tiss.str(tmp);
+
+        tiss >> var >> ws;
+
+        if (!tiss.good())
+        {
+            parse_error = true;
+            continue;
+        }
+
+        if (var == "USEDMEMORY")
+        {
+            tiss >> memory;
+        }
+        else if (var == "USEDCPU")
+        {
+            tiss >> cpu;
+        }
+        else if (var == "NETRX")
+        {
+            tiss >> net_rx;
+        }
+        else if (var == "NETTX")
+        {
+            tiss >> net_tx;
+        }
+        else if (var == "STATE")
+        {
+            tiss >> state;
+        }
+        else if (!var.empty())
+        {
+            string val;
+
+            os.str("");
+            os << "Adding custom monitoring attribute: " << tmp;
+
+            vm->log("VMM",Log::WARNING,os);
+
+            tiss >> val;
+
+            vm->replace_template_attribute(var,val);
+
+            updated = true;
+        }
+    }
+
+    if (parse_error)
+    {
+        os.str("");
+        os << "Error parsing monitoring str:\"" << monitor_str <<"\"";
+
+        vm->log("VMM",Log::ERROR,os);
+
+        vm->set_template_error_message(os.str());
+        vmpool->update(vm);
+
+        return;
+    }
+
+    // The VM is only written if the monitored values changed significantly
+    if ( vm->update_info(memory, cpu, net_tx, net_rx,
+                         vmpool->get_polling_delta()) )
+    {
+        updated = true;
+    }
+
+    if ( updated )
+    {
+        vmpool->update(vm);
+    }
+
+    // The monitoring store keeps every sample, not only the significant ones
+    MonitorStore * store = Nebula::instance().get_monitor_store();
+
+    if ( store != 0 && ( memory >= 0 || cpu >= 0 || net_tx >= 0 || net_rx >= 0))
+    {
+        int values[MonitorStore::NUM_VALUES] = {memory, cpu, net_tx, net_rx};
+
+        store->add(MonitorStore::VM, vm->get_oid(), time(0), values);
+    }
+
+    if (state != '-' &&
+        (vm->get_lcm_state() == VirtualMachine::RUNNING ||
+         vm->get_lcm_state() == VirtualMachine::UNKNOWN))
+    {
+        Nebula              &ne  = Nebula::instance();
+        LifeCycleManager *  lcm = ne.get_lcm();
+
+        switch (state)
+        {
+        case 'a': // Still active, good!
+            os.str("");
+            os  << "Monitor Information:\n"
+                << "\tCPU   : "<< cpu    << "\n"
+                << "\tMemory: "<< memory << "\n"
+                << "\tNet_TX: "<< net_tx << "\n"
+                << "\tNet_RX: "<< net_rx;
+            vm->log("VMM",Log::DEBUG,os);
+
+            if ( vm->get_lcm_state() == VirtualMachine::UNKNOWN)
+            {
+                vm->log("VMM",Log::INFO,"VM was now found, new state is"
+                        " RUNNING");
+                vm->set_state(VirtualMachine::RUNNING);
+                vmpool->update(vm);
+            }
+            break;
+
+        case 'p': // It's paused
+            vm->log("VMM",Log::INFO,"VM running but new state "
+                    "from monitor is PAUSED.");
+
+            lcm->trigger(LifeCycleManager::MONITOR_SUSPEND, vm->get_oid());
+            break;
+
+        case 'e': //Failed
+            vm->log("VMM",Log::INFO,"VM running but new state "
+                    "from monitor is ERROR.");
+
+            lcm->trigger(LifeCycleManager::MONITOR_FAILURE, vm->get_oid());
+            break;
+
+        case 'd': //The VM was not found
+            vm->log("VMM",Log::INFO,"VM running but it was not found."
+                    " Restart and delete actions available or try to"
+                    " recover it manually");
+
+            lcm->trigger(LifeCycleManager::MONITOR_DONE, vm->get_oid());
+            break;
+        }
+    }
+
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void VirtualMachineManagerDriver::process_poll(int vid, const string& monitor)
+{
+    VirtualMachine * vm;
+
+    if ( vid == -1 || monitor.empty() )
+    {
+        return;
+    }
+
+    vm = vmpool->get(vid,true);
+
+    if ( vm == 0 )
+    {
+        return;
+    }
+
+    if ( vm->get_lcm_state() != VirtualMachine::CLEANUP &&
+         vm->get_lcm_state() != VirtualMachine::FAILURE &&
+         vm->get_lcm_state() != VirtualMachine::LCM_INIT )
+    {
+        istringstream is(monitor);
+
+        process_poll(vm, is);
+    }
+
+    vm->unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void VirtualMachineManagerDriver::process_poll_host(
+    const string&  result,
+    int            hid,
+    istringstream& is)
+{
+    ostringstream os;
+    string        tmp;
+    int           vid = -1;
+
+    if ( result != "SUCCESS" )
+    {
+        string info;
+
+        getline(is,info);
+
+        os << "Error monitoring the VMs of host " << hid;
+
+        if (!info.empty() && info[0] != '-')
+        {
+            os << ": " << info;
+        }
+
+        NebulaLog::log("VMM",Log::ERROR,os);
+        return;
+    }
+
+    // The monitor information of each VM starts with VM=<vid> and it is
+    // followed by its VAR=VALUE pairs. Each VM is written on its own, under
+    // its lock: a batched write would need every VM of the host locked at
+    // once (PoolSQL::get waits for an object with the pool mutex held), or
+    // it could overwrite a newer state stored by the LCM in the meantime.
+    // Most polls do not write the VM anyway, only significant changes do.
+    while(is.good())
+    {
+        is >> tmp >> ws;
+
+        if ( tmp.compare(0,3,"VM=") == 0 )
+        {
+            process_poll(vid, os.str());
+
+            vid = atoi(tmp.c_str() + 3);
+
+            os.str("");
+        }
+        else
+        {
+            if ( os.tellp() > 0 )
+            {
+                os << " ";
+            }
+
+            os << tmp;
+        }
+    }
+
+    process_poll(vid, os.str());
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void VirtualMachineManagerDriver::protocol(
     string&     message)
 {
@@ -268,8 +568,7 @@ void VirtualMachineManagerDriver::protocol(
     VirtualMachine * vm;
 
 
-    os << "Message received: " << message;
-    NebulaLog::log("VMM", Log::DEBUG, os);
+    NEBULA_LOG("VMM", Log::DEBUG, "Message received: " << message);
 
     // Parse the driver message
     if ( is.good() )
@@ -303,6 +602,28 @@ void VirtualMachineManagerDriver::protocol(
     else
         return;
 
+    // Host actions, their ids do not refer to a VM
+    if ( id < 0 )
+    {
+        int hid = host_action_id(id);
+
+        if ( action == "POLL_HOST" )
+        {
+            process_poll_host(result, hid, is);
+        }
+        else if ( action == "LOG" )
+        {
+            string info;
+
+            getline(is,info);
+
+            NEBULA_LOG("VMM", log_type(result[0]),
+                       "Host " << hid << ": " << info);
+        }
+
+        return;
+    }
+
     // Get the VM from the pool
     vm = vmpool->get(id,true);
 
@@ -440,151 +761,7 @@ void VirtualMachineManagerDriver::protocol(
     {
         if (result == "SUCCESS")
         {
-            size_t          pos;
-
-            string          tmp;
-            string          var;
-            ostringstream   os;
-            istringstream   tiss;
-
-            int             cpu    = -1;
-            int             memory = -1;
-            int             net_tx = -1;
-            int             net_rx = -1;
-            char            state  = '-';
-
-            string monitor_str = is.str();
-            bool   parse_error = false;
-
-            while(is.good())
-            {
-                is >> tmp >> ws;
-
-                pos = tmp.find('=');
-
-                if ( pos == string::npos )
-                {
-                    parse_error = true;
-                    continue;
-                }
-
-                tmp.replace(pos,1," ");
-
-                tiss.clear();
-
-                tiss.str(tmp);
-
-                tiss >> var >> ws;
-
-                if (!tiss.good())
-                {
-                    parse_error = true;
-                    continue;
-                }
-
-                if (var == "USEDMEMORY")
-                {
-                    tiss >> memory;
-                }
-                else if (var == "USEDCPU")
-                {
-                    tiss >> cpu;
-                }
-                else if (var == "NETRX")
-                {
-                    tiss >> net_rx;
-                }
-                else if (var == "NETTX")
-                {
-                    tiss >> net_tx;
-                }
-                else if (var == "STATE")
-                {
-                    tiss >> state;
-                }
-                else if (!var.empty())
-                {
-                    string val;
-
-                    os.str("");
-                    os << "Adding custom monitoring attribute: " << tmp;
-
-                    vm->log("VMM",Log::WARNING,os);
-
-                    tiss >> val;
-
-                    vm->replace_template_attribute(var,val);
-                }
-            }
-
-            if (parse_error)
-            {
-                os.str("");
-                os << "Error parsing monitoring str:\"" << monitor_str <<"\"";
-
-                vm->log("VMM",Log::ERROR,os);
-
-                vm->set_template_error_message(os.str());
-                vmpool->update(vm);
-
-                vm->unlock();
-                return;
-            }
-
-            vm->update_info(memory,cpu,net_tx,net_rx);
-
-            vmpool->update(vm);
-
-            if (state != '-' &&
-                (vm->get_lcm_state() == VirtualMachine::RUNNING ||
-                 vm->get_lcm_state() == VirtualMachine::UNKNOWN))
-            {
-                Nebula              &ne  = Nebula::instance();
-                LifeCycleManager *  lcm = ne.get_lcm();
-
-                switch (state)
-                {
-                case 'a': // Still active, good!
-                    os.str("");
-                    os  << "Monitor Information:\n"
-                        << "\tCPU   : "<< cpu    << "\n"
-                        << "\tMemory: "<< memory << "\n"
-                        << "\tNet_TX: "<< net_tx << "\n"
-                        << "\tNet_RX: "<< net_rx;
-                    vm->log("VMM",Log::DEBUG,os);
-
-                    if ( vm->get_lcm_state() == VirtualMachine::UNKNOWN)
-                    {
-                        vm->log("VMM",Log::INFO,"VM was now found, new state is"
-                                " RUNNING");
-                        vm->set_state(VirtualMachine::RUNNING);
-                        vmpool->update(vm);
-                    }
-                    break;
-
-                case 'p': // It's paused
-                    vm->log("VMM",Log::INFO,"VM running but new state "
-                            "from monitor is PAUSED.");
-
-                    lcm->trigger(LifeCycleManager::MONITOR_SUSPEND, id);
-                    break;
-
-                case 'e': //Failed
-                    vm->log("VMM",Log::INFO,"VM running but new state "
-                            "from monitor is ERROR.");
-
-                    lcm->trigger(LifeCycleManager::MONITOR_FAILURE, id);
-                    break;
-
-                case 'd': //The VM was not found
-                    vm->log("VMM",Log::INFO,"VM running but it was not found."
-                            " Restart and delete actions available or try to"
-                            " recover it manually");
-
-                    lcm->trigger(LifeCycleManager::MONITOR_DONE, id);
-                    break;
-                }
-            }
+            process_poll(vm, is);
         }
         else
         {
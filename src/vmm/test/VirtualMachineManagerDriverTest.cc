@@ -0,0 +1,300 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <stdlib.h>
+
+#include "Nebula.h"
+#include "NebulaTest.h"
+#include "test/OneUnitTest.h"
+#include "VirtualMachineManagerDriver.h"
+
+using namespace std;
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class NebulaTestVMM: public NebulaTest
+{
+public:
+    NebulaTestVMM():NebulaTest()
+    {
+        NebulaTest::the_tester = this;
+
+        need_vm_pool = true;
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+/**
+ *  A driver that is never started, messages are passed to protocol()
+ */
+class DriverTest : public VirtualMachineManagerDriver
+{
+public:
+    DriverTest(VirtualMachinePool * vmpool):
+        VirtualMachineManagerDriver(0, map<string,string>(), false, vmpool){};
+
+    ~DriverTest(){};
+
+    int deployment_description(const VirtualMachine * vm,
+                               const string&          file_name) const
+    {
+        return 0;
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class VirtualMachineManagerDriverTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (VirtualMachineManagerDriverTest);
+
+    CPPUNIT_TEST (poll_host);
+    CPPUNIT_TEST (poll_host_attributes);
+    CPPUNIT_TEST (poll_host_failure);
+    CPPUNIT_TEST (poll_host_id);
+    CPPUNIT_TEST (last_poll);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+private:
+    NebulaTestVMM *      tester;
+
+    VirtualMachinePool * vmpool;
+
+    DriverTest *         driver;
+
+    int vm[2];  /**< Two RUNNING VMs */
+
+    /**
+     *  Allocates a VM and sets it to RUNNING
+     */
+    int allocate()
+    {
+        VirtualMachineTemplate * vm_template;
+        VirtualMachine *         vm;
+
+        char * error_msg = 0;
+        string error_str;
+        int    oid;
+
+        vm_template = new VirtualMachineTemplate;
+
+        vm_template->parse("NAME = test\nMEMORY = 128\nCPU = 1", &error_msg);
+
+        vmpool->allocate(0, 0, "oneadmin", "oneadmin", vm_template, &oid,
+                         error_str);
+
+        vm = vmpool->get(oid, true);
+
+        vm->set_state(VirtualMachine::ACTIVE);
+        vm->set_state(VirtualMachine::RUNNING);
+
+        vmpool->update(vm);
+
+        vm->unlock();
+
+        return oid;
+    };
+
+    /**
+     *  Gets a value of the XML representation of a VM
+     */
+    string value(int oid, const char * xpath)
+    {
+        VirtualMachine * vm;
+        string           xml;
+        string           val;
+
+        vm = vmpool->get(oid, true);
+
+        ObjectXML obj_xml(vm->to_xml(xml));
+
+        vm->unlock();
+
+        obj_xml.xpath(val, xpath, "");
+
+        return val;
+    };
+
+public:
+    VirtualMachineManagerDriverTest()
+    {
+        xmlInitParser();
+    };
+
+    ~VirtualMachineManagerDriverTest()
+    {
+        xmlCleanupParser();
+    };
+
+    /* ********************************************************************* */
+    /* ********************************************************************* */
+
+    void setUp()
+    {
+        create_db();
+
+        tester = new NebulaTestVMM();
+
+        Nebula& neb = Nebula::instance();
+        neb.start();
+
+        vmpool = neb.get_vmpool();
+        driver = new DriverTest(vmpool);
+
+        vm[0] = allocate();
+        vm[1] = allocate();
+    };
+
+    void tearDown()
+    {
+        delete driver;
+
+        delete_db();
+
+        delete tester;
+    };
+
+    /* ********************************************************************* */
+    /* ********************************************************************* */
+
+    void poll_host()
+    {
+        ostringstream oss;
+        string        message;
+
+        // The information of each VM ends where the next VM= starts. The
+        // unknown VM 99 is skipped
+        oss << "POLL_HOST SUCCESS -1 "
+            << "VM=" << vm[0] << " USEDMEMORY=256 USEDCPU=10 STATE=a "
+            << "VM=99 USEDMEMORY=1 "
+            << "VM=" << vm[1] << " USEDMEMORY=512 NETRX=300 STATE=a";
+
+        message = oss.str();
+
+        driver->protocol(message);
+
+        CPPUNIT_ASSERT( value(vm[0], "/VM/MEMORY") == "256" );
+        CPPUNIT_ASSERT( value(vm[0], "/VM/CPU")    == "10" );
+        CPPUNIT_ASSERT( value(vm[0], "/VM/NET_RX") == "0" );
+
+        CPPUNIT_ASSERT( value(vm[1], "/VM/MEMORY") == "512" );
+        CPPUNIT_ASSERT( value(vm[1], "/VM/CPU")    == "0" );
+        CPPUNIT_ASSERT( value(vm[1], "/VM/NET_RX") == "300" );
+
+        CPPUNIT_ASSERT( value(vm[0], "/VM/LCM_STATE") == "3" );
+        CPPUNIT_ASSERT( value(vm[1], "/VM/LCM_STATE") == "3" );
+    };
+
+    /* ********************************************************************* */
+
+    void poll_host_attributes()
+    {
+        ostringstream oss;
+        string        message;
+
+        // Custom attributes are added to their own VM, a VM with no
+        // information is not updated
+        oss << "POLL_HOST SUCCESS -1 "
+            << "VM=" << vm[1] << " "
+            << "VM=" << vm[0] << " CUSTOM=first USEDCPU=5";
+
+        message = oss.str();
+
+        driver->protocol(message);
+
+        CPPUNIT_ASSERT( value(vm[0], "/VM/TEMPLATE/CUSTOM") == "first" );
+        CPPUNIT_ASSERT( value(vm[0], "/VM/CPU") == "5" );
+
+        CPPUNIT_ASSERT( value(vm[1], "/VM/TEMPLATE/CUSTOM") == "" );
+        CPPUNIT_ASSERT( value(vm[1], "/VM/CPU") == "0" );
+    };
+
+    /* ********************************************************************* */
+
+    void poll_host_failure()
+    {
+        ostringstream oss;
+        string        message;
+
+        oss << "POLL_HOST FAILURE -1 "
+            << "VM=" << vm[0] << " USEDMEMORY=256";
+
+        message = oss.str();
+
+        driver->protocol(message);
+
+        CPPUNIT_ASSERT( value(vm[0], "/VM/MEMORY") == "0" );
+    };
+
+    /* ********************************************************************* */
+
+    void poll_host_id()
+    {
+        ostringstream oss;
+        string        message;
+
+        CPPUNIT_ASSERT( VirtualMachineManagerDriver::host_action_id(0) == -1 );
+        CPPUNIT_ASSERT( VirtualMachineManagerDriver::host_action_id(-4) == 3 );
+
+        // Host polls use negative ids, a VM id is not taken as a host
+        oss << "POLL_HOST SUCCESS " << vm[0] << " "
+            << "VM=" << vm[0] << " USEDMEMORY=256";
+
+        message = oss.str();
+
+        driver->protocol(message);
+
+        CPPUNIT_ASSERT( value(vm[0], "/VM/MEMORY") == "0" );
+    };
+
+    /* ********************************************************************* */
+
+    void last_poll()
+    {
+        VirtualMachine * vm_obj;
+
+        vm_obj = vmpool->get(vm[0], true);
+
+        CPPUNIT_ASSERT( vm_obj->info_xml().find("<LAST_POLL>0</LAST_POLL>")
+                        != string::npos );
+
+        // The cached info XML is rebuilt after setting the poll time
+        vm_obj->set_last_poll(1234);
+
+        CPPUNIT_ASSERT( vm_obj->info_xml().find("<LAST_POLL>1234</LAST_POLL>")
+                        != string::npos );
+
+        vm_obj->unlock();
+    };
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+int main(int argc, char ** argv)
+{
+    OneUnitTest::set_one_auth();
+
+    return OneUnitTest::main(argc, argv,
+                             VirtualMachineManagerDriverTest::suite());
+}
@@ -72,6 +72,17 @@ class DummyDriver < VirtualMachineDriver
         send_message(ACTION[:poll],RESULT[:success],id,monitor_info)
     end
 
+    def poll_host(id, host, vms, not_used)
+        monitor_info = vms.split(',').map do |vm|
+            "VM=#{vm.split(':').first} " \
+            "#{POLL_ATTRIBUTE[:state]}=#{VM_STATE[:active]} " \
+            "#{POLL_ATTRIBUTE[:nettx]}=12345"
+        end
+
+        send_message(ACTION[:poll_host],RESULT[:success],id,
+            monitor_info.join(' '))
+    end
+
     end
 
 dd = DummyDriver.new
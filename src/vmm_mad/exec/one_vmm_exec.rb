@@ -97,6 +97,17 @@ class ExecDriver < VirtualMachineDriver
     def poll(id, host, deploy_id, not_used)
         do_action("#{deploy_id} #{host}", id, host, :poll)
     end
+
+    # Polls all the VMs of the host with one execution of the poll script.
+    # Custom local poll scripts (e.g. ganglia) are used to poll each VM
+    def poll_host(id, host, vms, not_used)
+        if action_is_local?(:poll)
+            super(id, host, vms, not_used)
+        else
+            do_action("--vms #{vms} #{host}", id, host, :poll_host,
+                :script_name => 'poll')
+        end
+    end
 end
 
 # SshDriver Main program
@@ -332,6 +332,26 @@ def print_one_vm_info(hypervisor, vm_id)
     puts values.zip.join(' ')
 end
 
+def print_host_vms_info(hypervisor, vms)
+    all_info=hypervisor.get_all_vm_info
+
+    exit(-1) if !all_info
+
+    info=vms.split(',').map do |vm|
+        vm_id, deploy_id=vm.split(':', 2)
+
+        data=all_info[deploy_id] || {:state => 'd'}
+
+        values=data.map do |key, value|
+            print_data(key, value) if key != :name
+        end
+
+        "VM=#{vm_id} "+values.compact.join(' ')
+    end
+
+    puts info.join(' ')
+end
+
 def print_all_vm_info(hypervisor)
     require 'yaml'
     require 'base64'
@@ -352,7 +372,9 @@ load_vars(hypervisor)
 
 vm_id=ARGV[0]
 
-if vm_id
+if vm_id == '--vms'
+    print_host_vms_info(hypervisor, ARGV[1])
+elsif vm_id
     print_one_vm_info(hypervisor, vm_id)
 else
     print_all_vm_info(hypervisor)
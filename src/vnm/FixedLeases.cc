@@ -62,10 +62,6 @@ int FixedLeases::add(const string& ip, const string& mac, int vid,
     unsigned int     _ip;
     unsigned int     _mac [2];
 
-    Lease *         lease;
-    string          xml_body;
-    char *          sql_xml;
-
     int rc;
 
     if ( Leases::Lease::ip_to_number(ip,_ip) )
@@ -88,32 +84,20 @@ int FixedLeases::add(const string& ip, const string& mac, int vid,
         goto error_mac;
     }
 
-    lease = new Lease(_ip,_mac,vid,used);
-
-    sql_xml = db->escape_str(lease->to_xml_db(xml_body).c_str());
-
-    if ( sql_xml == 0 )
     {
-        goto error_body;
-    }
-
-    oss << "INSERT INTO " << table << " ("<< db_names <<") VALUES ("
-        <<          oid     << ","
-        <<          _ip     << ","
-        << "'" <<   sql_xml << "')";
+        Lease lease(_ip,_mac,vid,used);
 
-    db->free_str(sql_xml);
+        rc = insert_lease(lease);
 
-    rc = db->exec(oss);
+        if ( rc != 0 )
+        {
+            goto error_db;
+        }
 
-    if ( rc != 0 )
-    {
-        goto error_db;
+        leases.insert( make_pair(_ip,lease) );
     }
 
-    leases.insert( make_pair(_ip,lease) );
-
-    if(lease->used)
+    if(used)
     {
         n_used++;
     }
@@ -135,16 +119,9 @@ error_duplicate:
     oss << "Error inserting lease, IP " << ip << " already exists";
     goto error_common;
 
-error_body:
-    oss.str("");
-    oss << "Error inserting lease, marshall error";
-    delete lease;
-    goto error_common;
-
 error_db:
     oss.str("");
     oss << "Error inserting lease in database.";
-    delete lease;
 
 error_common:
     NebulaLog::log("VNM", Log::ERROR, oss);
@@ -157,7 +134,7 @@ error_common:
 
 int FixedLeases::remove(const string& ip, string& error_msg)
 {
-    map<unsigned int,Lease *>::iterator it;
+    map<unsigned int,Lease>::iterator it;
 
     ostringstream    oss;
     unsigned int     _ip;
@@ -176,23 +153,18 @@ int FixedLeases::remove(const string& ip, string& error_msg)
         goto error_notfound;
     }
 
-    if (it->second->used) //it is in use
+    if (it->second.used) //it is in use
     {
         goto error_used;
     }
 
-    oss << "DELETE FROM " << table << " WHERE (oid=" << oid
-        << " AND ip=" << _ip << ")";
-
-    rc = db->exec(oss);
+    rc = delete_lease(_ip);
 
     if ( rc != 0 )
     {
         goto error_db;
     }
 
-    delete it->second;
-    
     leases.erase(it);
 
     return rc;
@@ -230,7 +202,7 @@ int FixedLeases::unset(const string& ip)
 {
     unsigned int     _ip;
 
-    map<unsigned int, Lease *>::iterator  it_ip;
+    map<unsigned int, Lease>::iterator  it_ip;
 
     if ( Leases::Lease::ip_to_number(ip,_ip) )
     {
@@ -245,11 +217,11 @@ int FixedLeases::unset(const string& ip)
     }
 
     // Flip used flag to false
-    it_ip->second->used = false;
-    it_ip->second->vid  = -1;
+    it_ip->second.used = false;
+    it_ip->second.vid  = -1;
 
     // Update the lease
-    return update_lease(it_ip->second);
+    return update_lease(&it_ip->second);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -271,16 +243,16 @@ int FixedLeases::get(int vid, string&  ip, string&  mac)
             current = leases.begin();
         }
 
-        if (current->second->used == false)
+        if (current->second.used == false)
         {
             ostringstream oss;
 
-            current->second->used = true;
-            current->second->vid  = vid;
+            current->second.used = true;
+            current->second.vid  = vid;
 
-            rc = update_lease(current->second);
+            rc = update_lease(&current->second);
 
-            current->second->to_string(ip,mac);
+            current->second.to_string(ip,mac);
 
             current++;
             break;
@@ -293,9 +265,80 @@ int FixedLeases::get(int vid, string&  ip, string&  mac)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int FixedLeases::set(int vid, const string&  ip, string&  mac)
+int FixedLeases::get(const vector<int>& vids,
+                     vector<string>&    ips,
+                     vector<string>&    macs)
+{
+    vector<map<unsigned int, Lease>::iterator> free_leases;
+    vector<Lease>                              new_leases;
+    vector<Lease>                              old_leases;
+
+    map<unsigned int, Lease>::iterator it = current;
+
+    string ip;
+    string mac;
+
+    for (unsigned int i = 0; i < size && free_leases.size() < vids.size(); i++)
+    {
+        if (it == leases.end())
+        {
+            it = leases.begin();
+        }
+
+        if (it->second.used == false)
+        {
+            free_leases.push_back(it);
+        }
+
+        it++;
+    }
+
+    if ( free_leases.size() != vids.size() )
+    {
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < free_leases.size(); i++)
+    {
+        Lease lease = free_leases[i]->second;
+
+        old_leases.push_back(lease);
+
+        lease.used = true;
+        lease.vid  = vids[i];
+
+        new_leases.push_back(lease);
+    }
+
+    if ( update_leases(new_leases) != 0 )
+    {
+        update_leases(old_leases);
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < free_leases.size(); i++)
+    {
+        free_leases[i]->second = new_leases[i];
+
+        new_leases[i].to_string(ip,mac);
+
+        ips.push_back(ip);
+        macs.push_back(mac);
+    }
+
+    n_used += free_leases.size();
+
+    current = it;
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int FixedLeases::set(int vid, const string& ip, string& mac, bool use_held)
 {
-    map<unsigned int,Lease *>::iterator it;
+    map<unsigned int,Lease>::iterator it;
 
     unsigned int    num_ip;
     int             rc;
@@ -313,17 +356,34 @@ int FixedLeases::set(int vid, const string&  ip, string&  mac)
     {
         return -1;
     }
-    else if (it->second->used) //it is in use
+    else if (it->second.used) //it is in use, unless it is held
     {
-        return -1;
+        if ( it->second.vid != -1 || vid == -1 || !use_held )
+        {
+            return -1;
+        }
+
+        it->second.vid = vid;
+
+        rc = Leases::update_lease(it->second);
+
+        if ( rc != 0 )
+        {
+            it->second.vid = -1;
+            return -1;
+        }
+
+        Leases::Lease::mac_to_string(it->second.mac,mac);
+
+        return 0;
     }
 
-    it->second->used = true;
-    it->second->vid  = vid;
+    it->second.used = true;
+    it->second.vid  = vid;
 
-    Leases::Lease::mac_to_string(it->second->mac,mac);
+    Leases::Lease::mac_to_string(it->second.mac,mac);
 
-    return update_lease(it->second);
+    return update_lease(&it->second);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -331,17 +391,6 @@ int FixedLeases::set(int vid, const string&  ip, string&  mac)
 
 int FixedLeases::update_lease(Lease * lease)
 {
-    ostringstream   oss;
-    string          xml_body;
-    char *          sql_xml;
-
-    sql_xml = db->escape_str(lease->to_xml_db(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        return -1;
-    }
-
     if( lease->used )
     {
         n_used++;
@@ -351,12 +400,7 @@ int FixedLeases::update_lease(Lease * lease)
         n_used--;
     }
 
-    oss << "UPDATE " << table << " SET body='" << sql_xml << "'"
-        << " WHERE oid=" << oid << " AND ip='" << lease->ip <<"'";
-
-    db->free_str(sql_xml);
-
-    return db->exec(oss);
+    return Leases::update_lease(*lease);
 }
 
 /* -------------------------------------------------------------------------- */
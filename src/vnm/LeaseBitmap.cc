@@ -0,0 +1,169 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "LeaseBitmap.h"
+
+/* ************************************************************************** */
+/* Lease Bitmap :: Methods                                                    */
+/* ************************************************************************** */
+
+void LeaseBitmap::init(unsigned int size)
+{
+    unsigned int bits = size;
+    unsigned int words;
+
+    num_bits = size;
+
+    levels.clear();
+
+    do
+    {
+        words = (bits + WORD_BITS - 1) / WORD_BITS;
+
+        vector<unsigned int> level(words, 0);
+
+        // Addresses past the end of the range are never free
+        if ( bits % WORD_BITS != 0 )
+        {
+            level[words - 1] = FULL << (bits % WORD_BITS);
+        }
+
+        levels.push_back(level);
+
+        bits = words;
+    }
+    while ( words > 1 );
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void LeaseBitmap::set(unsigned int index, bool used)
+{
+    unsigned int pos = index;
+
+    if ( index >= num_bits )
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < levels.size(); i++)
+    {
+        unsigned int& word = levels[i][pos / WORD_BITS];
+        bool          full = ( word == FULL );
+
+        if ( used )
+        {
+            word |= (1U << (pos % WORD_BITS));
+        }
+        else
+        {
+            word &= ~(1U << (pos % WORD_BITS));
+        }
+
+        // The upper levels only change when the word gets full or not full
+        if ( full == ( word == FULL ) )
+        {
+            break;
+        }
+
+        used = ( word == FULL );
+        pos  = pos / WORD_BITS;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+long LeaseBitmap::next_free(unsigned int start) const
+{
+    long index;
+
+    if ( num_bits == 0 )
+    {
+        return -1;
+    }
+
+    if ( start >= num_bits )
+    {
+        start = 0;
+    }
+
+    index = next_zero(0, start);
+
+    if ( index == -1 && start > 0 )
+    {
+        index = next_zero(0, 0);
+    }
+
+    return index;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+long LeaseBitmap::next_zero(unsigned int level, unsigned int pos) const
+{
+    const vector<unsigned int>& words = levels[level];
+
+    unsigned int w = pos / WORD_BITS;
+    unsigned int word;
+    long         nw;
+
+    if ( w >= words.size() )
+    {
+        return -1;
+    }
+
+    // Bits before pos in its word are not considered
+    word = words[w] | ((1U << (pos % WORD_BITS)) - 1);
+
+    if ( word != FULL )
+    {
+        return w * WORD_BITS + first_zero(word);
+    }
+
+    // Next word that is not full, from the upper level
+    if ( level + 1 < levels.size() )
+    {
+        nw = next_zero(level + 1, w + 1);
+    }
+    else
+    {
+        for ( nw = w + 1; nw < static_cast<long>(words.size()); nw++ )
+        {
+            if ( words[nw] != FULL )
+            {
+                break;
+            }
+        }
+
+        if ( nw == static_cast<long>(words.size()) )
+        {
+            nw = -1;
+        }
+    }
+
+    if ( nw == -1 )
+    {
+        return -1;
+    }
+
+    return nw * WORD_BITS + first_zero(words[nw]);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
@@ -15,6 +15,9 @@
 /* -------------------------------------------------------------------------- */
 
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "Leases.h"
 #include "NebulaLog.h"
 
@@ -198,72 +201,35 @@ ostream& operator<<(ostream& os, Leases::Lease& _lease)
 
 string& Leases::Lease::to_xml(string& str) const
 {
-    string ip;
-    string mac;
-
-    ostringstream os;
-
-    to_string(ip,mac);
-
-    os <<
-        "<LEASE>" <<
-            "<IP>"  << ip   << "</IP>"  <<
-            "<MAC>" << mac  << "</MAC>" <<
-            "<USED>"<< used << "</USED>"<<
-            "<VID>" << vid  << "</VID>" <<
-        "</LEASE>";
-
-    str = os.str();
-
-    return str;
-}
-
-/* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
-
-string& Leases::Lease::to_xml_db(string& str) const
-{
-    ostringstream os;
+    XMLWriter writer(128);
 
-    os <<
-        "<LEASE>" <<
-            "<IP>"          << ip                   << "</IP>"  <<
-            "<MAC_PREFIX>"  << mac[Lease::PREFIX]   << "</MAC_PREFIX>" <<
-            "<MAC_SUFFIX>"  << mac[Lease::SUFFIX]   << "</MAC_SUFFIX>" <<
-            "<USED>"        << used                 << "</USED>"<<
-            "<VID>"         << vid                  << "</VID>" <<
-        "</LEASE>";
+    to_xml(writer);
 
-    str = os.str();
-
-    return str;
+    return writer.swap(str);
 }
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int Leases::Lease::from_xml(const string &xml_str)
+void Leases::Lease::to_xml(XMLWriter& xml) const
 {
-    int rc = 0;
-    int int_used;
-
-    // Initialize the internal XML object
-    update_from_str(xml_str);
-
-    rc += xpath(ip                , "/LEASE/IP"         , 0);
-    rc += xpath(mac[Lease::PREFIX], "/LEASE/MAC_PREFIX" , 0);
-    rc += xpath(mac[Lease::SUFFIX], "/LEASE/MAC_SUFFIX" , 0);
-    rc += xpath(int_used          , "/LEASE/USED"       , 0);
-    rc += xpath(vid               , "/LEASE/VID"        , 0);
-
-    used = static_cast<bool>(int_used);
-
-    if (rc != 0)
-    {
-        return -1;
-    }
-
-    return 0;
+    char str_ip[16];
+    char str_mac[18];
+
+    snprintf(str_ip, sizeof(str_ip), "%u.%u.%u.%u",
+             (ip >> 24) & 255, (ip >> 16) & 255, (ip >> 8) & 255, ip & 255);
+
+    snprintf(str_mac, sizeof(str_mac), "%02x:%02x:%02x:%02x:%02x:%02x",
+             (mac[PREFIX] >> 8)  & 255, mac[PREFIX] & 255,
+             (mac[SUFFIX] >> 24) & 255, (mac[SUFFIX] >> 16) & 255,
+             (mac[SUFFIX] >> 8)  & 255, mac[SUFFIX] & 255);
+
+    xml.open("LEASE")
+        .add("IP",   str_ip)
+        .add("MAC",  str_mac)
+        .add("USED", static_cast<int>(used))
+        .add("VID",  vid)
+    .close("LEASE");
 }
 
 /* ************************************************************************** */
@@ -274,35 +240,36 @@ int Leases::Lease::from_xml(const string &xml_str)
 
 const char * Leases::table        = "leases";
 
-const char * Leases::db_names     = "oid, ip, body";
+const char * Leases::db_names     = "oid, ip, mac_prefix, mac_suffix, vid, used";
 
 const char * Leases::db_bootstrap = "CREATE TABLE IF NOT EXISTS leases ("
-                "oid INTEGER, ip BIGINT, body TEXT, PRIMARY KEY(oid,ip))";
+                "oid INTEGER, ip BIGINT, mac_prefix BIGINT, mac_suffix BIGINT, "
+                "vid INTEGER, used INTEGER, PRIMARY KEY(oid,ip))";
+
+const unsigned int Leases::BATCH_SIZE = 100;
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
 int Leases::select_cb(void *nil, int num, char **values, char **names)
 {
-    Lease *         lease;
-    int             rc;
+    Lease lease;
 
-    if ( (!values[0]) || (num != 1) )
+    if ( (num != 5) || (!values[0]) || (!values[1]) || (!values[2]) ||
+         (!values[3]) || (!values[4]) )
     {
         return -1;
     }
 
-    lease = new Lease();
-    rc = lease->from_xml(values[0]);
-
-    if (rc != 0)
-    {
-        return -1;
-    }
+    lease.ip                 = strtoul(values[0], 0, 10);
+    lease.mac[Lease::PREFIX] = strtoul(values[1], 0, 10);
+    lease.mac[Lease::SUFFIX] = strtoul(values[2], 0, 10);
+    lease.vid                = atoi(values[3]);
+    lease.used               = atoi(values[4]) != 0;
 
-    leases.insert(make_pair(lease->ip, lease));
+    leases.insert(make_pair(lease.ip, lease));
 
-    if(lease->used)
+    if(lease.used)
     {
         n_used++;
     }
@@ -322,7 +289,8 @@ int Leases::select(SqlDB * db)
 
     set_callback(static_cast<Callbackable::Callback>(&Leases::select_cb));
 
-    oss << "SELECT body FROM " << table << " WHERE oid = " << oid;
+    oss << "SELECT ip, mac_prefix, mac_suffix, vid, used FROM " << table
+        << " WHERE oid = " << oid;
 
     rc = db->exec(oss,this);
 
@@ -346,6 +314,186 @@ error_id:
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+int Leases::insert_lease(const Lease& lease)
+{
+    ostringstream oss;
+
+    oss << "INSERT INTO " << table << " ("<< db_names <<") VALUES ("
+        << oid                     << ","
+        << lease.ip                << ","
+        << lease.mac[Lease::PREFIX]<< ","
+        << lease.mac[Lease::SUFFIX]<< ","
+        << lease.vid               << ","
+        << lease.used              << ")";
+
+    return db->exec(oss);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Leases::update_lease(const Lease& lease)
+{
+    ostringstream oss;
+
+    oss << "UPDATE " << table << " SET vid=" << lease.vid
+        << ", used=" << lease.used
+        << " WHERE oid=" << oid << " AND ip=" << lease.ip;
+
+    return db->exec(oss);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Leases::delete_lease(unsigned int ip)
+{
+    ostringstream oss;
+
+    oss << "DELETE FROM " << table << " WHERE oid=" << oid << " AND ip=" << ip;
+
+    return db->exec(oss);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Leases::insert_leases(const vector<Lease>& new_leases)
+{
+    ostringstream oss;
+    unsigned int  first;
+    unsigned int  last;
+    int           rc = 0;
+
+    for (first = 0; first < new_leases.size(); first = last)
+    {
+        last = first + BATCH_SIZE;
+
+        if ( last > new_leases.size() )
+        {
+            last = new_leases.size();
+        }
+
+        oss.str("");
+
+        oss << "INSERT INTO " << table << " (" << db_names << ") ";
+
+        for (unsigned int i = first; i < last; i++)
+        {
+            const Lease& lease = new_leases[i];
+
+            if ( i != first )
+            {
+                oss << " UNION ALL ";
+            }
+
+            oss << "SELECT " << oid                      << ","
+                             << lease.ip                 << ","
+                             << lease.mac[Lease::PREFIX] << ","
+                             << lease.mac[Lease::SUFFIX] << ","
+                             << lease.vid                << ","
+                             << lease.used;
+        }
+
+        rc = db->exec(oss);
+
+        if ( rc != 0 )
+        {
+            break;
+        }
+    }
+
+    if ( rc == 0 || first == 0 )
+    {
+        return rc;
+    }
+
+    // Rollback, delete the leases written by the previous statements
+    for (unsigned int done = 0; done < first; done += BATCH_SIZE)
+    {
+        oss.str("");
+
+        oss << "DELETE FROM " << table << " WHERE oid=" << oid << " AND ip IN (";
+
+        for (unsigned int i = done; i < done + BATCH_SIZE && i < first; i++)
+        {
+            if ( i != done )
+            {
+                oss << ",";
+            }
+
+            oss << new_leases[i].ip;
+        }
+
+        oss << ")";
+
+        db->exec(oss);
+    }
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Leases::update_leases(const vector<Lease>& new_leases)
+{
+    ostringstream oss;
+    ostringstream ips;
+    ostringstream vids;
+    ostringstream used;
+
+    unsigned int  last;
+    int           rc;
+
+    for (unsigned int first = 0; first < new_leases.size(); first = last)
+    {
+        last = first + BATCH_SIZE;
+
+        if ( last > new_leases.size() )
+        {
+            last = new_leases.size();
+        }
+
+        ips.str("");
+        vids.str("");
+        used.str("");
+
+        for (unsigned int i = first; i < last; i++)
+        {
+            const Lease& lease = new_leases[i];
+
+            if ( i != first )
+            {
+                ips << ",";
+            }
+
+            ips  << lease.ip;
+            vids << " WHEN " << lease.ip << " THEN " << lease.vid;
+            used << " WHEN " << lease.ip << " THEN " << lease.used;
+        }
+
+        oss.str("");
+
+        oss << "UPDATE " << table
+            << " SET vid = CASE ip" << vids.str() << " END,"
+            << " used = CASE ip" << used.str() << " END"
+            << " WHERE oid=" << oid << " AND ip IN (" << ips.str() << ")";
+
+        rc = db->exec(oss);
+
+        if ( rc != 0 )
+        {
+            return rc;
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 int Leases::drop(SqlDB * db)
 {
     ostringstream   oss;
@@ -381,7 +529,7 @@ int Leases::update(SqlDB * db)
 
 bool Leases::check(const string& ip)
 {
-    map<unsigned int,Lease *>::iterator it;
+    map<unsigned int,Lease>::iterator it;
 
     unsigned int _ip;
 
@@ -392,7 +540,7 @@ bool Leases::check(const string& ip)
 
     if (it!=leases.end())
     {
-        return it->second->used;
+        return it->second.used;
     }
     else
     {
@@ -405,13 +553,13 @@ bool Leases::check(const string& ip)
 
 bool Leases::check(unsigned int ip)
 {
-    map<unsigned int,Lease *>::iterator it;
+    map<unsigned int,Lease>::iterator it;
 
     it=leases.find(ip);
 
     if (it!=leases.end())
     {
-        return it->second->used;
+        return it->second.used;
     }
     else
     {
@@ -419,28 +567,127 @@ bool Leases::check(unsigned int ip)
     }
 }
 
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Leases::release_held(const string& ip)
+{
+    if ( is_held(ip) == false )
+    {
+        return -1;
+    }
+
+    release(ip);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+bool Leases::is_held(const string& ip)
+{
+    map<unsigned int,Lease>::iterator it;
+
+    unsigned int _ip;
+
+    if ( Leases::Lease::ip_to_number(ip,_ip) != 0 )
+    {
+        return false;
+    }
+
+    it = leases.find(_ip);
+
+    return ( it != leases.end() && it->second.used && it->second.vid == -1 );
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Leases::bind_held(const vector<string>& ips, const vector<int>& vids)
+{
+    map<unsigned int,Lease>::iterator it;
+    vector<Lease>                     bound;
+
+    unsigned int _ip;
+    unsigned int first;
+    unsigned int last;
+    int          rc = 0;
+
+    for (unsigned int i = 0; i < ips.size() && i < vids.size(); i++)
+    {
+        if ( is_held(ips[i]) == false )
+        {
+            continue;
+        }
+
+        Leases::Lease::ip_to_number(ips[i],_ip);
+
+        it = leases.find(_ip);
+
+        it->second.vid = vids[i];
+
+        bound.push_back(it->second);
+    }
+
+    // Each batch is a single statement, so a failed one is not written
+    for (first = 0; first < bound.size(); first = last)
+    {
+        last = first + BATCH_SIZE;
+
+        if ( last > bound.size() )
+        {
+            last = bound.size();
+        }
+
+        rc = update_leases(vector<Lease>(bound.begin() + first,
+                                         bound.begin() + last));
+        if ( rc != 0 )
+        {
+            break;
+        }
+    }
+
+    if ( rc != 0 )
+    {
+        // The leases of the failed and following batches are still held
+        for (unsigned int i = first; i < bound.size(); i++)
+        {
+            leases[bound[i].ip].vid = -1;
+        }
+    }
+
+    return rc;
+}
+
 /* ************************************************************************** */
 /* Leases :: Misc                                                             */
 /* ************************************************************************** */
 
 string& Leases::to_xml(string& xml) const
 {
-    map<unsigned int, Leases::Lease *>::const_iterator  it;
-    ostringstream os;
-    string        lease_xml;
+    XMLWriter writer(64 + 96 * leases.size());
+
+    to_xml(writer);
+
+    return writer.swap(xml);
+}
 
-    os << "<LEASES>";
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void Leases::to_xml(XMLWriter& xml) const
+{
+    map<unsigned int, Leases::Lease>::const_iterator  it;
+
+    xml.open("LEASES");
 
     for(it=leases.begin();it!=leases.end();it++)
     {
-        os << it->second->to_xml(lease_xml);
+        it->second.to_xml(xml);
     }
 
-    os << "</LEASES>";
-
-    xml = os.str();
-
-    return xml;
+    xml.close("LEASES");
 }
 
 /* -------------------------------------------------------------------------- */
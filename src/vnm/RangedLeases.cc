@@ -23,6 +23,10 @@
 /* Ranged Leases class                                                        */
 /* ************************************************************************** */
 
+const unsigned long RangedLeases::MAX_SIZE = 16777214;
+
+/* -------------------------------------------------------------------------- */
+
 RangedLeases::RangedLeases(
     SqlDB *        db,
     int           _oid,
@@ -35,53 +39,160 @@ RangedLeases::RangedLeases(
 
     Leases::Lease::ip_to_number(_network_address,net_addr);
 
+    //The host range can not be empty, wrong sizes of networks created by
+    //older versions are limited to a valid range
+    if ( _size == 0 )
+    {
+        _size = 1;
+    }
+    else if ( _size > MAX_SIZE )
+    {
+        _size = MAX_SIZE;
+    }
+
     //size is the number of hosts in the network
     size = _size + 2;
 
     network_address =  0xFFFFFFFF << (int) ceil(log(size)/log(2));
 
     network_address &= net_addr;
+
+    used_ips.init(size - 2);
 }
 
 /* ************************************************************************** */
 /* Ranged Leases :: Methods                                                   */
 /* ************************************************************************** */
 
+int RangedLeases::select(SqlDB * db)
+{
+    map<unsigned int, Lease>::iterator it;
+
+    //Read the leases from the DB
+    int rc = Leases::select(db);
+
+    if ( rc != 0 )
+    {
+        return rc;
+    }
+
+    used_ips.init(size - 2);
+
+    for (it = leases.begin(); it != leases.end(); it++)
+    {
+        if ( it->second.used && it->first > network_address )
+        {
+            used_ips.set(it->first - network_address - 1, true);
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 int RangedLeases::get(int vid, string&  ip, string&  mac)
 {
     unsigned int num_ip;
-    int          rc = -1;
+    unsigned int num_mac[2];
+    long         index;
+    int          rc;
+
+    index = used_ips.next_free(current % (size-2));
+
+    if ( index == -1 )
+    {
+        return -1;
+    }
 
-    for (unsigned int i=0; i<size; i++, current++)
+    num_ip = network_address + index + 1;
+
+    num_mac[Lease::PREFIX] = mac_prefix;
+    num_mac[Lease::SUFFIX] = num_ip;
+
+    rc = add(num_ip,num_mac,vid);
+
+    if ( rc != 0 )
     {
-        num_ip = network_address + (current%(size-2)) + 1;
+        return -1;
+    }
+
+    current = index + 1;
+
+    Leases::Lease::ip_to_string(num_ip,ip);
+    Leases::Lease::mac_to_string(num_mac,mac);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
 
-        if (check(num_ip) == false)
+int RangedLeases::get(const vector<int>& vids,
+                      vector<string>&    ips,
+                      vector<string>&    macs)
+{
+    vector<Lease> new_leases;
+    unsigned int  num_ip;
+    unsigned int  num_mac[2];
+    long          index = current;
+    string        ip;
+    string        mac;
+
+    num_mac[Lease::PREFIX] = mac_prefix;
+
+    // Mark the addresses as used while they are being selected
+    for (unsigned int i = 0; i < vids.size(); i++)
+    {
+        index = used_ips.next_free(index % (size-2));
+
+        if ( index == -1 )
         {
-            unsigned int num_mac[2];
+            break;
+        }
 
-            num_mac[Lease::PREFIX] = mac_prefix;
-            num_mac[Lease::SUFFIX] = num_ip;
+        used_ips.set(index, true);
 
-            rc = add(num_ip,num_mac,vid);
+        num_ip = network_address + index + 1;
+        num_mac[Lease::SUFFIX] = num_ip;
 
-            if (rc==0)
-            {
-                Leases::Lease::ip_to_string(num_ip,ip);
-                Leases::Lease::mac_to_string(num_mac,mac);
+        new_leases.push_back(Lease(num_ip,num_mac,vids[i]));
 
-                break;
-            }
+        index++;
+    }
+
+    if ( new_leases.size() != vids.size() || insert_leases(new_leases) != 0 )
+    {
+        for (unsigned int i = 0; i < new_leases.size(); i++)
+        {
+            used_ips.set(new_leases[i].ip - network_address - 1, false);
         }
+
+        return -1;
     }
 
-    return rc;
+    for (unsigned int i = 0; i < new_leases.size(); i++)
+    {
+        leases.insert(make_pair(new_leases[i].ip, new_leases[i]));
+
+        new_leases[i].to_string(ip,mac);
+
+        ips.push_back(ip);
+        macs.push_back(mac);
+    }
+
+    n_used += new_leases.size();
+
+    current = index;
+
+    return 0;
 }
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int RangedLeases::set(int vid, const string&  ip, string&  mac)
+int RangedLeases::set(int vid, const string& ip, string& mac, bool use_held)
 {
     unsigned int num_ip;
     unsigned int num_mac[2];
@@ -103,13 +214,33 @@ int RangedLeases::set(int vid, const string&  ip, string&  mac)
         return -1;
     }
 
+    num_mac[Lease::PREFIX] = mac_prefix;
+    num_mac[Lease::SUFFIX] = num_ip;
+
     if (check(num_ip) == true)
     {
-        return -1;
-    }
+        map<unsigned int, Lease>::iterator it = leases.find(num_ip);
 
-    num_mac[Lease::PREFIX] = mac_prefix;
-    num_mac[Lease::SUFFIX] = num_ip;
+        // A held lease can be set for a VM, if allowed
+        if ( it->second.vid != -1 || vid == -1 || !use_held )
+        {
+            return -1;
+        }
+
+        it->second.vid = vid;
+
+        rc = update_lease(it->second);
+
+        if ( rc != 0 )
+        {
+            it->second.vid = -1;
+            return -1;
+        }
+
+        Leases::Lease::mac_to_string(num_mac,mac);
+
+        return 0;
+    }
 
     rc = add(num_ip,num_mac,vid);
 
@@ -132,31 +263,12 @@ int RangedLeases::add(
     int             vid,
     bool            used)
 {
-    ostringstream    oss;
-
-    Lease *         lease;
-    string          xml_body;
-    char *          sql_xml;
+    ostringstream   oss;
+    Lease           lease(ip,mac,vid,used);
 
     int rc;
 
-    lease = new Lease(ip,mac,vid,used);
-
-    sql_xml = db->escape_str(lease->to_xml_db(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
-
-    oss << "INSERT INTO " << table << " ("<< db_names <<") VALUES ("
-        <<          oid     << ","
-        <<          ip      << ","
-        << "'" <<   sql_xml << "')";
-
-    db->free_str(sql_xml);
-
-    rc = db->exec(oss);
+    rc = insert_lease(lease);
 
     if ( rc != 0 )
     {
@@ -165,21 +277,20 @@ int RangedLeases::add(
 
     leases.insert( make_pair(ip,lease) );
 
+    if ( ip > network_address )
+    {
+        used_ips.set(ip - network_address - 1, true);
+    }
+
     n_used++;
 
     return rc;
 
 
-error_body:
-    oss.str("");
-    oss << "Error inserting lease, marshall error";
-    goto error_common;
-
 error_db:
     oss.str("");
     oss << "Error inserting lease in database.";
 
-error_common:
     NebulaLog::log("VNM", Log::ERROR, oss);
     return -1;
 }
@@ -190,9 +301,8 @@ error_common:
 int  RangedLeases::del(const string& ip)
 {
     unsigned int    _ip;
-    ostringstream   oss;
     int             rc;
-    map<unsigned int, Lease *>::iterator  it_ip;
+    map<unsigned int, Lease>::iterator  it_ip;
 
     // Remove lease from leases map
 
@@ -210,16 +320,16 @@ int  RangedLeases::del(const string& ip)
 
     // Erase it from DB
 
-    oss << "DELETE FROM " << table << " WHERE oid='" << oid
-    << "' AND ip='" << _ip << "'";
-
-    rc = db->exec(oss);
+    rc = delete_lease(_ip);
 
     if ( rc == 0 )
     {
         n_used--;
 
-        delete it_ip->second;
+        if ( _ip > network_address )
+        {
+            used_ips.set(_ip - network_address - 1, false);
+        }
 
         leases.erase(it_ip);
     }
@@ -322,6 +322,11 @@ int VirtualNetwork::insert(SqlDB * db, string& error_str)
         {
             size = default_size;
         }
+        else if (size < 0 ||
+                 static_cast<unsigned long>(size) > RangedLeases::MAX_SIZE)
+        {
+            goto error_size;
+        }
 
         leases = new RangedLeases(db,
                                   oid,
@@ -384,6 +389,11 @@ error_addr:
     ose << "No NETWORK_ADDRESS in template for Virtual Network.";
     goto error_common;
 
+error_size:
+    ose << "Wrong NETWORK_SIZE in template for Virtual Network, it must be "
+        << "between 1 and " << RangedLeases::MAX_SIZE << ".";
+    goto error_common;
+
 error_null_leases:
     ose << "Error getting Virtual Network leases.";
 
@@ -442,6 +452,8 @@ int VirtualNetwork::insert_replace(SqlDB *db, bool replace)
 
     rc = db->exec(oss);
 
+    update_xml_cache(0);
+
     db->free_str(sql_name);
     db->free_str(sql_xml);
 
@@ -493,10 +505,7 @@ string& VirtualNetwork::to_xml_extended(string& xml) const
 
 string& VirtualNetwork::to_xml_extended(string& xml, bool extended) const
 {
-    ostringstream os;
-
-    string template_xml;
-    string leases_xml;
+    XMLWriter writer(2048);
 
     // Total leases is the number of used leases.
     int total_leases = 0;
@@ -506,41 +515,39 @@ string& VirtualNetwork::to_xml_extended(string& xml, bool extended) const
         total_leases = leases->n_used;
     }
 
-    os <<
-        "<VNET>" <<
-            "<ID>"     << oid    << "</ID>"    <<
-            "<UID>"    << uid    << "</UID>"   <<
-            "<GID>"    << gid    << "</GID>"   <<
-            "<UNAME>"  << uname  << "</UNAME>" << 
-            "<GNAME>"  << gname  << "</GNAME>" <<
-            "<NAME>"   << name   << "</NAME>"  <<
-            "<TYPE>"   << type   << "</TYPE>"  <<
-            "<BRIDGE>" << bridge << "</BRIDGE>";
+    writer.open("VNET")
+        .add("ID",     oid)
+        .add("UID",    uid)
+        .add("GID",    gid)
+        .add("UNAME",  uname)
+        .add("GNAME",  gname)
+        .add("NAME",   name)
+        .add("TYPE",   static_cast<int>(type))
+        .add("BRIDGE", bridge);
 
     if (!phydev.empty())
     {
-        os << "<PHYDEV>" << phydev << "</PHYDEV>";
+        writer.add("PHYDEV", phydev);
     }
 
     if (!vlan_id.empty())
     {
-        os << "<VLAN_ID>" << vlan_id << "</VLAN_ID>";
+        writer.add("VLAN_ID", vlan_id);
     }
 
-    os  <<  "<PUBLIC>"      << public_obj   << "</PUBLIC>"      <<
-            "<TOTAL_LEASES>"<< total_leases << "</TOTAL_LEASES>"<<
-            obj_template->to_xml(template_xml);
+    writer.add("PUBLIC",       public_obj)
+          .add("TOTAL_LEASES", total_leases);
+
+    obj_template->to_xml(writer);
 
     if (extended && leases != 0)
     {
-        os << leases->to_xml(leases_xml);
+        leases->to_xml(writer);
     }
 
-    os << "</VNET>";
-
-    xml = os.str();
+    writer.close("VNET");
 
-    return xml;
+    return writer.swap(xml);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -548,42 +555,46 @@ string& VirtualNetwork::to_xml_extended(string& xml, bool extended) const
 
 int VirtualNetwork::from_xml(const string &xml_str)
 {
-    vector<xmlNodePtr> content;
+    XMLReader  reader;
+    xmlNodePtr node;
+
+    const char * nodes[] = {"/VNET/TEMPLATE", 0};
 
     int rc = 0;
     int int_type;
 
-    // Initialize the internal XML object
-    update_from_str(xml_str);
+    // Read the document in a single pass, only the template is kept as DOM
+    if ( reader.parse(xml_str, nodes) != 0 )
+    {
+        return -1;
+    }
 
     // Get class base attributes
-    rc += xpath(oid,        "/VNET/ID",     -1);
-    rc += xpath(uid,        "/VNET/UID",    -1);
-    rc += xpath(gid,        "/VNET/GID",    -1);
-    rc += xpath(uname,      "/VNET/UNAME",  "not_found");
-    rc += xpath(gname,      "/VNET/GNAME",  "not_found");
-    rc += xpath(name,       "/VNET/NAME",   "not_found");
-    rc += xpath(int_type,   "/VNET/TYPE",   -1);
-    rc += xpath(bridge,     "/VNET/BRIDGE", "not_found");
-    rc += xpath(public_obj, "/VNET/PUBLIC", 0);
-    
-    xpath(phydev,  "/VNET/PHYDEV", "");
-    xpath(vlan_id, "/VNET/VLAN_ID","");
+    rc += reader.get(oid,        "/VNET/ID",     -1);
+    rc += reader.get(uid,        "/VNET/UID",    -1);
+    rc += reader.get(gid,        "/VNET/GID",    -1);
+    rc += reader.get(uname,      "/VNET/UNAME",  "not_found");
+    rc += reader.get(gname,      "/VNET/GNAME",  "not_found");
+    rc += reader.get(name,       "/VNET/NAME",   "not_found");
+    rc += reader.get(int_type,   "/VNET/TYPE",   -1);
+    rc += reader.get(bridge,     "/VNET/BRIDGE", "not_found");
+    rc += reader.get(public_obj, "/VNET/PUBLIC", 0);
+
+    reader.get(phydev,  "/VNET/PHYDEV", "");
+    reader.get(vlan_id, "/VNET/VLAN_ID","");
 
     type = static_cast<NetworkType>(int_type);
 
     // Get associated classes
-    ObjectXML::get_nodes("/VNET/TEMPLATE", content);
+    node = reader.get_node("/VNET/TEMPLATE");
 
-    if (content.empty())
+    if (node == 0)
     {
         return -1;
     }
 
     // Virtual Network template
-    rc += obj_template->from_xml_node(content[0]);
-
-    ObjectXML::free_nodes(content);
+    rc += obj_template->from_xml_node(node);
 
     if (rc != 0)
     {
@@ -596,17 +607,14 @@ int VirtualNetwork::from_xml(const string &xml_str)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int VirtualNetwork::nic_attribute(VectorAttribute *nic, int vid)
+int VirtualNetwork::nic_attribute(VectorAttribute *nic, int vid, bool use_held)
 {
     int rc;
 
     string  ip;
     string  mac;
 
-    ostringstream  vnid;
-
     ip      = nic->vector_value("IP");
-    vnid   << oid;
 
     //--------------------------------------------------------------------------
     //                       GET NETWORK LEASE
@@ -618,7 +626,7 @@ int VirtualNetwork::nic_attribute(VectorAttribute *nic, int vid)
     }
     else
     {
-        rc = leases->set(vid,ip,mac);
+        rc = leases->set(vid,ip,mac,use_held);
     }
 
     if ( rc != 0 )
@@ -630,11 +638,26 @@ int VirtualNetwork::nic_attribute(VectorAttribute *nic, int vid)
     //                       NEW NIC ATTRIBUTES
     //--------------------------------------------------------------------------
 
+    network_attributes(nic);
+
+    nic->replace("MAC"       ,mac);
+    nic->replace("IP"        ,ip);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void VirtualNetwork::network_attributes(VectorAttribute *nic)
+{
+    ostringstream  vnid;
+
+    vnid << oid;
+
     nic->replace("NETWORK"   ,name);
     nic->replace("NETWORK_ID",vnid.str());
     nic->replace("BRIDGE"    ,bridge);
-    nic->replace("MAC"       ,mac);
-    nic->replace("IP"        ,ip);
 
     if (!phydev.empty())
     {
@@ -645,8 +668,6 @@ int VirtualNetwork::nic_attribute(VectorAttribute *nic, int vid)
     {
         nic->replace("VLAN_ID", vlan_id);
     }
-
-    return 0;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -659,6 +680,8 @@ int VirtualNetwork::add_leases(VirtualNetworkTemplate * leases_template,
 
     leases_template->get("LEASES", vector_leases);
 
+    set_dirty();
+
     return leases->add_leases(vector_leases, error_msg);
 }
 
@@ -672,8 +695,52 @@ int VirtualNetwork::remove_leases(VirtualNetworkTemplate * leases_template,
 
     leases_template->get("LEASES", vector_leases);
 
+    set_dirty();
+
     return leases->remove_leases(vector_leases, error_msg);
 }
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
+
+int VirtualNetwork::release_leases(VirtualNetworkTemplate * leases_template,
+                                   string&                  error_msg)
+{
+    vector<const Attribute *> vector_leases;
+    const VectorAttribute *   lease;
+
+    string        ip;
+    ostringstream oss;
+
+    leases_template->get("LEASES", vector_leases);
+
+    set_dirty();
+
+    for (unsigned int i = 0; i < vector_leases.size(); i++)
+    {
+        lease = dynamic_cast<const VectorAttribute *>(vector_leases[i]);
+
+        if ( lease == 0 )
+        {
+            continue;
+        }
+
+        ip = lease->vector_value("IP");
+
+        if ( leases->release_held(ip) != 0 )
+        {
+            goto error_held;
+        }
+    }
+
+    return 0;
+
+error_held:
+    oss << "Error releasing lease, IP " << ip << " is not held in NET " << oid;
+    error_msg = oss.str();
+
+    return -1;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
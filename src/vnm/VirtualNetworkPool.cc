@@ -27,6 +27,8 @@
 unsigned int VirtualNetworkPool::_mac_prefix;
 unsigned int VirtualNetworkPool::_default_size;
 
+const char * VirtualNetworkPool::held_lease_name = "HELD_LEASE";
+
 /* -------------------------------------------------------------------------- */
 
 VirtualNetworkPool::VirtualNetworkPool(SqlDB * db,
@@ -172,31 +174,167 @@ int VirtualNetworkPool::nic_attribute(VectorAttribute * nic, int uid, int vid)
         return -1;
     }
 
-    int rc = vnet->nic_attribute(nic,vid);
+    // Only a NIC authorized with MANAGE can get a held lease
+    bool use_held = ( uid == 0 || nic->vector_value(held_lease_name) == "YES" );
+
+    nic->remove(held_lease_name);
+
+    int rc = vnet->nic_attribute(nic,vid,use_held);
+
+    if ( rc == 0 )
+    {
+        update(vnet);
+    }
+
+    vnet->unlock();
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int VirtualNetworkPool::hold_leases(int             nid,
+                                    unsigned int    num,
+                                    vector<string>& ips,
+                                    vector<string>& macs)
+{
+    VirtualNetwork * vnet;
+    vector<int>      vids(num, -1);
+    int              rc;
+
+    vnet = get(nid,true);
+
+    if ( vnet == 0 )
+    {
+        return -1;
+    }
+
+    rc = vnet->get_leases(vids, ips, macs);
+
+    if ( rc == 0 )
+    {
+        update(vnet);
+    }
+
+    vnet->unlock();
+
+    return ( rc == 0 ) ? 0 : -2;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int VirtualNetworkPool::hold_nic_leases(VectorAttribute * nic,
+                                        unsigned int      num,
+                                        vector<string>&   ips,
+                                        vector<string>&   macs)
+{
+    VirtualNetwork * vnet = 0;
+    vector<int>      vids(num, -1);
+    istringstream    is;
+    int              network_id;
+    int              rc;
+
+    if (!nic->vector_value("NETWORK").empty())
+    {
+        return -3;
+    }
+
+    is.str(nic->vector_value("NETWORK_ID"));
+    is >> network_id;
+
+    if( !is.fail() )
+    {
+        vnet = get(network_id,true);
+    }
+
+    if (vnet == 0)
+    {
+        return -1;
+    }
+
+    rc = vnet->get_leases(vids, ips, macs);
 
     if ( rc == 0 )
     {
+        vnet->network_attributes(nic);
+
         update(vnet);
     }
 
     vnet->unlock();
 
+    return ( rc == 0 ) ? 0 : -2;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int VirtualNetworkPool::bind_held_leases(int                   nid,
+                                         const vector<string>& ips,
+                                         const vector<int>&    vids)
+{
+    VirtualNetwork * vnet;
+    int              rc;
+
+    vnet = get(nid,true);
+
+    if ( vnet == 0 )
+    {
+        return -1;
+    }
+
+    rc = vnet->leases->bind_held(ips, vids);
+
+    vnet->unlock();
+
     return rc;
 }
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void VirtualNetworkPool::release_held_leases(int                   nid,
+                                             const vector<string>& ips)
+{
+    VirtualNetwork * vnet;
+
+    vnet = get(nid,true);
+
+    if ( vnet == 0 )
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < ips.size(); i++)
+    {
+        vnet->leases->release_held(ips[i]);
+    }
+
+    update(vnet);
+
+    vnet->unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void VirtualNetworkPool::authorize_nic(VectorAttribute * nic, 
                                        int uid, 
                                        AuthRequest * ar)
 {
     string           network;
+    string           ip;
     VirtualNetwork * vnet = 0;
 
     istringstream   is;
     int             network_id;
 
+    AuthRequest::Operation op = AuthRequest::USE;
+
+    nic->remove(held_lease_name);
+
     network = nic->vector_value("NETWORK_ID");
 
     if(network.empty())
@@ -217,10 +355,20 @@ void VirtualNetworkPool::authorize_nic(VectorAttribute * nic,
         return;
     }
 
+    // A held lease is reserved, only those managing the network can use it
+    ip = nic->vector_value("IP");
+
+    if ( !ip.empty() && vnet->is_held(ip) )
+    {
+        op = AuthRequest::MANAGE;
+
+        nic->replace(held_lease_name, "YES");
+    }
+
     ar->add_auth(AuthRequest::NET,
                  vnet->get_oid(),
                  vnet->get_gid(),
-                 AuthRequest::USE,
+                 op,
                  vnet->get_uid(),
                  vnet->isPublic());
 
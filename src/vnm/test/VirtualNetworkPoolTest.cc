@@ -22,6 +22,7 @@
 #include "VirtualNetworkTemplate.h"
 #include "PoolTest.h"
 #include "ObjectXML.h"
+#include "AuthManager.h"
 
 using namespace std;
 
@@ -154,11 +155,16 @@ class VirtualNetworkPoolTest : public PoolTest
     CPPUNIT_TEST (wrong_get_name);
     CPPUNIT_TEST (update);
     CPPUNIT_TEST (size);
+    CPPUNIT_TEST (wrong_size);
     CPPUNIT_TEST (duplicates);
     CPPUNIT_TEST (dump);
     CPPUNIT_TEST (dump_where);
     CPPUNIT_TEST (fixed_leases);
     CPPUNIT_TEST (ranged_leases);
+    CPPUNIT_TEST (ranged_leases_full);
+    CPPUNIT_TEST (bulk_leases);
+    CPPUNIT_TEST (held_leases);
+    CPPUNIT_TEST (held_lease_nic);
     CPPUNIT_TEST (wrong_leases);
     CPPUNIT_TEST (overlapping_leases_ff);
     CPPUNIT_TEST (overlapping_leases_fr);
@@ -452,6 +458,39 @@ public:
         }
     }
 
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+    void wrong_size()
+    {
+        VirtualNetworkPoolFriend * vnpool =
+                                static_cast<VirtualNetworkPoolFriend*>(pool);
+
+        int rc;
+        int oid;
+
+        string templ[] = {
+            "NAME            = \"Net A\"\n"
+            "TYPE            = RANGED\n"
+            "BRIDGE          = br0\n"
+            "NETWORK_SIZE    = -1\n"
+            "NETWORK_ADDRESS = 192.168.1.0\n",
+
+            "NAME            = \"Net B\"\n"
+            "TYPE            = RANGED\n"
+            "BRIDGE          = br0\n"
+            "NETWORK_SIZE    = 16777215\n"
+            "NETWORK_ADDRESS = 10.0.0.0\n"
+        };
+
+        for (int i = 0 ; i < 2 ; i++)
+        {
+            rc = vnpool->allocate(uids[0], templ[i], &oid);
+
+            CPPUNIT_ASSERT( rc < 0 );
+        }
+    }
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
@@ -738,6 +777,375 @@ public:
         CPPUNIT_ASSERT( bridge  == "bridge0" );
     }
 
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+    void ranged_leases_full()
+    {
+        VirtualNetworkPoolFriend * vnpool =
+                                static_cast<VirtualNetworkPoolFriend*>(pool);
+        int rc, oid;
+        VirtualNetwork *vn;
+
+        string ip     = "";
+        string mac    = "";
+        string bridge = "";
+
+        string tmpl =
+            "NAME            = \"A full network\"\n"
+            "TYPE            = RANGED\n"
+            "BRIDGE          = bridge0\n"
+            "NETWORK_SIZE    = 300\n"
+            "NETWORK_ADDRESS = 10.0.0.0\n";
+
+        vnpool->allocate(45, tmpl, &oid);
+        CPPUNIT_ASSERT( oid != -1 );
+
+        vn = vnpool->get(oid, true);
+        CPPUNIT_ASSERT( vn != 0 );
+
+        for (int i = 0; i < 300; i++)
+        {
+            rc = vn->get_lease(i, ip, mac, bridge);
+            CPPUNIT_ASSERT( rc == 0 );
+        }
+
+        CPPUNIT_ASSERT( ip == "10.0.1.44" );
+
+        // All the IPs are used
+        rc = vn->get_lease(300, ip, mac, bridge);
+        CPPUNIT_ASSERT( rc != 0 );
+
+        vn->release_lease("10.0.0.200");
+        vn->release_lease("10.0.1.10");
+
+        vn->unlock();
+
+        // The free leases are found after reading the network from the DB
+        pool->clean();
+
+        vn = vnpool->get(oid, true);
+        CPPUNIT_ASSERT( vn != 0 );
+
+        rc = vn->get_lease(600, ip, mac, bridge);
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( ip == "10.0.0.200" );
+
+        rc = vn->get_lease(601, ip, mac, bridge);
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( ip == "10.0.1.10" );
+
+        rc = vn->get_lease(602, ip, mac, bridge);
+        CPPUNIT_ASSERT( rc != 0 );
+
+        vn->unlock();
+    }
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+    void bulk_leases()
+    {
+        VirtualNetworkPoolFriend * vnpool =
+                                static_cast<VirtualNetworkPoolFriend*>(pool);
+        int rc, oid_0, oid_1;
+        VirtualNetwork *vn;
+
+        string ip     = "";
+        string mac    = "";
+        string bridge = "";
+
+        vector<int>    vids;
+        vector<string> ips;
+        vector<string> macs;
+
+        string tmpl =
+            "NAME            = \"A ranged network\"\n"
+            "TYPE            = RANGED\n"
+            "BRIDGE          = bridge0\n"
+            "NETWORK_SIZE    = 300\n"
+            "NETWORK_ADDRESS = 10.0.0.0\n";
+
+        vnpool->allocate(45, tmpl, &oid_0);
+        CPPUNIT_ASSERT( oid_0 != -1 );
+
+        // More leases than a single DB statement
+        rc = vnpool->hold_leases(oid_0, 250, ips, macs);
+
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( ips.size() == 250 );
+        CPPUNIT_ASSERT( macs.size() == 250 );
+        CPPUNIT_ASSERT( ips[0]   == "10.0.0.1" );
+        CPPUNIT_ASSERT( ips[249] == "10.0.0.250" );
+
+        // Not enough free leases, none is taken
+        ips.clear();
+        macs.clear();
+
+        rc = vnpool->hold_leases(oid_0, 51, ips, macs);
+        CPPUNIT_ASSERT( rc == -2 );
+        CPPUNIT_ASSERT( ips.empty() );
+
+        rc = vnpool->hold_leases(oid_0, 50, ips, macs);
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( ips[49] == "10.0.1.44" );
+
+        rc = vnpool->hold_leases(-1, 1, ips, macs);
+        CPPUNIT_ASSERT( rc == -1 );
+
+        vn = vnpool->get(oid_0, true);
+        CPPUNIT_ASSERT( vn != 0 );
+
+        // A held lease can be set for one VM, if allowed
+        rc = vn->set_lease(7, "10.0.0.5", mac, bridge);
+        CPPUNIT_ASSERT( rc != 0 );
+        CPPUNIT_ASSERT( vn->is_held("10.0.0.5") == true );
+
+        rc = vn->set_lease(7, "10.0.0.5", mac, bridge, true);
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( mac == "00:02:0a:00:00:05" );
+
+        rc = vn->set_lease(8, "10.0.0.5", mac, bridge, true);
+        CPPUNIT_ASSERT( rc != 0 );
+
+        vn->unlock();
+
+        // Only held leases are released
+        ips.clear();
+        ips.push_back("10.0.0.5");
+        ips.push_back("10.0.0.6");
+
+        vnpool->release_held_leases(oid_0, ips);
+
+        pool->clean();
+
+        vn = vnpool->get(oid_0, true);
+        CPPUNIT_ASSERT( vn != 0 );
+
+        rc = vn->get_lease(9, ip, mac, bridge);
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( ip == "10.0.0.6" );
+
+        rc = vn->get_lease(10, ip, mac, bridge);
+        CPPUNIT_ASSERT( rc != 0 );
+
+        vn->unlock();
+
+        // Fixed network, the leases are set for a list of VMs
+        oid_1 = allocate(0);
+        CPPUNIT_ASSERT( oid_1 != -1 );
+
+        vn = vnpool->get(oid_1, true);
+        CPPUNIT_ASSERT( vn != 0 );
+
+        vids.push_back(3);
+        vids.push_back(4);
+
+        ips.clear();
+        macs.clear();
+
+        rc = vn->get_leases(vids, ips, macs);
+        CPPUNIT_ASSERT( rc != 0 );
+        CPPUNIT_ASSERT( ips.empty() );
+
+        vids.pop_back();
+
+        rc = vn->get_leases(vids, ips, macs);
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( ips.size() == 1 );
+        CPPUNIT_ASSERT( ips[0]  == "130.10.0.1" );
+        CPPUNIT_ASSERT( macs[0] == "50:20:20:20:20:20" );
+
+        vn->unlock();
+
+        pool->clean();
+
+        vn = vnpool->get(oid_1, true);
+        CPPUNIT_ASSERT( vn != 0 );
+
+        rc = vn->get_lease(5, ip, mac, bridge);
+        CPPUNIT_ASSERT( rc != 0 );
+
+        vn->unlock();
+    }
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+    void held_leases()
+    {
+        VirtualNetworkPoolFriend * vnpool =
+                                static_cast<VirtualNetworkPoolFriend*>(pool);
+        int rc, oid_0;
+        VirtualNetwork *vn;
+
+        string ip     = "";
+        string mac    = "";
+        string bridge = "";
+
+        vector<string> ips;
+        vector<string> macs;
+        vector<string> bound;
+        vector<int>    vids;
+
+        string tmpl =
+            "NAME            = \"A ranged network\"\n"
+            "TYPE            = RANGED\n"
+            "BRIDGE          = bridge0\n"
+            "VLAN_ID         = 7\n"
+            "NETWORK_SIZE    = 30\n"
+            "NETWORK_ADDRESS = 10.0.0.0\n";
+
+        vnpool->allocate(45, tmpl, &oid_0);
+        CPPUNIT_ASSERT( oid_0 != -1 );
+
+        // The network of a NIC must be referenced by its ID
+        VectorAttribute by_name("NIC");
+
+        by_name.replace("NETWORK", "A ranged network");
+
+        rc = vnpool->hold_nic_leases(&by_name, 2, ips, macs);
+        CPPUNIT_ASSERT( rc == -3 );
+
+        // The leases are held and the network attributes set in the NIC
+        ostringstream   nid;
+        VectorAttribute nic("NIC");
+
+        nid << oid_0;
+        nic.replace("NETWORK_ID", nid.str());
+
+        rc = vnpool->hold_nic_leases(&nic, 3, ips, macs);
+
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( ips.size() == 3 );
+        CPPUNIT_ASSERT( macs[2] == "00:02:0a:00:00:03" );
+        CPPUNIT_ASSERT( nic.vector_value("NETWORK") == "A ranged network" );
+        CPPUNIT_ASSERT( nic.vector_value("BRIDGE")  == "bridge0" );
+        CPPUNIT_ASSERT( nic.vector_value("VLAN_ID") == "7" );
+        CPPUNIT_ASSERT( nic.vector_value("IP").empty() );
+
+        // Using a held lease requires MANAGE on the network
+        AuthRequest ar(5, 0);
+        AuthRequest ar_held(5, 0);
+
+        vnpool->authorize_nic(&nic, 5, &ar);
+
+        nic.replace("IP", ips[0]);
+
+        vnpool->authorize_nic(&nic, 5, &ar_held);
+
+        CPPUNIT_ASSERT( ar.get_auths().find(":USE:") != string::npos );
+        CPPUNIT_ASSERT( ar_held.get_auths().find(":MANAGE:") != string::npos );
+
+        // Two leases are set for VMs, the last one is no longer held
+        bound.push_back(ips[0]);
+        bound.push_back(ips[1]);
+        bound.push_back(ips[2]);
+
+        vids.push_back(20);
+        vids.push_back(21);
+        vids.push_back(22);
+
+        vnpool->release_held_leases(oid_0, vector<string>(1, bound[2]));
+
+        rc = vnpool->bind_held_leases(oid_0, bound, vids);
+        CPPUNIT_ASSERT( rc == 0 );
+
+        pool->clean();
+
+        vn = vnpool->get(oid_0, true);
+        CPPUNIT_ASSERT( vn != 0 );
+
+        CPPUNIT_ASSERT( vn->is_held(bound[0]) == false );
+        CPPUNIT_ASSERT( vn->is_held(bound[1]) == false );
+
+        // The leases are used by the VMs
+        rc = vn->set_lease(30, bound[0], mac, bridge);
+        CPPUNIT_ASSERT( rc != 0 );
+
+        // The released lease is free
+        rc = vn->set_lease(31, bound[2], mac, bridge);
+        CPPUNIT_ASSERT( rc == 0 );
+
+        vn->unlock();
+
+        vn = vnpool->get(oid_0, false);
+
+        string xml_str;
+
+        vn->to_xml_extended(xml_str);
+
+        CPPUNIT_ASSERT( xml_str.find("<IP>10.0.0.1</IP><MAC>00:02:0a:00:00:01"
+            "</MAC><USED>1</USED><VID>20</VID>") != string::npos );
+        CPPUNIT_ASSERT( xml_str.find("<VID>21</VID>") != string::npos );
+        CPPUNIT_ASSERT( xml_str.find("<VID>22</VID>") == string::npos );
+    }
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+    void held_lease_nic()
+    {
+        VirtualNetworkPoolFriend * vnpool =
+                                static_cast<VirtualNetworkPoolFriend*>(pool);
+        int rc, oid_0;
+
+        vector<string> ips;
+        vector<string> macs;
+
+        string tmpl =
+            "NAME            = \"A ranged network\"\n"
+            "TYPE            = RANGED\n"
+            "BRIDGE          = bridge0\n"
+            "NETWORK_SIZE    = 30\n"
+            "NETWORK_ADDRESS = 10.0.0.0\n";
+
+        vnpool->allocate(45, tmpl, &oid_0);
+        CPPUNIT_ASSERT( oid_0 != -1 );
+
+        ostringstream   nid;
+        VectorAttribute nic("NIC");
+
+        nid << oid_0;
+        nic.replace("NETWORK_ID", nid.str());
+        nic.replace("IP", "10.0.0.1");
+        nic.replace("HELD_LEASE", "YES");
+
+        // The lease is free, USE is enough and the NIC is not marked
+        AuthRequest ar(5, 0);
+
+        vnpool->authorize_nic(&nic, 5, &ar);
+
+        CPPUNIT_ASSERT( ar.get_auths().find(":USE:") != string::npos );
+        CPPUNIT_ASSERT( nic.vector_value("HELD_LEASE").empty() );
+
+        // The lease is held after the authorization, it is not set
+        rc = vnpool->hold_leases(oid_0, 1, ips, macs);
+
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( ips[0] == "10.0.0.1" );
+
+        rc = vnpool->nic_attribute(&nic, 5, 40);
+        CPPUNIT_ASSERT( rc == -1 );
+
+        // Authorized with MANAGE, the held lease is set for the VM
+        AuthRequest ar_held(5, 0);
+
+        vnpool->authorize_nic(&nic, 5, &ar_held);
+
+        CPPUNIT_ASSERT( ar_held.get_auths().find(":MANAGE:") != string::npos );
+
+        rc = vnpool->nic_attribute(&nic, 5, 40);
+
+        CPPUNIT_ASSERT( rc == 0 );
+        CPPUNIT_ASSERT( nic.vector_value("HELD_LEASE").empty() );
+        CPPUNIT_ASSERT( nic.vector_value("MAC") == "00:02:0a:00:00:01" );
+
+        VirtualNetwork * vn = vnpool->get(oid_0, false);
+
+        CPPUNIT_ASSERT( vn->is_held("10.0.0.1") == false );
+    }
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
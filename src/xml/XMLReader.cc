@@ -0,0 +1,294 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2011, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "XMLReader.h"
+
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+XMLReader::~XMLReader()
+{
+    clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void XMLReader::clear()
+{
+    map<string, xmlNodePtr>::iterator it;
+
+    for (it = nodes.begin(); it != nodes.end(); it++)
+    {
+        xmlFreeNode(it->second);
+    }
+
+    nodes.clear();
+    values.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int XMLReader::parse(const string& xml_doc, const char * node_paths[])
+{
+    xmlTextReaderPtr reader;
+
+    vector<string::size_type> parents;
+
+    string path;
+    string text;
+    bool   leaf = false;
+    bool   skip;
+    int    rc;
+
+    clear();
+
+    reader = xmlReaderForMemory(xml_doc.c_str(), xml_doc.size(), 0, 0, 0);
+
+    if ( reader == 0 )
+    {
+        return -1;
+    }
+
+    rc = xmlTextReaderRead(reader);
+
+    while ( rc == 1 )
+    {
+        const xmlChar * str;
+
+        skip = false;
+
+        switch (xmlTextReaderNodeType(reader))
+        {
+            case XML_READER_TYPE_ELEMENT:
+                str = xmlTextReaderConstName(reader);
+
+                parents.push_back(path.size());
+
+                path += '/';
+                path += reinterpret_cast<const char *>(str);
+
+                text.clear();
+                leaf = true;
+
+                for (int i = 0; node_paths != 0 && node_paths[i] != 0; i++)
+                {
+                    if ( path == node_paths[i] )
+                    {
+                        skip = true;
+                        break;
+                    }
+                }
+
+                if ( skip )
+                {
+                    xmlNodePtr node = xmlTextReaderExpand(reader);
+
+                    if ( node != 0 && nodes.count(path) == 0 )
+                    {
+                        nodes.insert(make_pair(path, xmlCopyNode(node, 1)));
+                    }
+                }
+                else if ( xmlTextReaderIsEmptyElement(reader) == 1 )
+                {
+                    values.insert(make_pair(path, text));
+                }
+                else
+                {
+                    break;
+                }
+
+                // Element fully processed, no END_ELEMENT will be read
+                path.erase(parents.back());
+                parents.pop_back();
+
+                leaf = false;
+                break;
+
+            case XML_READER_TYPE_TEXT:
+            case XML_READER_TYPE_CDATA:
+            case XML_READER_TYPE_WHITESPACE:
+            case XML_READER_TYPE_SIGNIFICANT_WHITESPACE:
+                str = xmlTextReaderConstValue(reader);
+
+                if ( leaf && str != 0 )
+                {
+                    text += reinterpret_cast<const char *>(str);
+                }
+                break;
+
+            case XML_READER_TYPE_END_ELEMENT:
+                if ( leaf )
+                {
+                    values.insert(make_pair(path, text));
+                }
+
+                if ( !parents.empty() )
+                {
+                    path.erase(parents.back());
+                    parents.pop_back();
+                }
+
+                leaf = false;
+                break;
+
+            default:
+                break;
+        }
+
+        if ( skip )
+        {
+            rc = xmlTextReaderNext(reader);
+        }
+        else
+        {
+            rc = xmlTextReaderRead(reader);
+        }
+    }
+
+    xmlFreeTextReader(reader);
+
+    if ( rc != 0 )
+    {
+        clear();
+        return -1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int XMLReader::get(string& value, const string& path, const char * def) const
+{
+    const string * str = text(path);
+
+    if ( str == 0 )
+    {
+        value = def;
+        return -1;
+    }
+
+    value = *str;
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int XMLReader::get(int& value, const string& path, int def) const
+{
+    const string * str = text(path);
+    char *         end;
+    long           lval;
+
+    if ( str == 0 )
+    {
+        value = def;
+        return -1;
+    }
+
+    errno = 0;
+    lval  = strtol(str->c_str(), &end, 10);
+
+    if ( end == str->c_str() || errno != 0 || lval > INT_MAX || lval < INT_MIN)
+    {
+        value = def;
+        return -1;
+    }
+
+    value = static_cast<int>(lval);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int XMLReader::get(unsigned int& value,
+                   const string& path,
+                   unsigned int  def) const
+{
+    const string * str = text(path);
+    char *         end;
+    unsigned long  lval;
+
+    if ( str == 0 )
+    {
+        value = def;
+        return -1;
+    }
+
+    errno = 0;
+    lval  = strtoul(str->c_str(), &end, 10);
+
+    if ( end == str->c_str() || errno != 0 || lval > UINT_MAX )
+    {
+        value = def;
+        return -1;
+    }
+
+    value = static_cast<unsigned int>(lval);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int XMLReader::get(time_t& value, const string& path, time_t def) const
+{
+    const string * str = text(path);
+    char *         end;
+    long           lval;
+
+    if ( str == 0 )
+    {
+        value = def;
+        return -1;
+    }
+
+    errno = 0;
+    lval  = strtol(str->c_str(), &end, 10);
+
+    if ( end == str->c_str() || errno != 0 )
+    {
+        value = def;
+        return -1;
+    }
+
+    value = static_cast<time_t>(lval);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+xmlNodePtr XMLReader::get_node(const string& path) const
+{
+    map<string, xmlNodePtr>::const_iterator it = nodes.find(path);
+
+    if ( it == nodes.end() )
+    {
+        return 0;
+    }
+
+    return it->second;
+}
@@ -20,6 +20,7 @@
 #include <stdexcept>
 
 #include "ObjectXML.h"
+#include "XMLReader.h"
 #include "test/OneUnitTest.h"
 
 /* ************************************************************************* */
@@ -36,6 +37,8 @@ class ObjectXMLTest : public OneUnitTest
     CPPUNIT_TEST( rank );
     CPPUNIT_TEST( xpath );
     CPPUNIT_TEST( xpath_value );
+    CPPUNIT_TEST( reader );
+    CPPUNIT_TEST( reader_nodes );
 
     CPPUNIT_TEST_SUITE_END ();
 
@@ -369,6 +372,114 @@ public:
         }
     };
 
+    void reader()
+    {
+        ObjectXML obj(xml_history_dump);
+        XMLReader rd;
+
+        string str;
+        int    i;
+        time_t t;
+        int    rc;
+
+        const char * paths[] = {
+            "/VM_POOL/VM/ID",
+            "/VM_POOL/VM/STATE",
+            "/VM_POOL/VM/HISTORY/HOSTNAME",
+            "/VM_POOL/VM/HISTORY/SEQ",
+            "/VM_POOL/VM/DEPLOY_ID",
+            "/VM_POOL/VM/USERNAME",
+            "/VM_POOL/VM/STIME",
+            "/VM_POOL/NOT_AN_ELEMENT",
+            0
+        };
+
+        rc = rd.parse(xml_history_dump);
+        CPPUNIT_ASSERT(rc == 0);
+
+        // Same results as the xpath queries, first element is used
+        for (int j = 0; paths[j] != 0; j++)
+        {
+            string xpath_str;
+            int    xpath_i;
+
+            CPPUNIT_ASSERT(rd.get(str, paths[j], "default") ==
+                           obj.xpath(xpath_str, paths[j], "default"));
+            CPPUNIT_ASSERT(str == xpath_str);
+
+            CPPUNIT_ASSERT(rd.get(i, paths[j], 35) ==
+                           obj.xpath(xpath_i, paths[j], 35));
+            CPPUNIT_ASSERT(i == xpath_i);
+        }
+
+        rc = rd.get(str, "/VM_POOL/VM/HISTORY/HOSTNAME", "default_host");
+        CPPUNIT_ASSERT(str == "A_hostname");
+        CPPUNIT_ASSERT(rc == 0);
+
+        rc = rd.get(t, "/VM_POOL/VM/STIME", 35);
+        CPPUNIT_ASSERT(t == 0);
+        CPPUNIT_ASSERT(rc == 0);
+
+        rc = rd.get(i, "/VM_POOL/VM/USERNAME", 33);
+        CPPUNIT_ASSERT(i == 33);
+        CPPUNIT_ASSERT(rc == -1);
+
+        // Escaped text and CDATA sections
+        rc = rd.parse("<A><B>a &amp; b</B><C><![CDATA[x]]]]><![CDATA[>y]]></C>"
+                      "<D/></A>");
+        CPPUNIT_ASSERT(rc == 0);
+
+        rd.get(str, "/A/B", "");
+        CPPUNIT_ASSERT(str == "a & b");
+
+        rd.get(str, "/A/C", "");
+        CPPUNIT_ASSERT(str == "x]]>y");
+
+        rc = rd.get(str, "/A/D", "default");
+        CPPUNIT_ASSERT(str == "");
+        CPPUNIT_ASSERT(rc == 0);
+
+        // Malformed documents
+        rc = rd.parse("<A><B>1</A>");
+        CPPUNIT_ASSERT(rc == -1);
+
+        rc = rd.get(i, "/A/B", 7);
+        CPPUNIT_ASSERT(i == 7);
+        CPPUNIT_ASSERT(rc == -1);
+    };
+
+    void reader_nodes()
+    {
+        XMLReader  rd;
+        xmlNodePtr node;
+        string     str;
+        int        rc;
+
+        const char * nodes[] = {"/VM_POOL/VM/HISTORY", 0};
+
+        rc = rd.parse(xml_history_dump, nodes);
+        CPPUNIT_ASSERT(rc == 0);
+
+        // Elements of DOM nodes are not read as values
+        rc = rd.get(str, "/VM_POOL/VM/HISTORY/HOSTNAME", "default_host");
+        CPPUNIT_ASSERT(str == "default_host");
+        CPPUNIT_ASSERT(rc == -1);
+
+        rc = rd.get(str, "/VM_POOL/VM/NAME", "");
+        CPPUNIT_ASSERT(str == "VM one");
+        CPPUNIT_ASSERT(rc == 0);
+
+        node = rd.get_node("/VM_POOL/VM/HISTORY");
+        CPPUNIT_ASSERT(node != 0);
+
+        ObjectXML obj(node);
+
+        obj.xpath(str, "/HISTORY/HOSTNAME", "default_host");
+        CPPUNIT_ASSERT(str == "A_hostname");
+
+        CPPUNIT_ASSERT(rd.get_node("/VM_POOL/VM") == 0);
+    };
+
     static const string xml_history_dump;
     static const string xml_history_dump2;
     static const string host;